@@ -30,6 +30,7 @@
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QStatusBar>
+#include <QDebug>
 
 #include "widgets/buttonslist.h"
 #include "GUI/global.h"
@@ -84,6 +85,13 @@ private:
 stdsptr<ShaderEffectCreator> DialogsInterfaceImpl::execShaderChooser(
         const QString& name, const ShaderOptions& options) const {
     const auto parent = MainWindow::sGetInstance();
+    // no window when rendering from the command line
+    if(!parent) {
+        if(options.isEmpty()) return nullptr;
+        qWarning().noquote() << "Missing Shader Effect" << name
+                             << "using" << options.first()->fGrePath;
+        return options.first();
+    }
     ShaderChoiceDialog dialog(name, options, parent);
     const bool accepted = dialog.exec() == QDialog::Accepted;
     if(accepted) return dialog.getSelected();
@@ -135,6 +143,10 @@ void DialogsInterfaceImpl::showSceneSettingsDialog(Canvas* const scene) const {
 void DialogsInterfaceImpl::displayMessageToUser(
         const QString& message, const int ms) const {
     const auto parent = MainWindow::sGetInstance();
+    if(!parent) {
+        qInfo().noquote() << message;
+        return;
+    }
     const auto widget = new QLabel(message, parent, Qt::SplashScreen);
     widget->setObjectName("messageLabel");
     widget->show();
@@ -144,5 +156,9 @@ void DialogsInterfaceImpl::displayMessageToUser(
 void DialogsInterfaceImpl::showStatusMessage(
         const QString& message, const int ms) const {
     const auto win = MainWindow::sGetInstance();
+    if(!win) {
+        qInfo().noquote() << message;
+        return;
+    }
     win->statusBar()->showMessage(message, ms);
 }
@@ -59,22 +59,7 @@ RenderInstanceWidget::RenderInstanceWidget(const RenderInstanceSettings& sett,
 
 void RenderInstanceWidget::iniGUI()
 {
-    if (!OutputSettingsProfile::sOutputProfilesLoaded) {
-        OutputSettingsProfile::sOutputProfilesLoaded = true;
-        QDir dirPath(AppSupport::getAppOutputProfilesPath());
-        dirPath.setSorting(QDir::SortFlag::Name);
-        for (const auto &fileInfo : dirPath.entryInfoList()) {
-            if (!fileInfo.isFile()) { continue; }
-            if (!fileInfo.completeSuffix().contains("conf")) { continue; }
-            const auto profile = enve::make_shared<OutputSettingsProfile>();
-            try {
-                profile->load(fileInfo.absoluteFilePath());
-            } catch(const std::exception& e) {
-                gPrintExceptionCritical(e);
-            }
-            OutputSettingsProfile::sOutputProfiles << profile;
-        }
-    }
+    OutputSettingsProfile::sLoadOutputProfiles();
 
     setCheckable(true);
     setObjectName("darkWidget");
@@ -468,9 +453,14 @@ void RenderInstanceWidget::write(eWriteStream &dst) const {
 }
 
 void RenderInstanceWidget::read(eReadStream &src) {
-    mSettings.read(src);
+    setChecked(sReadSettings(src, mSettings));
+}
+
+bool RenderInstanceWidget::sReadSettings(eReadStream &src,
+                                         RenderInstanceSettings &settings) {
+    settings.read(src);
     bool checked; src >> checked;
-    setChecked(checked);
+    return checked;
 }
 
 void RenderInstanceWidget::updateRenderSettings()
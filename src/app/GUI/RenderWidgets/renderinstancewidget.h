@@ -60,6 +60,9 @@ public:
 
     void write(eWriteStream &dst) const;
     void read(eReadStream &src);
+    //! @brief Reads the data read by read into settings, returns checked
+    static bool sReadSettings(eReadStream &src,
+                              RenderInstanceSettings &settings);
     void updateRenderSettings();
 
 protected:
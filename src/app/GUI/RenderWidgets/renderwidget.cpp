@@ -288,12 +288,18 @@ void RenderWidget::write(eWriteStream &dst) const
 
 void RenderWidget::read(eReadStream &src)
 {
-    int nWidgets; src >> nWidgets;
-    for (int i = 0; i < nWidgets; i++) {
+    sRead(src, [this](eReadStream &src) {
         const auto wid = new RenderInstanceWidget(nullptr, this);
         wid->read(src);
         addRenderInstanceWidget(wid);
-    }
+    });
+}
+
+void RenderWidget::sRead(eReadStream &src,
+                         const std::function<void(eReadStream&)> &readInstance)
+{
+    int nWidgets; src >> nWidgets;
+    for (int i = 0; i < nWidgets; i++) { readInstance(src); }
 }
 
 void RenderWidget::updateRenderSettings()
@@ -51,6 +51,10 @@ public:
     void clearRenderQueue();
     void write(eWriteStream& dst) const;
     void read(eReadStream& src);
+    //! @brief Reads the render queue written by write,
+    //! readInstance is called for every queued instance
+    static void sRead(eReadStream& src,
+                      const std::function<void(eReadStream&)>& readInstance);
     void updateRenderSettings();
 
 signals:
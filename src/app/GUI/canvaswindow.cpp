@@ -379,10 +379,20 @@ void CanvasWindow::writeState(eWriteStream &dst) const
     dst << mViewTransform;
 }
 
+CanvasWindow::State CanvasWindow::sReadState(eReadStream &src)
+{
+    State state;
+    src >> state.fSceneReadId;
+    src >> state.fSceneDocumentId;
+    src >> state.fViewTransform;
+    return state;
+}
+
 void CanvasWindow::readState(eReadStream &src)
 {
-    int sceneReadId; src >> sceneReadId;
-    int sceneDocumentId; src >> sceneDocumentId;
+    const auto state = sReadState(src);
+    const int sceneReadId = state.fSceneReadId;
+    const int sceneDocumentId = state.fSceneDocumentId;
 
     src.addReadStreamDoneTask([this, sceneReadId, sceneDocumentId]
                               (eReadStream& src) {
@@ -397,7 +407,7 @@ void CanvasWindow::readState(eReadStream &src)
         setCurrentCanvas(enve_cast<Canvas*>(sceneBox));
     });
 
-    src >> mViewTransform;
+    mViewTransform = state.fViewTransform;
     mFitToSizeBlocked = true;
 }
 
@@ -91,6 +91,15 @@ public:
     void releaseMouse();
     bool isMouseGrabber();
 
+    struct State {
+        int fSceneReadId;
+        int fSceneDocumentId;
+        QMatrix fViewTransform;
+    };
+
+    //! @brief Reads the data written by writeState without a window
+    static State sReadState(eReadStream& src);
+
     void writeState(eWriteStream& dst) const;
     void readState(eReadStream& src);
 
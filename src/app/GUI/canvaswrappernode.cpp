@@ -64,6 +64,10 @@ CanvasWrapperNode::CanvasWrapperNode(Canvas* const scene) :
     mMenu->setCurrentScene(scene);
 }
 
+void CanvasWrapperNode::sSkipData(eReadStream &src) {
+    CanvasWindow::sReadState(src);
+}
+
 void CanvasWrapperNode::readData(eReadStream &src) {
     mCanvasWindow->readState(src);
     mMenu->setCurrentScene(mCanvasWindow->getCurrentCanvas());
@@ -34,6 +34,8 @@ class CanvasWrapperNode : public WidgetWrapperNode {
 public:
     CanvasWrapperNode(Canvas * const scene);
 
+    //! @brief Reads past the data read by readData
+    static void sSkipData(eReadStream& src);
 protected:
     void readData(eReadStream& src);
     void writeData(eWriteStream& dst);
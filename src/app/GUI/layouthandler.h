@@ -64,6 +64,12 @@ struct LayoutData {
         fTimelineLayout->readData(src);
     }
 
+    static void sSkip(eReadStream& src) {
+        QString name; src >> name;
+        WrapperNode::sSkip(src, CanvasWrapperNode::sSkipData);
+        WrapperNode::sSkip(src, TimelineWrapperNode::sSkipData);
+    }
+
     void writeXEV(QDomElement& ele, QDomDocument& doc,
                   RuntimeIdToWriteId& objListIdConv) const {
         ele.setAttribute("name", fName);
@@ -140,6 +146,15 @@ public:
         setCurrent(absId);
     }
 
+    //! @brief Reads past the data read by read without creating widgets
+    static void sSkip(eReadStream& src) {
+        int nLays; src >> nLays;
+        for(int i = 0; i < nLays; i++) LayoutData::sSkip(src);
+        int nScenes; src >> nScenes;
+        for(int i = 0; i < nScenes; i++) LayoutData::sSkip(src);
+        int relCurrentId; src >> relCurrentId;
+    }
+
     void writeXEV(QDomElement& ele, QDomDocument& doc,
                   RuntimeIdToWriteId& objListIdConv) const {
         for(int i = mNumberLayouts - 1; i >= 0; i--) {
@@ -152,6 +152,7 @@ MainWindow::MainWindow(Document& document,
     , mAutoSave(false)
     , mAutoSaveTimeout(0)
     , mAutoSaveTimer(nullptr)
+    , mLastSaveSize(0)
     , mAboutWidget(nullptr)
     , mAboutWindow(nullptr)
     , mViewTimelineAct(nullptr)
@@ -385,6 +386,7 @@ MainWindow::~MainWindow()
     mShutdown = true;
     std::cout << "Closing Friction, please wait ... " << std::endl;
     if (mAutoSaveTimer->isActive()) { mAutoSaveTimer->stop(); }
+    waitForAsyncSave();
     writeSettings();
     sInstance = nullptr;
 }
@@ -1229,7 +1231,9 @@ void MainWindow::checkAutoSaveTimer()
                                                                     QString::number(projectVersion)));
             return;
         }
-        saveFile(mDocument.fEvFile);
+        // the previous auto save is still being written
+        if (mSaveThread.joinable()) { return; }
+        saveFile(mDocument.fEvFile, true, true);
     }
 }
 
@@ -1840,13 +1844,18 @@ void MainWindow::saveFile()
 }
 
 void MainWindow::saveFile(const QString& path,
-                          const bool setPath)
+                          const bool setPath,
+                          const bool async)
 {
     try {
         QFileInfo fi(path);
         const QString suffix = fi.suffix();
         if (suffix == "friction" || suffix == "ev") {
-            saveToFile(path);
+            if (async) {
+                // the backup is written by the same thread
+                saveToFileAsync(path, mBackupOnSave ? nextBackupPath() : QString());
+                addRecentFile(path);
+            } else { saveToFile(path); }
         } /*else if (suffix == "xev") {
             saveToFileXEV(path);
             const auto& inst = DialogsInterface::instance();
@@ -1855,7 +1864,7 @@ void MainWindow::saveFile(const QString& path,
         if (setPath) mDocument.setPath(path);
         setFileChangedSinceSaving(false);
         updateLastSaveDir(path);
-        if (mBackupOnSave) {
+        if (mBackupOnSave && !async) {
             qDebug() << "auto backup";
             saveBackup();
         }
@@ -1883,10 +1892,21 @@ void MainWindow::saveFileAs(const bool setPath)
 }
 
 void MainWindow::saveBackup()
+{
+    const QString backupPath = nextBackupPath();
+    if (backupPath.isEmpty()) { return; }
+    try {
+        saveToFile(backupPath, false);
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+    }
+}
+
+const QString MainWindow::nextBackupPath()
 {
     const QString defPath = mDocument.fEvFile;
     QFileInfo defInfo(defPath);
-    if (defPath.isEmpty() || defInfo.isDir())  { return; }
+    if (defPath.isEmpty() || defInfo.isDir())  { return QString(); }
     const QString backupPath = defPath + "_backup/backup_%1.friction";
     int id = 1;
     QFile backupFile(backupPath.arg(id));
@@ -1894,11 +1914,7 @@ void MainWindow::saveBackup()
         id++;
         backupFile.setFileName(backupPath.arg(id) );
     }
-    try {
-        saveToFile(backupPath.arg(id), false);
-    } catch(const std::exception& e) {
-        gPrintExceptionCritical(e);
-    }
+    return backupPath.arg(id);
 }
 
 const QString MainWindow::checkBeforeExportSVG()
@@ -39,6 +39,8 @@
 #include <QComboBox>
 #include <QTimer>
 
+#include <thread>
+
 #include "widgets/fontswidget.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/document.h"
@@ -93,6 +95,8 @@ public:
     FillStrokeSettingsWidget *getFillStrokeSettings();
     void saveToFile(const QString &path,
                     const bool addRecent = true);
+    void saveToFileAsync(const QString &path,
+                         const QString &backupPath = QString());
     void saveToFileXEV(const QString& path);
     void loadEVFile(const QString &path);
     void loadXevFile(const QString &path);
@@ -152,9 +156,11 @@ public:
     void openFile(const QString& openPath);
     void saveFile();
     void saveFile(const QString& path,
-                  const bool setPath = true);
+                  const bool setPath = true,
+                  const bool async = false);
     void saveFileAs(const bool setPath = true);
     void saveBackup();
+    const QString nextBackupPath();
     const QString checkBeforeExportSVG();
     void exportSVG(const bool &preview = false);
     void updateLastOpenDir(const QString &path);
@@ -378,6 +384,17 @@ private:
     QTimer *mAutoSaveTimer;
     void checkAutoSaveTimer();
 
+    QByteArray writeToBuffer(const QString &path);
+    static void sWriteProjectFile(const QString &path,
+                                  const QByteArray &data);
+    void waitForAsyncSave();
+    void asyncSaveFinished(const QString &path,
+                           const QString &error,
+                           const QString &backupError);
+
+    std::thread mSaveThread;
+    int mLastSaveSize;
+
     AboutWidget *mAboutWidget;
     Window *mAboutWindow;
     void openAboutWindow();
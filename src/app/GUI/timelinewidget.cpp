@@ -390,32 +390,40 @@ void TimelineWidget::writeState(eWriteStream &dst) const {
     dst.write(&rules.fTarget, sizeof(SWT_Target));
 }
 
+TimelineWidget::State TimelineWidget::sReadState(eReadStream &src) {
+    State state;
+    src >> state.fSceneReadId;
+    src >> state.fSceneDocumentId;
+
+    src >> state.fSearch;
+    src >> state.fSliderPos;
+
+    src >> state.fFrame;
+    src >> state.fViewedRange.fMin;
+    src >> state.fViewedRange.fMax;
+
+    state.fHasRules = src.evFileVersion() > 6;
+    if(state.fHasRules) {
+        src.read(&state.fBoxRule, sizeof(SWT_BoxRule));
+        src.read(&state.fType, sizeof(SWT_Type));
+        src.read(&state.fTarget, sizeof(SWT_Target));
+    }
+    return state;
+}
+
 void TimelineWidget::readState(eReadStream &src) {
     const int id = mBoxesListWidget->getId();
     src.objListIdConv().assign(id);
 
-    int sceneReadId; src >> sceneReadId;
-    int sceneDocumentId; src >> sceneDocumentId;
-
-    QString search; src >> search;
-    int sliderPos; src >> sliderPos;
-
-    int frame; src >> frame;
-    int minViewedFrame; src >> minViewedFrame;
-    int maxViewedFrame; src >> maxViewedFrame;
-
-    if(src.evFileVersion() > 6) {
-        SWT_BoxRule boxRule;
-        SWT_Type type;
-        SWT_Target target;
-        src.read(&boxRule, sizeof(SWT_BoxRule));
-        src.read(&type, sizeof(SWT_Type));
-        src.read(&target, sizeof(SWT_Target));
-        setBoxRule(boxRule);
-        setType(type);
-        setTarget(target);
+    const auto state = sReadState(src);
+    if(state.fHasRules) {
+        setBoxRule(state.fBoxRule);
+        setType(state.fType);
+        setTarget(state.fTarget);
     }
 
+    const int sceneReadId = state.fSceneReadId;
+    const int sceneDocumentId = state.fSceneDocumentId;
     src.addReadStreamDoneTask([this, sceneReadId, sceneDocumentId]
                               (eReadStream& src) {
         BoundingBox* sceneBox = nullptr;
@@ -427,13 +435,13 @@ void TimelineWidget::readState(eReadStream &src) {
         setCurrentScene(enve_cast<Canvas*>(sceneBox));
     });
 
-    mSearchLine->setText(search);
+    mSearchLine->setText(state.fSearch);
 
     //mBoxesListScrollArea->verticalScrollBar()->setSliderPosition(sliderPos);
     //mKeysView->setViewedVerticalRange(sliderPos, sliderPos + mBoxesListScrollArea->height());
 
-    mFrameScrollBar->setFirstViewedFrame(frame);
-    setViewedFrameRange({minViewedFrame, maxViewedFrame});
+    mFrameScrollBar->setFirstViewedFrame(state.fFrame);
+    setViewedFrameRange(state.fViewedRange);
 }
 
 void TimelineWidget::readStateXEV(XevReadBoxesHandler& boxReadHandler,
@@ -75,6 +75,22 @@ public:
     void setBoxesListWidth(const int width);
     void setGraphEnabled(const bool enabled);
 
+    struct State {
+        int fSceneReadId;
+        int fSceneDocumentId;
+        QString fSearch;
+        int fSliderPos;
+        int fFrame;
+        FrameRange fViewedRange;
+        bool fHasRules;
+        SWT_BoxRule fBoxRule;
+        SWT_Type fType;
+        SWT_Target fTarget;
+    };
+
+    //! @brief Reads the data written by writeState without a widget
+    static State sReadState(eReadStream& src);
+
     void writeState(eWriteStream& dst) const;
     void readState(eReadStream& src);
 
@@ -36,6 +36,10 @@ TimelineWrapperNode::TimelineWrapperNode(Canvas * const scene) :
     mTimelineWidget->setCurrentScene(scene);
 }
 
+void TimelineWrapperNode::sSkipData(eReadStream &src) {
+    TimelineWidget::sReadState(src);
+}
+
 void TimelineWrapperNode::readData(eReadStream &src) {
     mTimelineWidget->readState(src);
 }
@@ -32,6 +32,8 @@ class TimelineWrapperNode : public WidgetWrapperNode {
 public:
     TimelineWrapperNode(Canvas* const scene);
 
+    //! @brief Reads past the data read by readData
+    static void sSkipData(eReadStream& src);
 protected:
     void readData(eReadStream& src);
     void writeData(eWriteStream& dst);
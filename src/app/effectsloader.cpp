@@ -39,6 +39,7 @@
 #include "Boxes/ecustombox.h"
 #include "Boxes/customboxcreator.h"
 #include "appsupport.h"
+#include "hardwareinfo.h"
 
 EffectsLoader* EffectsLoader::sInstance = nullptr;
 
@@ -274,7 +275,9 @@ void EffectsLoader::reloadProgram(ShaderEffectCreator* const loaded,
 
 void EffectsLoader::iniShaderEffects()
 {
-    makeCurrent();
+    // without a GPU the effects load with their cpu shader only
+    const bool gpu = HardwareInfo::sGpuAvailable();
+    if (gpu) { makeCurrent(); }
 
     for (const auto &path : AppSupport::getFilesFromPath(AppSupport::getAppShaderPresetsPath(),
                                                          QStringList() << "*.gre")) {
@@ -332,7 +335,7 @@ void EffectsLoader::iniShaderEffects()
             }
         });
     });*/
-    doneCurrent();
+    if (gpu) { doneCurrent(); }
 }
 
 void EffectsLoader::iniSingleRasterEffectProgram(const QString &grePath)
@@ -372,7 +375,8 @@ void EffectsLoader::iniShaderEffectProgramExec(const QString &grePath)
     qDebug() << "Loading Shader" << shaderID.first << shaderID.second << grePath;
     try {
         // TODO: we should keep each creator in an list, replace shaderID
-        /*const auto loaded =*/ ShaderEffectCreator::sLoadFromFile(this, grePath).get();
+        /*const auto loaded =*/ ShaderEffectCreator::sLoadFromFile(
+                    HardwareInfo::sGpuAvailable() ? this : nullptr, grePath).get();
         mLoadedGREPaths << grePath;
         mLoadedShaders << shaderID;
     } catch(...) {
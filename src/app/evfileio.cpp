@@ -56,6 +56,8 @@
 #include "GUI/canvaswindow.h"
 #include "gradientwidgets/gradientwidget.h"
 #include <QMessageBox>
+#include <QBuffer>
+#include <QSaveFile>
 #include "PathEffects/patheffectsinclude.h"
 #include "Boxes/internallinkcanvas.h"
 #include "Boxes/smartvectorpath.h"
@@ -69,87 +71,38 @@
 #include "ReadWrite/ereadstream.h"
 #include "ReadWrite/ewritestream.h"
 #include "XML/runtimewriteid.h"
+#include "evfilereader.h"
 
 void MainWindow::loadEVFile(const QString &path)
 {
-    QFile file(path);
-    if (!file.exists()) { RuntimeThrow("File does not exist " + path); }
-    if (!file.open(QIODevice::ReadOnly)) {
-        RuntimeThrow("Could not open file " + path);
+    const int evVersion = EvFileReader::sRead(path, mDocument,
+                                              [this](eReadStream& src) {
+        mLayoutHandler->read(src);
+    }, [this](eReadStream& src) {
+        mRenderWidget->read(src);
+    });
+    if (evVersion > EvFormat::version) {
+        QMessageBox::warning(this,
+                             tr("Unsupported project version"),
+                             tr("This project file (version %1) is not compatible"
+                                " with this version of Friction,"
+                                " max supported project version is %2.").arg(QString::number(evVersion),
+                                                                             QString::number(EvFormat::version)));
+        return;
     }
-    try {
-        const int evVersion = FileFooter::sReadEvFileVersion(&file);
-        if (evVersion <= 0) { RuntimeThrow("Incompatible or incomplete data"); }
-
-        if (evVersion > EvFormat::version) {
-            QMessageBox::warning(this,
-                                 tr("Unsupported project version"),
-                                 tr("This project file (version %1) is not compatible"
-                                    " with this version of Friction,"
-                                    " max supported project version is %2.").arg(QString::number(evVersion),
-                                                                                 QString::number(EvFormat::version)));
-            file.close();
-            return;
-        }
-
-        eReadStream readStream(evVersion, &file);
-        readStream.setPath(path);
-
-        const qint64 savedPos = file.pos();
-        const qint64 pos = file.size() - FileFooter::sSize(evVersion) -
-                qint64(sizeof(int));
-        file.seek(pos);
-        readStream.readFutureTable();
-        file.seek(savedPos);
-        readStream.readCheckpoint("File beginning pos mismatch");
-        if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
-            int nScenes; readStream >> nScenes;
-            for(int i = 0; i < nScenes; i++) {
-                const bool beforeContent = (evVersion >= EvFormat::readSceneSettingsBeforeContent);
-                const auto scene = mDocument.createNewScene(!beforeContent);
-                if (beforeContent) {
-                    scene->readSettings(readStream);
-                    mDocument.sceneCreated(scene);
-                }
-            }
-            mLayoutHandler->read(readStream);
-            readStream.readCheckpoint("Error reading Layout");
-        }
-        mDocument.readScenes(readStream);
-        readStream.readCheckpoint("Error reading Document");
-        if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
-            //const auto renderWidget = mTimeline->getRenderWidget();
-            mRenderWidget->read(readStream);
-            readStream.readCheckpoint("Error reading Render Widget");
-        }
-    } catch(...) {
-        file.close();
-        RuntimeThrow("Error while reading from file " + path);
-    }
-    file.close();
     addRecentFile(path);
     mRenderWidget->updateRenderSettings();
 }
 
-void MainWindow::saveToFile(const QString &path,
-                            const bool addRecent)
+QByteArray MainWindow::writeToBuffer(const QString &path)
 {
-    QFile file(path);
-    if (file.exists()) { file.remove(); }
-
-    // check if folder exists first
-    QFileInfo info(path);
-    QDir dir = info.absoluteDir();
-    if (!dir.exists()) {
-        if (!dir.mkpath(dir.absolutePath())) {
-            RuntimeThrow(tr("Unable to create directory: %1").arg(dir.absolutePath()));
-        }
-    }
-
-    if (!file.open(QIODevice::WriteOnly)) {
-        RuntimeThrow("Could not open file for writing " + path + ".");
-    }
-    eWriteStream writeStream(&file);
+    // serializing to memory avoids a device write per value,
+    // the previous save size is a good guess for the capacity
+    QByteArray data;
+    data.reserve(mLastSaveSize);
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    eWriteStream writeStream(&buffer);
     writeStream.setPath(path);
     try {
         writeStream.writeCheckpoint();
@@ -169,15 +122,105 @@ void MainWindow::saveToFile(const QString &path,
         writeStream.writeFutureTable();
         FileFooter::sWrite(writeStream);
     } catch(...) {
-        file.close();
+        BoundingBox::sClearWriteBoxes();
         RuntimeThrow("Error while writing to file " + path);
     }
-    file.close();
-
+    buffer.close();
     BoundingBox::sClearWriteBoxes();
+    mLastSaveSize = data.size();
+    return data;
+}
+
+void MainWindow::sWriteProjectFile(const QString &path,
+                                   const QByteArray &data)
+{
+    // check if folder exists first
+    QFileInfo info(path);
+    QDir dir = info.absoluteDir();
+    if (!dir.exists()) {
+        if (!dir.mkpath(dir.absolutePath())) {
+            RuntimeThrow(tr("Unable to create directory: %1").arg(dir.absolutePath()));
+        }
+    }
+
+    // the old file is only replaced once the new one is complete
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        RuntimeThrow("Could not open file for writing " + path + ".");
+    }
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        RuntimeThrow("Error while writing to file " + path);
+    }
+    if (!file.commit()) {
+        RuntimeThrow("Could not replace file " + path + ".");
+    }
+}
+
+void MainWindow::saveToFile(const QString &path,
+                            const bool addRecent)
+{
+    waitForAsyncSave();
+    sWriteProjectFile(path, writeToBuffer(path));
     if (addRecent) { addRecentFile(path); }
 }
 
+void MainWindow::saveToFileAsync(const QString &path,
+                                 const QString &backupPath)
+{
+    waitForAsyncSave();
+    const QByteArray data = writeToBuffer(path);
+    // relative paths are written relative to the file they are saved in
+    QByteArray backupData;
+    QString backupError;
+    if (!backupPath.isEmpty()) {
+        try {
+            backupData = writeToBuffer(backupPath);
+        } catch(const std::exception& e) {
+            backupError = e.what();
+        }
+    }
+    mSaveThread = std::thread([this, path, backupPath, data,
+                               backupData, backupError]() {
+        QString error;
+        QString bError = backupError;
+        try {
+            sWriteProjectFile(path, data);
+        } catch(const std::exception& e) {
+            error = e.what();
+        }
+        if (!backupData.isEmpty()) {
+            try {
+                sWriteProjectFile(backupPath, backupData);
+            } catch(const std::exception& e) {
+                bError = e.what();
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, path, error, bError]() {
+            asyncSaveFinished(path, error, bError);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::waitForAsyncSave()
+{
+    if (mSaveThread.joinable()) { mSaveThread.join(); }
+}
+
+void MainWindow::asyncSaveFinished(const QString &path,
+                                   const QString &error,
+                                   const QString &backupError)
+{
+    waitForAsyncSave();
+    // a failed backup leaves the saved project unchanged
+    if (!backupError.isEmpty()) {
+        gPrintException(tr("Could not save backup: %1").arg(backupError));
+    }
+    if (error.isEmpty()) { return; }
+    if (path == mDocument.fEvFile) { setFileChangedSinceSaving(true); }
+    gPrintException(error);
+}
+
 #include "XML/xevzipfilesaver.h"
 
 void MainWindow::saveToFileXEV(const QString &path) {
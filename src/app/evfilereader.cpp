@@ -0,0 +1,87 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "evfilereader.h"
+#include "canvas.h"
+#include "Private/document.h"
+#include "ReadWrite/evformat.h"
+#include "ReadWrite/filefooter.h"
+#include "ReadWrite/ereadstream.h"
+
+#include <QFile>
+
+int EvFileReader::sRead(const QString &path,
+                        Document &document,
+                        const SectionReader &readLayout,
+                        const SectionReader &readRenderQueue)
+{
+    QFile file(path);
+    if (!file.exists()) { RuntimeThrow("File does not exist " + path); }
+    if (!file.open(QIODevice::ReadOnly)) {
+        RuntimeThrow("Could not open file " + path);
+    }
+    int evVersion = 0;
+    try {
+        evVersion = FileFooter::sReadEvFileVersion(&file);
+        if (evVersion <= 0) { RuntimeThrow("Incompatible or incomplete data"); }
+        if (evVersion > EvFormat::version) {
+            file.close();
+            return evVersion;
+        }
+
+        eReadStream readStream(evVersion, &file);
+        readStream.setPath(path);
+
+        const qint64 savedPos = file.pos();
+        const qint64 pos = file.size() - FileFooter::sSize(evVersion) -
+                qint64(sizeof(int));
+        file.seek(pos);
+        readStream.readFutureTable();
+        file.seek(savedPos);
+        readStream.readCheckpoint("File beginning pos mismatch");
+        if (evVersion >= EvFormat::betterSWTAbsReadWrite) {
+            int nScenes; readStream >> nScenes;
+            for (int i = 0; i < nScenes; i++) {
+                const bool beforeContent = (evVersion >= EvFormat::readSceneSettingsBeforeContent);
+                const auto scene = document.createNewScene(!beforeContent);
+                if (beforeContent) {
+                    scene->readSettings(readStream);
+                    document.sceneCreated(scene);
+                }
+            }
+            readLayout(readStream);
+            readStream.readCheckpoint("Error reading Layout");
+        }
+        document.readScenes(readStream);
+        readStream.readCheckpoint("Error reading Document");
+        if (evVersion >= EvFormat::betterSWTAbsReadWrite) {
+            readRenderQueue(readStream);
+            readStream.readCheckpoint("Error reading Render Widget");
+        }
+    } catch(...) {
+        file.close();
+        RuntimeThrow("Error while reading from file " + path);
+    }
+    file.close();
+    return evVersion;
+}
@@ -0,0 +1,49 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef EVFILEREADER_H
+#define EVFILEREADER_H
+
+#include <QString>
+
+#include <functional>
+
+class Document;
+class eReadStream;
+
+//! @brief Reads .friction/.ev project files, shared by MainWindow and
+//! HeadlessRenderer. Layout and render queue data is passed to the caller.
+class EvFileReader
+{
+public:
+    using SectionReader = std::function<void(eReadStream&)>;
+
+    //! @brief Returns the file version, nothing is read into document
+    //! if it is newer than EvFormat::version. Throws on read errors.
+    static int sRead(const QString &path,
+                     Document &document,
+                     const SectionReader &readLayout,
+                     const SectionReader &readRenderQueue);
+};
+
+#endif // EVFILEREADER_H
@@ -0,0 +1,391 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "headlessrenderer.h"
+#include "renderhandler.h"
+#include "videoencoder.h"
+#include "canvas.h"
+#include "appsupport.h"
+#include "hardwareinfo.h"
+#include "evfilereader.h"
+#include "Private/document.h"
+#include "Sound/esoundsettings.h"
+#include "ReadWrite/evformat.h"
+#include "RasterEffects/rastereffect.h"
+#include "Properties/boxtargetproperty.h"
+#include "GUI/layouthandler.h"
+#include "GUI/RenderWidgets/renderwidget.h"
+#include "GUI/RenderWidgets/renderinstancewidget.h"
+
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QDir>
+
+#include <iostream>
+
+HeadlessRenderer::HeadlessRenderer(Document &document,
+                                   RenderHandler &renderHandler,
+                                   VideoEncoder &videoEncoder) :
+    mDocument(document),
+    mRenderHandler(renderHandler),
+    mVideoEncoder(videoEncoder)
+{
+    const auto emitter = mVideoEncoder.getEmitter();
+    connect(emitter, &VideoEncoderEmitter::encodingFinished,
+            this, [this]() { finish(0); });
+    connect(emitter, &VideoEncoderEmitter::encodingInterrupted,
+            this, [this]() { finish(1); });
+    connect(emitter, &VideoEncoderEmitter::encodingFailed,
+            this, [this]() { finish(1); });
+    connect(emitter, &VideoEncoderEmitter::encodingStartFailed,
+            this, [this]() { finish(1); });
+}
+
+// shader effects without a cpu program can only run on the gpu,
+// RasterEffectCollection::addEffects skips them for the preview
+static void findGpuOnlyEffects(BoundingBox * const box,
+                               QSet<BoundingBox*> &visited,
+                               QStringList &effects)
+{
+    if (!box || visited.contains(box)) { return; }
+    visited << box;
+    QList<BoundingBox*> targets;
+    box->ca_execOnDescendants([&](Property * const prop) {
+        if (const auto target = enve_cast<BoxTargetProperty*>(prop)) {
+            targets << target->getTarget();
+        } else if (const auto effect = enve_cast<RasterEffect*>(prop)) {
+            if (!effect->isVisible()) { return; }
+            if (effect->instanceHwSupport() != HardwareSupport::gpuOnly) { return; }
+            const QString name = effect->prp_getName();
+            if (!effects.contains(name)) { effects << name; }
+        }
+    });
+    for (const auto target : targets) {
+        findGpuOnlyEffects(target, visited, effects);
+    }
+}
+
+static OutputSettings defaultOutputSettings(const QString &path)
+{
+    OutputSettings settings;
+    const QByteArray pathData = path.toUtf8();
+    settings.fOutputFormat = av_guess_format(nullptr, pathData.constData(), nullptr);
+    if (!settings.fOutputFormat) {
+        RuntimeThrow("Could not guess output format from " + path);
+    }
+    settings.fVideoCodec = avcodec_find_encoder(settings.fOutputFormat->video_codec);
+    if (settings.fVideoCodec) {
+        settings.fVideoEnabled = true;
+        settings.fVideoPixelFormat = settings.fVideoCodec->pix_fmts ?
+                                     settings.fVideoCodec->pix_fmts[0] :
+                                     AV_PIX_FMT_YUV420P;
+    }
+    settings.fAudioCodec = avcodec_find_encoder(settings.fOutputFormat->audio_codec);
+    if (settings.fAudioCodec) {
+        settings.fAudioEnabled = true;
+        settings.fAudioSampleFormat = settings.fAudioCodec->sample_fmts ?
+                                      settings.fAudioCodec->sample_fmts[0] :
+                                      AV_SAMPLE_FMT_FLTP;
+        settings.fAudioChannelsLayout = AV_CH_LAYOUT_STEREO;
+        settings.fAudioSampleRate = eSoundSettings::sSampleRate();
+        settings.fAudioBitrate = 192000;
+    }
+    if (!settings.fVideoEnabled && !settings.fAudioEnabled) {
+        RuntimeThrow("No encoder available for " + path);
+    }
+    return settings;
+}
+
+int HeadlessRenderer::exec(const QStringList &args)
+{
+    QCommandLineParser parser;
+    const QCommandLineOption rendererOpt("renderer");
+    const QCommandLineOption sceneOpt("scene", QString(), "scene");
+    const QCommandLineOption startOpt("start", QString(), "frame");
+    const QCommandLineOption endOpt("end", QString(), "frame");
+    const QCommandLineOption widthOpt("width", QString(), "pixels");
+    const QCommandLineOption heightOpt("height", QString(), "pixels");
+    const QCommandLineOption resolutionOpt("resolution", QString(), "percent");
+    const QCommandLineOption profileOpt("profile", QString(), "profile");
+    const QCommandLineOption outputOpt("output", QString(), "file");
+    parser.addOptions({rendererOpt, sceneOpt, startOpt, endOpt,
+                       widthOpt, heightOpt, resolutionOpt,
+                       profileOpt, outputOpt});
+    parser.addPositionalArgument("project", QString());
+
+    if (!parser.parse(args)) {
+        qCritical().noquote() << parser.errorText();
+        AppSupport::printHelp(true);
+        return 2;
+    }
+    if (parser.positionalArguments().count() != 1) {
+        AppSupport::printHelp(true);
+        return 2;
+    }
+
+    const auto intValue = [&parser](const QCommandLineOption &opt,
+                                    int &value) {
+        if (!parser.isSet(opt)) { return true; }
+        bool ok;
+        value = parser.value(opt).toInt(&ok);
+        if (!ok) {
+            qCritical().noquote() << QString("Invalid value for --%1: %2").arg(opt.names().first(),
+                                                                              parser.value(opt));
+        }
+        return ok;
+    };
+
+    int start = 0;
+    int end = 0;
+    int width = 0;
+    int height = 0;
+    int resolution = 0;
+    if (!intValue(startOpt, start) || !intValue(endOpt, end) ||
+        !intValue(widthOpt, width) || !intValue(heightOpt, height) ||
+        !intValue(resolutionOpt, resolution)) { return 2; }
+    if (width < 0 || height < 0 || resolution < 0) {
+        qCritical() << "Output size must be positive";
+        return 2;
+    }
+
+    const QString projectPath = QFileInfo(parser.positionalArguments().first()).absoluteFilePath();
+    try {
+        loadProject(projectPath);
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+        return 1;
+    }
+
+    Canvas *scene = nullptr;
+    if (parser.isSet(sceneOpt)) {
+        scene = findScene(parser.value(sceneOpt));
+    } else {
+        for (const auto &queued : mQueue) {
+            if (!queued.fChecked) { continue; }
+            scene = queued.fSettings->getTargetCanvas();
+            if (scene) { break; }
+        }
+        if (!scene && !mDocument.fScenes.isEmpty()) {
+            scene = mDocument.fScenes.first().get();
+        }
+    }
+    if (!scene) {
+        qCritical() << "No scene to render";
+        return 1;
+    }
+    if (!HardwareInfo::sGpuAvailable()) {
+        QSet<BoundingBox*> visited;
+        QStringList gpuOnly;
+        findGpuOnlyEffects(scene, visited, gpuOnly);
+        if (!gpuOnly.isEmpty()) {
+            qCritical().noquote() << "No GPU available for effects:"
+                                  << gpuOnly.join(", ");
+            return 1;
+        }
+    }
+
+    // the render queue saved with the project provides the defaults
+    RenderInstanceSettings settings(scene);
+    bool hasOutputSettings = false;
+    if (const auto queued = findQueued(scene)) {
+        settings.setRenderSettings(queued->getRenderSettings());
+        settings.setOutputRenderSettings(queued->getOutputRenderSettings());
+        settings.setOutputSettingsProfile(queued->getOutputSettingsProfile());
+        settings.setOutputDestination(queued->getOutputDestination());
+        hasOutputSettings = true;
+    }
+
+    if (parser.isSet(profileOpt)) {
+        const QString profileName = parser.value(profileOpt);
+        OutputSettingsProfile *profile = nullptr;
+        try {
+            if (QFileInfo(profileName).isFile()) {
+                mProfile = enve::make_shared<OutputSettingsProfile>();
+                mProfile->load(profileName);
+                profile = mProfile.get();
+            } else {
+                OutputSettingsProfile::sLoadOutputProfiles();
+                profile = OutputSettingsProfile::sGetByName(profileName);
+            }
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+            return 1;
+        }
+        if (!profile) {
+            qCritical().noquote() << "Unknown output profile" << profileName;
+            return 1;
+        }
+        settings.setOutputSettingsProfile(profile);
+        settings.setOutputRenderSettings(profile->getSettings());
+        hasOutputSettings = true;
+    }
+
+    if (parser.isSet(outputOpt)) {
+        settings.setOutputDestination(QFileInfo(parser.value(outputOpt)).absoluteFilePath());
+    }
+    const QString output = settings.getOutputDestination();
+    if (output.isEmpty()) {
+        qCritical() << "No output file, use --output";
+        return 2;
+    }
+    const QDir outputDir = QFileInfo(output).absoluteDir();
+    if (!outputDir.exists() && !outputDir.mkpath(outputDir.absolutePath())) {
+        qCritical().noquote() << "Unable to create directory" << outputDir.absolutePath();
+        return 1;
+    }
+
+    if (!hasOutputSettings) {
+        try {
+            settings.setOutputRenderSettings(defaultOutputSettings(output));
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+            return 1;
+        }
+    }
+
+    RenderSettings renderSettings = settings.getRenderSettings();
+    renderSettings.fBaseWidth = scene->getCanvasWidth();
+    renderSettings.fBaseHeight = scene->getCanvasHeight();
+    renderSettings.fBaseFps = scene->getFps();
+    renderSettings.fFps = renderSettings.fBaseFps;
+    if (parser.isSet(startOpt)) { renderSettings.fMinFrame = start; }
+    if (parser.isSet(endOpt)) { renderSettings.fMaxFrame = end; }
+    if (renderSettings.fMinFrame > renderSettings.fMaxFrame) {
+        qCritical() << "Invalid frame range" << renderSettings.fMinFrame
+                    << "-" << renderSettings.fMaxFrame;
+        return 2;
+    }
+
+    if (width > 0 || height > 0) {
+        // a single dimension keeps the scene aspect ratio, as in RenderSettingsDialog
+        renderSettings.fResolution = width > 0 ?
+                    qreal(width)/renderSettings.fBaseWidth :
+                    qreal(height)/renderSettings.fBaseHeight;
+    } else if (resolution > 0) {
+        renderSettings.fResolution = resolution/100.;
+    }
+    renderSettings.fVideoWidth = width > 0 ? width :
+                                 qRound(renderSettings.fBaseWidth*
+                                        renderSettings.fResolution);
+    renderSettings.fVideoHeight = height > 0 ? height :
+                                  qRound(renderSettings.fBaseHeight*
+                                         renderSettings.fResolution);
+    settings.setRenderSettings(renderSettings);
+
+    std::cout << QString("Rendering '%1' frames %2-%3 at %4x%5 to %6").arg(
+                     scene->prp_getName(),
+                     QString::number(renderSettings.fMinFrame),
+                     QString::number(renderSettings.fMaxFrame),
+                     QString::number(renderSettings.fVideoWidth),
+                     QString::number(renderSettings.fVideoHeight),
+                     output).toStdString() << std::endl;
+    connect(&settings, &RenderInstanceSettings::renderFrameChanged,
+            this, [renderSettings](const int frame) {
+        std::cout << QString("Frame %1/%2").arg(QString::number(frame),
+                                                QString::number(renderSettings.fMaxFrame)).toStdString() << std::endl;
+    });
+
+    mDocument.addVisibleScene(scene);
+    mDocument.setActiveScene(scene);
+    mRenderHandler.renderFromSettings(&settings);
+    if (!mFinished) { mLoop.exec(); }
+
+    if (mStatus == 0) {
+        const auto &stats = mVideoEncoder.getStats();
+        if (stats.fFrames > 0) {
+            const auto perFrame = [&stats](const qint64 us) {
+                return QString::number(us/1000./stats.fFrames, 'f', 2);
+            };
+            std::cout << QString("Encoded %1 frames in %2 s, %3 ms/frame "
+                                 "(conversion %4 ms, encoding %5 ms)").arg(
+                             QString::number(stats.fFrames),
+                             QString::number(stats.fTotalUs/1000000., 'f', 2),
+                             perFrame(stats.fTotalUs),
+                             perFrame(stats.fConversionUs),
+                             perFrame(stats.fEncodingUs)).toStdString() << std::endl;
+        }
+        std::cout << "Done" << std::endl;
+    } else if (!settings.getRenderError().isEmpty()) {
+        qCritical().noquote() << settings.getRenderError();
+    }
+    mDocument.removeVisibleScene(scene);
+    return mStatus;
+}
+
+void HeadlessRenderer::loadProject(const QString &path)
+{
+    const QString suffix = QFileInfo(path).suffix();
+    if (suffix != "friction" && suffix != "ev") {
+        RuntimeThrow("Unrecognized file extension " + suffix);
+    }
+    // layout data only matters to widgets
+    const int evVersion = EvFileReader::sRead(path, mDocument,
+                                              LayoutHandler::sSkip,
+                                              [this](eReadStream &src) {
+        RenderWidget::sRead(src, [this](eReadStream &src) {
+            const auto settings = new RenderInstanceSettings(nullptr);
+            settings->setParent(this);
+            const bool checked = RenderInstanceWidget::sReadSettings(src, *settings);
+            mQueue << QueuedRender{settings, checked};
+        });
+    });
+    if (evVersion > EvFormat::version) {
+        RuntimeThrow(QString("This project file (version %1) is not compatible"
+                             " with this version of Friction,"
+                             " max supported project version is %2.").arg(QString::number(evVersion),
+                                                                          QString::number(EvFormat::version)));
+    }
+    mDocument.setPath(path);
+}
+
+Canvas *HeadlessRenderer::findScene(const QString &scene) const
+{
+    for (const auto &canvas : mDocument.fScenes) {
+        if (canvas->prp_getName() == scene) { return canvas.get(); }
+    }
+    bool isIndex;
+    const int index = scene.toInt(&isIndex);
+    if (isIndex && index >= 0 && index < mDocument.fScenes.count()) {
+        return mDocument.fScenes.at(index).get();
+    }
+    qCritical().noquote() << "Scene not found" << scene;
+    return nullptr;
+}
+
+RenderInstanceSettings *HeadlessRenderer::findQueued(Canvas * const scene) const
+{
+    RenderInstanceSettings *result = nullptr;
+    for (const auto &queued : mQueue) {
+        if (queued.fSettings->getTargetCanvas() != scene) { continue; }
+        if (queued.fChecked) { return queued.fSettings; }
+        if (!result) { result = queued.fSettings; }
+    }
+    return result;
+}
+
+void HeadlessRenderer::finish(const int status)
+{
+    mFinished = true;
+    mStatus = status;
+    mLoop.quit();
+}
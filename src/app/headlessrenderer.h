@@ -0,0 +1,73 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef HEADLESSRENDERER_H
+#define HEADLESSRENDERER_H
+
+#include <QObject>
+#include <QEventLoop>
+#include <QStringList>
+
+#include "renderinstancesettings.h"
+
+class Canvas;
+class Document;
+class RenderHandler;
+class VideoEncoder;
+
+//! @brief Renders a project to file without a GUI (--renderer),
+//! exec() returns the process exit status.
+class HeadlessRenderer : public QObject
+{
+    Q_OBJECT
+public:
+    HeadlessRenderer(Document &document,
+                     RenderHandler &renderHandler,
+                     VideoEncoder &videoEncoder);
+
+    int exec(const QStringList &args);
+
+private:
+    struct QueuedRender {
+        RenderInstanceSettings *fSettings;
+        bool fChecked;
+    };
+
+    void loadProject(const QString &path);
+    Canvas *findScene(const QString &scene) const;
+    RenderInstanceSettings *findQueued(Canvas * const scene) const;
+    void finish(const int status);
+
+    Document &mDocument;
+    RenderHandler &mRenderHandler;
+    VideoEncoder &mVideoEncoder;
+
+    QList<QueuedRender> mQueue;
+    qsptr<OutputSettingsProfile> mProfile;
+
+    QEventLoop mLoop;
+    bool mFinished = false;
+    int mStatus = 1;
+};
+
+#endif // HEADLESSRENDERER_H
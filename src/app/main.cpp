@@ -20,6 +20,7 @@
 */
 
 #include "GUI/mainwindow.h"
+#include "headlessrenderer.h"
 
 #include <iostream>
 #include <QApplication>
@@ -87,14 +88,18 @@ void generateAlphaMesh(QPixmap& alphaMesh,
 
 int main(int argc, char *argv[])
 {
-    // check if cli renderer (not supported yet)
-    const bool isRenderer = false; // AppSupport::hasArg(argc, argv, "--renderer");
+    // check if cli renderer
+    const bool isRenderer = AppSupport::hasArg(argc, argv, "--renderer");
 
     // init env variables
     AppSupport::initEnv(isRenderer);
 
     // version info
     AppSupport::printVersion();
+    if (AppSupport::hasArg(argc, argv, "--help")) {
+        AppSupport::printHelp(isRenderer);
+        return 0;
+    }
 
     // init app
     QApplication::setApplicationDisplayName(AppSupport::getAppDisplayName());
@@ -123,19 +128,20 @@ int main(int argc, char *argv[])
 #endif
 
     // init splash
-    bool showSplash = true;
+    bool showSplash = !isRenderer;
 #ifdef Q_OS_LINUX
     if (AppSupport::isWayland()) {
         QGuiApplication::setDesktopFileName(AppSupport::getAppID());
         showSplash = false;
     }
 #endif
-    QSplashScreen splash(QPixmap(":/icons/splash/splash-00001.png"));
+    std::unique_ptr<QSplashScreen> splash;
     if (showSplash) {
-        splash.show();
-        splash.raise();
-        splash.showMessage(QObject::tr("Loading ..."),
-                           Qt::AlignRight | Qt::AlignBottom, Qt::white);
+        splash.reset(new QSplashScreen(QPixmap(":/icons/splash/splash-00001.png")));
+        splash->show();
+        splash->raise();
+        splash->showMessage(QObject::tr("Loading ..."),
+                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
     }
 
     // init hardware
@@ -145,25 +151,29 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    // the renderer logs errors instead of showing dialogs
+    if (isRenderer) { gSetExceptionDialogs(false); }
+
 #ifndef Q_OS_DARWIN
-    const bool threadedOpenGL = QOpenGLContext::supportsThreadedOpenGL();
-    if (!threadedOpenGL) {
+    if (!isRenderer && !QOpenGLContext::supportsThreadedOpenGL()) {
         gPrintException("Your GPU drivers do not support OpenGL "
                         "rendering outside the main thread");
     }
 #endif
 
     try {
-        HardwareInfo::sUpdateInfo();
+        HardwareInfo::sUpdateInfo(!isRenderer);
     } catch(const std::exception& e) {
         GPU_NOT_COMPATIBLE;
         gPrintExceptionCritical(e);
     }
 
-    std::cout << "OpenGL Vendor: " << HardwareInfo::sGpuVendorString().toStdString() << std::endl
-              << "OpenGL Renderer: " << HardwareInfo::sGpuRendererString().toStdString() << std::endl
-              << "OpenGL Version: " << HardwareInfo::sGpuVersionString().toStdString() << std::endl
-              << "---" << std::endl;
+    if (HardwareInfo::sGpuAvailable()) {
+        std::cout << "OpenGL Vendor: " << HardwareInfo::sGpuVendorString().toStdString() << std::endl
+                  << "OpenGL Renderer: " << HardwareInfo::sGpuRendererString().toStdString() << std::endl
+                  << "OpenGL Version: " << HardwareInfo::sGpuVersionString().toStdString() << std::endl
+                  << "---" << std::endl;
+    }
 
     // init settings
     eSettings settings(HardwareInfo::sCpuThreads(),
@@ -216,7 +226,7 @@ int main(int argc, char *argv[])
     AppSupport::checkPerms(isRenderer);
 
     // portable
-    AppSupport::handlePortableFirstRun();
+    if (!isRenderer) { AppSupport::handlePortableFirstRun(); }
 
     // check XDG integration
 #ifdef Q_OS_LINUX
@@ -224,10 +234,10 @@ int main(int argc, char *argv[])
 #endif
 
     if (showSplash) {
-        splash.raise();
-        splash.setPixmap(QPixmap(":/icons/splash/splash-00002.png"));
-        splash.showMessage(QObject::tr("Initializing ..."),
-                           Qt::AlignRight | Qt::AlignBottom, Qt::white);
+        splash->raise();
+        splash->setPixmap(QPixmap(":/icons/splash/splash-00002.png"));
+        splash->showMessage(QObject::tr("Initializing ..."),
+                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
     }
 
     // load settings
@@ -250,12 +260,14 @@ int main(int argc, char *argv[])
     Actions actions(document);
 
     EffectsLoader effectsLoader;
-    try {
-        effectsLoader.initializeGpu();
-        taskScheduler.initializeGpu();
-    } catch(const std::exception& e) {
-        GPU_NOT_COMPATIBLE;
-        gPrintExceptionFatal(e);
+    if (!isRenderer) {
+        try {
+            effectsLoader.initializeGpu();
+            taskScheduler.initializeGpu();
+        } catch(const std::exception& e) {
+            GPU_NOT_COMPATIBLE;
+            gPrintExceptionFatal(e);
+        }
     }
 
     // disabled for now
@@ -268,16 +280,17 @@ int main(int argc, char *argv[])
 
     // init shaders
     if (showSplash) {
-        splash.raise();
-        splash.setPixmap(QPixmap(":/icons/splash/splash-00003.png"));
-        splash.showMessage(QObject::tr("Loading Shaders ..."),
-                           Qt::AlignRight | Qt::AlignBottom, Qt::white);
+        splash->raise();
+        splash->setPixmap(QPixmap(":/icons/splash/splash-00003.png"));
+        splash->showMessage(QObject::tr("Loading Shaders ..."),
+                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
     }
 
+    // the renderer has no gpu and loads the cpu shaders only
     try {
         effectsLoader.iniShaderEffects();
     } catch(const std::exception& e) {
-        GPU_NOT_COMPATIBLE;
+        if (!isRenderer) { GPU_NOT_COMPATIBLE; }
         gPrintExceptionCritical(e);
     }
     QObject::connect(&effectsLoader, &EffectsLoader::programChanged,
@@ -294,10 +307,10 @@ int main(int argc, char *argv[])
 
     // init audio
     if (showSplash) {
-        splash.raise();
-        splash.setPixmap(QPixmap(":/icons/splash/splash-00004.png"));
-        splash.showMessage(QObject::tr("Loading Audio ..."),
-                           Qt::AlignRight | Qt::AlignBottom, Qt::white);
+        splash->raise();
+        splash->setPixmap(QPixmap(":/icons/splash/splash-00004.png"));
+        splash->showMessage(QObject::tr("Loading Audio ..."),
+                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
     }
 
     eSoundSettings soundSettings;
@@ -315,10 +328,10 @@ int main(int argc, char *argv[])
 
     // init encoder
     if (showSplash) {
-        splash.raise();
-        splash.setPixmap(QPixmap(":/icons/splash/splash-00005.png"));
-        splash.showMessage(QObject::tr("Loading Encoder ..."),
-                           Qt::AlignRight | Qt::AlignBottom, Qt::white);
+        splash->raise();
+        splash->setPixmap(QPixmap(":/icons/splash/splash-00005.png"));
+        splash->showMessage(QObject::tr("Loading Encoder ..."),
+                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
     }
     const auto videoEncoder = enve::make_shared<VideoEncoder>();
     RenderHandler renderHandler(document, audioHandler,
@@ -327,11 +340,21 @@ int main(int argc, char *argv[])
     // check for ffmpeg version
     AppSupport::checkFFmpeg(isRenderer);
 
+    if (isRenderer) {
+        HeadlessRenderer renderer(document, renderHandler, *videoEncoder);
+        try {
+            return renderer.exec(QApplication::arguments());
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+            return 1;
+        }
+    }
+
     if (showSplash) {
-        splash.raise();
-        splash.setPixmap(QPixmap(":/icons/splash/splash-00006.png"));
-        splash.showMessage(QObject::tr("Loading User Interface ..."),
-                           Qt::AlignRight | Qt::AlignBottom, Qt::white);
+        splash->raise();
+        splash->setPixmap(QPixmap(":/icons/splash/splash-00006.png"));
+        splash->showMessage(QObject::tr("Loading User Interface ..."),
+                            Qt::AlignRight | Qt::AlignBottom, Qt::white);
     }
 
     // load UI
@@ -342,7 +365,7 @@ int main(int argc, char *argv[])
                  renderHandler,
                  openProject);
     w.show();
-    splash.finish(&w);
+    if (splash) { splash->finish(&w); }
 
     try {
         return app.exec();
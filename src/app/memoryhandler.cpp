@@ -26,6 +26,8 @@
 #include "memoryhandler.h"
 #include "Boxes/boxrendercontainer.h"
 #include "GUI/mainwindow.h"
+#include "skia/pixelbufferpool.h"
+#include "CacheHandlers/diskcache.h"
 #include <QMetaType>
 
 #ifdef Q_OS_MAC
@@ -96,12 +98,17 @@ void MemoryHandler::freeMemory(const MemoryState newState,
         mMemoryState = newState;
     }
 
+    // saving evicted data to disk would hold it in memory for longer
+    DiskCache::sSetSuspended(mMemoryState == CRITICAL_MEMORY_STATE);
     if(minFreeBytes.fValue <= 0) return;
     qint64 memToFree = minFreeBytes.fValue;
+    // recycled raster buffers hold no data, they go first
+    memToFree -= PixelBufferPool::trim(memToFree);
     while(memToFree > 0 && !mDataHandler.isEmpty()) {
-        const auto cont = mDataHandler.takeFirst();
-        memToFree -= cont->free_RAM_k();
+        memToFree -= mDataHandler.freeFirst();
     }
+    // freed containers return their pixels to the pool
+    PixelBufferPool::trim(std::numeric_limits<qint64>::max());
     if(newState == CRITICAL_MEMORY_STATE ||
        memToFree > 0) {
         mMemoryState = CRITICAL_MEMORY_STATE;
@@ -54,8 +54,10 @@ RenderHandler::RenderHandler(Document &document,
             this, &RenderHandler::nextPreviewFrame);
     connect(mPreviewFPSTimer, &QTimer::timeout,
             this, &RenderHandler::audioPushTimerExpired);
-    connect(audioHandler.audioOutput(), &QAudioOutput::notify,
-            this, &RenderHandler::audioPushTimerExpired);
+    if (audioHandler.audioOutput()) {
+        connect(audioHandler.audioOutput(), &QAudioOutput::notify,
+                this, &RenderHandler::audioPushTimerExpired);
+    }
 
     const auto vidEmitter = videoEncoder.getEmitter();
 //    connect(vidEmitter, &VideoEncoderEmitter::encodingStarted,
@@ -85,6 +87,7 @@ void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings)
         mMaxRenderFrame = renderSettings.fMaxFrame;
         const qreal fps = mCurrentScene->getFps();
         mMaxSoundSec = qFloor(mMaxRenderFrame/fps);
+        mCurrentScene->prefetchExpressions({mMinRenderFrame, mMaxRenderFrame});
 
         const auto nextFrameFunc = [this]() {
             nextSaveOutputFrame();
@@ -107,6 +110,7 @@ void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings)
         mCurrentScene->anim_setAbsFrame(mCurrentRenderFrame);
         mCurrentScene->setOutputRendering(true);
         TaskScheduler::instance()->setAlwaysQue(true);
+        TaskScheduler::instance()->setFocusFrame(mCurrentEncodeFrame);
         //fitSceneToSize();
         if(!isZero6Dec(mSavedResolutionFraction - resolutionFraction)) {
             mCurrentScene->setResolution(resolutionFraction);
@@ -186,6 +190,8 @@ void RenderHandler::renderPreview() {
 
     mCurrentRenderFrame = mMinRenderFrame;
     mCurrRenderRange = {mCurrentRenderFrame, mCurrentRenderFrame};
+    mCurrentScene->prefetchExpressions({mMinRenderFrame, mMaxRenderFrame});
+    TaskScheduler::instance()->setFocusFrame(mCurrentRenderFrame);
     mCurrentScene->setMinFrameUseRange(mCurrentRenderFrame);
     mCurrentSoundComposition->setMinFrameUseRange(mCurrentRenderFrame);
 
@@ -222,18 +228,26 @@ void RenderHandler::setPreviewing(const bool previewing) {
 
 void RenderHandler::interruptPreviewRendering() {
     TaskScheduler::sClearAllFinishedFuncs();
+    // look-ahead frames are kept, but the restored frame goes first
+    const auto scheduler = TaskScheduler::instance();
+    scheduler->setFocusFrame(mSavedCurrentFrame);
+    scheduler->demoteFramesOutside({mSavedCurrentFrame, mSavedCurrentFrame});
     stopPreview();
 }
 
 void RenderHandler::interruptOutputRendering() {
     if(mCurrentScene) mCurrentScene->setOutputRendering(false);
-    TaskScheduler::instance()->setAlwaysQue(false);
+    const auto scheduler = TaskScheduler::instance();
+    scheduler->setAlwaysQue(false);
     TaskScheduler::sClearAllFinishedFuncs();
+    scheduler->setFocusFrame(mSavedCurrentFrame);
+    scheduler->cancelFramesOutside({mSavedCurrentFrame, mSavedCurrentFrame});
     stopPreview();
 }
 
 void RenderHandler::stopPreview() {
     if(mCurrentScene) {
+        mCurrentScene->prefetchExpressions({0, -1});
         mCurrentScene->clearUseRange();
         setFrameAction(mSavedCurrentFrame);
         mCurrentScene->setSceneFrame(mSavedCurrentFrame);
@@ -338,6 +352,7 @@ void RenderHandler::finishEncoding() {
     TaskScheduler::sClearAllFinishedFuncs();
     mCurrentRenderSettings = nullptr;
     mCurrentScene->setOutputRendering(false);
+    mCurrentScene->prefetchExpressions({0, -1});
     TaskScheduler::instance()->setAlwaysQue(false);
     setFrameAction(mSavedCurrentFrame);
     if(!isZero4Dec(mSavedResolutionFraction - mCurrentScene->getResolution())) {
@@ -376,6 +391,8 @@ void RenderHandler::nextSaveOutputFrame() {
         VideoEncoder::sAddCacheContainerToEncoder(cont->ref<SceneFrameContainer>());
         mCurrentEncodeFrame = cont->getRangeMax() + 1;
     }
+    // the encoder waits for the oldest missing frame
+    TaskScheduler::instance()->setFocusFrame(mCurrentEncodeFrame);
 
     //mCurrentScene->renderCurrentFrameToOutput(*mCurrentRenderSettings);
     if(mCurrentRenderFrame >= mMaxRenderFrame) {
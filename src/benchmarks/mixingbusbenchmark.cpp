@@ -0,0 +1,175 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+// Mixes a second of sound layers the way SoundMerger did before, through
+// the per sample mergeInterleavedData templates, and through MixingBus,
+// with a static and an animated volume.
+// Usage: mixingbusbenchmark [layers] [sample rate] [repeats]
+
+#include "Sound/mixingbus.h"
+#include "Animators/qrealsnapshot.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    // previous soundmerger.cpp templates for interleaved formats
+    template <typename T>
+    void mergeInterleavedDataSigned(const T* const src, T * const dst,
+                                    const int nSamples,
+                                    QrealSnapshot::Iterator volIt,
+                                    const int nChannels) {
+        int dstId = 0;
+        int srcId = 0;
+        const qreal min = (qreal)std::numeric_limits<T>::min();
+        const qreal max = (qreal)std::numeric_limits<T>::max();
+        if(volIt.staticValue()) {
+            const qreal vol = volIt.getValueAndProgress(1);
+            for(int i = 0; i < nSamples; i++) {
+                for(int j = 0; j < nChannels; j++) {
+                    auto& dstP = dst[dstId++];
+                    dstP = T(qBound(min, round(dstP + src[srcId++]*vol), max));
+                }
+            }
+        } else {
+            for(int i = 0; i < nSamples; i++) {
+                const qreal vol = volIt.getValueAndProgress(1);
+                for(int j = 0; j < nChannels; j++) {
+                    auto& dstP = dst[dstId++];
+                    dstP = T(qBound(min, round(dstP + src[srcId++]*vol), max));
+                }
+            }
+        }
+    }
+
+    void mergeInterleavedData(const float* const src, float * const dst,
+                              const int nSamples,
+                              QrealSnapshot::Iterator volIt,
+                              const int nChannels) {
+        int dstId = 0;
+        int srcId = 0;
+        if(volIt.staticValue()) {
+            const float vol = static_cast<float>(volIt.getValueAndProgress(1));
+            for(int i = 0; i < nSamples; i++) {
+                for(int j = 0; j < nChannels; j++) {
+                    dst[dstId++] += src[srcId++]*vol;
+                }
+            }
+        } else {
+            for(int i = 0; i < nSamples; i++) {
+                const float vol = static_cast<float>(volIt.getValueAndProgress(1));
+                for(int j = 0; j < nChannels; j++) {
+                    dst[dstId++] += src[srcId++]*vol;
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    std::vector<std::vector<T>> createLayers(const int nLayers,
+                                             const int nValues,
+                                             const float scale) {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> dist(-scale, scale);
+        std::vector<std::vector<T>> layers(static_cast<size_t>(nLayers));
+        for(auto& layer : layers) {
+            layer.resize(static_cast<size_t>(nValues));
+            for(auto& value : layer) value = static_cast<T>(dist(gen));
+        }
+        return layers;
+    }
+
+    template <typename T, typename Merge>
+    void run(const char* name, const AVSampleFormat format,
+             const int nLayers, const int nSamples, const int repeats,
+             const float scale, const QrealSnapshot& volume,
+             const Merge& merge) {
+        const int nChannels = 2;
+        const int nValues = nSamples*nChannels;
+        const auto layers = createLayers<T>(nLayers, nValues, scale);
+        std::vector<T> dst(static_cast<size_t>(nValues));
+
+        auto start = Clock::now();
+        for(int r = 0; r < repeats; r++) {
+            std::fill(dst.begin(), dst.end(), T(0));
+            for(const auto& layer : layers) {
+                QrealSnapshot::Iterator volIt(0, 1000, &volume);
+                merge(layer.data(), dst.data(), nSamples, volIt, nChannels);
+            }
+        }
+        const double oldMs = std::chrono::duration<double, std::milli>(
+                    Clock::now() - start).count()/repeats;
+
+        start = Clock::now();
+        for(int r = 0; r < repeats; r++) {
+            MixingBus bus(nSamples, nChannels, format);
+            for(const auto& layer : layers) {
+                QrealSnapshot::Iterator volIt(0, 1000, &volume);
+                const auto src = reinterpret_cast<const uchar*>(layer.data());
+                bus.add(&src, 0, 0, nSamples, volIt);
+            }
+            auto out = reinterpret_cast<uchar*>(dst.data());
+            bus.write(&out);
+        }
+        const double busMs = std::chrono::duration<double, std::milli>(
+                    Clock::now() - start).count()/repeats;
+
+        printf("%-14s templates %8.3f ms, MixingBus %8.3f ms, %5.2fx\n",
+               name, oldMs, busMs, oldMs/busMs);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const int nLayers = argc > 1 ? atoi(argv[1]) : 32;
+    const int sampleRate = argc > 2 ? atoi(argv[2]) : 48000;
+    const int repeats = argc > 3 ? atoi(argv[3]) : 20;
+
+    const QrealSnapshot staticVolume(0.5);
+    QrealSnapshot animatedVolume(1, 1, 1);
+    animatedVolume.appendKey(0, 0, 0, 0, sampleRate/4, 0.25);
+    animatedVolume.appendKey(sampleRate/4, 0.75, sampleRate/2, 1,
+                             sampleRate/2, 1);
+
+    printf("%d stereo layers, %d samples, %d repeats\n",
+           nLayers, sampleRate, repeats);
+    const float s16 = 8000;
+    run<float>("flt static", AV_SAMPLE_FMT_FLT, nLayers, sampleRate,
+               repeats, 0.1f, staticVolume, mergeInterleavedData);
+    run<float>("flt animated", AV_SAMPLE_FMT_FLT, nLayers, sampleRate,
+               repeats, 0.1f, animatedVolume, mergeInterleavedData);
+    run<qint16>("s16 static", AV_SAMPLE_FMT_S16, nLayers, sampleRate,
+                repeats, s16, staticVolume, mergeInterleavedDataSigned<qint16>);
+    run<qint16>("s16 animated", AV_SAMPLE_FMT_S16, nLayers, sampleRate,
+                repeats, s16, animatedVolume, mergeInterleavedDataSigned<qint16>);
+    return 0;
+}
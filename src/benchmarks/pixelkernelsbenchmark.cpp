@@ -0,0 +1,188 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+// Compares the PixelKernels used by the cpu raster effects
+// with the per channel qreal loops they replaced. brightnessContrast
+// differs where the old loop went past the alpha, the kernel clamps.
+// Usage: pixelkernelsbenchmark [width] [height] [repeats]
+
+#include "RasterEffects/pixelkernels.h"
+#include "colorhelpers.h"
+
+#include <QtGlobal>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    // previous BrightnessContrastEffectCaller::processCpu loop
+    void brightnessContrastLoop(const uchar* src, uchar* dst, const int count,
+                                const qreal brightness, const qreal contrast) {
+        for(int i = 0; i < count; i++) {
+            const uchar r = *src++;
+            const uchar g = *src++;
+            const uchar b = *src++;
+            const uchar a = *src++;
+
+            // bounded here, converting out of range values is undefined
+            *dst++ = qBound(0., (r - 0.5*a)*(contrast + 1.) + a*(0.5 + brightness), 255.);
+            *dst++ = qBound(0., (g - 0.5*a)*(contrast + 1.) + a*(0.5 + brightness), 255.);
+            *dst++ = qBound(0., (b - 0.5*a)*(contrast + 1.) + a*(0.5 + brightness), 255.);
+            *dst++ = a;
+        }
+    }
+
+    // previous ColorizeEffectCaller::processCpu loop
+    void colorizeLoop(const uchar* src, uchar* dst, const int count,
+                      const qreal hue, const qreal saturation,
+                      const qreal lightness, const qreal influence) {
+        for(int i = 0; i < count; i++) {
+            const uchar texR = *src++;
+            const uchar texG = *src++;
+            const uchar texB = *src++;
+            const uchar texA = *src++;
+
+            const qreal texRF = texR/255.;
+            const qreal texGF = texG/255.;
+            const qreal texBF = texB/255.;
+            const qreal texAF = texA/255.;
+
+            if(texA == 0) {
+                for(int j = 0; j < 4; j++) *dst++ = 0;
+                continue;
+            }
+            qreal h = texRF/texAF;
+            qreal s = texGF/texAF;
+            qreal l = texBF/texAF;
+            qrgb_to_hsl(h, s, l);
+            h = hue / 360.;
+            s = saturation;
+            l = qBound(0., l + lightness, 1.);
+            qhsl_to_rgb(h, s, l);
+
+            *dst++ = 255*(h*texAF*influence + texRF*(1 - influence));
+            *dst++ = 255*(s*texAF*influence + texGF*(1 - influence));
+            *dst++ = 255*(l*texAF*influence + texBF*(1 - influence));
+            *dst++ = texA;
+        }
+    }
+
+    // previous NoiseFadeEffectCaller and WipeEffectCaller inner loop
+    void maskLoop(const uchar* src, uchar* dst, const float* mask,
+                  const int count) {
+        for(int i = 0; i < count; i++) {
+            const qreal alpha = mask[i];
+            for(int j = 0; j < 4; j++) {
+                *dst++ = *src++ * alpha;
+            }
+        }
+    }
+
+    template <typename Func>
+    double timeMs(const int repeats, const Func& func) {
+        const auto start = Clock::now();
+        for(int i = 0; i < repeats; i++) func();
+        const auto end = Clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count()/repeats;
+    }
+
+    int maxDiff(const std::vector<uchar>& a, const std::vector<uchar>& b) {
+        int result = 0;
+        for(size_t i = 0; i < a.size(); i++) {
+            result = qMax(result, qAbs(int(a[i]) - int(b[i])));
+        }
+        return result;
+    }
+
+    void report(const char* name, const double loopMs, const double kernelMs,
+                const std::vector<uchar>& loop,
+                const std::vector<uchar>& kernel) {
+        printf("%-20s loop %8.2f ms, kernel %8.2f ms, %5.1fx, max diff %d\n",
+               name, loopMs, kernelMs, loopMs/kernelMs, maxDiff(loop, kernel));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const int width = argc > 1 ? atoi(argv[1]) : 1920;
+    const int height = argc > 2 ? atoi(argv[2]) : 1080;
+    const int repeats = qMax(1, argc > 3 ? atoi(argv[3]) : 10);
+    const int count = width*height;
+    if(count <= 0) {
+        printf("invalid size %dx%d\n", width, height);
+        return 1;
+    }
+
+    // random premultiplied pixels, a tenth of them transparent
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uchar> src(size_t(count)*4);
+    for(int i = 0; i < count; i++) {
+        const int a = dist(rng) < 26 ? 0 : dist(rng);
+        uchar* const px = &src[size_t(i)*4];
+        for(int j = 0; j < 3; j++) px[j] = uchar(dist(rng)*a/255);
+        px[3] = uchar(a);
+    }
+    std::vector<float> mask(size_t(count));
+    for(auto& value : mask) value = dist(rng)/255.f;
+
+    std::vector<uchar> loopDst(src.size());
+    std::vector<uchar> kernelDst(src.size());
+    const auto srcData = src.data();
+
+    printf("%dx%d pixels, %d repeats\n", width, height, repeats);
+    {
+        const double loopMs = timeMs(repeats, [&]() {
+            brightnessContrastLoop(srcData, loopDst.data(), count, 0.1, 0.2);
+        });
+        const double kernelMs = timeMs(repeats, [&]() {
+            PixelKernels::brightnessContrast(srcData, kernelDst.data(), count,
+                                             0.1f, 0.2f);
+        });
+        report("brightnessContrast", loopMs, kernelMs, loopDst, kernelDst);
+    }
+    {
+        const double loopMs = timeMs(repeats, [&]() {
+            colorizeLoop(srcData, loopDst.data(), count, 200, 0.6, 0.1, 0.8);
+        });
+        const double kernelMs = timeMs(repeats, [&]() {
+            PixelKernels::colorize(srcData, kernelDst.data(), count,
+                                   200, 0.6f, 0.1f, 0.8f);
+        });
+        report("colorize", loopMs, kernelMs, loopDst, kernelDst);
+    }
+    {
+        const double loopMs = timeMs(repeats, [&]() {
+            maskLoop(srcData, loopDst.data(), mask.data(), count);
+        });
+        const double kernelMs = timeMs(repeats, [&]() {
+            PixelKernels::mask(srcData, kernelDst.data(), mask.data(), count);
+        });
+        report("mask", loopMs, kernelMs, loopDst, kernelDst);
+    }
+    return 0;
+}
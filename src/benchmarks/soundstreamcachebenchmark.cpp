@@ -0,0 +1,184 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+// Reads a 10 minute track second by second, the way the SoundReaders
+// did before, seeking for every second, and through the SoundStreamCache
+// decoding the stream once in order. Without a file a stereo sine wav
+// is written to the temporary folder.
+// Usage: soundstreamcachebenchmark [audio file]
+
+#include "CacheHandlers/soundstreamcache.h"
+#include "FileCacheHandlers/audiostreamsdata.h"
+#include "Sound/esoundsettings.h"
+#include "memorydatahandler.h"
+
+#include <QDir>
+#include <QFile>
+#include <QtMath>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    double msSince(const Clock::time_point& start) {
+        return std::chrono::duration<double, std::milli>(
+                    Clock::now() - start).count();
+    }
+
+    template <typename T>
+    void writeLE(QFile& file, const T value) {
+        for(uint i = 0; i < sizeof(T); i++) {
+            const char byte = static_cast<char>((value >> (8*i)) & 0xff);
+            file.write(&byte, 1);
+        }
+    }
+
+    bool writeSineWav(const QString& path, const int seconds) {
+        QFile file(path);
+        if(!file.open(QIODevice::WriteOnly)) return false;
+        const quint32 sampleRate = 44100;
+        const quint16 channels = 2;
+        const quint32 dataBytes = seconds*sampleRate*channels*2;
+        file.write("RIFF", 4);
+        writeLE<quint32>(file, 36 + dataBytes);
+        file.write("WAVEfmt ", 8);
+        writeLE<quint32>(file, 16);
+        writeLE<quint16>(file, 1);
+        writeLE<quint16>(file, channels);
+        writeLE<quint32>(file, sampleRate);
+        writeLE<quint32>(file, sampleRate*channels*2);
+        writeLE<quint16>(file, channels*2);
+        writeLE<quint16>(file, 16);
+        file.write("data", 4);
+        writeLE<quint32>(file, dataBytes);
+
+        std::vector<qint16> second(sampleRate*channels);
+        for(int s = 0; s < seconds; s++) {
+            for(quint32 i = 0; i < sampleRate; i++) {
+                const qreal t = (s*sampleRate + i)/qreal(sampleRate);
+                const auto val = static_cast<qint16>(8000*qSin(2*M_PI*440*t));
+                second[2*i] = val;
+                second[2*i + 1] = val;
+            }
+            const auto bytes = static_cast<qint64>(second.size()*2);
+            if(file.write(reinterpret_cast<const char*>(second.data()),
+                          bytes) != bytes) return false;
+        }
+        return true;
+    }
+
+    // previous SoundReader::readFrame, seek and decode one second
+    int readSecondSeeking(AudioStreamsData& audio, const int secondId) {
+        const auto stream = audio.fAudioStream;
+        const int64_t tm = av_rescale(secondId, stream->time_base.den,
+                                      stream->time_base.num);
+        avformat_seek_file(audio.fFormatContext, audio.fAudioStreamIndex,
+                           INT64_MIN, tm, tm, 0);
+        avcodec_flush_buffers(audio.fCodecContext);
+        const int sampleRate = stream->codecpar->sample_rate;
+        const int64_t lastSample = int64_t(secondId + 1)*sampleRate;
+        int nSamples = 0;
+        while(av_read_frame(audio.fFormatContext, audio.fPacket) >= 0) {
+            if(audio.fPacket->stream_index != audio.fAudioStreamIndex) {
+                av_packet_unref(audio.fPacket);
+                continue;
+            }
+            avcodec_send_packet(audio.fCodecContext, audio.fPacket);
+            av_packet_unref(audio.fPacket);
+            bool done = false;
+            while(avcodec_receive_frame(audio.fCodecContext,
+                                        audio.fDecodedFrame) >= 0) {
+                const auto frame = audio.fDecodedFrame;
+                const int64_t first = av_rescale_q(
+                            frame->best_effort_timestamp, stream->time_base,
+                            AVRational{1, sampleRate});
+                nSamples += frame->nb_samples;
+                done = done || first + frame->nb_samples >= lastSample;
+                av_frame_unref(frame);
+            }
+            if(done) break;
+        }
+        return nSamples;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const int seconds = 600;
+    QString path;
+    if(argc > 1) {
+        path = QString::fromLocal8Bit(argv[1]);
+    } else {
+        path = QDir(QDir::tempPath()).filePath("friction-soundstreamcachebenchmark.wav");
+        if(!writeSineWav(path, seconds)) {
+            printf("could not write %s\n", qPrintable(path));
+            return 1;
+        }
+    }
+
+    MemoryDataHandler memoryHandler;
+    eSoundSettings soundSettings;
+    const auto settings = eSoundSettings::sData();
+    const int sampleRate = settings.fSampleRate;
+    try {
+        const auto seekAudio = AudioStreamsData::sOpen(path);
+        const int nSeconds = qCeil(seekAudio->fDurationSec);
+        printf("%s, %d seconds\n", qPrintable(path), nSeconds);
+
+        auto start = Clock::now();
+        readSecondSeeking(*seekAudio, 0);
+        const double seekFirstMs = msSince(start);
+        start = Clock::now();
+        for(int i = 0; i < nSeconds; i++) readSecondSeeking(*seekAudio, i);
+        const double seekAllMs = msSince(start);
+
+        const auto audio = AudioStreamsData::sOpen(path);
+        const auto cache = enve::make_shared<SoundStreamCache>(settings);
+        start = Clock::now();
+        cache->read(*audio, {0, sampleRate - 1});
+        const double cacheFirstMs = msSince(start);
+        start = Clock::now();
+        for(int i = 1; i < nSeconds; i++) {
+            cache->read(*audio, {i*sampleRate, (i + 1)*sampleRate - 1});
+        }
+        const double cacheAllMs = cacheFirstMs + msSince(start);
+        start = Clock::now();
+        for(int i = 0; i < nSeconds; i++) {
+            cache->samples({i*sampleRate, (i + 1)*sampleRate - 1});
+        }
+        const double cacheCopyMs = msSince(start);
+
+        printf("first second: seeking %8.2f ms, SoundStreamCache %8.2f ms\n",
+               seekFirstMs, cacheFirstMs);
+        printf("all seconds:  seeking %8.2f ms, SoundStreamCache %8.2f ms\n",
+               seekAllMs, cacheAllMs);
+        printf("all seconds from the decoded stream %8.2f ms, %d KB in RAM\n",
+               cacheCopyMs, cache->getByteCount()/1024);
+    } catch(const std::exception& e) {
+        printf("%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+// Imports a large svg through ImportSVG, and parses its path data with
+// SvgDataParser and with SkParsePath, used by the importer before. Without
+// a file a map like svg is generated, with groups of cubic paths and
+// polygons.
+// Usage: svgimportbenchmark [svg file or generated paths] [repeats]
+
+#include "Boxes/containerbox.h"
+#include "Animators/gradient.h"
+#include "Private/esettings.h"
+#include "svgdataparser.h"
+#include "svgimporter.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
+#include <QXmlStreamReader>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    double msSince(const Clock::time_point& start) {
+        return std::chrono::duration<double, std::milli>(
+                    Clock::now() - start).count();
+    }
+
+    QByteArray generateSvg(const int nPaths) {
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> pos(0, 1920);
+        std::uniform_real_distribution<double> delta(-20, 20);
+        const auto num = [](const double value) {
+            return QByteArray::number(value, 'f', 3);
+        };
+        QByteArray svg;
+        svg += "<svg xmlns=\"http://www.w3.org/2000/svg\" "
+               "width=\"1920\" height=\"1080\">\n";
+        for(int i = 0; i < nPaths; i++) {
+            if(i % 100 == 0) {
+                if(i) svg += "</g>\n";
+                svg += "<g transform=\"translate(" + num(delta(gen)) + " " +
+                       num(delta(gen)) + ")\" fill=\"#5a8f3c\" "
+                       "stroke=\"#202020\" stroke-width=\"0.5\">\n";
+            }
+            if(i % 10 == 9) {
+                svg += "<polygon points=\"";
+                for(int j = 0; j < 16; j++) {
+                    if(j) svg += ' ';
+                    svg += num(pos(gen)) + ',' + num(pos(gen));
+                }
+                svg += "\"/>\n";
+                continue;
+            }
+            svg += "<path d=\"M" + num(pos(gen)) + ' ' + num(pos(gen));
+            for(int j = 0; j < 24; j++) {
+                svg += j ? " " : "c";
+                for(int k = 0; k < 6; k++) {
+                    if(k) svg += ' ';
+                    svg += num(delta(gen));
+                }
+            }
+            svg += "z\"/>\n";
+        }
+        if(nPaths > 0) svg += "</g>\n";
+        svg += "</svg>\n";
+        return svg;
+    }
+
+    struct PathData {
+        QByteArray fData;
+        bool fPoints;
+        bool fPolygon;
+    };
+
+    std::vector<PathData> readPathData(const QByteArray& svg) {
+        std::vector<PathData> result;
+        QXmlStreamReader reader(svg);
+        while(!reader.atEnd()) {
+            if(!reader.readNextStartElement()) continue;
+            const auto name = reader.name();
+            const auto attrs = reader.attributes();
+            if(name == QLatin1String("path")) {
+                result.push_back({attrs.value("d").toLatin1(), false, false});
+            } else if(name == QLatin1String("polyline") ||
+                      name == QLatin1String("polygon")) {
+                result.push_back({attrs.value("points").toLatin1(), true,
+                                  name == QLatin1String("polygon")});
+            }
+        }
+        return result;
+    }
+
+    // previous importer, std::string copy and SkParsePath for 'd' data
+    int parseSkia(const std::vector<PathData>& paths) {
+        int nVerbs = 0;
+        for(const auto& path : paths) {
+            if(path.fPoints) continue;
+            SkPath skPath;
+            const std::string data = path.fData.toStdString();
+            SkParsePath::FromSVGString(data.c_str(), &skPath);
+            nVerbs += skPath.countVerbs();
+        }
+        return nVerbs;
+    }
+
+    int parseSvgData(const std::vector<PathData>& paths,
+                     const bool points) {
+        int nVerbs = 0;
+        for(const auto& path : paths) {
+            if(path.fPoints != points) continue;
+            SkPath skPath;
+            const char* const begin = path.fData.constData();
+            const char* const end = begin + path.fData.size();
+            if(points) {
+                SvgDataParser::parsePoints(begin, end, skPath, path.fPolygon);
+            } else SvgDataParser::parsePath(begin, end, skPath);
+            nVerbs += skPath.countVerbs();
+        }
+        return nVerbs;
+    }
+
+    int countBoxes(BoundingBox* const box) {
+        if(!box) return 0;
+        int count = 1;
+        if(const auto group = enve_cast<ContainerBox*>(box)) {
+            for(const auto child : group->getContainedBoxes()) {
+                count += countBoxes(child);
+            }
+        }
+        return count;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // the importer parses path data on the settings cpu threads
+    eSettings settings(QThread::idealThreadCount(), intKB(0));
+
+    QByteArray svg;
+    const QString arg = argc > 1 ? QString::fromLocal8Bit(argv[1]) : QString();
+    if(QFile::exists(arg)) {
+        QFile file(arg);
+        if(!file.open(QIODevice::ReadOnly)) {
+            printf("could not read %s\n", qPrintable(arg));
+            return 1;
+        }
+        svg = file.readAll();
+        printf("%s, ", qPrintable(arg));
+    } else {
+        const int nPaths = argc > 1 ? atoi(argv[1]) : 100000;
+        svg = generateSvg(nPaths);
+        printf("generated %d paths, ", nPaths);
+    }
+    const int repeats = qMax(1, argc > 2 ? atoi(argv[2]) : 3);
+    printf("%.1f MB, %d threads, %d repeats\n", svg.size()/1048576.,
+           settings.fCpuThreads, repeats);
+
+    auto start = Clock::now();
+    const auto paths = readPathData(svg);
+    printf("stream read:        %9.2f ms, %zu paths\n",
+           msSince(start), paths.size());
+
+    start = Clock::now();
+    int skiaVerbs = 0;
+    for(int i = 0; i < repeats; i++) skiaVerbs = parseSkia(paths);
+    const double skiaMs = msSince(start)/repeats;
+    start = Clock::now();
+    int pathVerbs = 0;
+    for(int i = 0; i < repeats; i++) pathVerbs = parseSvgData(paths, false);
+    const double pathMs = msSince(start)/repeats;
+    start = Clock::now();
+    int pointVerbs = 0;
+    for(int i = 0; i < repeats; i++) pointVerbs = parseSvgData(paths, true);
+    const double pointMs = msSince(start)/repeats;
+    printf("d, SkParsePath:     %9.2f ms, %d verbs\n", skiaMs, skiaVerbs);
+    printf("d, SvgDataParser:   %9.2f ms, %d verbs\n", pathMs, pathVerbs);
+    printf("points:             %9.2f ms, %d verbs\n", pointMs, pointVerbs);
+
+    try {
+        std::vector<qsptr<Gradient>> gradients;
+        const auto gradientCreator = [&gradients]() {
+            gradients.push_back(enve::make_shared<Gradient>());
+            return gradients.back().get();
+        };
+        double importMs = 0;
+        int nBoxes = 0;
+        for(int i = 0; i < repeats; i++) {
+            start = Clock::now();
+            const auto imported = ImportSVG::loadSVGFile(svg, gradientCreator);
+            importMs += msSince(start);
+            nBoxes = countBoxes(imported.get());
+            gradients.clear();
+        }
+        importMs /= repeats;
+        printf("ImportSVG:          %9.2f ms, %d boxes, %.1f MB/s\n",
+               importMs, nBoxes, svg.size()/1048576./(importMs/1000));
+    } catch(const std::exception& e) {
+        printf("%s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
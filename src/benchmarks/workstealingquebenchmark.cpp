@@ -0,0 +1,115 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+// Pushes tiny eCustomCpuTasks through the old single list que of the
+// cpu executors and through the WorkStealingQue replacing it.
+// Usage: workstealingquebenchmark [tasks] [threads]
+
+#include "Private/Tasks/workstealingque.h"
+#include "Private/qatomiclist.h"
+#include "Tasks/updatable.h"
+
+#include <QThread>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    QList<stdsptr<eTask>> createTasks(const int count,
+                                      std::atomic<int>& processed) {
+        QList<stdsptr<eTask>> tasks;
+        tasks.reserve(count);
+        for(int i = 0; i < count; i++) {
+            tasks << enve::make_shared<eCustomCpuTask>(
+                         nullptr, [&processed]() { processed++; },
+                         nullptr, nullptr);
+        }
+        return tasks;
+    }
+
+    // batch == 1 matches sAddTask, larger batches match sAddTasks
+    // called by EffectSubTaskSpawner
+    template <typename Append, typename Worker>
+    double run(const QList<stdsptr<eTask>>& tasks, const int batch,
+               const int nThreads, std::atomic<int>& processed,
+               std::atomic<bool>& stop, const Append& append,
+               const Worker& worker) {
+        processed = 0;
+        stop = false;
+        std::vector<std::thread> threads;
+        for(int i = 0; i < nThreads; i++) threads.emplace_back(worker, i);
+
+        const auto start = Clock::now();
+        for(int i = 0; i < tasks.count(); i += batch) {
+            append(tasks.mid(i, batch));
+        }
+        while(processed < tasks.count()) std::this_thread::yield();
+        const auto end = Clock::now();
+
+        stop = true;
+        for(auto& thread : threads) thread.join();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const int nTasks = argc > 1 ? atoi(argv[1]) : 100000;
+    const int nThreads = argc > 2 ? atoi(argv[2]) :
+                                    qMax(1, QThread::idealThreadCount());
+    std::atomic<int> processed{0};
+    std::atomic<bool> stop{false};
+    const auto tasks = createTasks(nTasks, processed);
+
+    printf("%d tasks, %d threads\n", nTasks, nThreads);
+    for(const int batch : {1, 64}) {
+        QAtomicList<stdsptr<eTask>> list;
+        const double listMs = run(tasks, batch, nThreads, processed, stop,
+            [&list](const QList<stdsptr<eTask>>& add) {
+                list.appendAndNotifyAll(add);
+            },
+            [&list, &stop](const int) {
+                stdsptr<eTask> task;
+                while(list.waitTakeFirst(task, stop)) task->process();
+            });
+
+        WorkStealingQue que(nThreads);
+        const double queMs = run(tasks, batch, nThreads, processed, stop,
+            [&que](const QList<stdsptr<eTask>>& add) {
+                que.append(add);
+            },
+            [&que, &stop](const int) {
+                const int id = que.takeWorkerId();
+                stdsptr<eTask> task;
+                while(que.waitTake(id, task, stop)) task->process();
+            });
+
+        printf("batch %2d: QAtomicList %8.2f ms, WorkStealingQue %8.2f ms\n",
+               batch, listMs, queMs);
+    }
+    return 0;
+}
@@ -304,6 +304,16 @@ void QrealAnimator::setExpressionEasingAction(const qsptr<Expression> &expressio
     setExpression(expression);
 }
 
+void QrealAnimator::prefetchExpression(const FrameRange& absRange) {
+    if(!mExpression) return;
+    if(mExpression->isStatic()) mExpression->prefetch(this, {0, -1});
+    else mExpression->prefetch(this, absRange);
+}
+
+bool QrealAnimator::expressionPrefetchPending(const int absFrame) const {
+    return mExpression && mExpression->prefetchPending(absFrame);
+}
+
 void QrealAnimator::applyExpressionSub(const FrameRange& relRange,
                                        const int sampleInc,
                                        const bool action,
@@ -425,6 +435,9 @@ void QrealAnimator::setExpression(const qsptr<Expression>& expression) {
         });
         conn << connect(expression.get(), &Expression::relRangeChanged,
                         this, [this](const FrameRange& range) {
+            // the prefetched value might have been used before the change
+            if(range.inRange(anim_getCurrentRelFrame()))
+                updateCurrentEffectiveValue();
             prp_afterChangedRelRange(range);
         });
     }
@@ -476,6 +489,13 @@ qreal QrealAnimator::getEffectiveValue(const qreal relFrame) const {
     if(isZero4Dec(relFrame - anim_getCurrentRelFrame()))
         return getEffectiveValue();
     if(mExpression) {
+        // bound by another expression, use the worker value if there is one
+        const int iRelFrame = qRound(relFrame);
+        qreal value;
+        if(isZero4Dec(relFrame - iRelFrame) &&
+           mExpression->prefetched(prp_relFrameToAbsFrame(iRelFrame), value)) {
+            return clamped(value);
+        }
         const auto ret = mExpression->evaluate(relFrame);
         if(ret.isNumber()) return clamped(ret.toNumber());
     }
@@ -543,6 +563,7 @@ bool QrealAnimator::updateExpressionRelFrame() {
 void QrealAnimator::prp_afterFrameShiftChanged(const FrameRange &oldAbsRange,
                                                const FrameRange &newAbsRange) {
     GraphAnimator::prp_afterFrameShiftChanged(oldAbsRange, newAbsRange);
+    if(mExpression) mExpression->clearPrefetched();
     updateExpressionRelFrame();
 }
 
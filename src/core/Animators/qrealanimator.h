@@ -169,6 +169,8 @@ public:
     void setExpression(const qsptr<Expression>& expression);
     void setExpressionAction(const qsptr<Expression>& expression);
     void setExpressionEasingAction(const qsptr<Expression>& expression);
+    void prefetchExpression(const FrameRange& absRange);
+    bool expressionPrefetchPending(const int absFrame) const;
     void applyExpression(const FrameRange& relRange,
                          const qreal accuracy,
                          const bool action,
@@ -26,6 +26,8 @@
 #include "qrealsnapshot.h"
 #include "qrealkey.h"
 
+#include <algorithm>
+
 void QrealSnapshot::appendKey(const QrealKey * const key) {
     appendKey(key->getC0Frame(), key->getC0Value(),
               key->getRelFrame(), key->getValue(),
@@ -143,6 +145,42 @@ qreal QrealSnapshot::Iterator::getValueAndProgress(const qreal progress) {
     return result;
 }
 
+void QrealSnapshot::Iterator::getValuesAndProgress(float * const dst,
+                                                   const int count) {
+    int i = 0;
+    while(i < count) {
+        if(mStaticValue) {
+            std::fill(dst + i, dst + count, static_cast<float>(mPrevValue));
+            return;
+        }
+        // values up to the next sample are linear
+        const int segEnd = i + qMax(1, qFloor(mNextFrame - mCurrentFrame) + 1);
+        const int iMax = qMin(count, segEnd);
+        if(mInterpolate) {
+            const qreal step = (mNextValue - mPrevValue)*mInvFrameSpan;
+            const qreal first = (mCurrentFrame - mPrevFrame)*step + mPrevValue;
+            const float fStep = static_cast<float>(step);
+            const float fFirst = static_cast<float>(first);
+            float* const segDst = dst + i;
+            const int n = iMax - i;
+            int j = 0;
+            for(; j + 4 <= n; j += 4) {
+                const float base = fFirst + j*fStep;
+                segDst[j] = base;
+                segDst[j + 1] = base + fStep;
+                segDst[j + 2] = base + 2*fStep;
+                segDst[j + 3] = base + 3*fStep;
+            }
+            for(; j < n; j++) segDst[j] = fFirst + j*fStep;
+        } else {
+            std::fill(dst + i, dst + iMax, static_cast<float>(mPrevValue));
+        }
+        mCurrentFrame += iMax - i;
+        i = iMax;
+        if(mCurrentFrame > mNextFrame) updateSamples();
+    }
+}
+
 bool QrealSnapshot::Iterator::staticValue() const {
     return mStaticValue;
 }
@@ -48,6 +48,8 @@ public:
                  const QrealSnapshot * const snap);
 
         qreal getValueAndProgress(const qreal progress);
+        //! @brief Same as count getValueAndProgress(1) calls
+        void getValuesAndProgress(float * const dst, const int count);
 
         bool staticValue() const;
     private:
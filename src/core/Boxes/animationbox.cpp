@@ -185,6 +185,12 @@ FrameRange AnimationBox::prp_getIdenticalRelRange(const int relFrame) const {
     return BoundingBox::prp_getIdenticalRelRange(relFrame);
 }
 
+FrameRange AnimationBox::getRelRectIdenticalRelRange(const int relFrame) const {
+    // the frames can differ in size
+    const auto range = BoundingBox::getRelRectIdenticalRelRange(relFrame);
+    return range*prp_getIdenticalRelRange(relFrame);
+}
+
 class AnimationToPaint : public ComplexTask {
 public:
     using Loader = std::function<void(int, int)>;
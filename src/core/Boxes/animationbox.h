@@ -46,6 +46,7 @@ public:
     void anim_setAbsFrame(const int frame);
 
     FrameRange prp_getIdenticalRelRange(const int relFrame) const;
+    FrameRange getRelRectIdenticalRelRange(const int relFrame) const;
 
     void setupCanvasMenu(PropertyMenu * const menu);
     void setupRenderData(const qreal relFrame,
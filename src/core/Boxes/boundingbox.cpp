@@ -157,6 +157,9 @@ BoundingBox *BoundingBox::sGetBoxByDocumentId(const int documentId) {
 }
 
 void BoundingBox::prp_afterChangedAbsRange(const FrameRange &range, const bool clip) {
+    mEditId++;
+    mRelRectRange = FrameRange::INVALID;
+    mBoundsId++;
     const auto croppedRange = clip ? prp_absInfluenceRange()*range : range;
     StaticComplexAnimator::prp_afterChangedAbsRange(croppedRange, clip);
     if(croppedRange.inRange(anim_getCurrentAbsFrame())) {
@@ -263,6 +266,10 @@ bool BoundingBox::getRasterEffectsEnabled() const {
     return mRasterEffectsAnimators->SWT_isEnabled();
 }
 
+bool BoundingBox::hasRasterEffects() const {
+    return mRasterEffectsAnimators->hasEffects();
+}
+
 void BoundingBox::updateAllBoxes(const UpdateReason reason) {
     planUpdate(reason);
 }
@@ -524,6 +531,8 @@ QPointF BoundingBox::getPivotAbsPos(const qreal relFrame) {
 
 void BoundingBox::setRelBoundingRect(const QRectF& relRect) {
     mRelRect = relRect;
+    mRelRectRange = FrameRange::INVALID;
+    mBoundsId++;
     mRelRectSk = toSkRect(mRelRect);
     mSkRelBoundingRectPath.reset();
     mSkRelBoundingRectPath.addRect(mRelRectSk);
@@ -547,6 +556,41 @@ void BoundingBox::prp_updateCanvasProps() {
 void BoundingBox::updateCurrentPreviewDataFromRenderData(
         BoxRenderData* renderData) {
     setRelBoundingRect(renderData->fRelBoundingRect);
+    const qreal relFrame = renderData->fRelFrame;
+    if(renderData->fBoxEditId == mEditId && isInteger4Dec(relFrame)) {
+        mRelRectRange = getRelRectIdenticalRelRange(qRound(relFrame));
+    }
+}
+
+FrameRange BoundingBox::getRelRectIdenticalRelRange(const int relFrame) const {
+    FrameRange range{FrameRange::EMIN, FrameRange::EMAX};
+    for(const auto& child : ca_getChildren()) {
+        if(child == mTransformAnimator) continue;
+        range *= child->prp_getIdenticalRelRange(relFrame);
+        if(range.isUnary()) break;
+    }
+    return range;
+}
+
+bool BoundingBox::getParentBoundsAtFrame(const qreal relFrame,
+                                         QRectF& bounds,
+                                         FrameRange& range) {
+    range = FrameRange::EMINMAX;
+    // groups are drawn with their children, effect margins can be
+    // animated and transform effects can follow other boxes
+    if(isGroup() || hasTransformEffects() ||
+       mRasterEffectsAnimators->hasEffects()) return false;
+    const int minFrame = qFloor(relFrame);
+    const int maxFrame = qCeil(relFrame);
+    if(!mRelRectRange.inRange(minFrame) || !mRelRectRange.inRange(maxFrame)) {
+        range = {minFrame, maxFrame};
+        return false;
+    }
+    bounds = getRelativeTransformAtFrame(relFrame).mapRect(mRelRect);
+    const auto transRange = mTransformAnimator->prp_getIdenticalRelRange(minFrame);
+    if(transRange.inRange(maxFrame)) range = mRelRectRange*transRange;
+    else range = FrameRange::INVALID;
+    return true;
 }
 
 void BoundingBox::planUpdate(const UpdateReason reason) {
@@ -557,6 +601,9 @@ void BoundingBox::planUpdate(const UpdateReason reason) {
     else if(!enve_cast<Canvas*>(this)) return;
     if(reason == UpdateReason::userChange) {
         mStateId++;
+        mEditId++;
+        mRelRectRange = FrameRange::INVALID;
+        mBoundsId++;
         mRenderDataHandler.clear();
     }
 
@@ -1056,6 +1103,7 @@ void BoundingBox::setupWithoutRasterEffects(const qreal relFrame,
     if(!scene) return;
 
     data->fBoxStateId = mStateId;
+    data->fBoxEditId = mEditId;
     data->fRelFrame = relFrame;
 
     const auto thisRelM = getRelativeTransformAtFrame(relFrame);
@@ -1607,6 +1655,8 @@ eTask* BoundingBox::saveSVGWithTransform(SvgExporter& exp,
                 expPtr->addToDefs(eleMask);
             } else {
                 parentPtr->appendChild(withEffects);
+                // top level elements go straight to the file
+                expPtr->flush();
             }
         }
     }, nullptr});
@@ -215,6 +215,8 @@ public:
 
     virtual FrameRange getMotionBlurIdenticalRange(
             const qreal relFrame, const bool inheritedTransform);
+    //! @brief Range in which the relative bounding rect stays the same
+    virtual FrameRange getRelRectIdenticalRelRange(const int relFrame) const;
 
     virtual HardwareSupport hardwareSupport() const {
         return HardwareSupport::cpuPreffered;
@@ -267,6 +269,8 @@ public:
                                      const QMatrix& parentM);
     stdsptr<BoxRenderData> queExternalRender(
             const qreal relFrame, const bool forceRasterize);
+    //! @brief Changes with every user change to the box or its content
+    uint stateId() const { return mStateId; }
 
     void setupWithoutRasterEffects(const qreal relFrame,
                                    const QMatrix& parentM,
@@ -363,11 +367,17 @@ public:
     { return mRelRect; }
     const SkPath &getRelBoundingRectPath() const
     { return mSkRelBoundingRectPath; }
+    //! @brief Bounds in the parent group coordinates, false when
+    //! not known without rendering the box. Identical within range.
+    bool getParentBoundsAtFrame(const qreal relFrame, QRectF& bounds,
+                                FrameRange& range);
+    uint getBoundsId() const { return mBoundsId; }
     void drawHoveredPathSk(SkCanvas *canvas, const SkPath &path,
                            const float invScale);
 
     void setRasterEffectsEnabled(const bool enable);
     bool getRasterEffectsEnabled() const;
+    bool hasRasterEffects() const;
 
     void clearRasterEffects();
 
@@ -502,6 +512,9 @@ private:
 
     QRectF mRelRect;
     SkRect mRelRectSk;
+    FrameRange mRelRectRange = FrameRange::INVALID;
+    uint mEditId = 0;
+    uint mBoundsId = 0;
     SkPath mSkRelBoundingRectPath;
 
     BasicTransformAnimator* mParentTransform = nullptr;
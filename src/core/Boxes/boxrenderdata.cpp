@@ -26,6 +26,7 @@
 #include "boxrenderdata.h"
 #include "boundingbox.h"
 #include "skia/skiahelpers.h"
+#include "skia/pixelbufferpool.h"
 #include "efiltersettings.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/gputaskexecutor.h"
@@ -43,7 +44,6 @@ void BoxRenderData::transformRenderCanvas(SkCanvas &canvas) const {
 }
 
 void BoxRenderData::copyFrom(BoxRenderData *src) {
-    mCopySource = src;
     fRelTransform = src->fRelTransform;
     fInheritedTransform = src->fInheritedTransform;
     fTotalTransform = src->fTotalTransform;
@@ -58,7 +58,8 @@ void BoxRenderData::copyFrom(BoxRenderData *src) {
     fOpacity = src->fOpacity;
     fResolution = src->fResolution;
     fResolutionScale = src->fResolutionScale;
-    fRenderedImage = src->requestImageCopy();
+    fRenderedImage = src->fRenderedImage;
+    fRenderedImageShared = true;
     fBoxStateId = src->fBoxStateId;
     mState = eTaskState::finished;
     fRelBoundingRectSet = true;
@@ -71,11 +72,6 @@ stdsptr<BoxRenderData> BoxRenderData::makeCopy() {
     return copy;
 }
 
-sk_sp<SkImage> BoxRenderData::requestImageCopy() {
-    if(mImageCopies.isEmpty()) return SkiaHelpers::makeCopy(fRenderedImage);
-    else return mImageCopies.takeLast();
-}
-
 void BoxRenderData::drawOnParentLayer(SkCanvas * const canvas) {
     SkPaint paint;
     if(fUseRenderTransform) paint.setFilterQuality(fFilterQuality);
@@ -136,7 +132,7 @@ void BoxRenderData::processGpu(QGL33 * const gl,
                                                      kRGBA_8888_SkColorType);
     if(mEffectsRenderer.isEmpty() ||
        mEffectsRenderer.nextHardwareSupport() == HardwareSupport::cpuOnly)
-        fRenderedImage = fRenderedImage->makeRasterImage();
+        fRenderedImage = PixelBufferPool::makeRasterCopy(fRenderedImage);
     else mEffectsRenderer.processGpu(gl, context, this);
 //    if(mEffectsRenderer.isEmpty()) return;
 //    const auto nextEffectHw = mEffectsRenderer.nextHardwareSupport();
@@ -153,7 +149,10 @@ void BoxRenderData::process() {
 
     const auto info = SkiaHelpers::getPremulRGBAInfo(fGlobalRect.width(),
                                                      fGlobalRect.height());
-    mBitmap.allocPixels(info);
+    if(!PixelBufferPool::allocPixels(mBitmap, info)) {
+        RuntimeThrow("Could not allocate " + QString::number(info.width()) +
+                     "x" + QString::number(info.height()) + " box pixels");
+    }
     mBitmap.eraseColor(eraseColor());
     SkCanvas canvas(mBitmap);
     transformRenderCanvas(canvas);
@@ -166,19 +165,44 @@ void BoxRenderData::process() {
 void BoxRenderData::beforeProcessing(const Hardware hw) {
     Q_UNUSED(hw)
     Q_ASSERT(mStep != Step::EFFECTS);
+    if(mInstanceSource) return setupFromInstanceSource();
     setupRenderData();
     if(!mDataSet) dataSet();
     if(isZero4Dec(fOpacity)) finishedProcessing();
 }
 
+void BoxRenderData::setInstanceSource(const stdsptr<BoxRenderData>& src) {
+    mInstanceSource = src;
+    // the bounding rect is known only once src is set
+    delayDataSet();
+    src->addDependent(this);
+}
+
+void BoxRenderData::setupFromInstanceSource() {
+    const auto src = std::move(mInstanceSource);
+    fRelBoundingRect = src->fRelBoundingRect;
+    fRelBoundingRectSet = true;
+    dataSet();
+    fScaledTransform = fTotalTransform*fResolutionScale;
+    fGlobalRect = src->fGlobalRect;
+    // maps src pixels back to relative coordinates and then to this
+    if(src->fUseRenderTransform) fRenderTransform = src->fRenderTransform;
+    else fRenderTransform.reset();
+    fRenderTransform *= src->fScaledTransform.inverted()*fScaledTransform;
+    fUseRenderTransform = true;
+    fRenderedImage = src->fRenderedImage;
+    fRenderedImageShared = true;
+    fAntiAlias = true;
+    finishedProcessing();
+}
+
 void BoxRenderData::afterProcessing() {
-    if(fMotionBlurTarget) {
-        fMotionBlurTarget->fOtherGlobalRects << fGlobalRect;
+    for(const auto& target : fMotionBlurTargets) {
+        if(target) target->fOtherGlobalRects << fGlobalRect;
     }
+    fMotionBlurTargets.clear();
     if(fParentBox && fParentIsTarget) {
         fParentBox->renderDataFinished(this);
-    } else if(mCopySource) {
-        mCopySource->addImageCopy(std::move(fRenderedImage));
     }
 }
 
@@ -81,11 +81,11 @@ public:
     void process();
 
     stdsptr<BoxRenderData> makeCopy();
-    sk_sp<SkImage> requestImageCopy();
 
     bool fForceRasterize = false;
 
     uint fBoxStateId = 0;
+    uint fBoxEditId = 0;
 
     QMatrix fResolutionScale;
     QMatrix fScaledTransform;
@@ -106,9 +106,8 @@ public:
     qreal fResolution;
     qreal fRelFrame;
 
-    // for motion blur
-    stdptr<BoxRenderData> fMotionBlurTarget;
-    // for motion blur
+    // for motion blur, a sample can be shared by consecutive frames
+    QList<stdptr<BoxRenderData>> fMotionBlurTargets;
 
     SkBlendMode fBlendMode = SkBlendMode::kSrcOver;
     const SkFilterQuality fFilterQuality;
@@ -119,12 +118,18 @@ public:
     qptr<BoundingBox> fParentBox;
     BoundingBox* fBlendEffectIdentifier;
     sk_sp<SkImage> fRenderedImage;
+    //! @brief fRenderedImage pixels are also referenced by a cache
+    bool fRenderedImageShared = false;
 
     void dataSet();
 
     void addEffect(const stdsptr<RasterEffectCaller>& effect) {
         mEffectsRenderer.add(effect);
     }
+
+    //! @brief Reuse the image of src instead of drawing, src has to
+    //! differ from this only by its transform
+    void setInstanceSource(const stdsptr<BoxRenderData>& src);
 protected:
     bool hasEffects() const { return !mEffectsRenderer.isEmpty(); }
 
@@ -135,14 +140,11 @@ protected:
     bool mDelayDataSet = false;
     bool mDataSet = false;
 private:
-    void addImageCopy(const sk_sp<SkImage>& img) {
-        mImageCopies << img;
-    }
+    void setupFromInstanceSource();
 
     Step mStep = Step::BOX_IMAGE;
     EffectsRenderer mEffectsRenderer;
-    stdptr<BoxRenderData> mCopySource;
-    QList<sk_sp<SkImage>> mImageCopies;
+    stdsptr<BoxRenderData> mInstanceSource;
 };
 
 #endif // BOXRENDERDATA_H
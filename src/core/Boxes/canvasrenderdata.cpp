@@ -25,10 +25,186 @@
 
 #include "canvasrenderdata.h"
 #include "skia/skiahelpers.h"
+#include "skia/pixelbufferpool.h"
+#include "Private/esettings.h"
+#include "Private/Tasks/taskexecutor.h"
+#include "Tasks/updatable.h"
+
+#define TILE_SIZE 256
+
+bool CanvasComposite::Child::operator==(const Child& other) const {
+    return fBox == other.fBox &&
+           fBoxStateId == other.fBoxStateId &&
+           fGlobalRect == other.fGlobalRect &&
+           isZero4Dec(fOpacity - other.fOpacity) &&
+           fBlendMode == other.fBlendMode &&
+           fUseRenderTransform == other.fUseRenderTransform &&
+           fClipped == other.fClipped;
+}
+
+bool CanvasComposite::Child::affectsAll() const {
+    // drawn scaled, not within fGlobalRect
+    if(fUseRenderTransform) return true;
+    // clear everything outside, see BoxRenderData::drawOnParentLayer
+    return fBlendMode == SkBlendMode::kDstIn ||
+           fBlendMode == SkBlendMode::kSrcIn ||
+           fBlendMode == SkBlendMode::kDstATop ||
+           fBlendMode == SkBlendMode::kModulate ||
+           fBlendMode == SkBlendMode::kSrcOut;
+}
 
 CanvasRenderData::CanvasRenderData(BoundingBox * const parentBoxT) :
     ContainerBoxRenderData(parentBoxT) {}
 
+void CanvasRenderData::process() {
+    updateGlobalRect();
+    if(isZero4Dec(fOpacity)) return;
+    if(fGlobalRect.width() <= 0 || fGlobalRect.height() <= 0) return;
+    addChildrenProcessingUs();
+
+    mComposite = std::make_shared<CanvasComposite>();
+    mComposite->fRelFrame = fRelFrame;
+    mComposite->fResolution = fResolution;
+    mComposite->fGlobalRect = fGlobalRect;
+    mComposite->fBgColor = fBgColor;
+    for(const auto &child : fChildrenRenderData) {
+        mComposite->fChildren.append({child->fParentBox.data(),
+                                      child->fBoxStateId,
+                                      child->fGlobalRect,
+                                      child->fOpacity,
+                                      child->fBlendMode,
+                                      child->fUseRenderTransform,
+                                      !child.fClip.fClipOps.isEmpty()});
+    }
+
+    const auto info = SkiaHelpers::getPremulRGBAInfo(fGlobalRect.width(),
+                                                     fGlobalRect.height());
+    if(!PixelBufferPool::allocPixels(mBitmap, info)) {
+        RuntimeThrow("Could not allocate " + QString::number(info.width()) +
+                     "x" + QString::number(info.height()) + " scene pixels");
+    }
+    const QRect all(QPoint(0, 0), fGlobalRect.size());
+    QRegion dirty = dirtyRegion(*mComposite);
+    if(dirty != QRegion(all)) {
+        if(!fPreviousImage->readPixels(mBitmap.pixmap(), 0, 0)) dirty = all;
+    }
+    fPrevious.reset();
+    fPreviousImage.reset();
+
+    for(int y = 0; y < all.height(); y += TILE_SIZE) {
+        for(int x = 0; x < all.width(); x += TILE_SIZE) {
+            const QRect tile(x, y, qMin(TILE_SIZE, all.width() - x),
+                             qMin(TILE_SIZE, all.height() - y));
+            if(dirty.intersects(tile)) mTiles << tile;
+        }
+    }
+    // several tiles are drawn by sub tasks spawned in nextStep
+    if(mTiles.count() > 1) {
+        prepareChildrenForTiles();
+        return;
+    }
+    if(!mTiles.isEmpty()) drawTile(mTiles.takeFirst());
+    finishComposite();
+}
+
+bool CanvasRenderData::nextStep() {
+    if(mTiles.isEmpty()) return BoxRenderData::nextStep();
+    spawnTiles();
+    return true;
+}
+
+void CanvasRenderData::prepareChildrenForTiles() {
+    // the tile tasks draw the same children at once,
+    // leave nothing for them to compute and cache on first use
+    for(auto &child : fChildrenRenderData) {
+        auto& image = child->fRenderedImage;
+        if(image && (image->isTextureBacked() || image->isLazyGenerated())) {
+            image = image->makeRasterImage();
+        }
+        for(const auto& op : child.fClip.fClipOps) {
+            op.fClipPath.updateBoundsCache();
+        }
+    }
+}
+
+void CanvasRenderData::spawnTiles() {
+    const int nTasks = qMin(mTiles.count(), eSettings::sCpuThreadsCapped());
+    mNextTile = 0;
+    mRemainingTileTasks = nTasks;
+    const auto thisRef = ref<CanvasRenderData>();
+    const auto finished = [thisRef]() { thisRef->tileTaskFinished(); };
+    QList<stdsptr<eTask>> tasks;
+    for(int i = 0; i < nTasks; i++) {
+        tasks << enve::make_shared<eCustomCpuTask>(nullptr, [thisRef]() {
+            const auto& tiles = thisRef->mTiles;
+            int i;
+            while((i = thisRef->mNextTile++) < tiles.count()) {
+                thisRef->drawTile(tiles.at(i));
+            }
+        }, finished, finished);
+    }
+    CpuTaskExecutor::sAddTasks(tasks);
+}
+
+void CanvasRenderData::tileTaskFinished() {
+    if(--mRemainingTileTasks > 0) return;
+    mTiles.clear();
+    if(getState() == eTaskState::canceled) return;
+    finishComposite();
+    if(!nextStep()) finishedProcessing();
+}
+
+void CanvasRenderData::finishComposite() {
+    fRenderedImage = SkiaHelpers::transferDataToSkImage(mBitmap);
+    // effects replace fRenderedImage, the composite pixels are not kept
+    if(!hasEffects()) fComposite = mComposite;
+    mComposite.reset();
+}
+
+QRegion CanvasRenderData::dirtyRegion(const CanvasComposite& current) const {
+    const QRect all(QPoint(0, 0), fGlobalRect.size());
+    const auto prev = fPrevious.get();
+    if(!prev || !fPreviousImage) return all;
+    if(prev->fGlobalRect != current.fGlobalRect ||
+       prev->fBgColor != current.fBgColor ||
+       !isZero4Dec(prev->fRelFrame - current.fRelFrame) ||
+       !isZero4Dec(prev->fResolution - current.fResolution)) return all;
+    const int nChildren = current.fChildren.count();
+    if(prev->fChildren.count() != nChildren) return all;
+
+    QRegion dirty;
+    bool changed = false;
+    for(int i = 0; i < nChildren; i++) {
+        const auto& prevChild = prev->fChildren.at(i);
+        const auto& child = current.fChildren.at(i);
+        if(prevChild.fBox != child.fBox) return all;
+        if(prevChild == child) continue;
+        if(prevChild.affectsAll() || child.affectsAll()) return all;
+        changed = true;
+        // antialiased edges can reach past the rect
+        dirty += prevChild.fGlobalRect.adjusted(-1, -1, 1, 1);
+        dirty += child.fGlobalRect.adjusted(-1, -1, 1, 1);
+    }
+    if(!changed) return dirty;
+    // clips come from other boxes
+    for(const auto& child : current.fChildren) {
+        if(child.fClipped) dirty += child.fGlobalRect.adjusted(-1, -1, 1, 1);
+    }
+    dirty.translate(-fGlobalRect.topLeft());
+    return dirty.intersected(all);
+}
+
+void CanvasRenderData::drawTile(const QRect& tile) {
+    const auto canvas = SkCanvas::MakeRasterDirect(mBitmap.info(),
+                                                   mBitmap.getPixels(),
+                                                   mBitmap.rowBytes());
+    canvas->clipRect(SkRect::MakeXYWH(tile.x(), tile.y(),
+                                      tile.width(), tile.height()));
+    canvas->clear(eraseColor());
+    transformRenderCanvas(*canvas);
+    drawChildren(canvas.get());
+}
+
 void CanvasRenderData::updateGlobalRect() {
     fScaledTransform = fTotalTransform*fResolutionScale;
     const auto globalRectF = fScaledTransform.mapRect(fRelBoundingRect);
@@ -26,6 +26,36 @@
 #ifndef CANVASRENDERDATA_H
 #define CANVASRENDERDATA_H
 #include "layerboxrenderdata.h"
+
+#include <QRegion>
+
+#include <atomic>
+
+// Scene composite before effects, with what it was made of,
+// used to redraw only the tiles that changed on the same frame.
+struct CORE_EXPORT CanvasComposite {
+    struct Child {
+        const BoundingBox* fBox;
+        uint fBoxStateId;
+        QRect fGlobalRect;
+        qreal fOpacity;
+        SkBlendMode fBlendMode;
+        bool fUseRenderTransform;
+        bool fClipped;
+
+        bool operator==(const Child& other) const;
+        bool operator!=(const Child& other) const { return !(*this == other); }
+        //! @brief Changing the child affects pixels outside of its rect
+        bool affectsAll() const;
+    };
+
+    qreal fRelFrame;
+    qreal fResolution;
+    QRect fGlobalRect;
+    SkColor fBgColor;
+    QList<Child> fChildren;
+};
+
 struct CORE_EXPORT CanvasRenderData : public ContainerBoxRenderData {
     CanvasRenderData(BoundingBox * const parentBoxT);
 
@@ -33,10 +63,34 @@ struct CORE_EXPORT CanvasRenderData : public ContainerBoxRenderData {
     int fCanvasHeight;
     SkColor fBgColor;
 
+    //! @brief Previous composite of the scene and its pixels, set by the
+    //! Canvas while the scene frame cache still holds them in memory
+    stdsptr<const CanvasComposite> fPrevious;
+    sk_sp<SkImage> fPreviousImage;
+    //! @brief Set after processing on the CPU when fRenderedImage holds
+    //! the composite, i.e. there are no effects
+    stdsptr<CanvasComposite> fComposite;
+
     SkColor eraseColor() const { return fBgColor; }
+
+    void process();
+    bool nextStep();
 protected:
     void updateGlobalRect();
     void updateRelBoundingRect();
+private:
+    QRegion dirtyRegion(const CanvasComposite& current) const;
+    void prepareChildrenForTiles();
+    void spawnTiles();
+    void tileTaskFinished();
+    void drawTile(const QRect& tile);
+    void finishComposite();
+
+    stdsptr<CanvasComposite> mComposite;
+    //! @brief Tiles left for the tile tasks spawned by nextStep
+    QList<QRect> mTiles;
+    std::atomic<int> mNextTile{0};
+    int mRemainingTileTasks = 0;
 };
 
 #endif // CANVASRENDERDATA_H
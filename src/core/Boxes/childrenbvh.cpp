@@ -0,0 +1,204 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "childrenbvh.h"
+#include "boundingbox.h"
+
+#include <QtMath>
+
+#include <algorithm>
+
+#define NODE_LEAVES 4
+
+namespace {
+    // unlike QRectF::intersects, accepts rects with no area
+    bool touches(const QRectF& a, const QRectF& b) {
+        return a.left() <= b.right() && b.left() <= a.right() &&
+               a.top() <= b.bottom() && b.top() <= a.bottom();
+    }
+
+    bool contains(const QRectF& a, const QRectF& b) {
+        return a.left() <= b.left() && b.right() <= a.right() &&
+               a.top() <= b.top() && b.bottom() <= a.bottom();
+    }
+}
+
+void ChildrenBvh::clear() {
+    mLeaves.clear();
+    mOrder.clear();
+    mNodes.clear();
+    mRefits = 0;
+}
+
+void ChildrenBvh::cull(const QList<BoundingBox*>& boxes,
+                       const qreal absFrame, const QRectF& rect,
+                       std::vector<bool>& visible) {
+    const int count = boxes.count();
+    visible.assign(static_cast<size_t>(count), false);
+    if(count == 0) return;
+    if(static_cast<int>(mLeaves.size()) != count) clear();
+    mLeaves.resize(static_cast<size_t>(count));
+
+    bool changed = false;
+    for(int i = 0; i < count; i++) {
+        auto& leaf = mLeaves[static_cast<size_t>(i)];
+        const auto box = boxes.at(i);
+        if(leaf.fBox != box) {
+            leaf = Leaf();
+            leaf.fBox = box;
+            mNodes.clear();
+        }
+        if(updateLeaf(leaf, absFrame)) {
+            changed = true;
+            mRefits++;
+        }
+    }
+
+    // refitting keeps the topology, rebuild once it got too loose
+    if(mNodes.empty() || mRefits > count/2) {
+        mOrder.resize(static_cast<size_t>(count));
+        for(int i = 0; i < count; i++) mOrder[static_cast<size_t>(i)] = i;
+        mNodes.clear();
+        mNodes.reserve(static_cast<size_t>(2*count/NODE_LEAVES + 1));
+        build(0, count);
+        mRefits = 0;
+    } else if(changed) refit(0);
+
+    query(0, rect, visible);
+}
+
+bool ChildrenBvh::updateLeaf(Leaf& leaf, const qreal absFrame) {
+    const auto box = leaf.fBox;
+    const int minFrame = qFloor(absFrame);
+    const int maxFrame = qCeil(absFrame);
+    if(leaf.fBoundsId == box->getBoundsId() &&
+       leaf.fAbsRange.inRange(minFrame) &&
+       leaf.fAbsRange.inRange(maxFrame)) return false;
+    const bool wasKnown = leaf.fKnown;
+    const QRectF oldBounds = leaf.fBounds;
+    leaf.fBoundsId = box->getBoundsId();
+    const qreal relFrame = box->prp_absFrameToRelFrameF(absFrame);
+    FrameRange relRange;
+    leaf.fKnown = box->getParentBoundsAtFrame(relFrame, leaf.fBounds,
+                                              relRange);
+    leaf.fAbsRange = box->prp_relRangeToAbsRange(relRange);
+    if(wasKnown != leaf.fKnown) return true;
+    return leaf.fKnown && oldBounds != leaf.fBounds;
+}
+
+int ChildrenBvh::build(const int first, const int count) {
+    const int nodeId = static_cast<int>(mNodes.size());
+    mNodes.push_back(Node());
+    mNodes.back().fFirst = first;
+    mNodes.back().fCount = count;
+    if(count > NODE_LEAVES) {
+        // spatial median split along the longer axis of the centers,
+        // boxes with unknown bounds are kept together at the end
+        const auto begin = mOrder.begin() + first;
+        const auto end = begin + count;
+        const auto unknown = std::stable_partition(begin, end, [this](const int i) {
+            return mLeaves[static_cast<size_t>(i)].fKnown;
+        });
+        QRectF centers;
+        for(auto it = begin; it != unknown; it++) {
+            const auto c = mLeaves[static_cast<size_t>(*it)].fBounds.center();
+            if(it == begin) centers = QRectF(c, c);
+            else centers = centers.united(QRectF(c, c));
+        }
+        const bool horizontal = centers.width() >= centers.height();
+        const auto mid = begin + (unknown - begin)/2;
+        std::nth_element(begin, mid, unknown, [this, horizontal](const int i, const int j) {
+            const auto ci = mLeaves[static_cast<size_t>(i)].fBounds.center();
+            const auto cj = mLeaves[static_cast<size_t>(j)].fBounds.center();
+            return horizontal ? ci.x() < cj.x() : ci.y() < cj.y();
+        });
+        int split = static_cast<int>(mid - begin);
+        if(split == 0) split = static_cast<int>(unknown - begin);
+        if(split == 0 || split == count) split = count/2;
+        const int left = build(first, split);
+        const int right = build(first + split, count - split);
+        mNodes[static_cast<size_t>(nodeId)].fLeft = left;
+        mNodes[static_cast<size_t>(nodeId)].fRight = right;
+    }
+    fit(nodeId);
+    return nodeId;
+}
+
+void ChildrenBvh::fit(const int nodeId) {
+    auto& node = mNodes[static_cast<size_t>(nodeId)];
+    node.fKnown = true;
+    node.fBounds = QRectF();
+    bool empty = true;
+    const auto unite = [&](const QRectF& bounds, const bool known) {
+        if(!known) node.fKnown = false;
+        else if(empty) node.fBounds = bounds;
+        else node.fBounds = node.fBounds.united(bounds);
+        if(known) empty = false;
+    };
+    if(node.fLeft == -1) {
+        for(int i = node.fFirst; i < node.fFirst + node.fCount; i++) {
+            const auto& leaf = mLeaves[static_cast<size_t>(mOrder[static_cast<size_t>(i)])];
+            unite(leaf.fBounds, leaf.fKnown);
+        }
+    } else {
+        const auto& left = mNodes[static_cast<size_t>(node.fLeft)];
+        const auto& right = mNodes[static_cast<size_t>(node.fRight)];
+        unite(left.fBounds, left.fKnown);
+        unite(right.fBounds, right.fKnown);
+    }
+}
+
+void ChildrenBvh::refit(const int nodeId) {
+    const auto& node = mNodes[static_cast<size_t>(nodeId)];
+    if(node.fLeft != -1) {
+        refit(node.fLeft);
+        refit(node.fRight);
+    }
+    fit(nodeId);
+}
+
+void ChildrenBvh::query(const int nodeId, const QRectF& rect,
+                        std::vector<bool>& visible) const {
+    const auto& node = mNodes[static_cast<size_t>(nodeId)];
+    if(node.fKnown) {
+        if(!touches(rect, node.fBounds)) return;
+        if(contains(rect, node.fBounds)) {
+            for(int i = node.fFirst; i < node.fFirst + node.fCount; i++) {
+                visible[static_cast<size_t>(mOrder[static_cast<size_t>(i)])] = true;
+            }
+            return;
+        }
+    }
+    if(node.fLeft == -1) {
+        for(int i = node.fFirst; i < node.fFirst + node.fCount; i++) {
+            const int id = mOrder[static_cast<size_t>(i)];
+            const auto& leaf = mLeaves[static_cast<size_t>(id)];
+            if(!leaf.fKnown || touches(rect, leaf.fBounds)) {
+                visible[static_cast<size_t>(id)] = true;
+            }
+        }
+        return;
+    }
+    query(node.fLeft, rect, visible);
+    query(node.fRight, rect, visible);
+}
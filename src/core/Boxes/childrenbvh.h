@@ -0,0 +1,80 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef CHILDRENBVH_H
+#define CHILDRENBVH_H
+
+#include "core_global.h"
+#include "framerange.h"
+
+#include <QList>
+#include <QRectF>
+
+#include <vector>
+
+class BoundingBox;
+
+// Bounding volume hierarchy over the boxes of a ContainerBox, used to
+// skip boxes that end up outside the rendered area. The bounds of a box
+// are reused for as long as the box reports them identical, boxes with
+// unknown bounds are never culled.
+class CORE_EXPORT ChildrenBvh {
+public:
+    //! @brief Sets visible[i] for the boxes that can intersect rect,
+    //! rect is in the coordinates of the container
+    void cull(const QList<BoundingBox*>& boxes, const qreal absFrame,
+              const QRectF& rect, std::vector<bool>& visible);
+    void clear();
+private:
+    struct Leaf {
+        BoundingBox* fBox = nullptr;
+        uint fBoundsId = 0;
+        FrameRange fAbsRange = FrameRange::INVALID;
+        QRectF fBounds;
+        bool fKnown = false;
+    };
+
+    struct Node {
+        QRectF fBounds;
+        bool fKnown;
+        // span in mOrder
+        int fFirst;
+        int fCount;
+        int fLeft = -1;
+        int fRight = -1;
+    };
+
+    bool updateLeaf(Leaf& leaf, const qreal absFrame);
+    int build(const int first, const int count);
+    void fit(const int nodeId);
+    void refit(const int nodeId);
+    void query(const int nodeId, const QRectF& rect,
+               std::vector<bool>& visible) const;
+
+    std::vector<Leaf> mLeaves;
+    std::vector<int> mOrder;
+    std::vector<Node> mNodes;
+    int mRefits = 0;
+};
+
+#endif // CHILDRENBVH_H
@@ -26,6 +26,7 @@
 #include "containerbox.h"
 #include "Timeline/durationrectangle.h"
 #include "Animators/transformanimator.h"
+#include "Animators/qrealanimator.h"
 #include "canvas.h"
 #include "internallinkgroupbox.h"
 #include "PathEffects/patheffectcollection.h"
@@ -371,7 +372,19 @@ void ContainerBox::forcedMarginMeaningfulChange() {
     }
 }
 
+QRect ContainerBox::sBoundsOverride;
+
+ContainerBox::BoundsOverride::BoundsOverride(const QRect& bounds) :
+    mPrevious(sBoundsOverride) {
+    sBoundsOverride = bounds;
+}
+
+ContainerBox::BoundsOverride::~BoundsOverride() {
+    sBoundsOverride = mPrevious;
+}
+
 QRect ContainerBox::currentGlobalBounds() const {
+    if(sBoundsOverride.isValid()) return sBoundsOverride;
     const auto pScene = getParentScene();
     if(!pScene) return QRect();
     const auto sceneBounds = pScene->getCurrentBounds();
@@ -381,6 +394,25 @@ QRect ContainerBox::currentGlobalBounds() const {
                                 mForcedMargin.bottom());
 }
 
+void ContainerBox::cullContained(const qreal absFrame, const QMatrix& thisM,
+                                 const qreal resolution,
+                                 std::vector<bool>& visible) {
+    visible.assign(static_cast<size_t>(mContainedBoxes.count()), true);
+    if(!getParentScene() || !thisM.isInvertible()) return;
+    // path effects of the groups are applied to the contained paths
+    for(auto group = this; group; group = group->getParentGroup()) {
+        if(group->hasBasePathEffects() || group->hasFillEffects() ||
+           group->hasOutlineBaseEffects() || group->hasOutlineEffects()) {
+            return;
+        }
+    }
+    const qreal margin = 2/resolution + 1;
+    const auto bounds = QRectF(currentGlobalBounds()).adjusted(
+                -margin, -margin, margin, margin);
+    const auto rect = thisM.inverted().mapRect(bounds);
+    mChildrenBvh.cull(mContainedBoxes, absFrame, rect, visible);
+}
+
 void ContainerBox::queChildrenTasks() {
     for(const auto &child : mContainedBoxes)
         child->queTasks();
@@ -536,6 +568,20 @@ void ContainerBox::allDescendantsStartingWith(
     }
 }
 
+void ContainerBox::prefetchExpressions(const FrameRange& absRange) {
+    const auto op = [&absRange](Property* const prop) {
+        if(const auto qa = enve_cast<QrealAnimator*>(prop)) {
+            qa->prefetchExpression(absRange);
+        }
+    };
+    ca_execOnDescendants(op);
+    for(const auto box : mContainedBoxes) {
+        if(enve_cast<ContainerBox*>(box)) {
+            static_cast<ContainerBox*>(box)->prefetchExpressions(absRange);
+        } else box->ca_execOnDescendants(op);
+    }
+}
+
 void ContainerBox::allContainedStartingWith(
         const QString &text, QList<eBoxOrSound*> &result) {
     for(const auto &child : mContained) {
@@ -644,6 +690,21 @@ FrameRange ContainerBox::prp_getIdenticalRelRange(const int relFrame) const {
     return range;
 }
 
+FrameRange ContainerBox::getRelRectIdenticalRelRange(const int relFrame) const {
+    auto range = BoundingBox::getRelRectIdenticalRelRange(relFrame);
+    const int absFrame = prp_relFrameToAbsFrame(relFrame);
+    const auto minMax = getContainedMinMax();
+    for(int i = minMax.fMin; i <= minMax.fMax; i++) {
+        const auto& child = mContainedBoxes.at(i);
+        if(range.isUnary()) return range;
+        auto childRange = child->prp_getIdenticalRelRange(
+                    child->prp_absFrameToRelFrame(absFrame));
+        auto childAbsRange = child->prp_relRangeToAbsRange(childRange);
+        range *= prp_absRangeToRelRange(childAbsRange);
+    }
+    return range;
+}
+
 FrameRange ContainerBox::getMotionBlurIdenticalRange(
         const qreal relFrame, const bool inheritedTransform) {
     FrameRange range = BoundingBox::getMotionBlurIdenticalRange(
@@ -698,6 +759,7 @@ bool ContainerBox::isFlipBook() const {
 }
 
 void ContainerBox::updateContainedBoxes() {
+    mChildrenBvh.clear();
     mContainedBoxes.clear();
     for(const auto& child : mContained) {
         if(const auto box = enve_cast<BoundingBox*>(child)) {
@@ -972,11 +1034,22 @@ void ContainerBox::updateIfUsesProgram(
     BoundingBox::updateIfUsesProgram(program);
 }
 
+static bool blendEffectsInGroup(const ContainerBox * const group) {
+    for(const auto box : group->getContainedBoxes()) {
+        if(box->hasEnabledBlendEffects()) return true;
+        if(!box->isGroup()) continue;
+        const auto childGroup = static_cast<ContainerBox*>(box);
+        if(blendEffectsInGroup(childGroup)) return true;
+    }
+    return false;
+}
+
 void processChildData(BoundingBox * const child,
                       ContainerBoxRenderData * const parentData,
                       const qreal childRelFrame,
                       const QMatrix& thisM,
                       const qreal absFrame,
+                      const bool cull,
                       QList<ChildRenderData>& delayed) {
     if(!child->isFrameFVisibleAndInDurationRect(childRelFrame)) return;
     if(child->isGroup()) {
@@ -985,11 +1058,17 @@ void processChildData(BoundingBox * const child,
         const auto childM = childRelM*thisM;
         const auto& descs = childGroup->getContainedBoxes();
         const auto minMax = childGroup->getContainedMinMax();
+        std::vector<bool> visible(static_cast<size_t>(descs.count()), true);
+        if(cull) {
+            childGroup->cullContained(absFrame, childM,
+                                      parentData->fResolution, visible);
+        }
         for(int i = minMax.fMax; i >= minMax.fMin; i--) {
+            if(!visible[static_cast<size_t>(i)]) continue;
             const auto& desc = descs.at(i);
             const qreal descRelFrame = desc->prp_absFrameToRelFrameF(absFrame);
             processChildData(desc, parentData, descRelFrame,
-                             childM, absFrame, delayed);
+                             childM, absFrame, cull, delayed);
         }
         return;
     }
@@ -1023,11 +1102,16 @@ void ContainerBox::processChildrenData(const qreal relFrame,
     const qreal absFrame = prp_relFrameToAbsFrameF(relFrame);
     QList<ChildRenderData> delayed;
     const auto minMax = getContainedMinMax();
+    // blend effects can clip or move boxes within the whole subtree
+    const bool cull = !blendEffectsInGroup(this);
+    std::vector<bool> visible(static_cast<size_t>(mContainedBoxes.count()), true);
+    if(cull) cullContained(absFrame, thisM, data->fResolution, visible);
     for(int i = minMax.fMax; i >= minMax.fMin; i--) {
+        if(!visible[static_cast<size_t>(i)]) continue;
         const auto& box = mContainedBoxes.at(i);
         const qreal boxRelFrame = box->prp_absFrameToRelFrameF(absFrame);
         processChildData(box, groupData, boxRelFrame,
-                         thisM, absFrame, delayed);
+                         thisM, absFrame, cull, delayed);
     }
     for(auto& del : delayed) {
         auto& iClip = del.fClip;
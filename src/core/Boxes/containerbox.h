@@ -27,6 +27,7 @@
 #define CONTAINERBOX_H
 #include "boxwithpatheffects.h"
 #include "conncontextobjlist.h"
+#include "childrenbvh.h"
 
 class PathBox;
 class PathEffectCollection;
@@ -98,6 +99,7 @@ public:
     void setupCanvasMenu(PropertyMenu * const menu);
 
     FrameRange prp_getIdenticalRelRange(const int relFrame) const;
+    FrameRange getRelRectIdenticalRelRange(const int relFrame) const;
     FrameRange getMotionBlurIdenticalRange(
             const qreal relFrame, const bool inheritedTransform);
 
@@ -169,6 +171,19 @@ public:
 
     void forcedMarginMeaningfulChange();
     QRect currentGlobalBounds() const;
+    //! @brief Makes currentGlobalBounds() return bounds while it exists,
+    //! contained boxes set up meanwhile are culled and clipped at them
+    class BoundsOverride {
+    public:
+        BoundsOverride(const QRect& bounds);
+        ~BoundsOverride();
+    private:
+        const QRect mPrevious;
+    };
+    //! @brief Marks the contained boxes that can be visible
+    //! within currentGlobalBounds, thisM maps to the scene
+    void cullContained(const qreal absFrame, const QMatrix& thisM,
+                       const qreal resolution, std::vector<bool>& visible);
 
     bool diffsAffectingContainedBoxes(const int relFrame1,
                                       const int relFrame2);
@@ -239,6 +254,8 @@ public:
     void allContainedStartingWith(
             const QString& text, QList<eBoxOrSound*> &result);
 
+    void prefetchExpressions(const FrameRange& absRange);
+
     void addBoxWithBlendEffects(BoundingBox* const box)
     { mBoxesWithBlendEffects << box; }
     void removeBoxWithBlendEffects(BoundingBox* const box)
@@ -286,6 +303,8 @@ private:
     void updateRelBoundingRect();
     void removeContained(const qsptr<eBoxOrSound> &child);
 
+    static QRect sBoundsOverride;
+
     QMargins mForcedMargin;
     
     bool mIsLayer = false;
@@ -293,6 +312,7 @@ private:
     bool mIsDescendantCurrentGroup = false;
     QList<BoundingBox*> mBoxesWithBlendEffects;
     QList<BoundingBox*> mContainedBoxes;
+    ChildrenBvh mChildrenBvh;
     QList<qsptr<BlendEffectBoxShadow>> mBlendShadows;
     ConnContextObjList<qsptr<eBoxOrSound>> mContained;
     qsptr<FlipBookProperty> mFlipBook;
@@ -27,6 +27,7 @@
 #include "boxrenderdata.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "skia/skiaincludes.h"
+#include "skia/pixelbufferpool.h"
 #include "RasterEffects/rastereffect.h"
 #include "RasterEffects/rastereffectcaller.h"
 #include "Private/Tasks/taskexecutor.h"
@@ -59,10 +60,16 @@ private:
 void EffectSubTaskSpawner_priv::initialize() {
     SkPixmap pixmap;
     const auto& srcImg = mData->fRenderedImage;
-    mSrcRasterImg = srcImg->makeRasterImage();
+    // in place effects write to the source pixels, copy them on write
+    const bool copy = !mUseDst && mData->fRenderedImageShared;
+    if(copy || srcImg->isTextureBacked()) {
+        mSrcRasterImg = PixelBufferPool::makeRasterCopy(srcImg);
+    } else mSrcRasterImg = srcImg->makeRasterImage();
     mSrcRasterImg->peekPixels(&pixmap);
     mSrcBitmap.installPixels(pixmap);
-    if(mUseDst) mDstBitmap.allocPixels(mSrcBitmap.info());
+    if(mUseDst && !PixelBufferPool::allocPixels(mDstBitmap, mSrcBitmap.info())) {
+        RuntimeThrow("Could not allocate the effect destination pixels");
+    }
     spawn();
 }
 
@@ -142,6 +149,7 @@ void EffectSubTaskSpawner_priv::decRemaining_k() {
         } else {
             mData->fRenderedImage = mSrcRasterImg;
         }
+        mData->fRenderedImageShared = false;
         if(mData->nextStep()) {
             mData->queTask();
         } else {
@@ -155,5 +163,10 @@ void EffectSubTaskSpawner_priv::decRemaining_k() {
 void EffectSubTaskSpawner::sSpawn(const stdsptr<RasterEffectCaller> &effect,
                                   const stdsptr<BoxRenderData> &data) {
     const auto spawner = new EffectSubTaskSpawner_priv(effect, data);
-    spawner->initialize();
+    try {
+        spawner->initialize();
+    } catch(...) {
+        delete spawner;
+        throw;
+    }
 }
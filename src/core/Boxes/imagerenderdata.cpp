@@ -51,6 +51,7 @@ void ImageRenderData::setupDirectDraw() {
     fRenderTransform.translate(-fGlobalRect.x(), -fGlobalRect.y());
     fUseRenderTransform = true;
     fRenderedImage = fImage;
+    fRenderedImageShared = true;
     fAntiAlias = true;
     finishedProcessing();
 }
@@ -68,13 +69,5 @@ void ImageRenderData::drawSk(SkCanvas * const canvas) {
 
 void ImageContainerRenderData::setContainer(ImageCacheContainer *container) {
     if(!container) return;
-    mSrcContainer = container;
-    fImage = container->requestImageCopy();
-}
-
-void ImageContainerRenderData::afterProcessing() {
-    BoxRenderData::afterProcessing();
-    if(mSrcContainer && fImage) {
-        mSrcContainer->addImageCopy(fImage);
-    }
+    fImage = container->getImage();
 }
@@ -48,11 +48,8 @@ public:
     using ImageRenderData::ImageRenderData;
 
     void setContainer(ImageCacheContainer* container);
-
-    void afterProcessing();
 private:
     using ImageRenderData::fImage;
-    stdptr<ImageCacheContainer> mSrcContainer;
 };
 
 #endif // IMAGERENDERDATA_H
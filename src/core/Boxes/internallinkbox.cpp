@@ -31,6 +31,43 @@
 #include "skia/skiahelpers.h"
 #include "videobox.h"
 #include "Sound/evideosound.h"
+#include "containerbox.h"
+#include "RasterEffects/rastereffectcollection.h"
+
+#include <QHash>
+#include <QPointer>
+
+#include <cmath>
+
+// links may scale the target image up by this much without re-rendering
+#define MAX_INSTANCE_UPSCALE 1.05
+
+namespace {
+    // renders of link targets, shared by all links to a target
+    struct InstanceSource {
+        QPointer<BoundingBox> fTarget;
+        stdptr<BoxRenderData> fData;
+        // target placement area rendered by fData, in scene units
+        QRectF fCover;
+        // target placement area shown by the links using fData
+        QRectF fShown;
+    };
+    QHash<const BoundingBox*, InstanceSource> sInstanceSources;
+
+    bool isTranslation(const QMatrix& m) {
+        return isZero4Dec(m.m11() - 1) && isZero4Dec(m.m22() - 1) &&
+               isZero4Dec(m.m12()) && isZero4Dec(m.m21());
+    }
+
+    // largest singular value of the linear part of m
+    qreal maxStretch(const QMatrix& m) {
+        const qreal sum = m.m11()*m.m11() + m.m12()*m.m12() +
+                          m.m21()*m.m21() + m.m22()*m.m22();
+        const qreal det = m.determinant();
+        const qreal disc = qMax(0., sum*sum - 4*det*det);
+        return std::sqrt(0.5*(sum + std::sqrt(disc)));
+    }
+}
 
 InternalLinkBox::InternalLinkBox(BoundingBox * const linkTarget,
                                  const bool innerLink) :
@@ -45,6 +82,13 @@ void InternalLinkBox::setLinkTarget(BoundingBox * const linkTarget) {
     mSound.reset();
     auto& conn = assignLinkTarget(linkTarget);
     mBoxTarget->setTargetAction(linkTarget);
+    if(linkTarget) {
+        // hidden targets do not update their state id
+        conn << connect(linkTarget, &Property::prp_absFrameRangeChanged,
+                        this, [linkTarget]() {
+            sInstanceSources.remove(linkTarget);
+        });
+    }
     if(const auto vidBox = enve_cast<VideoBox*>(linkTarget)) {
         mSound = vidBox->sound()->createLink();
         conn << connect(this, &eBoxOrSound::parentChanged,
@@ -59,6 +103,88 @@ void InternalLinkBox::setupRenderData(const qreal relFrame,
                                       BoxRenderData * const data,
                                       Canvas* const scene) {
     const auto linkTarget = getLinkTarget();
-    if(linkTarget) linkTarget->setupRenderData(relFrame, parentM, data, scene);
+    if(linkTarget) {
+        const auto src = instanceSource(linkTarget, relFrame,
+                                        parentM, data, scene);
+        if(src) data->setInstanceSource(src);
+        else linkTarget->setupRenderData(relFrame, parentM, data, scene);
+    }
     BoundingBox::setupRenderData(relFrame, parentM, data, scene);
 }
+
+stdsptr<BoxRenderData> InternalLinkBox::instanceSource(
+        BoundingBox * const linkTarget, const qreal relFrame,
+        const QMatrix& parentM, BoxRenderData * const data,
+        Canvas * const scene) {
+    if(!scene || data->fForceRasterize) return nullptr;
+    // effects of the link itself need the image in its own pixels
+    if(mRasterEffectsAnimators->hasEffects()) return nullptr;
+    // target effects are skipped when it is transparent
+    if(linkTarget->getOpacity(relFrame) <= 0.001) return nullptr;
+
+    const qreal res = scene->getResolution();
+    QMatrix resScale;
+    resScale.scale(res, res);
+    const auto targetM = linkTarget->getTotalTransformAtFrame(relFrame);
+    if(!targetM.isInvertible()) return nullptr;
+    const auto linkM = getRelativeTransformAtFrame(relFrame)*parentM;
+    if(!linkM.isInvertible()) return nullptr;
+    // upscaling the target image would be visibly blurry
+    const auto srcToLinkM = targetM.inverted()*linkM;
+    if(maxStretch(srcToLinkM) > MAX_INSTANCE_UPSCALE) return nullptr;
+    // target effects are computed in the pixels of its placement
+    if(linkTarget->hasRasterEffects() && !isTranslation(srcToLinkM)) {
+        return nullptr;
+    }
+
+    // area of the target placement the link can show
+    const auto parent = getParentGroup();
+    const QRectF linkBounds = parent ? parent->currentGlobalBounds() :
+                                       scene->getCurrentBounds();
+    const auto shown = (linkM.inverted()*targetM).mapRect(linkBounds);
+
+    for(auto it = sInstanceSources.begin(); it != sInstanceSources.end();) {
+        if(it->fTarget) it++;
+        else it = sInstanceSources.erase(it);
+    }
+    auto& entry = sInstanceSources[linkTarget];
+    const auto& cached = entry.fData;
+    const bool current = cached && cached->fParentBox == linkTarget &&
+                         cached->fBoxStateId == linkTarget->stateId() &&
+                         isZero4Dec(cached->fRelFrame - relFrame) &&
+                         cached->fTotalTransform == targetM &&
+                         isZero4Dec(cached->fResolution - res) &&
+                         !cached->waitingToCancel() &&
+                         cached->getState() != eTaskState::canceled;
+    if(current && entry.fCover.contains(shown)) {
+        entry.fShown |= shown;
+        return cached->ref<BoxRenderData>();
+    }
+    if(current) {
+        // links that need more of the target get a larger render
+        entry.fShown |= shown;
+        entry.fCover |= shown;
+    } else {
+        // cover what the links showed in the previous render
+        entry.fCover = entry.fShown | shown;
+        entry.fShown = shown;
+    }
+    entry.fTarget = linkTarget;
+
+    const auto src = linkTarget->createRenderData(relFrame);
+    if(!src) return nullptr;
+    src->fParentIsTarget = false;
+    const auto targetParentM = linkTarget->getInheritedTransformAtFrame(relFrame);
+    {
+        // contained boxes are culled and clipped at the covered area
+        const ContainerBox::BoundsOverride bounds(entry.fCover.toAlignedRect());
+        linkTarget->setupRenderData(relFrame, targetParentM, src.get(), scene);
+    }
+    // the opacity of the link is used when drawing
+    src->fOpacity = 1;
+    src->fMaxBoundsRect = resScale.mapRect(entry.fCover).toAlignedRect();
+    src->queTask();
+
+    entry.fData = src.get();
+    return src;
+}
@@ -47,6 +47,12 @@ protected:
     const qsptr<BoxTargetProperty> mBoxTarget =
             enve::make_shared<BoxTargetProperty>("link target");
 private:
+    stdsptr<BoxRenderData> instanceSource(BoundingBox * const linkTarget,
+                                          const qreal relFrame,
+                                          const QMatrix& parentM,
+                                          BoxRenderData * const data,
+                                          Canvas * const scene);
+
     qsptr<eSound> mSound;
 };
 
@@ -41,6 +41,7 @@ public:
 
     FrameRange prp_getIdenticalRelRange(const int relFrame) const override;
     FrameRange prp_relInfluenceRange() const override;
+    FrameRange getRelRectIdenticalRelRange(const int relFrame) const override;
     int prp_getRelFrameShift() const override;
 
     void writeBoundingBox(eWriteStream& dst) const override
@@ -227,6 +228,14 @@ FrameRange ILBB::prp_getIdenticalRelRange(const int relFrame) const {
     return range*targetRange;
 }
 
+template <typename BoxT>
+FrameRange ILBB::getRelRectIdenticalRelRange(const int relFrame) const {
+    const auto range = BoxT::getRelRectIdenticalRelRange(relFrame);
+    const auto linkTarget = getLinkTarget();
+    if(!linkTarget) return range;
+    return range*linkTarget->prp_getIdenticalRelRange(relFrame);
+}
+
 template <typename BoxT>
 FrameRange ILBB::prp_relInfluenceRange() const {
     const auto linkTarget = getLinkTarget();
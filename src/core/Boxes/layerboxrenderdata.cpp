@@ -74,6 +74,18 @@ void ContainerBoxRenderData::updateRelBoundingRect() {
 }
 
 void ContainerBoxRenderData::drawSk(SkCanvas * const canvas) {
+    addChildrenProcessingUs();
+    drawChildren(canvas);
+}
+
+void ContainerBoxRenderData::addChildrenProcessingUs() {
+    // rendering the children is part of the cost of this image
+    for(const auto &child : fChildrenRenderData) {
+        addProcessingUs(child->processingUs());
+    }
+}
+
+void ContainerBoxRenderData::drawChildren(SkCanvas * const canvas) {
     for(const auto &child : fChildrenRenderData) {
         canvas->save();
         if(!child.fClip.fClipOps.isEmpty()) {
@@ -71,6 +71,9 @@ protected:
     void drawSk(SkCanvas * const canvas);
     void transformRenderCanvas(SkCanvas& canvas) const final;
     void updateRelBoundingRect();
+
+    void addChildrenProcessingUs();
+    void drawChildren(SkCanvas * const canvas);
 };
 
 #endif // CONTAINERBOXRENDERDATA_H
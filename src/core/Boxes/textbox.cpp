@@ -34,6 +34,7 @@
 #include "Animators/transformanimator.h"
 #include "Animators/outlinesettingsanimator.h"
 #include "textboxrenderdata.h"
+#include "textlayoutcache.h"
 #include "pathboxrenderdata.h"
 #include "ReadWrite/evformat.h"
 #include "svgexporter.h"
@@ -282,7 +283,7 @@ void TextBox::textToPath(const qreal x, const qreal y,
         qpath.addText(x, y, mQFont, text);
         path = toSkPath(qpath);
     } else {
-        SkiaHelpers::textToPath(mFont, x, y, text, path);
+        TextLayoutCache::path(mFont, x, y, text, path);
     }
 }
 
@@ -368,7 +369,7 @@ SkPath TextBox::getRelativePath(const qreal relFrame) const {
                 }
                 const QString letter = line.mid(i, 1);
                 SkPath letterPath;
-                SkiaHelpers::textToPath(mFont, xPos, lineY, letter, letterPath);
+                TextLayoutCache::path(mFont, xPos, lineY, letter, letterPath);
                 result.addPath(letterPath);
 
                 xPos += horizontalAdvance(mFont, letter) + letterSpacing*fontSize;
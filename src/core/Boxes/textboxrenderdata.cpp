@@ -25,6 +25,7 @@
 
 #include "textboxrenderdata.h"
 #include "textbox.h"
+#include "textlayoutcache.h"
 #include "PathEffects/patheffectstask.h"
 #include "canvas.h"
 
@@ -41,39 +42,67 @@ qreal textLineX(const Qt::Alignment &alignment,
 }
 
 qreal horizontalAdvance(const SkFont& font, const QString& str) {
-    const SkScalar result = font.measureText(str.utf16(),
-                                             str.size()*sizeof(short),
-                                             SkTextEncoding::kUTF16);
-    return static_cast<qreal>(result);
+    return TextLayoutCache::advance(font, str);
 }
 
 qreal horizontalAdvance(const SkFont& font, const QString& str,
                         const qreal letterSpacing) {
-    SkScalar result = font.measureText(str.utf16(),
-                                       str.size()*sizeof(short),
-                                       SkTextEncoding::kUTF16);
     const qreal fontSize = static_cast<qreal>(font.getSize());
-    result += static_cast<SkScalar>(fontSize*letterSpacing*str.length());
-    return static_cast<qreal>(result);
+    return TextLayoutCache::advance(font, str) +
+            fontSize*letterSpacing*str.length();
 }
 
 qreal horizontalAdvance(const SkFont& font, const QString& str,
                         const qreal letterSpacing, const qreal wordSpacing) {
-    SkScalar result = font.measureText(str.utf16(),
-                                       str.size()*sizeof(short),
-                                       SkTextEncoding::kUTF16);
+    qreal result = TextLayoutCache::advance(font, str);
     const qreal fontSize = static_cast<qreal>(font.getSize());
     const int nSpaces = str.count(" ");
     if(nSpaces > 0) {
-        const char spaceChar = ' ';
-        const SkScalar space = font.measureText(
-                    &spaceChar, sizeof(char),
-                    SkTextEncoding::kUTF8);
-        result += nSpaces*space*static_cast<SkScalar>(wordSpacing - 1);
+        const qreal space = TextLayoutCache::advance(font, " ");
+        result += nSpaces*space*(wordSpacing - 1);
     }
     const int nNonSpaces = str.length() - nSpaces;
-    result += static_cast<SkScalar>(fontSize*letterSpacing*nNonSpaces);
-    return static_cast<qreal>(result);
+    result += fontSize*letterSpacing*nNonSpaces;
+    return result;
+}
+
+namespace {
+    // same fields as BoundingBox::setupWithoutRasterEffects
+    void copyBoxSetup(const BoxRenderData& src, BoxRenderData& dst) {
+        dst.fBoxStateId = src.fBoxStateId;
+        dst.fBoxEditId = src.fBoxEditId;
+        dst.fRelFrame = src.fRelFrame;
+        dst.fRelTransform = src.fRelTransform;
+        dst.fInheritedTransform = src.fInheritedTransform;
+        dst.fTotalTransform = src.fTotalTransform;
+        dst.fResolution = src.fResolution;
+        dst.fResolutionScale = src.fResolutionScale;
+        dst.fOpacity = src.fOpacity;
+        dst.fBaseMargin = src.fBaseMargin;
+        dst.fBlendMode = src.fBlendMode;
+        dst.fMaxBoundsRect = src.fMaxBoundsRect;
+    }
+}
+
+LetterSetup::LetterSetup(const qreal relFrame,
+                         TextBox * const parent,
+                         Canvas * const scene) :
+    fRelFrame(relFrame), fParent(parent), fScene(scene),
+    fPrototype(enve::make_shared<LetterRenderData>(parent)) {
+    const auto parentM = parent->getInheritedTransformAtFrame(relFrame);
+    parent->BoundingBox::setupWithoutRasterEffects(
+                relFrame, parentM, fPrototype.get(), scene);
+    parent->setupPaintSettings(fPrototype.get(), relFrame);
+    parent->setupStrokerSettings(fPrototype.get(), relFrame);
+    parent->addPathEffects(relFrame, scene,
+                           fPrototype->fPathEffects,
+                           fPrototype->fFillEffects,
+                           fPrototype->fOutlineBaseEffects,
+                           fPrototype->fOutlineEffects);
+    fPathEffects = !fPrototype->fPathEffects.isEmpty() ||
+                   !fPrototype->fFillEffects.isEmpty() ||
+                   !fPrototype->fOutlineBaseEffects.isEmpty() ||
+                   !fPrototype->fOutlineEffects.isEmpty();
 }
 
 LetterRenderData::LetterRenderData(TextBox * const parent) :
@@ -94,31 +123,41 @@ void LetterRenderData::afterQued() {
     BoxRenderData::afterQued();
 }
 
-void LetterRenderData::initialize(const qreal relFrame,
-                                  const QPointF &pos,
+void LetterRenderData::initialize(const QPointF &pos,
                                   const QString &letter,
                                   const SkFont &font,
-                                  TextBox * const parent,
-                                  Canvas * const scene) {
+                                  LetterSetup &setup) {
     fOriginalPos = pos;
     fLetterPos = pos;
-    const auto parentM = parent->getInheritedTransformAtFrame(relFrame);
-    parent->BoundingBox::setupWithoutRasterEffects(
-                relFrame, parentM, this, scene);
-    parent->setupPaintSettings(this, relFrame);
-    parent->setupStrokerSettings(this, relFrame);
-    SkPath textPath;
-    SkiaHelpers::textToPath(font, pos.x(), pos.y(), letter, textPath);
-
-    fPath = textPath;
-    fEditPath = textPath;
-    fFillPath = textPath;
-    fOutlineBasePath = textPath;
-    fStroker.strokePath(fOutlineBasePath, &fOutlinePath);
-
-    parent->addPathEffects(relFrame, scene, fPathEffects, fFillEffects,
-                           fOutlineBaseEffects, fOutlineEffects);
-
+    const auto& proto = *setup.fPrototype;
+    copyBoxSetup(proto, *this);
+    fPaintSettings = proto.fPaintSettings;
+    fStrokeSettings = proto.fStrokeSettings;
+    fStroker = proto.fStroker;
+
+    const auto x = static_cast<SkScalar>(pos.x());
+    const auto y = static_cast<SkScalar>(pos.y());
+    SkPath letterPath;
+    TextLayoutCache::path(font, 0, 0, letter, letterPath);
+    auto outline = setup.fOutlines.find(letter);
+    if(outline == setup.fOutlines.end()) {
+        SkPath letterOutline;
+        fStroker.strokePath(letterPath, &letterOutline);
+        outline = setup.fOutlines.insert(letter, letterOutline);
+    }
+    letterPath.offset(x, y);
+    outline->offset(x, y, &fOutlinePath);
+
+    fPath = letterPath;
+    fEditPath = letterPath;
+    fFillPath = letterPath;
+    fOutlineBasePath = letterPath;
+
+    if(setup.fPathEffects) {
+        setup.fParent->addPathEffects(setup.fRelFrame, setup.fScene,
+                                      fPathEffects, fFillEffects,
+                                      fOutlineBaseEffects, fOutlineEffects);
+    }
 }
 
 void LetterRenderData::applyTransform(const QMatrix &transform) {
@@ -132,16 +171,12 @@ WordRenderData::WordRenderData(TextBox * const parent) :
     fParentIsTarget = false;
 }
 
-void WordRenderData::initialize(const qreal relFrame,
-                                const QPointF &pos,
+void WordRenderData::initialize(const QPointF &pos,
                                 const QString &word,
                                 const SkFont &font,
                                 const qreal letterSpacing,
-                                TextBox * const parent,
-                                Canvas * const scene) {
-    const auto parentM = parent->getInheritedTransformAtFrame(relFrame);
-    parent->BoundingBox::setupWithoutRasterEffects(
-                relFrame, parentM, this, scene);
+                                LetterSetup &setup) {
+    copyBoxSetup(*setup.fPrototype, *this);
 
     fOriginalPos = pos;
     fWordPos = pos;
@@ -150,9 +185,8 @@ void WordRenderData::initialize(const qreal relFrame,
     const qreal spacingAdd = static_cast<qreal>(font.getSize())*letterSpacing;
 
     for(const auto& letterStr : word) {
-        const auto letter = enve::make_shared<LetterRenderData>(parent);
-        letter->initialize(relFrame, QPointF(xPos, pos.y()),
-                           letterStr, font, parent, scene);
+        const auto letter = enve::make_shared<LetterRenderData>(setup.fParent);
+        letter->initialize(QPointF(xPos, pos.y()), letterStr, font, setup);
 
         fLetters << letter;
 
@@ -183,30 +217,30 @@ LineRenderData::LineRenderData(TextBox * const parent) :
     fParentIsTarget = false;
 }
 
-void LineRenderData::initialize(const qreal relFrame,
-                                const QPointF &pos,
+void LineRenderData::initialize(const QPointF &pos,
                                 const QString &line,
                                 const SkFont &font,
                                 const qreal letterSpacing,
                                 const qreal wordSpacing,
-                                TextBox * const parent,
-                                Canvas * const scene) {
+                                LetterSetup &setup) {
     fOriginalPos = pos;
     fLinePos = pos;
     fString = line;
-    const auto parentM = parent->getInheritedTransformAtFrame(relFrame);
-    parent->BoundingBox::setupRenderData(relFrame, parentM, this, scene);
+    const auto parent = setup.fParent;
+    const qreal relFrame = setup.fRelFrame;
+    const auto parentM = setup.fPrototype->fInheritedTransform;
+    parent->BoundingBox::setupRenderData(relFrame, parentM, this, setup.fScene);
 
     qreal xPos = pos.x();
     const qreal spaceX = horizontalAdvance(font, " ")*wordSpacing;
 
     const auto wordFinished =
-            [this, &xPos, &pos, &line, &font, parent, relFrame,
-            letterSpacing, scene](const int i0, const int i) {
+            [this, &xPos, &pos, &line, &font, &setup,
+            letterSpacing](const int i0, const int i) {
         const QString wordStr = line.mid(i0, i - i0 + 1);
-        const auto word = enve::make_shared<WordRenderData>(parent);
-        word->initialize(relFrame, QPointF(xPos, pos.y()), wordStr, font,
-                         letterSpacing, parent, scene);
+        const auto word = enve::make_shared<WordRenderData>(setup.fParent);
+        word->initialize(QPointF(xPos, pos.y()), wordStr, font,
+                         letterSpacing, setup);
         fWords << word;
         fChildrenRenderData << word;
         xPos += horizontalAdvance(font, wordStr, letterSpacing);
@@ -283,14 +317,15 @@ void TextBoxRenderData::initialize(const QString &text,
     else if(vAlignment == Qt::AlignBottom) yTranslate = -height;
     else /*if(vAlignment == Qt::AlignCenter)*/ yTranslate = -0.5*height;
 
+    LetterSetup setup(fRelFrame, parent, scene);
     qreal yPos = yTranslate;
     for(const auto& lineStr : lines) {
         const qreal lineWidth = horizontalAdvance(font, lineStr, letterSpacing,
                                                   wordSpacing);
         const qreal xPos = textLineX(hAlignment, lineWidth, maxWidth) + xTranslate;
         const auto line = enve::make_shared<LineRenderData>(parent);
-        line->initialize(fRelFrame, QPointF(xPos, yPos), lineStr,
-                         font, letterSpacing, wordSpacing, parent, scene);
+        line->initialize(QPointF(xPos, yPos), lineStr,
+                         font, letterSpacing, wordSpacing, setup);
         fLines << line;
         fChildrenRenderData << line;
         yPos += lineInc;
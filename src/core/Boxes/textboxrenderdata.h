@@ -28,6 +28,8 @@
 #include "layerboxrenderdata.h"
 #include "pathboxrenderdata.h"
 
+#include <QHash>
+
 class TextBox;
 class PathEffectCaller;
 
@@ -42,18 +44,34 @@ extern qreal horizontalAdvance(const SkFont& font, const QString& str,
 extern qreal horizontalAdvance(const SkFont& font, const QString& str,
                                const qreal letterSpacing, const qreal wordSpacing);
 
+class LetterRenderData;
+
+// TextBox state at a frame, evaluated once and copied to every word and
+// letter, only their paths and the TextEffect transforms differ
+struct CORE_EXPORT LetterSetup {
+    LetterSetup(const qreal relFrame,
+                TextBox * const parent,
+                Canvas * const scene);
+
+    const qreal fRelFrame;
+    TextBox * const fParent;
+    Canvas * const fScene;
+    stdsptr<LetterRenderData> fPrototype;
+    bool fPathEffects = false;
+    // stroked letter outlines with the baseline origin at 0, 0
+    QHash<QString, SkPath> fOutlines;
+};
+
 class CORE_EXPORT LetterRenderData : public PathBoxRenderData {
 public:
     LetterRenderData(TextBox* const parent);
 
     void afterQued();
 
-    void initialize(const qreal relFrame,
-                    const QPointF &pos,
+    void initialize(const QPointF &pos,
                     const QString &letter,
                     const SkFont &font,
-                    TextBox * const parent,
-                    Canvas * const scene);
+                    LetterSetup &setup);
 
     void applyTransform(const QMatrix& transform);
 
@@ -71,13 +89,11 @@ class CORE_EXPORT WordRenderData : public ContainerBoxRenderData {
 public:
     WordRenderData(TextBox* const parent);
 
-    void initialize(const qreal relFrame,
-                    const QPointF& pos,
+    void initialize(const QPointF& pos,
                     const QString& word,
                     const SkFont &font,
                     const qreal letterSpacing,
-                    TextBox * const parent,
-                    Canvas * const scene);
+                    LetterSetup &setup);
 
     void applyTransform(const QMatrix &transform);
     void queAllLetters();
@@ -92,14 +108,12 @@ class CORE_EXPORT LineRenderData : public ContainerBoxRenderData {
 public:
     LineRenderData(TextBox* const parent);
 
-    void initialize(const qreal relFrame,
-                    const QPointF& pos,
+    void initialize(const QPointF& pos,
                     const QString& line,
                     const SkFont &font,
                     const qreal letterSpacing,
                     const qreal wordSpacing,
-                    TextBox * const parent,
-                    Canvas * const scene);
+                    LetterSetup &setup);
 
     void applyTransform(const QMatrix &transform);
     void queAllWords();
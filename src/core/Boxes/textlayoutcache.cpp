@@ -0,0 +1,127 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "textlayoutcache.h"
+#include "skia/skiahelpers.h"
+
+#include <QHash>
+
+#include <mutex>
+
+// the whole cache is dropped once it grows past this many strings
+#define MAX_ENTRIES 8192
+
+namespace {
+    struct Key {
+        SkFontID fTypeface;
+        SkScalar fSize;
+        SkScalar fScaleX;
+        SkScalar fSkewX;
+        bool fEmbolden;
+        QString fString;
+
+        bool operator==(const Key& other) const {
+            return fTypeface == other.fTypeface &&
+                   fSize == other.fSize &&
+                   fScaleX == other.fScaleX &&
+                   fSkewX == other.fSkewX &&
+                   fEmbolden == other.fEmbolden &&
+                   fString == other.fString;
+        }
+    };
+
+    uint qHash(const Key& key, const uint seed = 0) {
+        uint hash = ::qHash(key.fString, seed);
+        hash ^= ::qHash(key.fTypeface) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= ::qHash(key.fSize) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    struct Entry {
+        SkScalar fAdvance = 0;
+        bool fAdvanceSet = false;
+        bool fPathSet = false;
+        SkPath fPath;
+    };
+
+    std::mutex sMutex;
+    QHash<Key, Entry> sEntries;
+
+    Key makeKey(const SkFont& font, const QString& str) {
+        const auto typeface = font.getTypefaceOrDefault();
+        return {typeface ? typeface->uniqueID() : 0,
+                font.getSize(), font.getScaleX(), font.getSkewX(),
+                font.isEmbolden(), str};
+    }
+
+    Entry& entry(const Key& key) {
+        if(sEntries.count() >= MAX_ENTRIES) sEntries.clear();
+        return sEntries[key];
+    }
+}
+
+// measuring and outlining run unlocked, racing threads at worst
+// compute the same entry twice
+qreal TextLayoutCache::advance(const SkFont& font, const QString& str) {
+    const auto key = makeKey(font, str);
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        const auto it = sEntries.constFind(key);
+        if(it != sEntries.constEnd() && it->fAdvanceSet) {
+            return static_cast<qreal>(it->fAdvance);
+        }
+    }
+    const SkScalar advance = font.measureText(str.utf16(),
+                                              str.size()*sizeof(short),
+                                              SkTextEncoding::kUTF16);
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        auto& ent = entry(key);
+        ent.fAdvance = advance;
+        ent.fAdvanceSet = true;
+    }
+    return static_cast<qreal>(advance);
+}
+
+void TextLayoutCache::path(const SkFont& font, const qreal x, const qreal y,
+                           const QString& str, SkPath& dst) {
+    const auto key = makeKey(font, str);
+    SkPath path;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        const auto it = sEntries.constFind(key);
+        if(it != sEntries.constEnd() && it->fPathSet) {
+            path = it->fPath;
+            found = true;
+        }
+    }
+    if(!found) {
+        SkiaHelpers::textToPath(font, 0, 0, str, path);
+        std::lock_guard<std::mutex> lock(sMutex);
+        auto& ent = entry(key);
+        ent.fPath = path;
+        ent.fPathSet = true;
+    }
+    path.offset(static_cast<SkScalar>(x), static_cast<SkScalar>(y), &dst);
+}
@@ -0,0 +1,46 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include "core_global.h"
+#include "skia/skiaincludes.h"
+
+#include <QString>
+
+// Advances and glyph outlines of strings laid out by TextBox, shared by
+// all frames and letters. Entries are keyed by typeface, font size and
+// string, so only text or font changes measure and outline again.
+namespace TextLayoutCache {
+    //! @brief Same as SkFont::measureText for the whole string
+    CORE_EXPORT
+    qreal advance(const SkFont& font, const QString& str);
+
+    //! @brief Outline of str with the baseline origin at x, y
+    CORE_EXPORT
+    void path(const SkFont& font, const qreal x, const qreal y,
+              const QString& str, SkPath& dst);
+}
+
+#endif // TEXTLAYOUTCACHE_H
@@ -60,6 +60,7 @@ void CacheContainer::updateInMemoryManagment() {
 
 void CacheContainer::incInUse() {
     mInUse++;
+    if(mHandledByMemoryHandler) MemoryDataHandler::sInstance->containerHit();
     removeFromMemoryManagment();
 }
 
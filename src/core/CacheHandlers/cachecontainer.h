@@ -38,6 +38,12 @@ public:
     ~CacheContainer();
 
     virtual int getByteCount() = 0;
+    //! @brief Frames between this container and the range in use
+    virtual int reuseDistance() const { return 0; }
+
+    //! @brief Time it took to produce the data, in microseconds
+    qint64 cost() const { return mCostUs; }
+    void setCost(const qint64 us) { mCostUs = us; }
 protected:
     virtual void noDataLeft_k() = 0;
 private:
@@ -57,6 +63,11 @@ private:
 
     bool mHandledByMemoryHandler = false;
     int mInUse = 0;
+    qint64 mCostUs = 0;
+    // MemoryDataHandler list
+    CacheContainer* mLruPrev = nullptr;
+    CacheContainer* mLruNext = nullptr;
+    qreal mEvictionCredit = 0;
 };
 
 #endif // MINIMALCACHECONTAINER_H
@@ -0,0 +1,261 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "diskcache.h"
+#include "Private/esettings.h"
+
+#include <QDir>
+
+#ifndef Q_OS_WIN
+#include <unistd.h>
+#endif
+
+#define BLOCK_BYTES (256*1024)
+#define SEGMENT_BLOCKS 1024
+// used when eSettings::fHddCacheMBCap is not set
+#define DEFAULT_CAP_MB 4096
+
+static std::atomic<bool> sSuspended{false};
+
+DiskCacheFile::DiskCacheFile() {}
+
+DiskCacheFile::~DiskCacheFile() {
+    DiskCache::instance().release(this);
+}
+
+bool DiskCacheFile::open(OpenMode mode) {
+    if(mInvalid) return false;
+    if(mode & WriteOnly) {
+        // written once, from the start
+        if(mSize > 0) return false;
+    } else if(mSize == 0) return false;
+    mOpened = true;
+    DiskCache::instance().touch(this);
+    if(!QIODevice::open(mode | Unbuffered)) {
+        mOpened = false;
+        return false;
+    }
+    return true;
+}
+
+void DiskCacheFile::close() {
+    QIODevice::close();
+    mOpened = false;
+}
+
+qint64 DiskCacheFile::readData(char *data, qint64 maxSize) {
+    if(mInvalid) return -1;
+    auto& cache = DiskCache::instance();
+    qint64 pos = this->pos();
+    const qint64 toRead = qMin(maxSize, mSize - pos);
+    qint64 done = 0;
+    while(done < toRead) {
+        const int block = mBlocks[static_cast<size_t>(pos/BLOCK_BYTES)];
+        const qint64 offset = pos % BLOCK_BYTES;
+        const qint64 size = qMin(toRead - done, BLOCK_BYTES - offset);
+        if(!cache.read(block, offset, data + done, size)) return -1;
+        done += size;
+        pos += size;
+    }
+    return done;
+}
+
+qint64 DiskCacheFile::writeData(const char *data, qint64 maxSize) {
+    if(mInvalid) return -1;
+    auto& cache = DiskCache::instance();
+    const qint64 capacity = static_cast<qint64>(mBlocks.size())*BLOCK_BYTES;
+    const qint64 missing = mSize + maxSize - capacity;
+    if(missing > 0) {
+        const int nBlocks = static_cast<int>((missing + BLOCK_BYTES - 1)/BLOCK_BYTES);
+        if(!cache.allocate(this, nBlocks)) {
+            mInvalid = true;
+            return -1;
+        }
+    }
+    qint64 done = 0;
+    while(done < maxSize) {
+        const int block = mBlocks[static_cast<size_t>(mSize/BLOCK_BYTES)];
+        const qint64 offset = mSize % BLOCK_BYTES;
+        const qint64 size = qMin(maxSize - done, BLOCK_BYTES - offset);
+        if(!cache.write(block, offset, data + done, size)) {
+            mInvalid = true;
+            return -1;
+        }
+        done += size;
+        mSize += size;
+    }
+    return done;
+}
+
+DiskCache& DiskCache::instance() {
+    static DiskCache sInstance;
+    return sInstance;
+}
+
+bool DiskCache::sEnabled() {
+    return eSettings::instance().fHddCache && !sSuspended;
+}
+
+void DiskCache::sSetSuspended(const bool suspended) {
+    sSuspended = suspended;
+}
+
+bool DiskCache::allocate(DiskCacheFile * const file, const int nBlocks) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    const qint64 capMB = eSettings::instance().fHddCacheMBCap.fValue;
+    const int capBlocks = static_cast<int>(
+                (capMB > 0 ? capMB : DEFAULT_CAP_MB)*1024*1024/BLOCK_BYTES);
+    if(mUsedBlocks + nBlocks > capBlocks) {
+        evictFor(nBlocks, capBlocks);
+        if(mUsedBlocks + nBlocks > capBlocks) return false;
+    }
+    while(static_cast<int>(mFreeBlocks.size()) < nBlocks) {
+        if(!addSegment()) return false;
+    }
+    for(int i = 0; i < nBlocks; i++) {
+        const auto first = mFreeBlocks.begin();
+        file->mBlocks.push_back(*first);
+        mFreeBlocks.erase(first);
+    }
+    mUsedBlocks += nBlocks;
+    if(!file->mInLru) {
+        file->mLru = mLru.insert(mLru.end(), file);
+        file->mInLru = true;
+    }
+    return true;
+}
+
+void DiskCache::release(DiskCacheFile * const file) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(const int block : file->mBlocks) mFreeBlocks.insert(block);
+    mUsedBlocks -= static_cast<int>(file->mBlocks.size());
+    file->mBlocks.clear();
+    if(file->mInLru) {
+        mLru.erase(file->mLru);
+        file->mInLru = false;
+    }
+    removeEmptySegments();
+}
+
+void DiskCache::touch(DiskCacheFile * const file) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(!file->mInLru) return;
+    mLru.splice(mLru.end(), mLru, file->mLru);
+}
+
+void DiskCache::evictFor(const int nBlocks, const int capBlocks) {
+    auto it = mLru.begin();
+    while(it != mLru.end() && mUsedBlocks + nBlocks > capBlocks) {
+        const auto file = *it;
+        if(file->mOpened || file->mLocks > 0) {
+            it++;
+            continue;
+        }
+        it = mLru.erase(it);
+        file->mInLru = false;
+        for(const int block : file->mBlocks) mFreeBlocks.insert(block);
+        mUsedBlocks -= static_cast<int>(file->mBlocks.size());
+        file->mBlocks.clear();
+        file->mInvalid = true;
+        emit file->evicted();
+    }
+}
+
+bool DiskCache::addSegment() {
+    QString folder = eSettings::instance().fHddCacheFolder;
+    if(folder.isEmpty() || !QDir(folder).exists()) folder = QDir::tempPath();
+    const auto templ = QDir(folder).filePath("friction-cache-XXXXXX");
+    auto file = std::make_unique<QTemporaryFile>(templ);
+    if(!file->open()) return false;
+    if(!file->resize(static_cast<qint64>(SEGMENT_BLOCKS)*BLOCK_BYTES)) {
+        return false;
+    }
+    const int firstBlock = static_cast<int>(mSegments.size())*SEGMENT_BLOCKS;
+    for(int i = 0; i < SEGMENT_BLOCKS; i++) {
+        mFreeBlocks.insert(mFreeBlocks.end(), firstBlock + i);
+    }
+    const int handle = file->handle();
+    mSegments.push_back({std::move(file), handle});
+    return true;
+}
+
+void DiskCache::removeEmptySegments() {
+    // the first segment is kept for the next files
+    while(mSegments.size() > 1) {
+        const int firstBlock = static_cast<int>(mSegments.size() - 1)*SEGMENT_BLOCKS;
+        const auto first = mFreeBlocks.lower_bound(firstBlock);
+        if(std::distance(first, mFreeBlocks.end()) < SEGMENT_BLOCKS) break;
+        mFreeBlocks.erase(first, mFreeBlocks.end());
+        mSegments.pop_back();
+    }
+}
+
+bool DiskCache::write(const int block, const qint64 offset,
+                      const char * const data, const qint64 size) {
+    const qint64 pos = static_cast<qint64>(block % SEGMENT_BLOCKS)*BLOCK_BYTES + offset;
+#ifdef Q_OS_WIN
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto& file = mSegments[static_cast<size_t>(block/SEGMENT_BLOCKS)].fFile;
+    if(!file->seek(pos)) return false;
+    return file->write(data, size) == size;
+#else
+    int handle;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        handle = mSegments[static_cast<size_t>(block/SEGMENT_BLOCKS)].fHandle;
+    }
+    qint64 done = 0;
+    while(done < size) {
+        const auto ret = pwrite(handle, data + done,
+                                static_cast<size_t>(size - done), pos + done);
+        if(ret <= 0) return false;
+        done += ret;
+    }
+    return true;
+#endif
+}
+
+bool DiskCache::read(const int block, const qint64 offset,
+                     char * const data, const qint64 size) {
+    const qint64 pos = static_cast<qint64>(block % SEGMENT_BLOCKS)*BLOCK_BYTES + offset;
+#ifdef Q_OS_WIN
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto& file = mSegments[static_cast<size_t>(block/SEGMENT_BLOCKS)].fFile;
+    if(!file->seek(pos)) return false;
+    return file->read(data, size) == size;
+#else
+    int handle;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        handle = mSegments[static_cast<size_t>(block/SEGMENT_BLOCKS)].fHandle;
+    }
+    qint64 done = 0;
+    while(done < size) {
+        const auto ret = pread(handle, data + done,
+                               static_cast<size_t>(size - done), pos + done);
+        if(ret <= 0) return false;
+        done += ret;
+    }
+    return true;
+#endif
+}
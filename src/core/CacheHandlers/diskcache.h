@@ -0,0 +1,115 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include "core_global.h"
+
+#include <QIODevice>
+#include <QTemporaryFile>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+// Data of a single HddCachableCont, stored in blocks of the shared
+// cache files. Written once, then read back any number of times.
+class CORE_EXPORT DiskCacheFile : public QIODevice {
+    Q_OBJECT
+    friend class DiskCache;
+public:
+    DiskCacheFile();
+    ~DiskCacheFile();
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    qint64 size() const override { return mSize; }
+
+    //! @brief Set when writing failed or the data was evicted
+    bool isValid() const { return !mInvalid; }
+
+    // locked files are not evicted, used by pending loaders
+    void lock() { mLocks++; }
+    void unlock() { mLocks--; }
+signals:
+    //! @brief Emitted from the thread that needed the space
+    void evicted();
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+private:
+    std::vector<int> mBlocks;
+    qint64 mSize = 0;
+    std::atomic<bool> mOpened{false};
+    std::atomic<bool> mInvalid{false};
+    std::atomic<int> mLocks{0};
+    bool mInLru = false;
+    std::list<DiskCacheFile*>::iterator mLru;
+};
+
+// Disk cache tier shared by all HddCachableConts. The data is packed into
+// a few preallocated files in eSettings::fHddCacheFolder, divided into
+// fixed size blocks. Least recently used files are evicted once
+// eSettings::fHddCacheMBCap, or a default cap when it is not set, is
+// reached. Segments left empty at the end are removed.
+class CORE_EXPORT DiskCache {
+    friend class DiskCacheFile;
+    DiskCache() {}
+public:
+    static DiskCache& instance();
+    static bool sEnabled();
+    //! @brief Evicted data is not saved while suspended, saving holds
+    //! the memory until the data is written
+    static void sSetSuspended(const bool suspended);
+private:
+    struct Segment {
+        std::unique_ptr<QTemporaryFile> fFile;
+        int fHandle;
+    };
+
+    bool allocate(DiskCacheFile * const file, const int nBlocks);
+    void release(DiskCacheFile * const file);
+    void touch(DiskCacheFile * const file);
+    void evictFor(const int nBlocks, const int capBlocks);
+    bool addSegment();
+    void removeEmptySegments();
+
+    bool write(const int block, const qint64 offset,
+               const char * const data, const qint64 size);
+    bool read(const int block, const qint64 offset,
+              char * const data, const qint64 size);
+
+    std::mutex mMutex;
+    std::vector<Segment> mSegments;
+    // lowest blocks are handed out first
+    std::set<int> mFreeBlocks;
+    // front is the least recently used
+    std::list<DiskCacheFile*> mLru;
+    int mUsedBlocks = 0;
+};
+
+#endif // DISKCACHE_H
@@ -98,6 +98,8 @@ public:
         mUsedRange.clearRange();
     }
 
+    const UsedRange& usedRange() const { return mUsedRange; }
+
     auto begin() const { return mConts.begin(); }
     auto end() const { return mConts.begin(); }
 private:
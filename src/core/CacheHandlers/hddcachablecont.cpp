@@ -25,17 +25,36 @@
 
 #include "hddcachablecont.h"
 
+// memory held by savers waiting for the disk, evicted data is dropped
+// instead of saved once this much is pending
+#define MAX_PENDING_SAVE_BYTES (256*1024*1024)
+
+qint64 HddCachableCont::sPendingSaveBytes = 0;
+
 HddCachableCont::HddCachableCont() {}
 
 HddCachableCont::~HddCachableCont() {
+    setSavePending(0);
     if(mTmpFile) scheduleDeleteTmpFile();
 }
 
 int HddCachableCont::free_RAM_k() {
+    // keep the data in the disk cache tier
+    const bool save = DiskCache::sEnabled() && !mTmpFile && !mTmpSaveTask &&
+                      sPendingSaveBytes + getByteCount() <= MAX_PENDING_SAVE_BYTES;
+    if(save) scheduleSaveToTmpFile();
     const int bytes = clearMemory();
     setDataInMemory(false);
     if(!mTmpFile && !mTmpSaveTask) noDataLeft_k();
-    return bytes;
+    if(!save) return bytes;
+    // the saver holds the data until it is written
+    setSavePending(bytes);
+    return 0;
+}
+
+void HddCachableCont::setSavePending(const int bytes) {
+    sPendingSaveBytes += bytes - mPendingSaveBytes;
+    mPendingSaveBytes = bytes;
 }
 
 eTask *HddCachableCont::scheduleDeleteTmpFile() {
@@ -57,6 +76,7 @@ eTask *HddCachableCont::scheduleLoadFromTmpFile() {
     if(storesDataInMemory()) return nullptr;
     if(mTmpLoadTask) return mTmpLoadTask.get();
     if(!mTmpSaveTask && !mTmpFile) return nullptr;
+    if(mTmpFile && !mTmpFile->isValid()) return nullptr;
 
     mTmpLoadTask = createTmpFileDataLoader();
     if(mTmpSaveTask)
@@ -65,9 +85,25 @@ eTask *HddCachableCont::scheduleLoadFromTmpFile() {
     return mTmpLoadTask.get();
 }
 
-void HddCachableCont::setDataSavedToTmpFile(const qsptr<QTemporaryFile> &tmpFile) {
+void HddCachableCont::setDataSavedToTmpFile(const qsptr<DiskCacheFile> &tmpFile) {
     mTmpSaveTask.reset();
+    setSavePending(0);
     mTmpFile = tmpFile;
+    if(mTmpFile) {
+        const stdptr<HddCachableCont> thisPtr = this;
+        QObject::connect(mTmpFile.get(), &DiskCacheFile::evicted,
+                         mTmpFile.get(), [thisPtr]() {
+            if(thisPtr) thisPtr->tmpFileEvicted();
+        }, Qt::QueuedConnection);
+        if(!mTmpFile->isValid()) mTmpFile.reset();
+    }
+    if(!mTmpFile && !mDataInMemory && !mTmpLoadTask) noDataLeft_k();
+}
+
+void HddCachableCont::tmpFileEvicted() {
+    if(!mTmpFile || mTmpFile->isValid()) return;
+    mTmpFile.reset();
+    if(!mDataInMemory && !mTmpLoadTask && !mTmpSaveTask) noDataLeft_k();
 }
 
 void HddCachableCont::afterDataLoadedFromTmpFile() {
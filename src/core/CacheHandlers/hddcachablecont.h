@@ -44,20 +44,27 @@ public:
     eTask* scheduleSaveToTmpFile();
     eTask* scheduleLoadFromTmpFile();
 
-    void setDataSavedToTmpFile(const qsptr<QTemporaryFile> &tmpFile);
+    void setDataSavedToTmpFile(const qsptr<DiskCacheFile> &tmpFile);
 
     bool storesDataInMemory() const { return mDataInMemory; }
-    qsptr<QTemporaryFile> getTmpFile() const { return mTmpFile; }
+    qsptr<DiskCacheFile> getTmpFile() const { return mTmpFile; }
 protected:
     void afterDataLoadedFromTmpFile();
     void afterDataReplaced();
     void setDataInMemory(const bool dataInMemory);
+    void tmpFileEvicted();
 
-    qsptr<QTemporaryFile> mTmpFile;
+    qsptr<DiskCacheFile> mTmpFile;
 private:
+    //! @brief Bytes held by the pending saver, freed once it is done
+    void setSavePending(const int bytes);
+
     bool mDataInMemory = false;
     stdsptr<eTask> mTmpLoadTask;
     stdsptr<eTask> mTmpSaveTask;
+    int mPendingSaveBytes = 0;
+
+    static qint64 sPendingSaveBytes;
 };
 
 #endif // HddCACHABLECONT_H
@@ -44,6 +44,16 @@ bool HddCachableRangeCont::inRange(const int unary) const {
     return mRange.inRange(unary);
 }
 
+int HddCachableRangeCont::reuseDistance() const {
+    if(!mParentCacheHandler_k) return 0;
+    const auto& usedRange = mParentCacheHandler_k->usedRange();
+    if(!usedRange.validRange()) return 0;
+    const auto& used = usedRange.range();
+    if(mRange.fMax < used.fMin) return used.fMin - mRange.fMax;
+    if(mRange.fMin > used.fMax) return mRange.fMin - used.fMax;
+    return 0;
+}
+
 void HddCachableRangeCont::setUnaryRange(const int unary) {
     mRange.fMin = unary;
     mRange.fMax = unary;
@@ -51,6 +51,8 @@ public:
     void setRangeMin(const int min);
     void setRange(const FrameRange &range);
     bool inRange(const int unary) const;
+
+    int reuseDistance() const;
 private:
     FrameRange mRange;
     HddCachableCacheHandler * const mParentCacheHandler_k;
@@ -27,6 +27,7 @@
 #include "tmpdeleter.h"
 #include "canvas.h"
 #include "skia/skiahelpers.h"
+#include "Private/esettings.h"
 
 ImageCacheContainer::ImageCacheContainer(const FrameRange &range,
                                          HddCachableCacheHandler * const parent) :
@@ -58,7 +59,8 @@ int ImageCacheContainer::clearMemory() {
 }
 
 stdsptr<eHddTask> ImageCacheContainer::createTmpFileDataSaver() {
-    return enve::make_shared<ImgSaver>(this, getImage());
+    const bool compress = eSettings::instance().fHddCacheCompression;
+    return enve::make_shared<ImgSaver>(this, getImage(), compress);
 }
 
 stdsptr<eHddTask> ImageCacheContainer::createTmpFileDataLoader() {
@@ -27,6 +27,7 @@
 #define IMAGECACHECONTAINER_H
 #include "skia/skiaincludes.h"
 #include "skia/skiahelpers.h"
+#include "skia/imagecodec.h"
 #include "hddcachablerangecont.h"
 #include "imagedatahandler.h"
 class Canvas;
@@ -57,17 +58,21 @@ public:
 class CORE_EXPORT ImgSaver : public TmpSaver {
     e_OBJECT
 public:
-    typedef std::function<void(const qsptr<QTemporaryFile>&)> Func;
+    typedef std::function<void(const qsptr<DiskCacheFile>&)> Func;
 protected:
     ImgSaver(ImageCacheContainer* const target,
-             const sk_sp<SkImage> &image) :
-        TmpSaver(target), mImage(image) {}
+             const sk_sp<SkImage> &image,
+             const bool compress) :
+        TmpSaver(target), mImage(image), mCompress(compress) {}
 
     void write(eWriteStream& dst) {
-        SkiaHelpers::writeImg(mImage, dst);
+        dst << mCompress;
+        if(mCompress) ImageCodec::writeImg(mImage, dst);
+        else SkiaHelpers::writeImg(mImage, dst);
     }
 private:
     const sk_sp<SkImage> mImage;
+    const bool mCompress;
 };
 
 class CORE_EXPORT ImgLoader : public TmpLoader {
@@ -77,13 +82,16 @@ public:
 
     const sk_sp<SkImage>& image() const { return mImage; }
 protected:
-    ImgLoader(const qsptr<QTemporaryFile> &file,
+    ImgLoader(const qsptr<DiskCacheFile> &file,
               ImageCacheContainer* const target,
               const Func& finishedFunc) :
         TmpLoader(file, target), mFinishedFunc(finishedFunc) {}
 
     void read(eReadStream& src) {
-        mImage = SkiaHelpers::readImg(src);
+        bool compressed;
+        src >> compressed;
+        if(compressed) mImage = ImageCodec::readImg(src);
+        else mImage = SkiaHelpers::readImg(src);
     }
     void afterProcessing() {
         if(mFinishedFunc) mFinishedFunc(mImage);
@@ -25,8 +25,6 @@
 
 #include "imagedatahandler.h"
 
-#include "skia/skiahelpers.h"
-
 ImageDataHandler::ImageDataHandler() {}
 
 ImageDataHandler::ImageDataHandler(const sk_sp<SkImage>& img) :
@@ -35,19 +33,14 @@ ImageDataHandler::ImageDataHandler(const sk_sp<SkImage>& img) :
 int ImageDataHandler::clearImageMemory() {
     const int bytes = getImageByteCount();
     mImage.reset();
-    mImageCopies.clear();
     return bytes;
 }
 
 int ImageDataHandler::getImageByteCount() const {
     if(!mImage) return 0;
-    SkPixmap pixmap;
-    if(mImage->peekPixels(&pixmap)) {
-        const int nCopies = mImageCopies.count();
-        return pixmap.width()*pixmap.height()*
-               pixmap.info().bytesPerPixel()*(1 + nCopies);
-    }
-    return 0;
+    // render tasks share the pixels, so they are only counted once
+    const auto& info = mImage->imageInfo();
+    return info.width()*info.height()*info.bytesPerPixel();
 }
 
 void ImageDataHandler::drawImage(SkCanvas * const canvas,
@@ -61,16 +54,6 @@ const sk_sp<SkImage>& ImageDataHandler::getImage() const {
     return mImage;
 }
 
-sk_sp<SkImage> ImageDataHandler::requestImageCopy() {
-    if(mImageCopies.isEmpty()) return SkiaHelpers::makeCopy(mImage);
-    else return mImageCopies.takeLast();
-}
-
-void ImageDataHandler::addImageCopy(const sk_sp<SkImage> &img) {
-    mImageCopies << img;
-}
-
 void ImageDataHandler::replaceImage(const sk_sp<SkImage> &img) {
     mImage = img;
-    mImageCopies.clear();
 }
@@ -29,8 +29,6 @@
 #include "skia/skiaincludes.h"
 #include "../core_global.h"
 
-#include <QList>
-
 class CORE_EXPORT ImageDataHandler {
 protected:
     ImageDataHandler();
@@ -45,12 +43,10 @@ public:
                    const SkFilterQuality filter) const;
 
     bool hasImage() const { return mImage.get(); }
+    //! @brief The image is immutable and can be shared with render tasks
     const sk_sp<SkImage>& getImage() const;
-    sk_sp<SkImage> requestImageCopy();
-    void addImageCopy(const sk_sp<SkImage> &img);
 private:
     sk_sp<SkImage> mImage;
-    QList<sk_sp<SkImage>> mImageCopies;
 };
 
 #endif // IMAGEDATAHANDLER_H
@@ -35,7 +35,9 @@ SceneFrameContainer::SceneFrameContainer(
     ImageCacheContainer(data->fRenderedImage, range, parent),
     fBoxState(data->fBoxStateId),
     fResolution(data->fResolution),
-    mScene(scene) {}
+    mScene(scene) {
+    setCost(data->processingUs());
+}
 
 stdsptr<eHddTask> SceneFrameContainer::createTmpFileDataLoader() {
     const ImgLoader::Func func = [this](sk_sp<SkImage> img) {
@@ -34,7 +34,16 @@ SoundDataHandler::SoundDataHandler() {
 }
 
 stdsptr<Samples> SoundHandler::getSamplesForSecond(const int secondId) {
-    return mDataHandler->getSamplesForSecond(secondId);
+    const auto samples = mDataHandler->getSamplesForSecond(secondId);
+    if(samples || !mAudioStreamsData) return samples;
+    // any second the stream is decoded past is a copy away
+    const auto streamCache = mAudioStreamsData->fStreamCache;
+    if(!streamCache) return nullptr;
+    const auto& settings = eSoundSettings::sData();
+    if(!streamCache->matches(settings)) return nullptr;
+    const int sampleRate = settings.fSampleRate;
+    const SampleRange range = {secondId*sampleRate, (secondId + 1)*sampleRate - 1};
+    return streamCache->samples(range);
 }
 
 void SoundHandler::secondReaderFinished(
@@ -0,0 +1,283 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "soundstreamcache.h"
+#include "FileCacheHandlers/audiostreamsdata.h"
+#include "Private/esettings.h"
+
+#include <QDir>
+
+// streams decoding to more bytes are kept in a temporary file
+#define MAX_RAM_BYTES (64*1024*1024)
+
+namespace {
+    void freeSwr(SwrContext* swr) { swr_free(&swr); }
+}
+
+SoundStreamCache::SoundStreamCache(const eSoundSettingsData& settings) :
+    mSettings(settings),
+    mPackedFormat(av_get_packed_sample_fmt(settings.fSampleFormat)),
+    mChannels(settings.channelCount()),
+    mFrameBytes(static_cast<qint64>(settings.bytesPerSample())*mChannels),
+    mSwr(nullptr, freeSwr) {}
+
+bool SoundStreamCache::matches(const eSoundSettingsData& settings) const {
+    return mSettings.fSampleRate == settings.fSampleRate &&
+           mSettings.fSampleFormat == settings.fSampleFormat &&
+           mSettings.fChannelLayout == settings.fChannelLayout;
+}
+
+stdsptr<Samples> SoundStreamCache::read(AudioStreamsData& audio,
+                                        const SampleRange& range) {
+    std::lock_guard<std::mutex> lock(mDecodeMutex);
+    try {
+        if(!mStarted) start(audio);
+        while(!mComplete && mSampleCount <= range.fMax) {
+            decodePacket(audio);
+        }
+        return copySamples(range);
+    } catch(...) {
+        clear();
+        RuntimeThrow("Failed to decode audio stream '" + audio.fPath + "'.");
+    }
+}
+
+stdsptr<Samples> SoundStreamCache::samples(const SampleRange& range) {
+    // never wait for a reader decoding, it is called on the main thread
+    std::unique_lock<std::mutex> lock(mDecodeMutex, std::try_to_lock);
+    if(!lock.owns_lock()) return nullptr;
+    if(!mComplete && mSampleCount <= range.fMax) return nullptr;
+    return copySamples(range);
+}
+
+void SoundStreamCache::readerFinished() {
+    updateInMemoryManagment();
+}
+
+int SoundStreamCache::free_RAM_k() {
+    std::unique_lock<std::mutex> lock(mDecodeMutex, std::try_to_lock);
+    // the next reader puts it back in the memory managment
+    if(!lock.owns_lock() || mFile) return 0;
+    const int bytes = mRamBytes;
+    noDataLeft_k();
+    return bytes;
+}
+
+void SoundStreamCache::noDataLeft_k() {
+    clear();
+}
+
+void SoundStreamCache::clear() {
+    mComplete = false;
+    mStarted = false;
+    mFirstFrame = true;
+    mSkipSamples = 0;
+    mSampleCount = 0;
+    mSwr.reset();
+    // closing the file unmaps it
+    mFile.reset();
+    mMapped = nullptr;
+    mMappedBytes = 0;
+    std::vector<uchar>().swap(mRam);
+    mRamBytes = 0;
+}
+
+void SoundStreamCache::start(AudioStreamsData& audio) {
+    if(!audio.fOpened)
+        RuntimeThrow("Cannot decode closed AudioStream");
+    const int dstSampleRate = mSettings.fSampleRate;
+    const auto codecPars = audio.fAudioStream->codecpar;
+
+    const qreal expectedBytes = audio.fDurationSec*dstSampleRate*mFrameBytes;
+    if(expectedBytes > MAX_RAM_BYTES) {
+        QString folder;
+        if(eSettings::sInstance) folder = eSettings::instance().fHddCacheFolder;
+        if(folder.isEmpty() || !QDir(folder).exists()) folder = QDir::tempPath();
+        const auto templ = QDir(folder).filePath("friction-audio-XXXXXX");
+        mFile = std::make_unique<QTemporaryFile>(templ);
+        if(!mFile->open()) RuntimeThrow("Could not create audio cache file");
+        // the file is preallocated and mapped once, one more second
+        // covers inexact stream durations
+        mapFile(static_cast<qint64>(expectedBytes) + dstSampleRate*mFrameBytes);
+    } else {
+        mRam.reserve(static_cast<size_t>(expectedBytes));
+        mRamBytes = static_cast<int>(mRam.capacity());
+    }
+
+    // own resampler, the samples are stored interleaved
+    mSwr.reset(swr_alloc());
+    const auto swr = mSwr.get();
+    const auto srcSampleFormat = static_cast<AVSampleFormat>(codecPars->format);
+    av_opt_set_int(swr, "in_channel_count", codecPars->channels, 0);
+    av_opt_set_int(swr, "out_channel_count", mChannels, 0);
+    av_opt_set_int(swr, "in_channel_layout", codecPars->channel_layout, 0);
+    av_opt_set_int(swr, "out_channel_layout", mSettings.fChannelLayout, 0);
+    av_opt_set_int(swr, "in_sample_rate", codecPars->sample_rate, 0);
+    av_opt_set_int(swr, "out_sample_rate", dstSampleRate, 0);
+    av_opt_set_sample_fmt(swr, "in_sample_fmt", srcSampleFormat, 0);
+    av_opt_set_sample_fmt(swr, "out_sample_fmt", mPackedFormat, 0);
+    swr_init(swr);
+    if(!swr_is_initialized(swr)) {
+        RuntimeThrow("Resampler has not been properly initialized");
+    }
+
+    avformat_seek_file(audio.fFormatContext, audio.fAudioStreamIndex,
+                       INT64_MIN, 0, 0, 0);
+    avcodec_flush_buffers(audio.fCodecContext);
+    mStarted = true;
+}
+
+void SoundStreamCache::decodePacket(AudioStreamsData& audio) {
+    const auto packet = audio.fPacket;
+    const auto codecContext = audio.fCodecContext;
+    if(av_read_frame(audio.fFormatContext, packet) < 0) {
+        // drain the decoder and the resampler
+        avcodec_send_packet(codecContext, nullptr);
+        receiveFrames(audio);
+        resample(nullptr, 0);
+        avcodec_flush_buffers(codecContext);
+        finish();
+        return;
+    }
+    if(packet->stream_index != audio.fAudioStreamIndex) {
+        av_packet_unref(packet);
+        return;
+    }
+    const int sendRet = avcodec_send_packet(codecContext, packet);
+    av_packet_unref(packet);
+    if(sendRet < 0) RuntimeThrow("Sending packet to the decoder failed");
+    receiveFrames(audio);
+}
+
+void SoundStreamCache::receiveFrames(AudioStreamsData& audio) {
+    const auto decodedFrame = audio.fDecodedFrame;
+    while(true) {
+        const int recRet = avcodec_receive_frame(audio.fCodecContext, decodedFrame);
+        if(recRet == AVERROR_EOF || recRet == AVERROR(EAGAIN)) break;
+        if(recRet < 0) RuntimeThrow("Did not receive frame from the decoder");
+        if(mFirstFrame) {
+            // place the stream at its first timestamp
+            const int64_t pts = decodedFrame->best_effort_timestamp;
+            if(pts != AV_NOPTS_VALUE) {
+                const int firstSample = static_cast<int>(
+                        av_rescale_q(pts, audio.fAudioStream->time_base,
+                                     AVRational{1, mSettings.fSampleRate}));
+                if(firstSample > 0) appendSilence(firstSample);
+                else mSkipSamples = -firstSample;
+            }
+            mFirstFrame = false;
+        }
+        resample(const_cast<const uint8_t**>(decodedFrame->extended_data),
+                 decodedFrame->nb_samples);
+        av_frame_unref(decodedFrame);
+    }
+}
+
+void SoundStreamCache::resample(const uint8_t** src, const int nSrcSamples) {
+    const auto swr = mSwr.get();
+    const int bufferSamples = swr_get_out_samples(swr, nSrcSamples);
+    if(bufferSamples <= 0) return;
+    const auto bufferBytes = static_cast<size_t>(bufferSamples*mFrameBytes);
+    if(mBuffer.size() < bufferBytes) mBuffer.resize(bufferBytes);
+    uint8_t* dst = mBuffer.data();
+    const int nDstSamples = swr_convert(swr, &dst, bufferSamples,
+                                        src, nSrcSamples);
+    if(nDstSamples < 0) RuntimeThrow("Resampling failed");
+    const int skip = qMin(mSkipSamples, nDstSamples);
+    mSkipSamples -= skip;
+    append(mBuffer.data() + skip*mFrameBytes, nDstSamples - skip);
+}
+
+void SoundStreamCache::append(const uchar * const data, const int nSamples) {
+    if(nSamples <= 0) return;
+    const qint64 bytes = nSamples*mFrameBytes;
+    if(mFile) {
+        const qint64 pos = mSampleCount*mFrameBytes;
+        if(pos + bytes > mMappedBytes) {
+            mapFile(qMax(pos + bytes, mMappedBytes + mMappedBytes/4));
+        }
+        memcpy(mMapped + pos, data, static_cast<size_t>(bytes));
+    } else {
+        mRam.insert(mRam.end(), data, data + bytes);
+        mRamBytes = static_cast<int>(mRam.capacity());
+    }
+    mSampleCount += nSamples;
+}
+
+void SoundStreamCache::mapFile(const qint64 bytes) {
+    if(mMapped) mFile->unmap(mMapped);
+    mMapped = nullptr;
+    mMappedBytes = 0;
+    if(!mFile->resize(bytes)) RuntimeThrow("Could not resize audio cache file");
+    mMapped = mFile->map(0, bytes);
+    if(!mMapped) RuntimeThrow("Could not map audio cache file");
+    mMappedBytes = bytes;
+}
+
+void SoundStreamCache::appendSilence(const int nSamples) {
+    const uchar val = mPackedFormat == AV_SAMPLE_FMT_U8 ? 0x80 : 0;
+    const std::vector<uchar> silence(static_cast<size_t>(nSamples*mFrameBytes), val);
+    append(silence.data(), nSamples);
+}
+
+void SoundStreamCache::finish() {
+    mSwr.reset();
+    std::vector<uchar>().swap(mBuffer);
+    if(mFile) {
+        // drop the unused preallocated end
+        const qint64 bytes = mSampleCount*mFrameBytes;
+        if(bytes > 0 && bytes < mMappedBytes) mapFile(bytes);
+    } else {
+        mRam.shrink_to_fit();
+        mRamBytes = static_cast<int>(mRam.capacity());
+    }
+    mComplete = true;
+}
+
+stdsptr<Samples> SoundStreamCache::copySamples(const SampleRange& range) {
+    SampleRange clipped = range*SampleRange{0, mSampleCount - 1};
+    if(!clipped.isValid()) clipped = {range.fMin, range.fMin - 1};
+    const auto result = enve::make_shared<Samples>(
+                clipped, mSettings.fSampleRate,
+                mSettings.fSampleFormat, mSettings.fChannelLayout);
+    const int nSamples = clipped.span();
+    if(nSamples == 0) return result;
+    const qint64 bytes = nSamples*mFrameBytes;
+    const qint64 pos = clipped.fMin*mFrameBytes;
+    const uchar* const src = (mFile ? mMapped : mRam.data()) + pos;
+    if(result->fPlanar) {
+        const uint sampleSize = result->fSampleSize;
+        for(int i = 0; i < mChannels; i++) {
+            const uchar * iSrc = src + i*sampleSize;
+            uchar * iDst = result->fData[i];
+            for(int j = 0; j < nSamples; j++) {
+                memcpy(iDst, iSrc, sampleSize);
+                iSrc += mFrameBytes;
+                iDst += sampleSize;
+            }
+        }
+    } else {
+        memcpy(result->fData[0], src, static_cast<size_t>(bytes));
+    }
+    return result;
+}
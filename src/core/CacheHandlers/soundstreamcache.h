@@ -0,0 +1,105 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef SOUNDSTREAMCACHE_H
+#define SOUNDSTREAMCACHE_H
+
+#include "CacheHandlers/cachecontainer.h"
+#include "CacheHandlers/samples.h"
+#include "Sound/esoundsettings.h"
+
+#include <QTemporaryFile>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct AudioStreamsData;
+struct SwrContext;
+
+// Audio stream decoded in order, resampled to the sound settings it was
+// created with. Each reader only decodes up to the samples it needs and
+// continues where the previous one stopped. Samples are kept interleaved,
+// in RAM for short files and in a memory mapped temporary file for long
+// ones, so that reading them never does file I/O.
+class CORE_EXPORT SoundStreamCache : public CacheContainer {
+    e_OBJECT
+protected:
+    SoundStreamCache(const eSoundSettingsData& settings);
+public:
+    //! @brief Decodes up to the end of the range unless already done
+    stdsptr<Samples> read(AudioStreamsData& audio, const SampleRange& range);
+
+    //! @brief Set once the whole stream is decoded
+    bool isComplete() const { return mComplete; }
+
+    bool matches(const eSoundSettingsData& settings) const;
+
+    //! @brief Copies the range if it is decoded already, clipped to the stream
+    stdsptr<Samples> samples(const SampleRange& range);
+
+    //! @brief Call on the main thread after read() to report the RAM used
+    void readerFinished();
+
+    int getByteCount() { return mRamBytes; }
+protected:
+    void noDataLeft_k();
+private:
+    int free_RAM_k();
+
+    void start(AudioStreamsData& audio);
+    void decodePacket(AudioStreamsData& audio);
+    void receiveFrames(AudioStreamsData& audio);
+    void resample(const uint8_t** src, const int nSrcSamples);
+    void append(const uchar * const data, const int nSamples);
+    void mapFile(const qint64 bytes);
+    void appendSilence(const int nSamples);
+    void finish();
+    void clear();
+    stdsptr<Samples> copySamples(const SampleRange& range);
+
+    const eSoundSettingsData mSettings;
+    const AVSampleFormat mPackedFormat;
+    const int mChannels;
+    const qint64 mFrameBytes;
+
+    std::mutex mDecodeMutex;
+    std::atomic<bool> mComplete{false};
+    std::atomic<int> mRamBytes{0};
+    int mSampleCount = 0;
+
+    // decoding state kept between readers
+    bool mStarted = false;
+    bool mFirstFrame = true;
+    int mSkipSamples = 0;
+    std::unique_ptr<SwrContext, void(*)(SwrContext*)> mSwr;
+    std::vector<uchar> mBuffer;
+
+    std::vector<uchar> mRam;
+    std::unique_ptr<QTemporaryFile> mFile;
+    uchar* mMapped = nullptr;
+    qint64 mMappedBytes = 0;
+};
+
+#endif // SOUNDSTREAMCACHE_H
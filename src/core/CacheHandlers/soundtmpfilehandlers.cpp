@@ -27,7 +27,7 @@
 #include "soundcachecontainer.h"
 
 SoundContainerTmpFileDataLoader::SoundContainerTmpFileDataLoader(
-        const qsptr<QTemporaryFile> &file,
+        const qsptr<DiskCacheFile> &file,
         SoundCacheContainer *target) :
     TmpLoader(file, target), mTarget(target) {}
 
@@ -28,7 +28,6 @@
 #include "tmpdeleter.h"
 #include "soundcachecontainer.h"
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
 #include "skia/skiaincludes.h"
 #include "tmpsaver.h"
 #include "tmploader.h"
@@ -37,7 +36,7 @@ class SoundCacheContainer;
 class CORE_EXPORT SoundContainerTmpFileDataLoader : public TmpLoader {
     e_OBJECT
 public:
-    SoundContainerTmpFileDataLoader(const qsptr<QTemporaryFile> &file,
+    SoundContainerTmpFileDataLoader(const qsptr<DiskCacheFile> &file,
                                     SoundCacheContainer *target);
     void read(eReadStream& src);
     void afterProcessing();
@@ -27,7 +27,7 @@
 #include "imagecachecontainer.h"
 #include "skia/skiahelpers.h"
 
-TmpDeleter::TmpDeleter(const qsptr<QTemporaryFile> &file) :
+TmpDeleter::TmpDeleter(const qsptr<DiskCacheFile> &file) :
     mTmpFile(file) {}
 
 void TmpDeleter::process() { mTmpFile.reset(); }
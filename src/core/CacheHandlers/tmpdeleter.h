@@ -26,16 +26,16 @@
 #ifndef TMPFILEHANDLERS_H
 #define TMPFILEHANDLERS_H
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
+#include "diskcache.h"
 
 class CORE_EXPORT TmpDeleter : public eHddTask {
     e_OBJECT
 protected:
-    TmpDeleter(const qsptr<QTemporaryFile> &file);
+    TmpDeleter(const qsptr<DiskCacheFile> &file);
 public:
     void process();
 private:
-    qsptr<QTemporaryFile> mTmpFile;
+    qsptr<DiskCacheFile> mTmpFile;
 };
 
 
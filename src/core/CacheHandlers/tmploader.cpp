@@ -25,13 +25,19 @@
 
 #include "tmploader.h"
 
-TmpLoader::TmpLoader(const qsptr<QTemporaryFile> &file,
+TmpLoader::TmpLoader(const qsptr<DiskCacheFile> &file,
                      HddCachableCont * const target) :
-    mTmpFile(file), mTarget(target) {}
+    mTmpFile(file), mTarget(target) {
+    if(mTmpFile) mTmpFile->lock();
+}
+
+TmpLoader::~TmpLoader() {
+    if(mTmpFile) mTmpFile->unlock();
+}
 
 void TmpLoader::process() {
     if(!mTmpFile) return;
-    if(mTmpFile->open()) {
+    if(mTmpFile->open(QIODevice::ReadOnly)) {
         eReadStream src(mTmpFile.get());
         read(src);
         mTmpFile->close();
@@ -41,5 +47,8 @@ void TmpLoader::process() {
 }
 
 void TmpLoader::beforeProcessing(const Hardware) {
-    if(mTarget && !mTmpFile) mTmpFile = mTarget->getTmpFile();
+    if(mTarget && !mTmpFile) {
+        mTmpFile = mTarget->getTmpFile();
+        if(mTmpFile) mTmpFile->lock();
+    }
 }
@@ -27,21 +27,22 @@
 #define TMPLOADER_H
 
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
+#include "diskcache.h"
 #include "hddcachablecont.h"
 
 #include "ReadWrite/ereadstream.h"
 
 class CORE_EXPORT TmpLoader : public eHddTask {
 public:
-    TmpLoader(const qsptr<QTemporaryFile> &file,
+    TmpLoader(const qsptr<DiskCacheFile> &file,
               HddCachableCont * const target);
+    ~TmpLoader();
 
     virtual void read(eReadStream& src) = 0;
     void process();
     void beforeProcessing(const Hardware);
 private:
-    qsptr<QTemporaryFile> mTmpFile;
+    qsptr<DiskCacheFile> mTmpFile;
     const stdptr<HddCachableCont> mTarget;
 };
 
@@ -25,16 +25,16 @@
 
 #include "tmpsaver.h"
 
+// the file is created here to live in the main thread
 TmpSaver::TmpSaver(HddCachableCont* const target) :
-    mTarget(target) {}
+    mTarget(target), mTmpFile(new DiskCacheFile) {}
 
 void TmpSaver::process() {
-    mTmpFile = qsptr<QTemporaryFile>(new QTemporaryFile());
-    if(mTmpFile->open()) {
+    if(mTmpFile->open(QIODevice::WriteOnly)) {
         eWriteStream dst(mTmpFile.get());
         write(dst);
         mTmpFile->close();
-        mSavingSuccessful = true;
+        mSavingSuccessful = mTmpFile->isValid();
     } else {
         mSavingSuccessful = false;
     }
@@ -42,6 +42,5 @@ void TmpSaver::process() {
 
 void TmpSaver::afterProcessing() {
     if(!mTarget) return;
-    if(!mSavingSuccessful) return;
-    mTarget->setDataSavedToTmpFile(mTmpFile);
+    mTarget->setDataSavedToTmpFile(mSavingSuccessful ? mTmpFile : nullptr);
 }
@@ -27,7 +27,7 @@
 #define TMPSAVER_H
 
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
+#include "diskcache.h"
 #include "hddcachablecont.h"
 
 #include "ReadWrite/ewritestream.h"
@@ -44,7 +44,7 @@ public:
 private:
     const stdptr<HddCachableCont> mTarget;
     bool mSavingSuccessful = false;
-    qsptr<QTemporaryFile> mTmpFile;
+    qsptr<DiskCacheFile> mTmpFile;
 };
 
 
@@ -27,6 +27,12 @@
 
 #include "exceptions.h"
 
+// frames evaluated in one script call, also lets the first frames
+// of a long render range finish before the whole range is done
+#define BATCH_FRAMES 64
+// frames gathered ahead of the current frame
+#define PREFETCH_WINDOW (2*BATCH_FRAMES)
+
 Expression::ResultTester Expression::sQrealAnimatorTester =
         [](const QJSValue& val) {
             if(!val.isNumber()) PrettyRuntimeThrow("Invalid return type");
@@ -48,6 +54,8 @@ Expression::Expression(const QString& definitionsStr,
         connect(binding.second.get(), &PropertyBinding::relRangeChanged,
                 this, &Expression::relRangeChanged);
     }
+    connect(this, &Expression::relRangeChanged,
+            this, &Expression::clearPrefetched);
 }
 
 
@@ -122,6 +130,8 @@ qsptr<Expression> Expression::sCreate(const QString& definitionsStr,
 }
 
 bool Expression::setAbsFrame(const int absFrame) {
+    mAbsFrame = absFrame;
+    prefetchAhead(absFrame);
     bool changed = false;
     for(const auto& binding : mBindings) {
         const bool c = binding.second->setAbsFrame(absFrame);
@@ -151,6 +161,8 @@ bool Expression::dependsOn(const Property* const prop) {
 }
 
 QJSValue Expression::evaluate() {
+    qreal value;
+    if(prefetched(mAbsFrame, value)) return value;
     QJSValueList values;
     for(const auto& binding : mBindings) {
         values << binding.second->getJSValue(*mEngine);
@@ -171,6 +183,89 @@ QJSValue Expression::evaluate(const qreal relFrame)
     return res;
 }
 
+void Expression::prefetch(const Property* const context,
+                          const FrameRange& absRange) {
+    mPrefetched.clear();
+    mPrefetchContext = context;
+    mPrefetchRange = absRange;
+    mPrefetchNext = absRange.fMin;
+    prefetchAhead(absRange.fMin);
+}
+
+void Expression::prefetchAhead(const int absFrame) {
+    if(!mPrefetchRange.isValid() || !mPrefetchContext) return;
+    // frames skipped by the render are not gathered anymore
+    if(absFrame > mPrefetchNext) mPrefetchNext = absFrame;
+    const int windowEnd = qMin(mPrefetchRange.fMax, absFrame + PREFETCH_WINDOW);
+    if(mPrefetchNext > windowEnd) return;
+    // gather whole batches, so that every frame step costs nothing
+    const int last = qMin(mPrefetchRange.fMax, mPrefetchNext + BATCH_FRAMES - 1);
+    QStringList bindingVars;
+    for(const auto& binding : mBindings) bindingVars << binding.first;
+    const auto batch = std::make_shared<ExpressionBatch>(
+                mDefinitionsStr, mScriptStr, bindingVars);
+    int frame = mPrefetchNext;
+    while(frame <= last) {
+        // bound expressions have to be evaluated by the workers first,
+        // this frame is gathered again with the next setAbsFrame()
+        bool pending = false;
+        for(const auto& binding : mBindings) {
+            pending = binding.second->prefetchPending(frame);
+            if(pending) break;
+        }
+        if(pending) break;
+
+        // frames with identical binding values are evaluated once
+        const int relFrame = mPrefetchContext->prp_absFrameToRelFrame(frame);
+        const auto relIdRange = identicalRelRange(frame);
+        const int idFrames = relIdRange.fMax == FrameRange::EMAX ?
+                    mPrefetchRange.fMax - frame :
+                    qBound(0, relIdRange.fMax - relFrame,
+                           mPrefetchRange.fMax - frame);
+        const FrameRange idRange{frame, frame + idFrames};
+
+        QVariantList args;
+        for(const auto& binding : mBindings) {
+            const auto val = binding.second->getJSValueAtAbsFrame(*mEngine, frame);
+            args << val.toVariant();
+        }
+        batch->append(idRange, args);
+        frame = idRange.fMax + 1;
+    }
+    mPrefetchNext = frame;
+    if(batch->isEmpty()) return;
+    ExpressionEvaluator::sInstance()->evaluate(batch);
+    mPrefetched << batch;
+    // drop batches the render has passed
+    while(!mPrefetched.isEmpty() &&
+          mPrefetched.first()->absRange().fMax < mAbsFrame) {
+        mPrefetched.removeFirst();
+    }
+}
+
+void Expression::clearPrefetched() {
+    mPrefetched.clear();
+    // gathered again from the current frame on
+    mPrefetchNext = mPrefetchRange.fMin;
+}
+
+bool Expression::prefetched(const int absFrame, qreal& value) const {
+    for(const auto& batch : mPrefetched) {
+        if(!batch->absRange().inRange(absFrame)) continue;
+        return batch->value(absFrame, value);
+    }
+    return false;
+}
+
+bool Expression::prefetchPending(const int absFrame) const {
+    if(!mPrefetchRange.inRange(absFrame)) return false;
+    for(const auto& batch : mPrefetched) {
+        if(!batch->absRange().inRange(absFrame)) continue;
+        return !batch->isFinished();
+    }
+    return absFrame >= mPrefetchNext;
+}
+
 FrameRange Expression::identicalRelRange(const int absFrame) const {
     FrameRange result{FrameRange::EMINMAX};
     for(const auto& binding : mBindings) {
@@ -30,6 +30,7 @@
 #include <QJSEngine>
 
 #include "propertybindingparser.h"
+#include "expressionevaluator.h"
 
 class CORE_EXPORT Expression : public QObject {
     Q_OBJECT
@@ -68,6 +69,17 @@ public:
     QJSValue evaluate();
     QJSValue evaluate(const qreal relFrame);
 
+    //! @brief Evaluates absRange on the ExpressionEvaluator workers, a
+    //! window ahead of setAbsFrame(), evaluate() then returns the
+    //! precomputed values. An invalid range stops prefetching.
+    void prefetch(const Property* const context, const FrameRange& absRange);
+    void clearPrefetched();
+
+    //! @brief Returns false unless a worker has evaluated absFrame
+    bool prefetched(const int absFrame, qreal& value) const;
+    //! @brief absFrame is in the prefetched range, but not evaluated yet
+    bool prefetchPending(const int absFrame) const;
+
     int nextDifferentRelFrame(const int absFrame) const
     { return identicalRelRange(absFrame).adjusted(0, 1).fMax; }
     int prevDifferentRelFrame(const int absFrame) const
@@ -82,12 +94,20 @@ signals:
     void relRangeChanged(const FrameRange& range);
     void currentValueChanged();
 private:
+    void prefetchAhead(const int absFrame);
+
     const QString mDefinitionsStr;
     const QString mScriptStr;
 
     QJSValue mEEvaluate;
     const PropertyBindingMap mBindings;
     const std::unique_ptr<QJSEngine> mEngine;
+
+    int mAbsFrame = 0;
+    const Property* mPrefetchContext = nullptr;
+    FrameRange mPrefetchRange{0, -1};
+    int mPrefetchNext = 0;
+    QList<stdsptr<ExpressionBatch>> mPrefetched;
 };
 
 #endif // EXPRESSION_H
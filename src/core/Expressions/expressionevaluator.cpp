@@ -0,0 +1,189 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "expressionevaluator.h"
+
+#include "Private/esettings.h"
+
+#include <QHash>
+#include <QJSEngine>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+
+#define MAX_WORKERS 4
+// compiled scripts kept by every worker engine
+#define MAX_PROGRAMS 64
+
+ExpressionBatch::ExpressionBatch(const QString& definitionsStr,
+                                 const QString& scriptStr,
+                                 const QStringList& bindingVars) :
+    mDefinitionsStr(definitionsStr),
+    mScriptStr(scriptStr),
+    mBindingVars(bindingVars) {}
+
+void ExpressionBatch::append(const FrameRange& absRange,
+                             const QVariantList& args) {
+    Q_ASSERT(args.count() == mBindingVars.count());
+    mRanges << absRange;
+    mArgs << args;
+}
+
+FrameRange ExpressionBatch::absRange() const {
+    if(mRanges.isEmpty()) return FrameRange::EMINMAX;
+    return {mRanges.first().fMin, mRanges.last().fMax};
+}
+
+bool ExpressionBatch::isFinished() const {
+    QMutexLocker lock(&mMutex);
+    return mFinished;
+}
+
+bool ExpressionBatch::value(const int absFrame, qreal& result) const {
+    const auto it = std::lower_bound(mRanges.begin(), mRanges.end(), absFrame,
+                                     [](const FrameRange& range, const int frame) {
+        return range.fMax < frame;
+    });
+    if(it == mRanges.end() || !it->inRange(absFrame)) return false;
+    // never wait for the workers, the caller evaluates directly instead
+    QMutexLocker lock(&mMutex);
+    if(!mFinished) return false;
+    const int id = static_cast<int>(it - mRanges.begin());
+    if(id >= mResults.count()) return false;
+    result = mResults.at(id);
+    return !std::isnan(result);
+}
+
+void ExpressionBatch::evaluated(QVector<qreal>&& results) {
+    QMutexLocker lock(&mMutex);
+    mResults = std::move(results);
+    mArgs.clear();
+    mFinished = true;
+}
+
+class ExpressionWorker : public QThread {
+public:
+    ExpressionWorker(ExpressionEvaluator& parent) : mParent(parent) {}
+protected:
+    void run() override {
+        QJSEngine engine;
+        QHash<QString, QJSValue> programs;
+        while(const auto batch = mParent.takeBatch()) {
+            const QString key = batch->mBindingVars.join(',') + '\n' +
+                                batch->mDefinitionsStr + '\n' +
+                                batch->mScriptStr;
+            auto it = programs.find(key);
+            if(it == programs.end()) {
+                if(programs.count() >= MAX_PROGRAMS) programs.clear();
+                it = programs.insert(key, compile(engine, *batch));
+            }
+            batch->evaluated(evaluate(engine, *it, *batch));
+        }
+    }
+private:
+    // definitions are scoped to the program, so that expressions
+    // sharing the engine do not overwrite each other's globals
+    static QJSValue compile(QJSEngine& engine, const ExpressionBatch& batch) {
+        return engine.evaluate(
+                "(function() {\n" +
+                    batch.mDefinitionsStr + "\n;\n"
+                    "var eEvaluate = function(" +
+                        batch.mBindingVars.join(", ") + ") {\n" +
+                        batch.mScriptStr + "\n"
+                    "};\n"
+                    "return function(args, n, count) {\n"
+                    "    var results = new Array(count);\n"
+                    "    for(var i = 0; i < count; i++) {\n"
+                    "        results[i] = eEvaluate.apply(null, args.slice(i*n, i*n + n));\n"
+                    "    }\n"
+                    "    return results;\n"
+                    "};\n"
+                "})()");
+    }
+
+    static QVector<qreal> evaluate(QJSEngine& engine, QJSValue& program,
+                                   const ExpressionBatch& batch) {
+        const int count = batch.mRanges.count();
+        QVector<qreal> results(count, qQNaN());
+        if(!program.isCallable()) return results;
+        const auto ret = program.call({engine.toScriptValue(batch.mArgs),
+                                       batch.mBindingVars.count(), count});
+        if(ret.isError() || !ret.isArray()) return results;
+        for(int i = 0; i < count; i++) {
+            const auto val = ret.property(static_cast<quint32>(i));
+            if(val.isNumber()) results[i] = val.toNumber();
+        }
+        return results;
+    }
+
+    ExpressionEvaluator& mParent;
+};
+
+ExpressionEvaluator::ExpressionEvaluator() {
+    const int count = qBound(1, eSettings::sCpuThreadsCapped(), MAX_WORKERS);
+    for(int i = 0; i < count; i++) {
+        const auto worker = new ExpressionWorker(*this);
+        worker->start(QThread::LowPriority);
+        mWorkers << worker;
+    }
+}
+
+ExpressionEvaluator::~ExpressionEvaluator() {
+    {
+        QMutexLocker lock(&mMutex);
+        mQuit = true;
+        mQueueCond.wakeAll();
+    }
+    for(const auto worker : mWorkers) {
+        worker->wait();
+        delete worker;
+    }
+    for(const auto& batch : mQueue) batch->evaluated({});
+}
+
+ExpressionEvaluator* ExpressionEvaluator::sInstance() {
+    static ExpressionEvaluator instance;
+    return &instance;
+}
+
+void ExpressionEvaluator::evaluate(const stdsptr<ExpressionBatch>& batch) {
+    if(batch->isEmpty()) {
+        batch->evaluated({});
+        return;
+    }
+    QMutexLocker lock(&mMutex);
+    // earlier frames are needed first
+    const int minFrame = batch->absRange().fMin;
+    int id = mQueue.count();
+    while(id > 0 && mQueue.at(id - 1)->absRange().fMin > minFrame) id--;
+    mQueue.insert(id, batch);
+    mQueueCond.wakeOne();
+}
+
+stdsptr<ExpressionBatch> ExpressionEvaluator::takeBatch() {
+    QMutexLocker lock(&mMutex);
+    while(mQueue.isEmpty() && !mQuit) mQueueCond.wait(&mMutex);
+    if(mQuit) return nullptr;
+    return mQueue.takeFirst();
+}
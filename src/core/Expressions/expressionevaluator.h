@@ -0,0 +1,93 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef EXPRESSIONEVALUATOR_H
+#define EXPRESSIONEVALUATOR_H
+
+#include "core_global.h"
+#include "framerange.h"
+#include "smartPointers/stdselfref.h"
+
+#include <QMutex>
+#include <QVariant>
+#include <QVector>
+#include <QWaitCondition>
+
+class ExpressionWorker;
+
+//! @brief Frames of a single expression evaluated in one script call
+class CORE_EXPORT ExpressionBatch {
+    friend class ExpressionWorker;
+    friend class ExpressionEvaluator;
+public:
+    ExpressionBatch(const QString& definitionsStr,
+                    const QString& scriptStr,
+                    const QStringList& bindingVars);
+
+    //! @brief Frames in absRange share the binding values in args
+    void append(const FrameRange& absRange, const QVariantList& args);
+
+    FrameRange absRange() const;
+    bool isEmpty() const { return mRanges.isEmpty(); }
+
+    bool isFinished() const;
+    //! @brief Returns false if absFrame is not in the batch, the batch is
+    //! not evaluated yet or the script did not return a number for it
+    bool value(const int absFrame, qreal& result) const;
+private:
+    void evaluated(QVector<qreal>&& results);
+
+    const QString mDefinitionsStr;
+    const QString mScriptStr;
+    const QStringList mBindingVars;
+
+    QVector<FrameRange> mRanges;
+    QVariantList mArgs;
+
+    mutable QMutex mMutex;
+    bool mFinished = false;
+    QVector<qreal> mResults;
+};
+
+// Evaluates expression batches on worker threads, every worker owns a
+// QJSEngine, so the GUI thread engine of the Expression is not touched
+class CORE_EXPORT ExpressionEvaluator {
+    ExpressionEvaluator();
+public:
+    ~ExpressionEvaluator();
+
+    static ExpressionEvaluator* sInstance();
+
+    void evaluate(const stdsptr<ExpressionBatch>& batch);
+private:
+    friend class ExpressionWorker;
+    stdsptr<ExpressionBatch> takeBatch();
+
+    QMutex mMutex;
+    QWaitCondition mQueueCond;
+    bool mQuit = false;
+    QList<stdsptr<ExpressionBatch>> mQueue;
+    QList<ExpressionWorker*> mWorkers;
+};
+
+#endif // EXPRESSIONEVALUATOR_H
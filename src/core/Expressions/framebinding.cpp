@@ -44,6 +44,12 @@ QJSValue FrameBinding::getJSValue(QJSEngine& e, const qreal relFrame) {
     return this->relFrame();
 }
 
+QJSValue FrameBinding::getJSValueAtAbsFrame(QJSEngine& e, const int absFrame) {
+    Q_UNUSED(e)
+    if(mContext) return mContext->prp_absFrameToRelFrameF(absFrame);
+    return relFrame();
+}
+
 FrameRange FrameBinding::identicalRelRange(const int absFrame) {
     if(mContext) {
         const int relFrame = mContext->prp_absFrameToRelFrame(absFrame);
@@ -83,6 +83,29 @@ QJSValue PropertyBinding::getJSValue(QJSEngine& e, const qreal relFrame) {
     else return QJSValue::NullValue;
 }
 
+QJSValue PropertyBinding::getJSValueAtAbsFrame(QJSEngine& e, const int absFrame) {
+    if(mBindPathValid && mBindProperty) {
+        const qreal relFrame = mBindProperty->prp_absFrameToRelFrameF(absFrame);
+        return mBindProperty->prp_getEffectiveJSValue(e, relFrame);
+    } else return QJSValue::NullValue;
+}
+
+bool PropertyBinding::prefetchPending(const int absFrame) {
+    if(!mBindPathValid || !mBindProperty) return false;
+    bool pending = false;
+    const auto op = [&pending, absFrame](Property* const prop) {
+        if(pending) return;
+        if(const auto qa = enve_cast<QrealAnimator*>(prop)) {
+            pending = qa->expressionPrefetchPending(absFrame);
+        }
+    };
+    op(mBindProperty.get());
+    if(const auto ca = enve_cast<ComplexAnimator*>(mBindProperty.get())) {
+        ca->ca_execOnDescendants(op);
+    }
+    return pending;
+}
+
 bool PropertyBinding::dependsOn(const Property* const prop) {
     if(!mBindProperty) return false;
     return mBindProperty == prop || mBindProperty->prp_dependsOn(prop);
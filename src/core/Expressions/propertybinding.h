@@ -52,6 +52,7 @@ public:
 
     QJSValue getJSValue(QJSEngine& e);
     QJSValue getJSValue(QJSEngine& e, const qreal relFrame);
+    QJSValue getJSValueAtAbsFrame(QJSEngine& e, const int absFrame);
 
     FrameRange identicalRelRange(const int absFrame);
     FrameRange nextNonUnaryIdenticalRelRange(const int absFrame);
@@ -60,6 +61,7 @@ public:
 
     bool dependsOn(const Property* const prop);
     bool isValid() const { return mBindPathValid; }
+    bool prefetchPending(const int absFrame);
 
     void setPath(const QString& path);
     Property* getBindProperty() const { return mBindProperty.get(); }
@@ -40,6 +40,8 @@ protected:
 public:
     virtual QJSValue getJSValue(QJSEngine& e) = 0;
     virtual QJSValue getJSValue(QJSEngine& e, const qreal relFrame) = 0;
+    //! @brief Value getJSValue(e) would return with the scene at absFrame
+    virtual QJSValue getJSValueAtAbsFrame(QJSEngine& e, const int absFrame) = 0;
     virtual FrameRange identicalRelRange(const int absFrame) = 0;
     virtual FrameRange nextNonUnaryIdenticalRelRange(const int absFrame) = 0;
     virtual QString path() const = 0;
@@ -48,6 +50,11 @@ public:
         return false;
     }
     virtual bool isValid() const { return true; }
+    //! @brief The bound value at absFrame waits for a prefetched expression
+    virtual bool prefetchPending(const int absFrame) {
+        Q_UNUSED(absFrame)
+        return false;
+    }
 
     bool setAbsFrame(const int absFrame);
 signals:
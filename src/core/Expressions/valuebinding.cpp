@@ -43,6 +43,12 @@ QJSValue ValueBinding::getJSValue(QJSEngine& e, const qreal relFrame) {
     else return QJSValue::NullValue;
 }
 
+QJSValue ValueBinding::getJSValueAtAbsFrame(QJSEngine& e, const int absFrame) {
+    if(!mContext) return QJSValue::NullValue;
+    const qreal relFrame = mContext->prp_absFrameToRelFrameF(absFrame);
+    return mContext->prp_getBaseJSValue(e, relFrame);
+}
+
 FrameRange ValueBinding::identicalRelRange(const int absFrame) {
     Q_UNUSED(absFrame)
     return FrameRange::EMINMAX;
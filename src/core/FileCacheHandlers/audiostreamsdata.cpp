@@ -29,7 +29,7 @@
 AudioStreamsData::AudioStreamsData() {
     connect(eSoundSettings::sInstance, &eSoundSettings::settingsChanged,
             this, [this]() {
-        updateSwrContext();
+        fStreamCache.reset();
     });
 }
 
@@ -45,32 +45,6 @@ stdsptr<const AudioStreamsData> AudioStreamsData::sOpen(
     return result;
 }
 
-void AudioStreamsData::updateSwrContext() {
-    if(mLocked) {
-        mUpdateSwrPlanned = true;
-        return;
-    }
-    mUpdateSwrPlanned = false;
-
-    const auto audCodecPars = fAudioStream->codecpar;
-    const auto sampleFormat = static_cast<AVSampleFormat>(audCodecPars->format);
-
-    if(fSwrContext) swr_free(&fSwrContext);
-    fSwrContext = swr_alloc();
-    av_opt_set_int(fSwrContext, "in_channel_count",  audCodecPars->channels, 0);
-    av_opt_set_int(fSwrContext, "out_channel_count", eSoundSettings::sChannelCount(), 0);
-    av_opt_set_int(fSwrContext, "in_channel_layout",  audCodecPars->channel_layout, 0);
-    av_opt_set_int(fSwrContext, "out_channel_layout", eSoundSettings::sChannelLayout(), 0);
-    av_opt_set_int(fSwrContext, "in_sample_rate", audCodecPars->sample_rate, 0);
-    av_opt_set_int(fSwrContext, "out_sample_rate", eSoundSettings::sSampleRate(), 0);
-    av_opt_set_sample_fmt(fSwrContext, "in_sample_fmt", sampleFormat, 0);
-    av_opt_set_sample_fmt(fSwrContext, "out_sample_fmt", eSoundSettings::sSampleFormat(),  0);
-    swr_init(fSwrContext);
-    if(!swr_is_initialized(fSwrContext)) {
-        RuntimeThrow("Resampler has not been properly initialized");
-    }
-}
-
 stdsptr<AudioStreamsData> AudioStreamsData::sOpen(const QString &path) {
     const auto result = std::shared_ptr<AudioStreamsData>(
                 new AudioStreamsData, AudioStreamsData::sDestroy);
@@ -104,7 +78,6 @@ void AudioStreamsData::close() {
 
     if(fDecodedFrame) av_frame_free(&fDecodedFrame);
     if(fPacket) av_packet_free(&fPacket);
-    if(fSwrContext) swr_free(&fSwrContext);
     if(fCodecContext) {
         avcodec_close(fCodecContext);
         avcodec_free_context(&fCodecContext);
@@ -177,8 +150,6 @@ void AudioStreamsData::open(AVFormatContext * const formatContext) {
         RuntimeThrow("Failed to open codec");
     }
 
-    updateSwrContext();
-
     fPacket = av_packet_alloc();
     if(!fPacket) RuntimeThrow("Error allocating AVPacket");
     fDecodedFrame = av_frame_alloc();
@@ -26,6 +26,7 @@
 #ifndef AUDIOSTREAMSDATA_H
 #define AUDIOSTREAMSDATA_H
 #include "soundreader.h"
+#include "CacheHandlers/soundstreamcache.h"
 
 struct CORE_EXPORT AudioStreamsData : public QObject {
 private:
@@ -51,7 +52,6 @@ public:
     bool unlock() {
         if(!mLocked) return false;
         mLocked = false;
-        if(mUpdateSwrPlanned) updateSwrContext();
         return true;
     }
 
@@ -64,10 +64,8 @@ public:
     AVPacket * fPacket = nullptr;
     AVFrame *fDecodedFrame = nullptr;
     AVCodecContext * fCodecContext = nullptr;
-    struct SwrContext * fSwrContext = nullptr;
-    int fLastDstSample = 0;
-
-    void updateSwrContext();
+    // decoded in order by the SoundReaders needing samples
+    stdsptr<SoundStreamCache> fStreamCache;
 
     static stdsptr<AudioStreamsData> sOpen(const QString& path);
 private:
@@ -80,7 +78,6 @@ private:
     void close();
 
     bool mLocked = false;
-    bool mUpdateSwrPlanned = false;
 };
 
 #endif // AUDIOSTREAMSDATA_H
@@ -39,6 +39,7 @@ extern "C" {
 }
 
 class SoundHandler;
+class SoundStreamCache;
 struct AudioStreamsData;
 
 class CORE_EXPORT SoundReader : public eHddTask {
@@ -68,6 +69,7 @@ private:
     const int mSecondId;
     const SampleRange mSampleRange;
     const eSoundSettingsData mSettings;
+    stdsptr<SoundStreamCache> mStreamCache;
     stdsptr<Samples> mSamples;
 };
 
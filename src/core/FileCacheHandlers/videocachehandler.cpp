@@ -47,8 +47,9 @@ ImageCacheContainer* VideoFrameHandler::getFrameAtOrBeforeFrame(const int relFra
 }
 
 void VideoFrameHandler::frameLoaderFinished(const int frame,
-                                            const sk_sp<SkImage>& image) {
-    mDataHandler->frameLoaderFinished(frame, image);
+                                            const sk_sp<SkImage>& image,
+                                            const qint64 costUs) {
+    mDataHandler->frameLoaderFinished(frame, image, costUs);
     removeFrameLoader(frame);
 }
 
@@ -95,19 +96,59 @@ VideoFrameLoader *VideoFrameHandler::addFrameConverter(
     return loader.get();
 }
 
+VideoFrameLoader *VideoFrameHandler::addDecoderFrameLoader(const int frameId) {
+    const auto loader = enve::make_shared<VideoFrameLoader>(
+                    this, mVideoStreamsData, frameId);
+    mDataHandler->addFrameLoader(frameId, loader);
+    mDecoderFrames.insert(frameId);
+    return loader.get();
+}
+
 void VideoFrameHandler::removeFrameLoader(const int frame) {
     mDataHandler->removeFrameLoader(frame);
     mNeededFrames.erase(frame);
+    mDecoderFrames.erase(frame);
+}
+
+void VideoFrameHandler::decoderFramesDecoded() {
+    const auto frames = mDecoderFrames;
+    for(const int frame : frames) {
+        const auto loader = getFrameLoader(frame);
+        if(!loader || loader->getState() != eTaskState::created) {
+            mDecoderFrames.erase(frame);
+            continue;
+        }
+        const auto decoded = mDecoder ? mDecoder->takeFrame(frame) : nullptr;
+        if(decoded) {
+            loader->setFrameToConvert(decoded, mVideoStreamsData->fCodecContext);
+        } else if(mDecoder && mDecoder->pending(frame)) {
+            continue;
+        }
+        // without a decoded frame it is read with a seek
+        mDecoderFrames.erase(frame);
+        loader->queTask();
+    }
 }
 
 void VideoFrameHandler::openVideoStream()
 {
+    mDecoder.reset();
+    // loaders left waiting for the previous decoder
+    decoderFramesDecoded();
     const auto filePath = mDataHandler->getFilePath();
     mVideoStreamsData = VideoStreamsData::sOpen(filePath);
     mDataHandler->setFrameCount(mVideoStreamsData->fFrameCount);
     mDataHandler->setFps(mVideoStreamsData->fFps);
     mDataHandler->setDim(QSize(mVideoStreamsData->fWidth,
                                mVideoStreamsData->fHeight));
+    const auto codecContext = mVideoStreamsData->fCodecContext;
+    mDecoder = std::make_unique<VideoDecoder>(filePath,
+                                              codecContext->width,
+                                              codecContext->height,
+                                              codecContext->pix_fmt);
+    connect(mDecoder.get(), &VideoDecoder::framesDecoded,
+            this, &VideoFrameHandler::decoderFramesDecoded,
+            Qt::QueuedConnection);
 }
 
 eTask* VideoFrameHandler::scheduleFrameLoad(const int frame) {
@@ -118,6 +159,15 @@ eTask* VideoFrameHandler::scheduleFrameLoad(const int frame) {
     if(mDataHandler->getFrameAtFrame(frame)) return nullptr;
     const auto loadTask = mDataHandler->scheduleFrameHddCacheLoad(frame);
     if(loadTask) return loadTask;
+    if(mDecoder && mDecoder->request(frame)) {
+        const auto decoded = mDecoder->takeFrame(frame);
+        if(decoded) {
+            const auto converter = addFrameConverter(frame, decoded);
+            converter->queTask();
+            return converter;
+        }
+        return addDecoderFrameLoader(frame);
+    }
     const auto loader = addFrameLoader(frame);
     loader->queTask();
     return loader;
@@ -192,10 +242,13 @@ void VideoDataHandler::removeFrameLoader(const int frame) {
 }
 
 void VideoDataHandler::frameLoaderFinished(const int frame,
-                                           const sk_sp<SkImage> &image) {
+                                           const sk_sp<SkImage> &image,
+                                           const qint64 costUs) {
     if(image) {
-        mFramesCache.add(enve::make_shared<ImageCacheContainer>(
-                             image, FrameRange{frame, frame}, &mFramesCache));
+        const auto cont = enve::make_shared<ImageCacheContainer>(
+                    image, FrameRange{frame, frame}, &mFramesCache);
+        cont->setCost(costUs);
+        mFramesCache.add(cont);
     } else {
         mFrameCount = frame;
         emit frameCountUpdated(mFrameCount);
@@ -28,6 +28,7 @@
 
 #include "animationcachehandler.h"
 #include "videostreamsdata.h"
+#include "videodecoder.h"
 #include "filecachehandler.h"
 #include "CacheHandlers/hddcachablecachehandler.h"
 
@@ -49,7 +50,8 @@ public:
     void addFrameLoader(const int frameId, const stdsptr<VideoFrameLoader>& loader);
     VideoFrameLoader * getFrameLoader(const int frame) const;
     void removeFrameLoader(const int frame);
-    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image);
+    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image,
+                             const qint64 costUs);
     eTask* scheduleFrameHddCacheLoad(const int frame);
     ImageCacheContainer* getFrameAtFrame(const int relFrame) const;
     ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame) const;
@@ -86,7 +88,8 @@ public:
 
     void afterSourceChanged();
 
-    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image);
+    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image,
+                             const qint64 costUs);
     void frameLoaderCanceled(const int frameId);
     void frameLoaderFailed(const int frameId);
 
@@ -96,14 +99,20 @@ protected:
     VideoFrameLoader * getFrameLoader(const int frame);
     VideoFrameLoader * addFrameLoader(const int frameId);
     VideoFrameLoader * addFrameConverter(const int frameId, AVFrame * const frame);
+    VideoFrameLoader * addDecoderFrameLoader(const int frameId);
     void removeFrameLoader(const int frame);
 
     void openVideoStream();
 private:
+    void decoderFramesDecoded();
+
     std::set<int> mNeededFrames;
+    // loaders waiting for mDecoder, not qued yet
+    std::set<int> mDecoderFrames;
 
     VideoDataHandler* const mDataHandler;
     stdsptr<VideoStreamsData> mVideoStreamsData;
+    std::unique_ptr<VideoDecoder> mDecoder;
 };
 #include "CacheHandlers/soundcachehandler.h"
 class CORE_EXPORT VideoFileHandler : public FileCacheHandler {
@@ -0,0 +1,199 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "videodecoder.h"
+#include "videoframeloader.h"
+
+// memory available to decoded frames waiting in the read-ahead window
+#define READ_AHEAD_BYTES (256*1024*1024)
+#define MIN_READ_AHEAD_FRAMES 2
+#define MAX_READ_AHEAD_FRAMES 32
+
+VideoDecoder::VideoDecoder(const QString& path,
+                           const int width, const int height,
+                           const AVPixelFormat format) :
+    mPath(path) {
+    const int frameBytes = av_image_get_buffer_size(format, width, height, 1);
+    const int frames = frameBytes > 0 ? READ_AHEAD_BYTES/frameBytes :
+                                        MIN_READ_AHEAD_FRAMES;
+    mCapacity = qBound(MIN_READ_AHEAD_FRAMES, frames, MAX_READ_AHEAD_FRAMES);
+    mThread = std::thread(&VideoDecoder::run, this);
+}
+
+VideoDecoder::~VideoDecoder() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+        mCondition.notify_one();
+    }
+    mThread.join();
+    clearFrames();
+}
+
+AVFrame* VideoDecoder::takeFrame(const int frame) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    const auto it = mFrames.find(frame);
+    if(it == mFrames.end()) return nullptr;
+    const auto result = it->second;
+    mFrames.erase(it);
+    mCondition.notify_one();
+    return result;
+}
+
+bool VideoDecoder::request(const int frame) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(mFailed) return false;
+    if(pendingNoLock(frame)) {
+        // playback moved past these
+        mFrames.erase(mFrames.begin(), mFrames.lower_bound(frame));
+        mCondition.notify_one();
+        return true;
+    }
+    // a straggler just behind the window does not move it
+    if(mCursor >= 0 && frame < mCursor && frame >= mCursor - mCapacity) {
+        return false;
+    }
+    // the requested frame is read with a seek,
+    // read ahead from the next one
+    clearFrames();
+    mCursor = frame + 1;
+    mSeekTo = mCursor;
+    mEof = false;
+    mCondition.notify_one();
+    return false;
+}
+
+bool VideoDecoder::pending(const int frame) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return pendingNoLock(frame);
+}
+
+bool VideoDecoder::pendingNoLock(const int frame) const {
+    if(mFailed || mCursor < 0) return false;
+    if(mFrames.find(frame) != mFrames.end()) return true;
+    return !mEof && frame >= mCursor && frame < mCursor + mCapacity;
+}
+
+void VideoDecoder::clearFrames() {
+    for(auto& frame : mFrames) av_frame_free(&frame.second);
+    mFrames.clear();
+}
+
+void VideoDecoder::run() {
+    try {
+        mStreams = VideoStreamsData::sOpen(mPath, false);
+    } catch(...) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFailed = true;
+        }
+        emit framesDecoded();
+        return;
+    }
+    const auto videoStream = mStreams->fVideoStream;
+    const qreal fps = mStreams->fFps;
+    AVFrame* decoded = av_frame_alloc();
+    while(true) {
+        int seekTo = -1;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() {
+                if(mStop || mSeekTo >= 0) return true;
+                const int size = static_cast<int>(mFrames.size());
+                return mCursor >= 0 && !mEof && size < mCapacity;
+            });
+            if(mStop) break;
+            seekTo = mSeekTo;
+            mSeekTo = -1;
+        }
+        bool decodedFrame;
+        try {
+            if(seekTo >= 0) {
+                seek(0, seekTo, fps, mStreams->fFormatContext,
+                     mStreams->fVideoStreamIndex, videoStream,
+                     mStreams->fCodecContext);
+                mDraining = false;
+            }
+            decodedFrame = decodeNext(decoded);
+        } catch(...) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFailed = true;
+            clearFrames();
+            break;
+        }
+        bool added = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(mSeekTo >= 0) { // moved while decoding
+                av_frame_unref(decoded);
+                continue;
+            }
+            if(!decodedFrame) {
+                mEof = true;
+                added = true;
+            } else {
+                const int id = frameId(decoded, videoStream, fps);
+                // frames before the seek target are dropped
+                if(id >= mCursor) {
+                    mFrames[id] = decoded;
+                    decoded = av_frame_alloc();
+                    mCursor = id + 1;
+                    added = true;
+                } else av_frame_unref(decoded);
+            }
+        }
+        if(added) emit framesDecoded();
+    }
+    av_frame_free(&decoded);
+    mStreams.reset();
+    // let the waiting frames fall back to VideoFrameLoader
+    if(mFailed) emit framesDecoded();
+}
+
+bool VideoDecoder::decodeNext(AVFrame * const frame) {
+    const auto formatContext = mStreams->fFormatContext;
+    const auto codecContext = mStreams->fCodecContext;
+    const auto packet = mStreams->fPacket;
+    while(true) {
+        const int recRet = avcodec_receive_frame(codecContext, frame);
+        if(recRet >= 0) return true;
+        if(recRet == AVERROR_EOF) return false;
+        if(recRet != AVERROR(EAGAIN))
+            RuntimeThrow("Did not receive frame from the decoder");
+        if(mDraining) return false;
+
+        const int readRet = av_read_frame(formatContext, packet);
+        if(readRet < 0) { // end of file, drain the decoder
+            mDraining = true;
+            avcodec_send_packet(codecContext, nullptr);
+            continue;
+        }
+        if(packet->stream_index != mStreams->fVideoStreamIndex) {
+            av_packet_unref(packet);
+            continue;
+        }
+        const int sendRet = avcodec_send_packet(codecContext, packet);
+        av_packet_unref(packet);
+        if(sendRet < 0) RuntimeThrow("Sending packet to the decoder failed");
+    }
+}
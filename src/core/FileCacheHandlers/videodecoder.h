@@ -0,0 +1,77 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef VIDEODECODER_H
+#define VIDEODECODER_H
+
+#include "videostreamsdata.h"
+
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Decodes a video file sequentially on its own thread, with its own
+// AVCodecContext, keeping a window of decoded frames ahead of playback.
+// Random access is left to VideoFrameLoader and its seek logic.
+class CORE_EXPORT VideoDecoder : public QObject {
+    Q_OBJECT
+public:
+    VideoDecoder(const QString& path,
+                 const int width, const int height,
+                 const AVPixelFormat format);
+    ~VideoDecoder();
+
+    //! @brief Takes ownership of the decoded frame, nullptr if not decoded
+    AVFrame* takeFrame(const int frame);
+    //! @brief Returns true if the frame is going to be decoded,
+    //! false if it has to be read with a seek.
+    bool request(const int frame);
+    //! @brief Returns true if the frame is decoded or still ahead
+    bool pending(const int frame);
+signals:
+    //! @brief Emitted from the decoder thread
+    void framesDecoded();
+private:
+    void run();
+    bool decodeNext(AVFrame * const frame);
+    bool pendingNoLock(const int frame) const;
+    void clearFrames();
+
+    const QString mPath;
+    int mCapacity = 0;
+    stdsptr<VideoStreamsData> mStreams;
+    bool mDraining = false;
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::map<int, AVFrame*> mFrames;
+    int mCursor = -1; // next frame to decode, -1 until first request
+    int mSeekTo = -1;
+    bool mEof = false;
+    bool mFailed = false;
+    bool mStop = false;
+};
+
+#endif // VIDEODECODER_H
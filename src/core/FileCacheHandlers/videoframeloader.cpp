@@ -195,7 +195,7 @@ void VideoFrameLoader::readFrame() {
 
 void VideoFrameLoader::afterProcessing() {
     if(!mCacheHandler) return;
-    mCacheHandler->frameLoaderFinished(mFrameId, mLoadedFrame);
+    mCacheHandler->frameLoaderFinished(mFrameId, mLoadedFrame, processingUs());
     for(auto& excess : mExcessFrames) {
         if(mCacheHandler->getFrameAtFrame(excess.first)) {
             av_frame_unref(excess.second);
@@ -38,8 +38,18 @@ extern "C" {
 }
 
 struct VideoStreamsData;
+
+int frameId(AVFrame * const decodedFrame,
+            AVStream * const videoStream,
+            const qreal fps);
+void seek(const int tryN, const int frameId, const qreal fps,
+          AVFormatContext * const formatContext,
+          const int videoStreamIndex, AVStream * const videoStream,
+          AVCodecContext * const codecContext);
+
 class CORE_EXPORT VideoFrameLoader : public eHddTask {
     e_OBJECT
+    friend class VideoFrameHandler;
 protected:
     VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                      const stdsptr<VideoStreamsData>& openedVideo,
@@ -26,9 +26,11 @@
 #include "videostreamsdata.h"
 #include "Private/esettings.h"
 
-stdsptr<VideoStreamsData> VideoStreamsData::sOpen(const QString &path) {
+stdsptr<VideoStreamsData> VideoStreamsData::sOpen(const QString &path,
+                                                  const bool withAudio) {
     const auto result = std::shared_ptr<VideoStreamsData>(
                 new VideoStreamsData, VideoStreamsData::sDestroy);
+    result->fWithAudio = withAudio;
     result->open(path);
     return result;
 }
@@ -137,6 +139,7 @@ void VideoStreamsData::open(const char * const path)
     int maxThreads = eSettings::sCpuThreadsCapped() - 1;
     if (maxThreads > 0) {
         fCodecContext->thread_count = maxThreads > 16 ? 16 : maxThreads;
+        fCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
     }
 
     if (avcodec_parameters_to_context(fCodecContext,
@@ -170,5 +173,5 @@ void VideoStreamsData::open(const char * const path)
 
     fOpened = true;
 
-    if (hasAudio) { fAudioData = AudioStreamsData::sOpen(fPath); }
+    if (hasAudio && fWithAudio) { fAudioData = AudioStreamsData::sOpen(fPath); }
 }
@@ -58,8 +58,11 @@ public:
 
     stdsptr<const AudioStreamsData> fAudioData;
 
-    static stdsptr<VideoStreamsData> sOpen(const QString& path);
+    static stdsptr<VideoStreamsData> sOpen(const QString& path,
+                                           const bool withAudio = true);
 private:
+    bool fWithAudio = true;
+
     void open(const QString& path);
     void open();
     void open(const char * const path);
@@ -25,31 +25,51 @@
 
 #include "taskexecutor.h"
 
+#include <QThread>
+
+#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+
 QAtomicInt TaskExecutor::sTaskFinishSignals = 0;
 
 void TaskExecutor::processTask(eTask& task) {
     task.process();
 }
 
-QAtomicList<stdsptr<eTask>> CpuTaskExecutor::sTasks;
+bool TaskExecutor::waitTakeTask(stdsptr<eTask>& task,
+                                const std::atomic<bool>& stop) {
+    return mTasks->waitTakeFirst(task, stop);
+}
+
+WorkStealingQue CpuTaskExecutor::sTasks(QThread::idealThreadCount());
 QAtomicInt CpuTaskExecutor::sUseCount = 0;
 
 void CpuTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.append(ready);
 }
 
 void CpuTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.append(ready);
 }
 
 int CpuTaskExecutor::sUsageCount() {
     return sUseCount;
 }
 
+int CpuTaskExecutor::sWorkerCount() {
+    return sTasks.workerCount();
+}
+
 int CpuTaskExecutor::sWaitingTasks() {
     return sTasks.count();
 }
 
+bool CpuTaskExecutor::waitTakeTask(stdsptr<eTask>& task,
+                                   const std::atomic<bool>& stop) {
+    return sTasks.waitTake(mWorkerId, task, stop);
+}
+
 void TaskExecutor::start() {
     processLoop();
 }
@@ -62,13 +82,17 @@ void TaskExecutor::processLoop() {
     mStop = false;
     while(!mStop) {
         stdsptr<eTask> task;
-        if(!mTasks.waitTakeFirst(task, mStop)) break;
+        if(!waitTakeTask(task, mStop)) break;
         mUseCount++;
+        const auto start = Clock::now();
         try {
             processTask(*task);
         } catch(...) {
             task->setException(std::current_exception());
         }
+        const auto time = Clock::now() - start;
+        task->addProcessingUs(std::chrono::duration_cast<
+                              std::chrono::microseconds>(time).count());
 
         const bool nextStep = !task->waitingToCancel() &&
                               task->nextStep();
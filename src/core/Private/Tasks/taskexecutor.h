@@ -30,13 +30,14 @@
 
 #include "Tasks/updatable.h"
 #include "../qatomiclist.h"
+#include "workstealingque.h"
 
 class CORE_EXPORT TaskExecutor : public QObject {
     Q_OBJECT
 public:
     TaskExecutor(QAtomicInt& count,
                  QAtomicList<stdsptr<eTask>>& tasks) :
-        mUseCount(count), mTasks(tasks) {}
+        mUseCount(count), mTasks(&tasks) {}
 
     static QAtomicInt sTaskFinishSignals;
 
@@ -45,27 +46,40 @@ public:
 signals:
     void finishedTask(const stdsptr<eTask>&);
 protected:
+    explicit TaskExecutor(QAtomicInt& count) :
+        mUseCount(count), mTasks(nullptr) {}
+
     void processLoop();
 private:
     virtual void processTask(eTask& task);
+    virtual bool waitTakeTask(stdsptr<eTask>& task,
+                              const std::atomic<bool>& stop);
 
     std::atomic<bool> mStop;
 
     QAtomicInt& mUseCount;
-    QAtomicList<stdsptr<eTask>>& mTasks;
+    QAtomicList<stdsptr<eTask>>* const mTasks;
 };
 
 class CORE_EXPORT CpuTaskExecutor : public TaskExecutor {
 public:
-    CpuTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+    CpuTaskExecutor() : TaskExecutor(sUseCount),
+        mWorkerId(sTasks.takeWorkerId()) {}
 
     static void sAddTask(const stdsptr<eTask>& ready);
     static void sAddTasks(const QList<stdsptr<eTask>>& ready);
     static int sUsageCount();
     static int sWaitingTasks();
+    //! @brief Number of cpu executors the task que is sized for
+    static int sWorkerCount();
 private:
+    bool waitTakeTask(stdsptr<eTask>& task,
+                      const std::atomic<bool>& stop);
+
+    const int mWorkerId;
+
     static QAtomicInt sUseCount;
-    static QAtomicList<stdsptr<eTask>> sTasks;
+    static WorkStealingQue sTasks;
 };
 
 class CORE_EXPORT HddTaskExecutor : public TaskExecutor {
@@ -25,36 +25,37 @@
 
 #include "taskque.h"
 #include "Private/esettings.h"
+#include "hardwareinfo.h"
 
-TaskQue::TaskQue() {}
+TaskQue::TaskQue(const int frame) : mFrame(frame) {}
 
 TaskQue::~TaskQue() {
-    for(const auto& task : mCpuOnly) task->cancel();
-    for(const auto& task : mCpuPreffered) task->cancel();
-    for(const auto& task : mGpuPreffered) task->cancel();
-    for(const auto& task : mGpuOnly) task->cancel();
+    for(const auto& ready : mReady) {
+        for(const auto& task : ready) task->cancel();
+    }
+    for(const auto& waiting : mWaiting) {
+        waiting.fTask->mWaitingQue = nullptr;
+        waiting.fTask->cancel();
+    }
 }
 
 int TaskQue::countQued() const {
-    return mCpuOnly.count() + mCpuPreffered.count() +
-           mGpuPreffered.count() + mGpuOnly.count();
+    return mReadyCount + mWaiting.count();
 }
 
 bool TaskQue::allDone() const { return countQued() == 0; }
 
-void TaskQue::addTask(const stdsptr<eTask> &task) {
-    const auto hwSupport = task->hardwareSupport();
+TaskQue::Category TaskQue::sCategory(const HardwareSupport hwSupport) {
+    if(!HardwareInfo::sGpuAvailable()) return cpuOnly;
     switch(eSettings::sInstance->fAccPreference) {
         case AccPreference::gpuStrongPreference:
             switch(hwSupport) {
                 case HardwareSupport::gpuOnly:
                 case HardwareSupport::gpuPreffered:
                 case HardwareSupport::cpuPreffered:
-                    mGpuOnly << task;
-                    break;
+                    return gpuOnly;
                 case HardwareSupport::cpuOnly:
-                    mCpuOnly << task;
-                    break;
+                    return cpuOnly;
             default:;
             }
             break;
@@ -62,99 +63,117 @@ void TaskQue::addTask(const stdsptr<eTask> &task) {
             switch(hwSupport) {
                 case HardwareSupport::gpuOnly:
                 case HardwareSupport::gpuPreffered:
-                    mGpuOnly << task;
-                    break;
+                    return gpuOnly;
                 case HardwareSupport::cpuPreffered:
-                    mCpuPreffered << task;
-                    break;
+                    return cpuPreffered;
                 case HardwareSupport::cpuOnly:
-                    mCpuOnly << task;
-                    break;
+                    return cpuOnly;
             default:;
             }
             break;
         case AccPreference::defaultPreference:
             switch(hwSupport) {
                 case HardwareSupport::gpuOnly:
-                    mGpuOnly << task;
-                    break;
+                    return gpuOnly;
                 case HardwareSupport::gpuPreffered:
-                    mGpuPreffered << task;
-                    break;
+                    return gpuPreffered;
                 case HardwareSupport::cpuPreffered:
-                    mCpuPreffered << task;
-                    break;
+                    return cpuPreffered;
                 case HardwareSupport::cpuOnly:
-                    mCpuOnly << task;
-                    break;
+                    return cpuOnly;
             default:;
             }
             break;
         case AccPreference::cpuSoftPreference:
             switch(hwSupport) {
                 case HardwareSupport::gpuOnly:
-                    mGpuOnly << task;
-                    break;
+                    return gpuOnly;
                 case HardwareSupport::gpuPreffered:
-                    mGpuPreffered << task;
-                    break;
+                    return gpuPreffered;
                 case HardwareSupport::cpuPreffered:
                 case HardwareSupport::cpuOnly:
-                    mCpuOnly << task;
-                    break;
+                    return cpuOnly;
             default:;
             }
             break;
         case AccPreference::cpuStrongPreference:
             switch(hwSupport) {
                 case HardwareSupport::gpuOnly:
-                    mGpuOnly << task;
-                    break;
+                    return gpuOnly;
                 case HardwareSupport::gpuPreffered:
                 case HardwareSupport::cpuPreffered:
                 case HardwareSupport::cpuOnly:
-                    mCpuOnly << task;
-                    break;
+                    return cpuOnly;
             default:;
             }
             break;
     }
+    return nCategories;
 }
 
-stdsptr<eTask> TaskQue::takeQuedForCpuProcessing() {
-    for(int i = 0; i < mCpuOnly.count(); i++) {
-        const auto& task = mCpuOnly.at(i);
-        if(task->readyToBeProcessed())
-            return mCpuOnly.takeAt(i);
-    }
-    for(int i = 0; i < mCpuPreffered.count(); i++) {
-        const auto& task = mCpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mCpuPreffered.takeAt(i);
-    }
-    for(int i = 0; i < mGpuPreffered.count(); i++) {
-        const auto& task = mGpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mGpuPreffered.takeAt(i);
+void TaskQue::setFocusFrame(const int focusFrame) {
+    updatePriority(qAbs(mFrame - focusFrame));
+}
+
+void TaskQue::setDemoted(const bool demoted) {
+    mDemoted = demoted;
+}
+
+void TaskQue::updatePriority(const int priority) {
+    mPriority = priority;
+}
+
+void TaskQue::addTask(const stdsptr<eTask> &task) {
+    const auto category = sCategory(task->hardwareSupport());
+    if(category == nCategories) return;
+    if(task->readyToBeProcessed()) addReadyTask(task, category);
+    else addWaitingTask(task, category);
+}
+
+void TaskQue::addReadyTask(const stdsptr<eTask>& task,
+                           const Category category) {
+    mReady[category] << task;
+    mReadyCount++;
+}
+
+void TaskQue::addWaitingTask(const stdsptr<eTask>& task,
+                             const Category category) {
+    task->mWaitingQue = this;
+    mWaiting.insert(task.get(), {task, category});
+}
+
+void TaskQue::taskReady(eTask* const task) {
+    const auto it = mWaiting.find(task);
+    if(it == mWaiting.end()) return;
+    task->mWaitingQue = nullptr;
+    addReadyTask(it->fTask, it->fCategory);
+    mWaiting.erase(it);
+}
+
+stdsptr<eTask> TaskQue::takeReady(const Category category) {
+    auto& ready = mReady[category];
+    while(!ready.isEmpty()) {
+        const auto task = ready.takeFirst();
+        mReadyCount--;
+        // dependencies can be added after a task became ready
+        if(task->readyToBeProcessed()) return task;
+        addWaitingTask(task, category);
     }
     return nullptr;
 }
 
+stdsptr<eTask> TaskQue::takeQuedForCpuProcessing() {
+    if(mReadyCount == 0) return nullptr;
+    if(const auto task = takeReady(cpuOnly)) return task;
+    if(const auto task = takeReady(cpuPreffered)) return task;
+    if(const auto task = takeReady(gpuPreffered)) return task;
+    return nullptr;
+}
+
 stdsptr<eTask> TaskQue::takeQuedForGpuProcessing() {
-    for(int i = 0; i < mGpuOnly.count(); i++) {
-        const auto& task = mGpuOnly.at(i);
-        if(task->readyToBeProcessed())
-            return mGpuOnly.takeAt(i);
-    }
-    for(int i = 0; i < mGpuPreffered.count(); i++) {
-        const auto& task = mGpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mGpuPreffered.takeAt(i);
-    }
-    for(int i = 0; i < mCpuPreffered.count(); i++) {
-        const auto& task = mCpuPreffered.at(i);
-        if(task->readyToBeProcessed())
-            return mCpuPreffered.takeAt(i);
-    }
+    if(mReadyCount == 0) return nullptr;
+    if(const auto task = takeReady(gpuOnly)) return task;
+    if(const auto task = takeReady(gpuPreffered)) return task;
+    if(const auto task = takeReady(cpuPreffered)) return task;
     return nullptr;
 }
@@ -25,12 +25,16 @@
 
 #ifndef TASKQUE_H
 #define TASKQUE_H
+#include <QHash>
+
 #include "Tasks/updatable.h"
+#include "framerange.h"
 
 class CORE_EXPORT TaskQue {
     friend class TaskQueHandler;
+    friend class eTask;
 public:
-    explicit TaskQue();
+    explicit TaskQue(const int frame);
     TaskQue(const TaskQue&) = delete;
     TaskQue& operator=(const TaskQue&) = delete;
 
@@ -40,12 +44,41 @@ protected:
     bool allDone() const;
     void addTask(const stdsptr<eTask>& task);
 
+    int frame() const { return mFrame; }
+    int priority() const { return mPriority; }
+    bool demoted() const { return mDemoted; }
+    void setFocusFrame(const int focusFrame);
+    void setDemoted(const bool demoted);
+
     stdsptr<eTask> takeQuedForCpuProcessing();
     stdsptr<eTask> takeQuedForGpuProcessing();
 private:
-    QList<stdsptr<eTask>> mGpuOnly;
-    QList<stdsptr<eTask>> mGpuPreffered;
-    QList<stdsptr<eTask>> mCpuPreffered;
-    QList<stdsptr<eTask>> mCpuOnly;
+    enum Category {
+        gpuOnly, gpuPreffered, cpuPreffered, cpuOnly, nCategories
+    };
+
+    struct WaitingTask {
+        stdsptr<eTask> fTask;
+        Category fCategory;
+    };
+
+    static Category sCategory(const HardwareSupport hwSupport);
+
+    void taskReady(eTask* const task);
+    void addReadyTask(const stdsptr<eTask>& task, const Category category);
+    void addWaitingTask(const stdsptr<eTask>& task, const Category category);
+    stdsptr<eTask> takeReady(const Category category);
+    void updatePriority(const int priority);
+
+    //! @brief Frame the tasks were qued for
+    const int mFrame;
+    int mPriority = 0;
+    bool mDemoted = false;
+    int mReadyCount = 0;
+    // only tasks ready to be processed, in the order they became ready
+    QList<stdsptr<eTask>> mReady[nCategories];
+    // tasks waiting for their dependencies, moved to mReady
+    // once the last dependency finishes
+    QHash<eTask*, WaitingTask> mWaiting;
 };
 #endif // TASKQUE_H
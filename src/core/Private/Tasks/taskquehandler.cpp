@@ -25,6 +25,8 @@
 
 #include "taskquehandler.h"
 
+#include <algorithm>
+
 int TaskQueHandler::countQues() const { return mQues.count(); }
 
 bool TaskQueHandler::isEmpty() const { return mQues.isEmpty(); }
@@ -63,10 +65,13 @@ stdsptr<eTask> TaskQueHandler::takeQuedForCpuProcessing() {
     return nullptr;
 }
 
-void TaskQueHandler::beginQue() {
+void TaskQueHandler::beginQue(const int frame) {
     if(mCurrentQue) RuntimeThrow("Previous list not ended");
-    mQues << std::make_shared<TaskQue>();
-    mCurrentQue = mQues.last().get();
+    const auto que = std::make_shared<TaskQue>(frame);
+    que->setFocusFrame(mFocusFrame);
+    mQues << que;
+    mCurrentQue = que.get();
+    sortQues();
 }
 
 void TaskQueHandler::addTask(const stdsptr<eTask> &task) {
@@ -75,7 +80,7 @@ void TaskQueHandler::addTask(const stdsptr<eTask> &task) {
         mTaskCount++;
     } else {
         if(mQues.isEmpty()) {
-            beginQue();
+            beginQue(mFocusFrame);
             addTask(task);
             endQue();
         } else {
@@ -93,6 +98,40 @@ void TaskQueHandler::endQue() {
     mCurrentQue = nullptr;
 }
 
+void TaskQueHandler::setFocusFrame(const int focusFrame) {
+    if(mFocusFrame == focusFrame) return;
+    mFocusFrame = focusFrame;
+    for(const auto& que : mQues) que->setFocusFrame(focusFrame);
+    sortQues();
+}
+
+void TaskQueHandler::demoteFramesOutside(const FrameRange& range) {
+    for(const auto& que : mQues) {
+        que->setDemoted(!range.inRange(que->frame()));
+    }
+    sortQues();
+}
+
+void TaskQueHandler::cancelFramesOutside(const FrameRange& range) {
+    for(int i = 0; i < mQues.count(); i++) {
+        const auto& que = mQues.at(i);
+        if(que.get() == mCurrentQue) continue;
+        if(range.inRange(que->frame())) continue;
+        mTaskCount -= que->countQued();
+        mQues.removeAt(i--);
+    }
+}
+
+void TaskQueHandler::sortQues() {
+    // stable, so ques with equal priority keep their fifo order
+    std::stable_sort(mQues.begin(), mQues.end(),
+                     [](const stdsptr<TaskQue>& a,
+                        const stdsptr<TaskQue>& b) {
+        if(a->demoted() != b->demoted()) return b->demoted();
+        return a->priority() < b->priority();
+    });
+}
+
 void TaskQueHandler::queDone(const TaskQue * const que, const int queId) {
     if(que == mCurrentQue) return;
     mQues.removeAt(queId);
@@ -37,17 +37,23 @@ public:
     stdsptr<eTask> takeQuedForGpuProcessing();
     stdsptr<eTask> takeQuedForCpuProcessing();
 
-    void beginQue();
+    void beginQue(const int frame);
 
     void addTask(const stdsptr<eTask>& task);
 
     void endQue();
 
+    void setFocusFrame(const int focusFrame);
+    void demoteFramesOutside(const FrameRange& range);
+    void cancelFramesOutside(const FrameRange& range);
+
     int taskCount() const { return mTaskCount; }
 private:
     void queDone(const TaskQue * const que, const int queId);
+    void sortQues();
 
     int mTaskCount = 0;
+    int mFocusFrame = 0;
     QList<stdsptr<TaskQue>> mQues;
     TaskQue * mCurrentQue = nullptr;
 };
@@ -39,7 +39,7 @@ TaskScheduler::TaskScheduler() {
     Q_ASSERT(!sInstance);
     sInstance = this;
     qRegisterMetaType<stdsptr<eTask>>();
-    const int numberThreads = qMax(1, QThread::idealThreadCount());
+    const int numberThreads = CpuTaskExecutor::sWorkerCount();
     for(int i = 0; i < numberThreads; i++) {
         const auto taskExecutor = std::make_shared<CpuExecController>(this);
         connect(taskExecutor.get(), &ExecController::finishedTaskSignal,
@@ -155,8 +155,11 @@ void TaskScheduler::queTasks() {
 void TaskScheduler::queScheduledCpuTasks() {
     if(!mAlwaysQue && !shouldQueMoreCpuTasks()) return;
     mCpuQueing = true;
-    mQuedCGTasks.beginQue();
-    for(const auto& it : Document::sInstance->fVisibleScenes) {
+    const auto& scenes = Document::sInstance->fVisibleScenes;
+    const int frame = scenes.empty() ? 0 :
+                      scenes.begin()->first->getCurrentFrame();
+    mQuedCGTasks.beginQue(frame);
+    for(const auto& it : scenes) {
         const auto scene = it.first;
         scene->queTasks();
     }
@@ -287,6 +290,19 @@ void TaskScheduler::setAlwaysQue(const bool alwaysQue) {
     mAlwaysQue = alwaysQue;
 }
 
+void TaskScheduler::setFocusFrame(const int frame) {
+    mQuedCGTasks.setFocusFrame(frame);
+}
+
+void TaskScheduler::demoteFramesOutside(const FrameRange& range) {
+    mQuedCGTasks.demoteFramesOutside(range);
+}
+
+void TaskScheduler::cancelFramesOutside(const FrameRange& range) {
+    mQuedCGTasks.cancelFramesOutside(range);
+    callAllTasksFinishedFunc();
+}
+
 void TaskScheduler::addComplexTask(const qsptr<ComplexTask> &task) {
     if(task->done()) return;
     mComplexTasks << task;
@@ -86,6 +86,10 @@ public:
 
     void setAlwaysQue(const bool alwaysQue);
 
+    void setFocusFrame(const int frame);
+    void demoteFramesOutside(const FrameRange& range);
+    void cancelFramesOutside(const FrameRange& range);
+
     void addComplexTask(const qsptr<ComplexTask>& task);
 
     void enterCriticalMemoryState();
@@ -0,0 +1,142 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "workstealingque.h"
+
+#include "exceptions.h"
+
+#include <QThread>
+
+static thread_local int tWorkerId = -1;
+
+WorkStealingQue::WorkStealingQue(const int nWorkers) :
+    mWorkers(sCreateWorkers(nWorkers)) {}
+
+std::vector<std::unique_ptr<WorkStealingQue::Worker>>
+    WorkStealingQue::sCreateWorkers(const int nWorkers) {
+    std::vector<std::unique_ptr<Worker>> workers;
+    for(int i = 0; i < qMax(1, nWorkers); i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    return workers;
+}
+
+int WorkStealingQue::takeWorkerId() {
+    const int id = mNextWorkerId++;
+    if(id >= workerCount()) RuntimeThrow("No free worker in the que");
+    return id;
+}
+
+void WorkStealingQue::append(const stdsptr<eTask>& task) {
+    append(QList<stdsptr<eTask>>() << task);
+}
+
+void WorkStealingQue::append(const QList<stdsptr<eTask>>& tasks) {
+    const int nWorkers = workerCount();
+    if(tasks.isEmpty()) return;
+    const int nTasks = tasks.count();
+    if(tWorkerId >= 0 && tWorkerId < nWorkers) {
+        auto& worker = *mWorkers.at(tWorkerId);
+        std::lock_guard<std::mutex> lk(worker.fMutex);
+        for(const auto& task : tasks) worker.fTasks.push_back(task);
+    } else {
+        const int nUsed = qMin(nTasks, nWorkers);
+        const uint next = mNextWorker.fetch_add(static_cast<uint>(nUsed));
+        const int first = static_cast<int>(next % static_cast<uint>(nWorkers));
+        // lock each receiving deque only once
+        for(int i = 0; i < nUsed; i++) {
+            auto& worker = *mWorkers.at((first + i) % nWorkers);
+            std::lock_guard<std::mutex> lk(worker.fMutex);
+            for(int j = i; j < nTasks; j += nUsed) {
+                worker.fTasks.push_back(tasks.at(j));
+            }
+        }
+    }
+    mCount += nTasks;
+    if(mSleeping > 0) wakeSleeping(nTasks);
+}
+
+void WorkStealingQue::wakeSleeping(const int count) {
+    int woken = 0;
+    const int nWorkers = workerCount();
+    for(int i = 0; i < nWorkers && woken < count; i++) {
+        auto& worker = *mWorkers.at(i);
+        std::lock_guard<std::mutex> lk(worker.fMutex);
+        if(!worker.fSleeping || worker.fWake) continue;
+        worker.fWake = true;
+        worker.fCv.notify_one();
+        woken++;
+    }
+}
+
+bool WorkStealingQue::takeOwn(Worker& worker, stdsptr<eTask>& task) {
+    std::lock_guard<std::mutex> lk(worker.fMutex);
+    if(worker.fTasks.empty()) return false;
+    task = std::move(worker.fTasks.front());
+    worker.fTasks.pop_front();
+    mCount--;
+    return true;
+}
+
+bool WorkStealingQue::steal(const int thiefId, stdsptr<eTask>& task) {
+    const int nWorkers = workerCount();
+    for(int i = 1; i < nWorkers; i++) {
+        auto& victim = *mWorkers.at((thiefId + i) % nWorkers);
+        std::lock_guard<std::mutex> lk(victim.fMutex);
+        if(victim.fTasks.empty()) continue;
+        task = std::move(victim.fTasks.back());
+        victim.fTasks.pop_back();
+        mCount--;
+        return true;
+    }
+    return false;
+}
+
+bool WorkStealingQue::waitTake(const int workerId, stdsptr<eTask>& task,
+                               const std::atomic<bool>& stop) {
+    auto& self = *mWorkers.at(workerId);
+    tWorkerId = workerId;
+    while(!stop) {
+        if(takeOwn(self, task) || steal(workerId, task)) return true;
+        std::unique_lock<std::mutex> lk(self.fMutex);
+        if(!self.fTasks.empty()) continue;
+        self.fSleeping = true;
+        self.fWake = false;
+        mSleeping++;
+        // tasks appended before we registered as sleeping
+        // will not wake us up, make sure there are none left
+        if(mCount > 0) {
+            self.fSleeping = false;
+            mSleeping--;
+            lk.unlock();
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        self.fCv.wait_for(lk, std::chrono::seconds(1),
+                          [&self]() { return self.fWake; });
+        self.fSleeping = false;
+        self.fWake = false;
+        mSleeping--;
+    }
+    return false;
+}
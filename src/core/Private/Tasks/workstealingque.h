@@ -0,0 +1,86 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef WORKSTEALINGQUE_H
+#define WORKSTEALINGQUE_H
+
+#include <QList>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <condition_variable>
+
+#include "Tasks/etask.h"
+
+// Task que shared by the cpu executors.
+// Each worker owns a deque it takes from the front of,
+// idle workers steal from the back of other deques.
+// Tasks added from a worker thread (e.g. effect sub-tasks) go to
+// that worker's deque, other tasks are spread in round-robin fashion.
+// Producers only wake as many sleeping workers as they add tasks.
+class CORE_EXPORT WorkStealingQue {
+public:
+    // The worker deques are created up front and never reallocated,
+    // so worker threads can run while later workers are still registered
+    explicit WorkStealingQue(const int nWorkers);
+    WorkStealingQue(const WorkStealingQue&) = delete;
+    WorkStealingQue& operator=(const WorkStealingQue&) = delete;
+
+    int workerCount() const { return static_cast<int>(mWorkers.size()); }
+    // Returns the next free worker id, at most workerCount() ids are taken
+    int takeWorkerId();
+
+    void append(const stdsptr<eTask>& task);
+    void append(const QList<stdsptr<eTask>>& tasks);
+
+    bool waitTake(const int workerId, stdsptr<eTask>& task,
+                  const std::atomic<bool>& stop);
+
+    int count() const { return mCount; }
+private:
+    struct Worker {
+        std::mutex fMutex;
+        std::condition_variable fCv;
+        std::deque<stdsptr<eTask>> fTasks;
+        bool fSleeping = false;
+        bool fWake = false;
+    };
+
+    static std::vector<std::unique_ptr<Worker>> sCreateWorkers(
+            const int nWorkers);
+
+    bool takeOwn(Worker& worker, stdsptr<eTask>& task);
+    bool steal(const int thiefId, stdsptr<eTask>& task);
+    void wakeSleeping(const int count);
+
+    std::atomic<int> mCount{0};
+    std::atomic<int> mSleeping{0};
+    std::atomic<uint> mNextWorker{0};
+    std::atomic<int> mNextWorkerId{0};
+    const std::vector<std::unique_ptr<Worker>> mWorkers;
+};
+
+#endif // WORKSTEALINGQUE_H
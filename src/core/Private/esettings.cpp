@@ -191,6 +191,9 @@ eSettings::eSettings(const int cpuThreads,
     gSettings << std::make_shared<eIntSetting>(
                      reinterpret_cast<int&>(fHddCacheMBCap),
                      "hddCacheMBCap", 0);
+    gSettings << std::make_shared<eBoolSetting>(
+                     fHddCacheCompression,
+                     "hddCacheCompression", true);
 
     gSettings << std::make_shared<eQrealSetting>(
                      fInterfaceScaling,
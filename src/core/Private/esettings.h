@@ -102,7 +102,8 @@ public:
 
     bool fHddCache = true;
     QString fHddCacheFolder = ""; // "" - use system default temporary files folder
-    intMB fHddCacheMBCap = intMB(0); // <= 0 - no cap
+    intMB fHddCacheMBCap = intMB(0); // <= 0 - default cap
+    bool fHddCacheCompression = true;
 
     // history
     int fUndoCap = 25; // <= 0 - no cap
@@ -26,6 +26,7 @@
 #include "brightnesscontrasteffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "colorhelpers.h"
 #include "Animators/qrealanimator.h"
@@ -106,20 +107,12 @@ void BrightnessContrastEffectCaller::processCpu(CpuRenderTools& renderTools,
     const int xMax = data.fTexTile.right();
     const int yMin = data.fTexTile.top();
     const int yMax = data.fTexTile.bottom();
+    const int width = xMax - xMin + 1;
 
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
-            const uchar r = *src++;
-            const uchar g = *src++;
-            const uchar b = *src++;
-            const uchar a = *src++;
-
-            *dst++ = (r - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = (g - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = (b - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = a;
-        }
+        PixelKernels::brightnessContrast(src, dst, width,
+                                         mBrightness, mContrast);
     }
 }
@@ -26,6 +26,7 @@
 #include "colorizeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "colorhelpers.h"
 #include "Animators/qrealanimator.h"
@@ -131,38 +132,12 @@ void ColorizeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const int xMax = data.fTexTile.right();
     const int yMin = data.fTexTile.top();
     const int yMax = data.fTexTile.bottom();
+    const int width = xMax - xMin + 1;
 
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
-            const uchar texR = *src++;
-            const uchar texG = *src++;
-            const uchar texB = *src++;
-            const uchar texA = *src++;
-
-            const qreal texRF = texR/255.;
-            const qreal texGF = texG/255.;
-            const qreal texBF = texB/255.;
-            const qreal texAF = texA/255.;
-
-            if(texA == 0) {
-                for(int i = 0; i < 4; i++) *dst++ = 0;
-                continue;
-            }
-            qreal h = texRF/texAF;
-            qreal s = texGF/texAF;
-            qreal l = texBF/texAF;
-            qrgb_to_hsl(h, s, l);
-            h = mHue / 360.;
-            s = mSaturation;
-            l = qBound(0., l + mLightness, 1.);
-            qhsl_to_rgb(h, s, l);
-
-            *dst++ = 255*(h*texAF*mInfluence + texRF*(1 - mInfluence));
-            *dst++ = 255*(s*texAF*mInfluence + texGF*(1 - mInfluence));
-            *dst++ = 255*(l*texAF*mInfluence + texBF*(1 - mInfluence));
-            *dst++ = texA;
-        }
+        PixelKernels::colorize(src, dst, width, mHue, mSaturation,
+                               mLightness, mInfluence);
     }
 }
@@ -112,20 +112,22 @@ stdsptr<RasterEffectCaller> MotionBlurEffect::getEffectCaller(
     qreal sampleCount = mNumberSamples->getEffectiveValue(relFrame)*influence;
     const qreal opacity = mOpacity->getEffectiveValue(relFrame)*0.01*influence;
     const qreal frameStep = mFrameStep->getEffectiveValue(relFrame);
-    if(isZero4Dec(frameStep)) return nullptr;
-
     const int nSamples = qCeil(sampleCount);
-    if(nSamples == 0) return nullptr;
+    if(isZero4Dec(frameStep) || nSamples == 0) {
+        mSamplesCache.clear();
+        return nullptr;
+    }
+
     qreal sampleRelFrame = relFrame - nSamples*frameStep;
     QList<stdsptr<BoxRenderData>> samples;
     for(int i = 0; i < nSamples; i++) {
         if(!idRange.inRange(sampleRelFrame)) {
-            const auto sample = mParentBox->queExternalRender(sampleRelFrame, true);
+            const auto sample = getSample(sampleRelFrame, data);
             if(sample) {
                 if(sample->finished()) {
                     data->fOtherGlobalRects << sample->fGlobalRect;
                 } else {
-                    sample->fMotionBlurTarget = data;
+                    sample->fMotionBlurTargets << data;
                     sample->addDependent(data);
                 }
                 samples << sample;
@@ -134,11 +136,29 @@ stdsptr<RasterEffectCaller> MotionBlurEffect::getEffectCaller(
 
         sampleRelFrame += frameStep;
     }
+    mSamplesCache = samples;
     if(samples.isEmpty()) return nullptr;
     return enve::make_shared<MotionBlurCaller>(
                 instanceHwSupport(), sampleCount, opacity, samples);
 }
 
+stdsptr<BoxRenderData> MotionBlurEffect::getSample(
+        const qreal relFrame, const BoxRenderData * const data) const {
+    const uint stateId = mParentBox->stateId();
+    const auto parentM = mParentBox->getInheritedTransformAtFrame(relFrame);
+    for(const auto& sample : mSamplesCache) {
+        if(sample->fBoxStateId != stateId) continue;
+        if(!isZero4Dec(sample->fRelFrame - relFrame)) continue;
+        if(!isZero4Dec(sample->fResolution - data->fResolution)) continue;
+        if(sample->fInheritedTransform != parentM) continue;
+        const auto state = sample->getState();
+        if(state == eTaskState::canceled || sample->waitingToCancel() ||
+           sample->unhandledException()) continue;
+        return sample;
+    }
+    return mParentBox->queExternalRender(relFrame, true);
+}
+
 FrameRange MotionBlurEffect::getMotionBlurPropsIdenticalRange(const int relFrame) const
 {
     auto range = mParentBox ? mParentBox->getMotionBlurIdenticalRange(relFrame, true) : FrameRange::EMINMAX;
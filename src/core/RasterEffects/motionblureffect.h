@@ -41,8 +41,12 @@ public:
             const qreal influence, BoxRenderData* const data) const;
 private:
     FrameRange getMotionBlurPropsIdenticalRange(const int relFrame) const;
+    stdsptr<BoxRenderData> getSample(const qreal relFrame,
+                                     const BoxRenderData * const data) const;
 
     mutable bool mBlocked = false;
+    // samples used by the last frame, consecutive frames share most
+    mutable QList<stdsptr<BoxRenderData>> mSamplesCache;
     qptr<BoundingBox> mParentBox;
     qsptr<QrealAnimator> mOpacity;
     qsptr<QrealAnimator> mNumberSamples;
@@ -26,6 +26,7 @@
 #include "noisefadeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "Animators/qrealanimator.h"
 
@@ -196,18 +197,18 @@ void NoiseFadeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const qreal t = abs(sin(0.5*PI*mTime));
     const qreal b = 0.25*(0.75 - 0.749*mSharpness);
 
+    const int width = xMax - xMin + 1;
+    std::vector<float> mask(static_cast<size_t>(width));
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
+        const qreal y = yi/imgHeight;
         for(int xi = xMin; xi <= xMax; xi++) {
             const qreal x = xi/imgWidth;
-            const qreal y = yi/imgHeight;
 
             const qreal c = GLSL_smoothstep(t + b, t - b, noise(QPointF{x, y} * .4));
-
-            for(int i = 0; i < 4; i++) {
-                *dst++ = *src++ * (1 - c);
-            }
+            mask[static_cast<size_t>(xi - xMin)] = static_cast<float>(1 - c);
         }
+        PixelKernels::mask(src, dst, mask.data(), width);
     }
 }
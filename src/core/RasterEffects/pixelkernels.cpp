@@ -0,0 +1,417 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "pixelkernels.h"
+#include "colorhelpers.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PIXELKERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace {
+    enum class Isa { scalar, sse41, avx2 };
+
+    Isa detectIsa() {
+#ifdef PIXELKERNELS_X86
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        const int nIds = info[0];
+        __cpuid(info, 1);
+        const bool sse41 = info[2] & (1 << 19);
+        const bool osxsave = info[2] & (1 << 27);
+        const bool avx = info[2] & (1 << 28);
+        bool avx2 = false;
+        // the os has to save the ymm registers as well
+        if(nIds >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+            __cpuidex(info, 7, 0);
+            avx2 = info[1] & (1 << 5);
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse41 = __builtin_cpu_supports("sse4.1");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if(avx2) return Isa::avx2;
+        if(sse41) return Isa::sse41;
+#endif
+        return Isa::scalar;
+    }
+
+    Isa isa() {
+        static const Isa sIsa = detectIsa();
+        return sIsa;
+    }
+
+    // hsl to rgb with fixed hue and saturation is
+    // rgb = l + C*k, C = (1 - |2l - 1|)*s, where k only depends on the hue
+    struct ColorizeParams {
+        float fK[3];
+        float fS;
+        float fL;
+        float fInfl;
+    };
+
+    ColorizeParams colorizeParams(const float hue, const float saturation,
+                                  const float lightness, const float influence) {
+        qreal r = hue/360.;
+        qreal g = 1;
+        qreal b = 0.5;
+        qhsl_to_rgb(r, g, b);
+        return {{static_cast<float>(r - 0.5),
+                 static_cast<float>(g - 0.5),
+                 static_cast<float>(b - 0.5)},
+                qBound(0.f, saturation, 1.f), lightness, influence};
+    }
+
+    void brightnessContrastScalar(const uchar* src, uchar* dst,
+                                  const int count,
+                                  const float k, const float m) {
+        for(int i = 0; i < count; i++) {
+            const float a = src[3];
+            for(int j = 0; j < 3; j++) {
+                const float v = src[j]*k + a*m;
+                dst[j] = static_cast<uchar>(qBound(0.f, v, a));
+            }
+            dst[3] = src[3];
+            src += 4;
+            dst += 4;
+        }
+    }
+
+    void colorizeScalar(const uchar* src, uchar* dst, const int count,
+                        const ColorizeParams& p) {
+        for(int i = 0; i < count; i++) {
+            const float a = src[3];
+            const float mx = std::max({src[0], src[1], src[2]});
+            const float mn = std::min({src[0], src[1], src[2]});
+            const float l = (mx + mn)/(2*std::max(a, 1.f));
+            const float nl = qBound(0.f, l + p.fL, 1.f);
+            const float c = (1 - std::abs(2*nl - 1))*p.fS;
+            for(int j = 0; j < 3; j++) {
+                const float v = (nl + c*p.fK[j])*a*p.fInfl + src[j]*(1 - p.fInfl);
+                dst[j] = static_cast<uchar>(v);
+            }
+            dst[3] = src[3];
+            src += 4;
+            dst += 4;
+        }
+    }
+
+    void maskScalar(const uchar* src, uchar* dst, const float* mask,
+                    const int count) {
+        for(int i = 0; i < count; i++) {
+            const float m = mask[i];
+            for(int j = 0; j < 4; j++) {
+                dst[j] = static_cast<uchar>(src[j]*m);
+            }
+            src += 4;
+            dst += 4;
+        }
+    }
+
+#ifdef PIXELKERNELS_X86
+    // four pixels per iteration, a single pixel in each vector,
+    // returns the number of pixels processed
+    template <typename K>
+    TARGET_SSE41
+    int rowSse41(const uchar* src, uchar* dst, const int count,
+                 const K& kernel) {
+        int i = 0;
+        for(; i + 4 <= count; i += 4) {
+            const auto px = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(src + 4*i));
+            const auto p0 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(px));
+            const auto p1 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(px, 4)));
+            const auto p2 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(px, 8)));
+            const auto p3 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(px, 12)));
+            const auto r0 = _mm_cvttps_epi32(kernel(p0, i));
+            const auto r1 = _mm_cvttps_epi32(kernel(p1, i + 1));
+            const auto r2 = _mm_cvttps_epi32(kernel(p2, i + 2));
+            const auto r3 = _mm_cvttps_epi32(kernel(p3, i + 3));
+            const auto r01 = _mm_packs_epi32(r0, r1);
+            const auto r23 = _mm_packs_epi32(r2, r3);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i),
+                             _mm_packus_epi16(r01, r23));
+        }
+        return i;
+    }
+
+    TARGET_AVX2
+    __m256 loadAvx2(const uchar* src) {
+        const auto px = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(px));
+    }
+
+    // eight pixels per iteration, a pixel in each 128 bit lane
+    template <typename K>
+    TARGET_AVX2
+    int rowAvx2(const uchar* src, uchar* dst, const int count,
+                const K& kernel) {
+        // packing interleaves the lanes
+        const auto order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        int i = 0;
+        for(; i + 8 <= count; i += 8) {
+            const auto s = src + 4*i;
+            const auto r01 = _mm256_cvttps_epi32(kernel(loadAvx2(s), i));
+            const auto r23 = _mm256_cvttps_epi32(kernel(loadAvx2(s + 8), i + 2));
+            const auto r45 = _mm256_cvttps_epi32(kernel(loadAvx2(s + 16), i + 4));
+            const auto r67 = _mm256_cvttps_epi32(kernel(loadAvx2(s + 24), i + 6));
+            const auto r0123 = _mm256_packs_epi32(r01, r23);
+            const auto r4567 = _mm256_packs_epi32(r45, r67);
+            const auto packed = _mm256_packus_epi16(r0123, r4567);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i),
+                                _mm256_permutevar8x32_epi32(packed, order));
+        }
+        return i;
+    }
+
+    struct BrightnessContrastSse41 {
+        __m128 fK;
+        __m128 fM;
+
+        TARGET_SSE41
+        __m128 operator()(const __m128 px, const int) const {
+            const auto a = _mm_shuffle_ps(px, px, _MM_SHUFFLE(3, 3, 3, 3));
+            auto v = _mm_add_ps(_mm_mul_ps(px, fK), _mm_mul_ps(a, fM));
+            v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), a);
+            return _mm_blend_ps(v, a, 0x8);
+        }
+    };
+
+    struct BrightnessContrastAvx2 {
+        __m256 fK;
+        __m256 fM;
+
+        TARGET_AVX2
+        __m256 operator()(const __m256 px, const int) const {
+            const auto a = _mm256_shuffle_ps(px, px, _MM_SHUFFLE(3, 3, 3, 3));
+            auto v = _mm256_add_ps(_mm256_mul_ps(px, fK), _mm256_mul_ps(a, fM));
+            v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), a);
+            return _mm256_blend_ps(v, a, 0x88);
+        }
+    };
+
+    struct ColorizeSse41 {
+        __m128 fK;
+        __m128 fS;
+        __m128 fL;
+        __m128 fInfl;
+        __m128 fInvInfl;
+
+        TARGET_SSE41
+        __m128 operator()(const __m128 px, const int) const {
+            const auto one = _mm_set1_ps(1);
+            const auto two = _mm_set1_ps(2);
+            const auto a = _mm_shuffle_ps(px, px, _MM_SHUFFLE(3, 3, 3, 3));
+            // rotated rgb, the max and min end up in each of the rgb lanes
+            const auto gbr = _mm_shuffle_ps(px, px, _MM_SHUFFLE(3, 0, 2, 1));
+            const auto brg = _mm_shuffle_ps(px, px, _MM_SHUFFLE(3, 1, 0, 2));
+            const auto mx = _mm_max_ps(px, _mm_max_ps(gbr, brg));
+            const auto mn = _mm_min_ps(px, _mm_min_ps(gbr, brg));
+            const auto l = _mm_div_ps(_mm_add_ps(mx, mn),
+                                      _mm_mul_ps(two, _mm_max_ps(a, one)));
+            const auto nl = _mm_min_ps(_mm_max_ps(_mm_add_ps(l, fL),
+                                                  _mm_setzero_ps()), one);
+            const auto d = _mm_sub_ps(_mm_mul_ps(two, nl), one);
+            const auto absD = _mm_andnot_ps(_mm_set1_ps(-0.f), d);
+            const auto c = _mm_mul_ps(_mm_sub_ps(one, absD), fS);
+            const auto rgb = _mm_add_ps(nl, _mm_mul_ps(c, fK));
+            const auto v = _mm_add_ps(_mm_mul_ps(rgb, _mm_mul_ps(a, fInfl)),
+                                      _mm_mul_ps(px, fInvInfl));
+            return _mm_blend_ps(v, a, 0x8);
+        }
+    };
+
+    struct ColorizeAvx2 {
+        __m256 fK;
+        __m256 fS;
+        __m256 fL;
+        __m256 fInfl;
+        __m256 fInvInfl;
+
+        TARGET_AVX2
+        __m256 operator()(const __m256 px, const int) const {
+            const auto one = _mm256_set1_ps(1);
+            const auto two = _mm256_set1_ps(2);
+            const auto a = _mm256_shuffle_ps(px, px, _MM_SHUFFLE(3, 3, 3, 3));
+            const auto gbr = _mm256_shuffle_ps(px, px, _MM_SHUFFLE(3, 0, 2, 1));
+            const auto brg = _mm256_shuffle_ps(px, px, _MM_SHUFFLE(3, 1, 0, 2));
+            const auto mx = _mm256_max_ps(px, _mm256_max_ps(gbr, brg));
+            const auto mn = _mm256_min_ps(px, _mm256_min_ps(gbr, brg));
+            const auto l = _mm256_div_ps(_mm256_add_ps(mx, mn),
+                                         _mm256_mul_ps(two, _mm256_max_ps(a, one)));
+            const auto nl = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(l, fL),
+                                                        _mm256_setzero_ps()), one);
+            const auto d = _mm256_sub_ps(_mm256_mul_ps(two, nl), one);
+            const auto absD = _mm256_andnot_ps(_mm256_set1_ps(-0.f), d);
+            const auto c = _mm256_mul_ps(_mm256_sub_ps(one, absD), fS);
+            const auto rgb = _mm256_add_ps(nl, _mm256_mul_ps(c, fK));
+            const auto v = _mm256_add_ps(_mm256_mul_ps(rgb, _mm256_mul_ps(a, fInfl)),
+                                         _mm256_mul_ps(px, fInvInfl));
+            return _mm256_blend_ps(v, a, 0x88);
+        }
+    };
+
+    struct MaskSse41 {
+        const float* fMask;
+
+        TARGET_SSE41
+        __m128 operator()(const __m128 px, const int i) const {
+            return _mm_mul_ps(px, _mm_set1_ps(fMask[i]));
+        }
+    };
+
+    struct MaskAvx2 {
+        const float* fMask;
+
+        TARGET_AVX2
+        __m256 operator()(const __m256 px, const int i) const {
+            const float m0 = fMask[i];
+            const float m1 = fMask[i + 1];
+            const auto m = _mm256_setr_ps(m0, m0, m0, m0, m1, m1, m1, m1);
+            return _mm256_mul_ps(px, m);
+        }
+    };
+
+    TARGET_SSE41
+    int brightnessContrastSse41(const uchar* src, uchar* dst, const int count,
+                                const float k, const float m) {
+        const BrightnessContrastSse41 kernel{_mm_set1_ps(k), _mm_set1_ps(m)};
+        return rowSse41(src, dst, count, kernel);
+    }
+
+    TARGET_AVX2
+    int brightnessContrastAvx2(const uchar* src, uchar* dst, const int count,
+                               const float k, const float m) {
+        const BrightnessContrastAvx2 kernel{_mm256_set1_ps(k), _mm256_set1_ps(m)};
+        return rowAvx2(src, dst, count, kernel);
+    }
+
+    TARGET_SSE41
+    int colorizeSse41(const uchar* src, uchar* dst, const int count,
+                      const ColorizeParams& p) {
+        const ColorizeSse41 kernel{
+            _mm_setr_ps(p.fK[0], p.fK[1], p.fK[2], 0),
+            _mm_set1_ps(p.fS), _mm_set1_ps(p.fL),
+            _mm_set1_ps(p.fInfl), _mm_set1_ps(1 - p.fInfl)};
+        return rowSse41(src, dst, count, kernel);
+    }
+
+    TARGET_AVX2
+    int colorizeAvx2(const uchar* src, uchar* dst, const int count,
+                     const ColorizeParams& p) {
+        const ColorizeAvx2 kernel{
+            _mm256_setr_ps(p.fK[0], p.fK[1], p.fK[2], 0,
+                           p.fK[0], p.fK[1], p.fK[2], 0),
+            _mm256_set1_ps(p.fS), _mm256_set1_ps(p.fL),
+            _mm256_set1_ps(p.fInfl), _mm256_set1_ps(1 - p.fInfl)};
+        return rowAvx2(src, dst, count, kernel);
+    }
+
+    TARGET_SSE41
+    int maskSse41(const uchar* src, uchar* dst, const float* mask,
+                  const int count) {
+        return rowSse41(src, dst, count, MaskSse41{mask});
+    }
+
+    TARGET_AVX2
+    int maskAvx2(const uchar* src, uchar* dst, const float* mask,
+                 const int count) {
+        return rowAvx2(src, dst, count, MaskAvx2{mask});
+    }
+#endif
+}
+
+void PixelKernels::brightnessContrast(const uchar* src, uchar* dst,
+                                      const int count,
+                                      const float brightness,
+                                      const float contrast) {
+    // (c - a/2)*(contrast + 1) + a*(brightness + 1/2)
+    const float k = contrast + 1;
+    const float m = brightness + 0.5f - 0.5f*k;
+    int done = 0;
+#ifdef PIXELKERNELS_X86
+    switch(isa()) {
+    case Isa::avx2:
+        done = brightnessContrastAvx2(src, dst, count, k, m);
+        break;
+    case Isa::sse41:
+        done = brightnessContrastSse41(src, dst, count, k, m);
+        break;
+    default: break;
+    }
+#endif
+    brightnessContrastScalar(src + 4*done, dst + 4*done, count - done, k, m);
+}
+
+void PixelKernels::colorize(const uchar* src, uchar* dst, const int count,
+                            const float hue, const float saturation,
+                            const float lightness, const float influence) {
+    const auto p = colorizeParams(hue, saturation, lightness, influence);
+    int done = 0;
+#ifdef PIXELKERNELS_X86
+    switch(isa()) {
+    case Isa::avx2:
+        done = colorizeAvx2(src, dst, count, p);
+        break;
+    case Isa::sse41:
+        done = colorizeSse41(src, dst, count, p);
+        break;
+    default: break;
+    }
+#endif
+    colorizeScalar(src + 4*done, dst + 4*done, count - done, p);
+}
+
+void PixelKernels::mask(const uchar* src, uchar* dst, const float* mask,
+                        const int count) {
+    int done = 0;
+#ifdef PIXELKERNELS_X86
+    switch(isa()) {
+    case Isa::avx2:
+        done = maskAvx2(src, dst, mask, count);
+        break;
+    case Isa::sse41:
+        done = maskSse41(src, dst, mask, count);
+        break;
+    default: break;
+    }
+#endif
+    maskScalar(src + 4*done, dst + 4*done, mask + done, count - done);
+}
@@ -0,0 +1,51 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include "core_global.h"
+
+// Colour operations on rows of premultiplied RGBA8 pixels, used by the
+// cpu paths of the raster effects. An AVX2 or SSE4.1 implementation is
+// picked at runtime, with a scalar fallback. src and dst may be the same.
+namespace PixelKernels {
+    //! @brief brightness and contrast in [-1, 1]
+    CORE_EXPORT
+    void brightnessContrast(const uchar* src, uchar* dst, const int count,
+                            const float brightness, const float contrast);
+
+    //! @brief Replaces hue and saturation, hue in degrees,
+    //! lightness in [-1, 1] is added to the source lightness
+    CORE_EXPORT
+    void colorize(const uchar* src, uchar* dst, const int count,
+                  const float hue, const float saturation,
+                  const float lightness, const float influence);
+
+    //! @brief Multiplies each pixel by the matching mask value in [0, 1]
+    CORE_EXPORT
+    void mask(const uchar* src, uchar* dst, const float* mask,
+              const int count);
+}
+
+#endif // PIXELKERNELS_H
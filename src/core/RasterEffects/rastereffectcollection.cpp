@@ -30,6 +30,7 @@
 #include "RasterEffects/rastereffectsinclude.h"
 #include "RasterEffects/customrastereffectcreator.h"
 #include "rastereffectmenucreator.h"
+#include "hardwareinfo.h"
 
 RasterEffectCollection::RasterEffectCollection() :
     RasterEffectCollectionBase("raster effects") {
@@ -87,6 +88,9 @@ void RasterEffectCollection::addEffects(const qreal relFrame,
     for(const auto& effect : children) {
         const auto rEffect = static_cast<RasterEffect*>(effect.get());
         if(!rEffect->isVisible()) continue;
+        // can't run without a gpu, --renderer refuses such scenes up front
+        if(!HardwareInfo::sGpuAvailable() &&
+           rEffect->instanceHwSupport() == HardwareSupport::gpuOnly) continue;
         if(zeroInfluence && rEffect->skipZeroInfluence(relFrame)) continue;
         const auto effectRenderData = rEffect->getEffectCaller(
                     relFrame, data->fResolution, influence, data);
@@ -26,6 +26,7 @@
 #include "wipeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "Animators/qrealanimator.h"
 
@@ -152,20 +153,22 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const int yMax = data.fTexTile.bottom();
 
     const qreal c = 0.25*PI - direction;
+    // a*cos(direction - asin(y/a)) with a = |(x, y)| is a linear gradient
+    const qreal fx = cos(direction) / (cos(c) * sqrt(2));
+    const qreal fy = sin(direction) / (cos(c) * sqrt(2));
 
+    const int nPixels = xMax - xMin + 1;
+    std::vector<float> mask(static_cast<size_t>(nPixels));
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
+        const qreal y = yi/imgHeight;
         for(int xi = xMin; xi <= xMax; xi++) {
             qreal x = xi/imgWidth;
-            const qreal y = yi/imgHeight;
 
             if(i) x = 1 - x;
 
-            const qreal a = sqrt(x*x + y*y);
-            const qreal b = direction - asin(y / a);
-
-            qreal f = a * cos(b) / (cos(c) * sqrt(2));
+            qreal f = x*fx + y*fy;
 
             if(ii) f = 1 - f;
 
@@ -179,10 +182,8 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
             } else {
                 alpha = 1 - 0.5*(cos(PI*(f - x0)/(1 - mSharpness)) + 1);
             }
-
-            for(int i = 0; i < 4; i++) {
-                *dst++ = *src++ * alpha;
-            }
+            mask[static_cast<size_t>(xi - xMin)] = alpha;
         }
+        PixelKernels::mask(src, dst, mask.data(), nPixels);
     }
 }
@@ -0,0 +1,2270 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "cpushader.h"
+#include "exceptions.h"
+
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <set>
+
+// pixels are shaded in batches, one bit of the mask per pixel
+#define LANES 64
+#define MAX_LOOP_ITERATIONS (1 << 20)
+#define MAX_MACRO_DEPTH 32
+
+typedef uint64_t Mask;
+
+namespace {
+
+enum class Base : char { Void, Bool, Int, Float, Sampler };
+
+struct Type {
+    Base fBase = Base::Void;
+    int fSize = 1;
+
+    bool operator==(const Type& other) const {
+        return fBase == other.fBase && fSize == other.fSize;
+    }
+    bool operator!=(const Type& other) const {
+        return !(*this == other);
+    }
+    bool numeric() const {
+        return fBase == Base::Int || fBase == Base::Float;
+    }
+    bool scalar() const { return fSize == 1; }
+};
+
+bool typeFromName(const std::string& name, Type& type) {
+    static const std::map<std::string, Type> sTypes = {
+        {"void", {Base::Void, 1}},
+        {"bool", {Base::Bool, 1}}, {"bvec2", {Base::Bool, 2}},
+        {"bvec3", {Base::Bool, 3}}, {"bvec4", {Base::Bool, 4}},
+        {"int", {Base::Int, 1}}, {"ivec2", {Base::Int, 2}},
+        {"ivec3", {Base::Int, 3}}, {"ivec4", {Base::Int, 4}},
+        {"uint", {Base::Int, 1}}, {"uvec2", {Base::Int, 2}},
+        {"uvec3", {Base::Int, 3}}, {"uvec4", {Base::Int, 4}},
+        {"float", {Base::Float, 1}}, {"vec2", {Base::Float, 2}},
+        {"vec3", {Base::Float, 3}}, {"vec4", {Base::Float, 4}},
+        {"sampler2D", {Base::Sampler, 1}}
+    };
+    const auto it = sTypes.find(name);
+    if(it == sTypes.end()) return false;
+    type = it->second;
+    return true;
+}
+
+inline bool lane(const Mask mask, const int i) {
+    return (mask >> i) & 1;
+}
+
+Mask truthMask(const float* const values) {
+    Mask mask = 0;
+    for(int i = 0; i < LANES; i++) {
+        if(values[i] != 0.f) mask |= Mask(1) << i;
+    }
+    return mask;
+}
+
+void storeMasked(float* const dst, const float* const src, const Mask mask) {
+    if(mask == ~Mask(0)) {
+        memcpy(dst, src, LANES*sizeof(float));
+        return;
+    }
+    for(int i = 0; i < LANES; i++) {
+        if(lane(mask, i)) dst[i] = src[i];
+    }
+}
+
+struct Context {
+    std::vector<float> fMem;
+    Mask fMask = 0;
+    Mask fBreak = 0;
+    Mask fContinue = 0;
+    Mask fReturned = 0;
+    Mask fDiscarded = 0;
+
+    const uchar* fSrc = nullptr;
+    size_t fSrcRowBytes = 0;
+    int fSrcWidth = 0;
+    int fSrcHeight = 0;
+
+    float* at(const int offset) { return fMem.data() + offset; }
+
+    void sample(const float u, const float v, float* const rgba) const {
+        // bilinear with clamp to edge, like the gpu texture
+        const float x = qBound(-1.f, u*fSrcWidth - 0.5f, float(fSrcWidth));
+        const float y = qBound(-1.f, v*fSrcHeight - 0.5f, float(fSrcHeight));
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const float tx = x - fx;
+        const float ty = y - fy;
+        const int x0 = qBound(0, int(fx), fSrcWidth - 1);
+        const int x1 = qBound(0, int(fx) + 1, fSrcWidth - 1);
+        const int y0 = qBound(0, int(fy), fSrcHeight - 1);
+        const int y1 = qBound(0, int(fy) + 1, fSrcHeight - 1);
+        const uchar* const r0 = fSrc + size_t(y0)*fSrcRowBytes;
+        const uchar* const r1 = fSrc + size_t(y1)*fSrcRowBytes;
+        for(int c = 0; c < 4; c++) {
+            const float top = r0[4*x0 + c]*(1 - tx) + r0[4*x1 + c]*tx;
+            const float bottom = r1[4*x0 + c]*(1 - tx) + r1[4*x1 + c]*tx;
+            rgba[c] = (top*(1 - ty) + bottom*ty)/255.f;
+        }
+    }
+
+    void fetch(const int x, const int y, float* const rgba) const {
+        if(x < 0 || y < 0 || x >= fSrcWidth || y >= fSrcHeight) {
+            for(int c = 0; c < 4; c++) rgba[c] = 0.f;
+            return;
+        }
+        const uchar* const px = fSrc + size_t(y)*fSrcRowBytes + 4*x;
+        for(int c = 0; c < 4; c++) rgba[c] = px[c]/255.f;
+    }
+};
+
+struct Expr {
+    Expr(const Type& type) : fType(type) {}
+    virtual ~Expr() {}
+
+    virtual const float* eval(Context& ctx) const = 0;
+
+    virtual bool assignable() const { return false; }
+    virtual float* ref(Context& ctx) const { Q_UNUSED(ctx) return nullptr; }
+    //! @brief Component of the referenced storage written for component i
+    virtual int comp(const int i) const { return i; }
+
+    const Type fType;
+};
+
+typedef std::unique_ptr<Expr> ExprPtr;
+
+void store(Context& ctx, const Expr& dst, const float* const src) {
+    float* const base = dst.ref(ctx);
+    for(int c = 0; c < dst.fType.fSize; c++) {
+        storeMasked(base + dst.comp(c)*LANES, src + c*LANES, ctx.fMask);
+    }
+}
+
+inline const float* component(const float* const values,
+                              const Type& type, const int c) {
+    return type.scalar() ? values : values + c*LANES;
+}
+
+struct ConstExpr : public Expr {
+    ConstExpr(const Type& type, const int out, const float* const values) :
+        Expr(type), fOut(out) {
+        for(int c = 0; c < type.fSize; c++) fValues[c] = values[c];
+    }
+
+    const float* eval(Context& ctx) const { return ctx.at(fOut); }
+
+    const int fOut;
+    float fValues[4];
+};
+
+struct VarExpr : public Expr {
+    VarExpr(const Type& type, const int offset, const bool readOnly) :
+        Expr(type), fOffset(offset), fReadOnly(readOnly) {}
+
+    const float* eval(Context& ctx) const { return ctx.at(fOffset); }
+    bool assignable() const { return !fReadOnly; }
+    float* ref(Context& ctx) const { return ctx.at(fOffset); }
+
+    const int fOffset;
+    const bool fReadOnly;
+};
+
+struct SwizzleExpr : public Expr {
+    SwizzleExpr(const Type& type, const int out, ExprPtr&& sub,
+                const int* const comps) :
+        Expr(type), fOut(out), fSub(std::move(sub)) {
+        fUnique = true;
+        for(int c = 0; c < type.fSize; c++) {
+            fComps[c] = comps[c];
+            for(int p = 0; p < c; p++) {
+                if(fComps[p] == fComps[c]) fUnique = false;
+            }
+        }
+    }
+
+    const float* eval(Context& ctx) const {
+        const float* const src = fSub->eval(ctx);
+        float* const out = ctx.at(fOut);
+        for(int c = 0; c < fType.fSize; c++) {
+            memcpy(out + c*LANES, src + fComps[c]*LANES, LANES*sizeof(float));
+        }
+        return out;
+    }
+
+    bool assignable() const { return fUnique && fSub->assignable(); }
+    float* ref(Context& ctx) const { return fSub->ref(ctx); }
+    int comp(const int i) const { return fSub->comp(fComps[i]); }
+
+    const int fOut;
+    const ExprPtr fSub;
+    int fComps[4];
+    bool fUnique;
+};
+
+struct IndexExpr : public Expr {
+    IndexExpr(const Type& type, const int out,
+              ExprPtr&& sub, ExprPtr&& index) :
+        Expr(type), fOut(out), fSub(std::move(sub)),
+        fIndex(std::move(index)) {}
+
+    const float* eval(Context& ctx) const {
+        const float* const src = fSub->eval(ctx);
+        const float* const index = fIndex->eval(ctx);
+        float* const out = ctx.at(fOut);
+        const int last = fSub->fType.fSize - 1;
+        for(int i = 0; i < LANES; i++) {
+            const int c = qBound(0, int(index[i]), last);
+            out[i] = src[c*LANES + i];
+        }
+        return out;
+    }
+
+    const int fOut;
+    const ExprPtr fSub;
+    const ExprPtr fIndex;
+};
+
+enum class Op {
+    Add, Sub, Mul, Div, Mod,
+    Lt, Gt, Le, Ge, Eq, Ne,
+    And, Or, Xor,
+    Neg, Not
+};
+
+template <typename F>
+void binaryLoop(float* const out, const float* const a,
+                const float* const b, const F& f) {
+    for(int i = 0; i < LANES; i++) out[i] = f(a[i], b[i]);
+}
+
+void arithmetic(const Op op, const bool isInt, const Type& type,
+                const float* const a, const Type& aType,
+                const float* const b, const Type& bType,
+                float* const out) {
+    for(int c = 0; c < type.fSize; c++) {
+        float* const o = out + c*LANES;
+        const float* const ac = component(a, aType, c);
+        const float* const bc = component(b, bType, c);
+        switch(op) {
+        case Op::Add:
+            binaryLoop(o, ac, bc, [](float x, float y) { return x + y; });
+            break;
+        case Op::Sub:
+            binaryLoop(o, ac, bc, [](float x, float y) { return x - y; });
+            break;
+        case Op::Mul:
+            binaryLoop(o, ac, bc, [](float x, float y) { return x*y; });
+            break;
+        case Op::Div:
+            if(isInt) {
+                binaryLoop(o, ac, bc, [](float x, float y) {
+                    return y == 0.f ? 0.f : std::trunc(x/y);
+                });
+            } else {
+                binaryLoop(o, ac, bc, [](float x, float y) { return x/y; });
+            }
+            break;
+        case Op::Mod:
+            if(isInt) {
+                binaryLoop(o, ac, bc, [](float x, float y) {
+                    return y == 0.f ? 0.f : std::fmod(x, y);
+                });
+            } else {
+                binaryLoop(o, ac, bc, [](float x, float y) {
+                    return x - y*std::floor(x/y);
+                });
+            }
+            break;
+        default: break;
+        }
+    }
+}
+
+struct ArithmeticExpr : public Expr {
+    ArithmeticExpr(const Type& type, const int out, const Op op,
+                   ExprPtr&& a, ExprPtr&& b) :
+        Expr(type), fOut(out), fOp(op), fA(std::move(a)), fB(std::move(b)) {}
+
+    const float* eval(Context& ctx) const {
+        const float* const a = fA->eval(ctx);
+        const float* const b = fB->eval(ctx);
+        float* const out = ctx.at(fOut);
+        arithmetic(fOp, fType.fBase == Base::Int, fType,
+                   a, fA->fType, b, fB->fType, out);
+        return out;
+    }
+
+    const int fOut;
+    const Op fOp;
+    const ExprPtr fA;
+    const ExprPtr fB;
+};
+
+struct CompareExpr : public Expr {
+    CompareExpr(const int out, const Op op, ExprPtr&& a, ExprPtr&& b) :
+        Expr({Base::Bool, 1}), fOut(out), fOp(op),
+        fA(std::move(a)), fB(std::move(b)) {}
+
+    const float* eval(Context& ctx) const {
+        const float* const a = fA->eval(ctx);
+        const float* const b = fB->eval(ctx);
+        float* const out = ctx.at(fOut);
+        switch(fOp) {
+        case Op::Lt:
+            binaryLoop(out, a, b, [](float x, float y) { return float(x < y); });
+            break;
+        case Op::Gt:
+            binaryLoop(out, a, b, [](float x, float y) { return float(x > y); });
+            break;
+        case Op::Le:
+            binaryLoop(out, a, b, [](float x, float y) { return float(x <= y); });
+            break;
+        case Op::Ge:
+            binaryLoop(out, a, b, [](float x, float y) { return float(x >= y); });
+            break;
+        default: {
+            const bool eq = fOp == Op::Eq;
+            for(int i = 0; i < LANES; i++) out[i] = 1.f;
+            for(int c = 0; c < fA->fType.fSize; c++) {
+                const float* const ac = a + c*LANES;
+                const float* const bc = b + c*LANES;
+                for(int i = 0; i < LANES; i++) {
+                    if(ac[i] != bc[i]) out[i] = 0.f;
+                }
+            }
+            if(!eq) {
+                for(int i = 0; i < LANES; i++) out[i] = 1.f - out[i];
+            }
+        }
+        }
+        return out;
+    }
+
+    const int fOut;
+    const Op fOp;
+    const ExprPtr fA;
+    const ExprPtr fB;
+};
+
+struct LogicExpr : public Expr {
+    LogicExpr(const int out, const Op op, ExprPtr&& a, ExprPtr&& b) :
+        Expr({Base::Bool, 1}), fOut(out), fOp(op),
+        fA(std::move(a)), fB(std::move(b)) {}
+
+    const float* eval(Context& ctx) const {
+        const Mask a = truthMask(fA->eval(ctx));
+        const Mask saved = ctx.fMask;
+        // the right operand only runs where it can change the result
+        Mask needed = saved;
+        if(fOp == Op::And) needed &= a;
+        else if(fOp == Op::Or) needed &= ~a;
+        Mask b = 0;
+        if(needed) {
+            ctx.fMask = needed;
+            b = truthMask(fB->eval(ctx));
+            ctx.fMask = saved;
+        }
+        Mask result;
+        if(fOp == Op::And) result = a & b;
+        else if(fOp == Op::Or) result = a | b;
+        else result = a ^ b;
+        float* const out = ctx.at(fOut);
+        for(int i = 0; i < LANES; i++) out[i] = lane(result, i) ? 1.f : 0.f;
+        return out;
+    }
+
+    const int fOut;
+    const Op fOp;
+    const ExprPtr fA;
+    const ExprPtr fB;
+};
+
+struct UnaryExpr : public Expr {
+    UnaryExpr(const Type& type, const int out, const Op op, ExprPtr&& sub) :
+        Expr(type), fOut(out), fOp(op), fSub(std::move(sub)) {}
+
+    const float* eval(Context& ctx) const {
+        const float* const src = fSub->eval(ctx);
+        float* const out = ctx.at(fOut);
+        const int n = fType.fSize*LANES;
+        if(fOp == Op::Neg) {
+            for(int i = 0; i < n; i++) out[i] = -src[i];
+        } else {
+            for(int i = 0; i < n; i++) out[i] = src[i] == 0.f ? 1.f : 0.f;
+        }
+        return out;
+    }
+
+    const int fOut;
+    const Op fOp;
+    const ExprPtr fSub;
+};
+
+struct IncDecExpr : public Expr {
+    IncDecExpr(const int out, const int tmp, ExprPtr&& sub,
+               const float delta, const bool post) :
+        Expr(sub->fType), fOut(out), fTmp(tmp), fSub(std::move(sub)),
+        fDelta(delta), fPost(post) {}
+
+    const float* eval(Context& ctx) const {
+        const float* const src = fSub->eval(ctx);
+        float* const out = ctx.at(fOut);
+        float* const tmp = ctx.at(fTmp);
+        const int n = fType.fSize*LANES;
+        for(int i = 0; i < n; i++) {
+            out[i] = src[i];
+            tmp[i] = src[i] + fDelta;
+        }
+        store(ctx, *fSub, tmp);
+        return fPost ? out : tmp;
+    }
+
+    const int fOut;
+    const int fTmp;
+    const ExprPtr fSub;
+    const float fDelta;
+    const bool fPost;
+};
+
+struct TernaryExpr : public Expr {
+    TernaryExpr(const Type& type, const int out, ExprPtr&& cond,
+                ExprPtr&& a, ExprPtr&& b) :
+        Expr(type), fOut(out), fCond(std::move(cond)),
+        fA(std::move(a)), fB(std::move(b)) {}
+
+    const float* eval(Context& ctx) const {
+        const Mask cond = truthMask(fCond->eval(ctx));
+        const Mask saved = ctx.fMask;
+        float* const out = ctx.at(fOut);
+        const int n = fType.fSize;
+        if(saved & cond) {
+            ctx.fMask = saved & cond;
+            const float* const a = fA->eval(ctx);
+            for(int c = 0; c < n; c++) {
+                storeMasked(out + c*LANES, a + c*LANES, cond);
+            }
+        }
+        if(saved & ~cond) {
+            ctx.fMask = saved & ~cond;
+            const float* const b = fB->eval(ctx);
+            for(int c = 0; c < n; c++) {
+                storeMasked(out + c*LANES, b + c*LANES, ~cond);
+            }
+        }
+        ctx.fMask = saved;
+        return out;
+    }
+
+    const int fOut;
+    const ExprPtr fCond;
+    const ExprPtr fA;
+    const ExprPtr fB;
+};
+
+struct AssignExpr : public Expr {
+    AssignExpr(const int tmp, const Op op, ExprPtr&& dst, ExprPtr&& value) :
+        Expr(dst->fType), fTmp(tmp), fOp(op),
+        fDst(std::move(dst)), fValue(std::move(value)) {}
+
+    const float* eval(Context& ctx) const {
+        const float* value = fValue->eval(ctx);
+        if(fOp != Op::Eq) {
+            const float* const current = fDst->eval(ctx);
+            float* const tmp = ctx.at(fTmp);
+            arithmetic(fOp, fType.fBase == Base::Int, fType,
+                       current, fType, value, fValue->fType, tmp);
+            value = tmp;
+        } else if(fValue->fType.fSize != fType.fSize) {
+            // scalar assigned to every component
+            float* const tmp = ctx.at(fTmp);
+            for(int c = 0; c < fType.fSize; c++) {
+                memcpy(tmp + c*LANES, value, LANES*sizeof(float));
+            }
+            value = tmp;
+        }
+        store(ctx, *fDst, value);
+        return fDst->eval(ctx);
+    }
+
+    const int fTmp;
+    const Op fOp;
+    const ExprPtr fDst;
+    const ExprPtr fValue;
+};
+
+struct SequenceExpr : public Expr {
+    SequenceExpr(ExprPtr&& a, ExprPtr&& b) :
+        Expr(b->fType), fA(std::move(a)), fB(std::move(b)) {}
+
+    const float* eval(Context& ctx) const {
+        fA->eval(ctx);
+        return fB->eval(ctx);
+    }
+
+    const ExprPtr fA;
+    const ExprPtr fB;
+};
+
+// ints are stored as floats, an int to float conversion only changes the type
+struct RetypeExpr : public Expr {
+    RetypeExpr(const Type& type, ExprPtr&& sub) :
+        Expr(type), fSub(std::move(sub)) {}
+
+    const float* eval(Context& ctx) const { return fSub->eval(ctx); }
+
+    const ExprPtr fSub;
+};
+
+void convert(const float* const src, const Base from, const Base to,
+             float* const dst) {
+    if(to == Base::Bool && from != Base::Bool) {
+        for(int i = 0; i < LANES; i++) dst[i] = src[i] != 0.f ? 1.f : 0.f;
+    } else if(to == Base::Int && from == Base::Float) {
+        for(int i = 0; i < LANES; i++) dst[i] = std::trunc(src[i]);
+    } else memcpy(dst, src, LANES*sizeof(float));
+}
+
+struct ConstructExpr : public Expr {
+    ConstructExpr(const Type& type, const int out,
+                  std::vector<ExprPtr>&& args) :
+        Expr(type), fOut(out), fArgs(std::move(args)) {}
+
+    const float* eval(Context& ctx) const {
+        float* const out = ctx.at(fOut);
+        const int n = fType.fSize;
+        if(fArgs.size() == 1 && fArgs.front()->fType.scalar()) {
+            const auto& arg = fArgs.front();
+            convert(arg->eval(ctx), arg->fType.fBase, fType.fBase, out);
+            for(int c = 1; c < n; c++) {
+                memcpy(out + c*LANES, out, LANES*sizeof(float));
+            }
+            return out;
+        }
+        int c = 0;
+        for(const auto& arg : fArgs) {
+            const float* const src = arg->eval(ctx);
+            for(int ac = 0; ac < arg->fType.fSize && c < n; ac++, c++) {
+                convert(src + ac*LANES, arg->fType.fBase, fType.fBase,
+                        out + c*LANES);
+            }
+        }
+        return out;
+    }
+
+    const int fOut;
+    const std::vector<ExprPtr> fArgs;
+};
+
+enum class Fn {
+    Radians, Degrees, Sin, Cos, Tan, Asin, Acos, Atan, Exp, Log, Exp2, Log2,
+    Sqrt, InverseSqrt, Abs, Sign, Floor, Ceil, Fract, Trunc, Round,
+    Pow, Atan2, Mod, Min, Max, Step,
+    Clamp, Mix, Smoothstep,
+    Length, Distance, Dot, Cross, Normalize,
+    Texture, TexelFetch, TextureSize
+};
+
+template <typename F>
+void unaryLoop(float* const out, const float* const a, const F& f) {
+    for(int i = 0; i < LANES; i++) out[i] = f(a[i]);
+}
+
+template <typename F>
+void ternaryLoop(float* const out, const float* const a,
+                 const float* const b, const float* const c, const F& f) {
+    for(int i = 0; i < LANES; i++) out[i] = f(a[i], b[i], c[i]);
+}
+
+struct BuiltinExpr : public Expr {
+    BuiltinExpr(const Type& type, const int out, const Fn fn,
+                std::vector<ExprPtr>&& args) :
+        Expr(type), fOut(out), fFn(fn), fArgs(std::move(args)) {}
+
+    const float* eval(Context& ctx) const {
+        const float* args[3] = {nullptr, nullptr, nullptr};
+        for(size_t i = 0; i < fArgs.size() && i < 3; i++) {
+            if(fArgs[i]->fType.fBase == Base::Sampler) continue;
+            args[i] = fArgs[i]->eval(ctx);
+        }
+        float* const out = ctx.at(fOut);
+        switch(fFn) {
+        case Fn::Length:
+        case Fn::Distance:
+        case Fn::Dot: {
+            const auto& type = fArgs[0]->fType;
+            for(int i = 0; i < LANES; i++) out[i] = 0.f;
+            for(int c = 0; c < type.fSize; c++) {
+                const float* const a = args[0] + c*LANES;
+                if(fFn == Fn::Length) {
+                    for(int i = 0; i < LANES; i++) out[i] += a[i]*a[i];
+                } else if(fFn == Fn::Distance) {
+                    const float* const b = args[1] + c*LANES;
+                    for(int i = 0; i < LANES; i++) {
+                        const float d = a[i] - b[i];
+                        out[i] += d*d;
+                    }
+                } else {
+                    const float* const b = args[1] + c*LANES;
+                    for(int i = 0; i < LANES; i++) out[i] += a[i]*b[i];
+                }
+            }
+            if(fFn != Fn::Dot) unaryLoop(out, out, [](float x) { return std::sqrt(x); });
+            return out;
+        }
+        case Fn::Normalize: {
+            const int n = fType.fSize;
+            for(int i = 0; i < LANES; i++) {
+                float sum = 0.f;
+                for(int c = 0; c < n; c++) {
+                    const float v = args[0][c*LANES + i];
+                    sum += v*v;
+                }
+                const float inv = 1.f/std::sqrt(sum);
+                for(int c = 0; c < n; c++) {
+                    out[c*LANES + i] = args[0][c*LANES + i]*inv;
+                }
+            }
+            return out;
+        }
+        case Fn::Cross: {
+            const float* const a = args[0];
+            const float* const b = args[1];
+            for(int i = 0; i < LANES; i++) {
+                const float ax = a[i], ay = a[LANES + i], az = a[2*LANES + i];
+                const float bx = b[i], by = b[LANES + i], bz = b[2*LANES + i];
+                out[i] = ay*bz - az*by;
+                out[LANES + i] = az*bx - ax*bz;
+                out[2*LANES + i] = ax*by - ay*bx;
+            }
+            return out;
+        }
+        case Fn::Texture: {
+            const float* const u = args[1];
+            const float* const v = args[1] + LANES;
+            float rgba[4];
+            for(int i = 0; i < LANES; i++) {
+                if(!lane(ctx.fMask, i)) continue;
+                ctx.sample(u[i], v[i], rgba);
+                for(int c = 0; c < 4; c++) out[c*LANES + i] = rgba[c];
+            }
+            return out;
+        }
+        case Fn::TexelFetch: {
+            const float* const x = args[1];
+            const float* const y = args[1] + LANES;
+            float rgba[4];
+            for(int i = 0; i < LANES; i++) {
+                if(!lane(ctx.fMask, i)) continue;
+                ctx.fetch(int(x[i]), int(y[i]), rgba);
+                for(int c = 0; c < 4; c++) out[c*LANES + i] = rgba[c];
+            }
+            return out;
+        }
+        case Fn::TextureSize:
+            for(int i = 0; i < LANES; i++) {
+                out[i] = ctx.fSrcWidth;
+                out[LANES + i] = ctx.fSrcHeight;
+            }
+            return out;
+        default: break;
+        }
+
+        for(int c = 0; c < fType.fSize; c++) {
+            float* const o = out + c*LANES;
+            const float* const a = component(args[0], fArgs[0]->fType, c);
+            const float* const b = fArgs.size() > 1 ?
+                        component(args[1], fArgs[1]->fType, c) : nullptr;
+            const float* const d = fArgs.size() > 2 ?
+                        component(args[2], fArgs[2]->fType, c) : nullptr;
+            switch(fFn) {
+            case Fn::Radians:
+                unaryLoop(o, a, [](float x) { return x*float(M_PI/180); });
+                break;
+            case Fn::Degrees:
+                unaryLoop(o, a, [](float x) { return x*float(180/M_PI); });
+                break;
+            case Fn::Sin: unaryLoop(o, a, [](float x) { return std::sin(x); }); break;
+            case Fn::Cos: unaryLoop(o, a, [](float x) { return std::cos(x); }); break;
+            case Fn::Tan: unaryLoop(o, a, [](float x) { return std::tan(x); }); break;
+            case Fn::Asin: unaryLoop(o, a, [](float x) { return std::asin(x); }); break;
+            case Fn::Acos: unaryLoop(o, a, [](float x) { return std::acos(x); }); break;
+            case Fn::Atan: unaryLoop(o, a, [](float x) { return std::atan(x); }); break;
+            case Fn::Exp: unaryLoop(o, a, [](float x) { return std::exp(x); }); break;
+            case Fn::Log: unaryLoop(o, a, [](float x) { return std::log(x); }); break;
+            case Fn::Exp2: unaryLoop(o, a, [](float x) { return std::exp2(x); }); break;
+            case Fn::Log2: unaryLoop(o, a, [](float x) { return std::log2(x); }); break;
+            case Fn::Sqrt: unaryLoop(o, a, [](float x) { return std::sqrt(x); }); break;
+            case Fn::InverseSqrt:
+                unaryLoop(o, a, [](float x) { return 1.f/std::sqrt(x); });
+                break;
+            case Fn::Abs: unaryLoop(o, a, [](float x) { return std::abs(x); }); break;
+            case Fn::Sign:
+                unaryLoop(o, a, [](float x) {
+                    return x > 0.f ? 1.f : (x < 0.f ? -1.f : 0.f);
+                });
+                break;
+            case Fn::Floor: unaryLoop(o, a, [](float x) { return std::floor(x); }); break;
+            case Fn::Ceil: unaryLoop(o, a, [](float x) { return std::ceil(x); }); break;
+            case Fn::Fract:
+                unaryLoop(o, a, [](float x) { return x - std::floor(x); });
+                break;
+            case Fn::Trunc: unaryLoop(o, a, [](float x) { return std::trunc(x); }); break;
+            case Fn::Round: unaryLoop(o, a, [](float x) { return std::round(x); }); break;
+            case Fn::Pow:
+                binaryLoop(o, a, b, [](float x, float y) { return std::pow(x, y); });
+                break;
+            case Fn::Atan2:
+                binaryLoop(o, a, b, [](float y, float x) { return std::atan2(y, x); });
+                break;
+            case Fn::Mod:
+                binaryLoop(o, a, b, [](float x, float y) {
+                    return x - y*std::floor(x/y);
+                });
+                break;
+            case Fn::Min:
+                binaryLoop(o, a, b, [](float x, float y) { return y < x ? y : x; });
+                break;
+            case Fn::Max:
+                binaryLoop(o, a, b, [](float x, float y) { return x < y ? y : x; });
+                break;
+            case Fn::Step:
+                binaryLoop(o, a, b, [](float e, float x) { return x < e ? 0.f : 1.f; });
+                break;
+            case Fn::Clamp:
+                ternaryLoop(o, a, b, d, [](float x, float lo, float hi) {
+                    return qMin(qMax(x, lo), hi);
+                });
+                break;
+            case Fn::Mix:
+                ternaryLoop(o, a, b, d, [](float x, float y, float t) {
+                    return x*(1 - t) + y*t;
+                });
+                break;
+            case Fn::Smoothstep:
+                ternaryLoop(o, a, b, d, [](float e0, float e1, float x) {
+                    const float t = qBound(0.f, (x - e0)/(e1 - e0), 1.f);
+                    return t*t*(3 - 2*t);
+                });
+                break;
+            default: break;
+            }
+        }
+        return out;
+    }
+
+    const int fOut;
+    const Fn fFn;
+    const std::vector<ExprPtr> fArgs;
+};
+
+struct Stmt {
+    virtual ~Stmt() {}
+    virtual void exec(Context& ctx) const = 0;
+};
+
+typedef std::unique_ptr<Stmt> StmtPtr;
+
+enum class Qualifier { In, Out, InOut };
+
+struct Param {
+    Type fType;
+    Qualifier fQualifier;
+    int fOffset;
+};
+
+struct Function {
+    std::string fName;
+    Type fReturn;
+    std::vector<Param> fParams;
+    int fReturnOffset = -1;
+    StmtPtr fBody;
+    std::set<Function*> fCalls;
+};
+
+struct CallExpr : public Expr {
+    CallExpr(const int out, Function* const function,
+             std::vector<ExprPtr>&& args) :
+        Expr(function->fReturn), fOut(out), fFunction(function),
+        fArgs(std::move(args)) {}
+
+    const float* eval(Context& ctx) const {
+        // all arguments first, they might call this function too
+        std::vector<const float*> values(fArgs.size());
+        for(size_t i = 0; i < fArgs.size(); i++) {
+            if(fFunction->fParams[i].fQualifier == Qualifier::Out) continue;
+            values[i] = fArgs[i]->eval(ctx);
+        }
+        for(size_t i = 0; i < fArgs.size(); i++) {
+            if(!values[i]) continue;
+            const auto& param = fFunction->fParams[i];
+            float* const dst = ctx.at(param.fOffset);
+            const auto& argType = fArgs[i]->fType;
+            for(int c = 0; c < param.fType.fSize; c++) {
+                memcpy(dst + c*LANES, component(values[i], argType, c),
+                       LANES*sizeof(float));
+            }
+        }
+        const Mask mask = ctx.fMask;
+        const Mask returned = ctx.fReturned;
+        const Mask breaks = ctx.fBreak;
+        const Mask continues = ctx.fContinue;
+        ctx.fReturned = 0;
+        ctx.fBreak = 0;
+        ctx.fContinue = 0;
+        fFunction->fBody->exec(ctx);
+        ctx.fMask = mask & ~ctx.fDiscarded;
+        ctx.fReturned = returned;
+        ctx.fBreak = breaks;
+        ctx.fContinue = continues;
+        for(size_t i = 0; i < fArgs.size(); i++) {
+            const auto& param = fFunction->fParams[i];
+            if(param.fQualifier == Qualifier::In) continue;
+            store(ctx, *fArgs[i], ctx.at(param.fOffset));
+        }
+        if(fType.fBase == Base::Void) return nullptr;
+        float* const out = ctx.at(fOut);
+        memcpy(out, ctx.at(fFunction->fReturnOffset),
+               fType.fSize*LANES*sizeof(float));
+        return out;
+    }
+
+    const int fOut;
+    Function* const fFunction;
+    const std::vector<ExprPtr> fArgs;
+};
+
+struct ExprStmt : public Stmt {
+    ExprStmt(ExprPtr&& expr) : fExpr(std::move(expr)) {}
+
+    void exec(Context& ctx) const { fExpr->eval(ctx); }
+
+    const ExprPtr fExpr;
+};
+
+struct BlockStmt : public Stmt {
+    void exec(Context& ctx) const {
+        for(const auto& stmt : fStmts) {
+            if(!ctx.fMask) return;
+            stmt->exec(ctx);
+        }
+    }
+
+    std::vector<StmtPtr> fStmts;
+};
+
+struct IfStmt : public Stmt {
+    IfStmt(ExprPtr&& cond, StmtPtr&& then, StmtPtr&& otherwise) :
+        fCond(std::move(cond)), fThen(std::move(then)),
+        fElse(std::move(otherwise)) {}
+
+    void exec(Context& ctx) const {
+        const Mask saved = ctx.fMask;
+        const Mask cond = truthMask(fCond->eval(ctx)) & saved;
+        const Mask other = saved & ~cond;
+        Mask remaining = 0;
+        if(cond) {
+            ctx.fMask = cond;
+            if(fThen) fThen->exec(ctx);
+            remaining |= ctx.fMask;
+        }
+        if(other && fElse) {
+            ctx.fMask = other;
+            fElse->exec(ctx);
+            remaining |= ctx.fMask;
+        } else remaining |= other;
+        ctx.fMask = remaining;
+    }
+
+    const ExprPtr fCond;
+    const StmtPtr fThen;
+    const StmtPtr fElse;
+};
+
+struct LoopStmt : public Stmt {
+    LoopStmt(StmtPtr&& init, ExprPtr&& cond, ExprPtr&& step,
+             StmtPtr&& body, const bool condFirst) :
+        fInit(std::move(init)), fCond(std::move(cond)),
+        fStep(std::move(step)), fBody(std::move(body)),
+        fCondFirst(condFirst) {}
+
+    void exec(Context& ctx) const {
+        const Mask saved = ctx.fMask;
+        const Mask breaks = ctx.fBreak;
+        const Mask continues = ctx.fContinue;
+        if(fInit) fInit->exec(ctx);
+        Mask active = ctx.fMask;
+        for(int i = 0; active && i < MAX_LOOP_ITERATIONS; i++) {
+            ctx.fMask = active;
+            if(fCondFirst && fCond) {
+                active &= truthMask(fCond->eval(ctx));
+                if(!active) break;
+                ctx.fMask = active;
+            }
+            ctx.fContinue = 0;
+            if(fBody) fBody->exec(ctx);
+            // lanes that hit break or return drop out of the loop
+            active = ctx.fMask | ctx.fContinue;
+            ctx.fMask = active;
+            if(!active) break;
+            if(fStep) fStep->eval(ctx);
+            if(!fCondFirst && fCond) {
+                active &= truthMask(fCond->eval(ctx));
+            }
+        }
+        ctx.fMask = saved & ~ctx.fReturned & ~ctx.fDiscarded;
+        ctx.fBreak = breaks;
+        ctx.fContinue = continues;
+    }
+
+    const StmtPtr fInit;
+    const ExprPtr fCond;
+    const ExprPtr fStep;
+    const StmtPtr fBody;
+    const bool fCondFirst;
+};
+
+enum class Jump { Break, Continue, Return, Discard };
+
+struct JumpStmt : public Stmt {
+    JumpStmt(const Jump jump, ExprPtr&& value = nullptr,
+             const int offset = -1) :
+        fJump(jump), fValue(std::move(value)), fOffset(offset) {}
+
+    void exec(Context& ctx) const {
+        switch(fJump) {
+        case Jump::Break: ctx.fBreak |= ctx.fMask; break;
+        case Jump::Continue: ctx.fContinue |= ctx.fMask; break;
+        case Jump::Return:
+            if(fValue) {
+                const float* const value = fValue->eval(ctx);
+                float* const dst = ctx.at(fOffset);
+                const auto& type = fValue->fType;
+                for(int c = 0; c < type.fSize; c++) {
+                    storeMasked(dst + c*LANES, value + c*LANES, ctx.fMask);
+                }
+            }
+            ctx.fReturned |= ctx.fMask;
+            break;
+        case Jump::Discard: ctx.fDiscarded |= ctx.fMask; break;
+        }
+        ctx.fMask = 0;
+    }
+
+    const Jump fJump;
+    const ExprPtr fValue;
+    const int fOffset;
+};
+
+enum class Tok { End, Ident, Int, Float, Op };
+
+struct Token {
+    Tok fType = Tok::End;
+    std::string fText;
+    double fValue = 0;
+    int fLine = 0;
+};
+
+}
+
+struct CpuShaderProgram {
+    struct Uniform {
+        std::string fName;
+        int fOffset;
+        int fSize;
+    };
+
+    std::vector<float> fMemory;
+    std::vector<Uniform> fUniforms;
+    std::vector<std::unique_ptr<Function>> fFunctions;
+    BlockStmt fGlobals;
+    Function* fMain = nullptr;
+    int fFragCoord = -1;
+    int fTexCoord = -1;
+    int fOutput = -1;
+    bool fPixelCenterInteger = false;
+};
+
+namespace {
+
+class Compiler {
+public:
+    Compiler(const std::string& source, CpuShaderProgram& program) :
+        mSource(source), mProgram(program) {}
+
+    void compile() {
+        tokenize();
+        mScopes.emplace_back();
+        declareBuiltins();
+        while(peek().fType != Tok::End) topLevel();
+        if(!mProgram.fMain || !mProgram.fMain->fBody) {
+            error("missing main()");
+        }
+        for(const auto& function : mProgram.fFunctions) {
+            if(!function->fBody && function->fCalls.empty()) continue;
+            std::set<Function*> visiting;
+            checkRecursion(function.get(), visiting);
+        }
+        std::set<Function*> visiting;
+        for(const auto call : mGlobalCalls) checkRecursion(call, visiting);
+        mProgram.fOutput = mOutput < 0 ? mFragColor : mOutput;
+        mProgram.fMemory.resize(static_cast<size_t>(mMemory), 0.f);
+        for(const auto& c : mConstants) {
+            float* const dst = mProgram.fMemory.data() + c.first;
+            std::fill(dst, dst + LANES, c.second);
+        }
+    }
+private:
+    struct Var {
+        Type fType;
+        int fOffset;
+        bool fReadOnly;
+    };
+
+    [[noreturn]] void error(const std::string& msg) const {
+        const int line = mPos < mTokens.size() ? mTokens[mPos].fLine : 0;
+        RuntimeThrow("line " + std::to_string(line) + ": " + msg);
+    }
+
+    int alloc(const Type& type) {
+        const int offset = mMemory;
+        mMemory += type.fSize*LANES;
+        return offset;
+    }
+
+    // tokens
+
+    void tokenize() {
+        std::vector<bool> active{true};
+        std::map<std::string, std::vector<Token>> macros;
+        const std::string& s = mSource;
+        const size_t n = s.size();
+        size_t i = 0;
+        int line = 1;
+        bool lineStart = true;
+        std::vector<Token> tokens;
+        while(i < n) {
+            const char c = s[i];
+            if(c == '\n') {
+                line++;
+                lineStart = true;
+                i++;
+                continue;
+            }
+            if(isspace(static_cast<uchar>(c))) {
+                i++;
+                continue;
+            }
+            if(c == '/' && i + 1 < n && s[i + 1] == '/') {
+                while(i < n && s[i] != '\n') i++;
+                continue;
+            }
+            if(c == '/' && i + 1 < n && s[i + 1] == '*') {
+                i += 2;
+                while(i + 1 < n && !(s[i] == '*' && s[i + 1] == '/')) {
+                    if(s[i] == '\n') line++;
+                    i++;
+                }
+                i += 2;
+                continue;
+            }
+            if(c == '#' && lineStart) {
+                size_t end = s.find('\n', i);
+                if(end == std::string::npos) end = n;
+                directive(s.substr(i + 1, end - i - 1), line, active, macros);
+                i = end;
+                continue;
+            }
+            lineStart = false;
+            Token token;
+            token.fLine = line;
+            if(isalpha(static_cast<uchar>(c)) || c == '_') {
+                const size_t start = i;
+                while(i < n && (isalnum(static_cast<uchar>(s[i])) || s[i] == '_')) i++;
+                token.fType = Tok::Ident;
+                token.fText = s.substr(start, i - start);
+            } else if(isdigit(static_cast<uchar>(c)) ||
+                      (c == '.' && i + 1 < n && isdigit(static_cast<uchar>(s[i + 1])))) {
+                i = number(i, token);
+            } else {
+                static const char* const sOps[] = {
+                    "++", "--", "+=", "-=", "*=", "/=", "%=", "==", "!=",
+                    "<=", ">=", "&&", "||", "^^"
+                };
+                token.fType = Tok::Op;
+                token.fText = std::string(1, c);
+                for(const auto op : sOps) {
+                    if(s.compare(i, 2, op) == 0) {
+                        token.fText = op;
+                        break;
+                    }
+                }
+                if(!strchr("+-*/%<>=!&|^~?:;,.(){}[]", c)) {
+                    mLine = line;
+                    lexError(std::string("unexpected character '") + c + "'");
+                }
+                i += token.fText.size();
+            }
+            if(!active.back()) continue;
+            expand(token, macros, tokens, 0);
+        }
+        if(active.size() != 1) lexError("unterminated #if");
+        mTokens = std::move(tokens);
+        Token end;
+        end.fLine = line;
+        mTokens.push_back(end);
+    }
+
+    [[noreturn]] void lexError(const std::string& msg) const {
+        RuntimeThrow("line " + std::to_string(mLine) + ": " + msg);
+    }
+
+    size_t number(size_t i, Token& token) {
+        const std::string& s = mSource;
+        const size_t n = s.size();
+        const size_t start = i;
+        bool isFloat = false;
+        if(s[i] == '0' && i + 1 < n && (s[i + 1] == 'x' || s[i + 1] == 'X')) {
+            i += 2;
+            while(i < n && isxdigit(static_cast<uchar>(s[i]))) i++;
+            token.fValue = double(std::stoll(s.substr(start, i - start), nullptr, 16));
+        } else {
+            while(i < n && isdigit(static_cast<uchar>(s[i]))) i++;
+            if(i < n && s[i] == '.') {
+                isFloat = true;
+                i++;
+                while(i < n && isdigit(static_cast<uchar>(s[i]))) i++;
+            }
+            if(i < n && (s[i] == 'e' || s[i] == 'E')) {
+                isFloat = true;
+                i++;
+                if(i < n && (s[i] == '+' || s[i] == '-')) i++;
+                while(i < n && isdigit(static_cast<uchar>(s[i]))) i++;
+            }
+            token.fValue = std::strtod(s.substr(start, i - start).c_str(), nullptr);
+        }
+        if(i < n && (s[i] == 'f' || s[i] == 'F')) {
+            isFloat = true;
+            i++;
+        } else if(i + 1 < n && (s.compare(i, 2, "lf") == 0 ||
+                                s.compare(i, 2, "LF") == 0)) {
+            isFloat = true;
+            i += 2;
+        } else if(i < n && (s[i] == 'u' || s[i] == 'U')) i++;
+        token.fType = isFloat ? Tok::Float : Tok::Int;
+        token.fText = s.substr(start, i - start);
+        return i;
+    }
+
+    void directive(const std::string& text, const int line,
+                   std::vector<bool>& active,
+                   std::map<std::string, std::vector<Token>>& macros) {
+        mLine = line;
+        size_t i = 0;
+        const auto skipSpace = [&]() {
+            while(i < text.size() && isspace(static_cast<uchar>(text[i]))) i++;
+        };
+        const auto word = [&]() {
+            skipSpace();
+            const size_t start = i;
+            while(i < text.size() && (isalnum(static_cast<uchar>(text[i])) ||
+                                      text[i] == '_')) i++;
+            return text.substr(start, i - start);
+        };
+        const std::string name = word();
+        if(name == "ifdef" || name == "ifndef") {
+            const bool defined = macros.find(word()) != macros.end();
+            active.push_back(active.back() && defined == (name == "ifdef"));
+        } else if(name == "else") {
+            if(active.size() < 2) lexError("#else without #if");
+            const bool parent = active[active.size() - 2];
+            active.back() = parent && !active.back();
+        } else if(name == "endif") {
+            if(active.size() < 2) lexError("#endif without #if");
+            active.pop_back();
+        } else if(!active.back()) {
+            return;
+        } else if(name == "version" || name == "extension" ||
+                  name == "pragma" || name == "line" || name.empty()) {
+            return;
+        } else if(name == "define") {
+            const std::string macro = word();
+            if(macro.empty()) lexError("invalid #define");
+            if(i < text.size() && text[i] == '(') {
+                lexError("function-like macros are not supported");
+            }
+            Compiler sub(text.substr(i), mProgram);
+            sub.mLine = line;
+            sub.tokenize();
+            auto& tokens = sub.mTokens;
+            tokens.pop_back();
+            for(auto& token : tokens) token.fLine = line;
+            macros[macro] = tokens;
+        } else if(name == "undef") {
+            macros.erase(word());
+        } else {
+            lexError("unsupported directive #" + name);
+        }
+    }
+
+    void expand(const Token& token,
+                const std::map<std::string, std::vector<Token>>& macros,
+                std::vector<Token>& dst, const int depth) {
+        if(token.fType == Tok::Ident) {
+            const auto it = macros.find(token.fText);
+            if(it != macros.end()) {
+                if(depth > MAX_MACRO_DEPTH) lexError("recursive macro");
+                for(auto sub : it->second) {
+                    sub.fLine = token.fLine;
+                    expand(sub, macros, dst, depth + 1);
+                }
+                return;
+            }
+        }
+        dst.push_back(token);
+    }
+
+    const Token& peek(const size_t ahead = 0) const {
+        const size_t i = qMin(mPos + ahead, mTokens.size() - 1);
+        return mTokens[i];
+    }
+
+    Token next() {
+        const Token token = peek();
+        if(mPos < mTokens.size() - 1) mPos++;
+        return token;
+    }
+
+    bool isOp(const char* const op, const size_t ahead = 0) const {
+        const auto& token = peek(ahead);
+        return token.fType == Tok::Op && token.fText == op;
+    }
+
+    bool isIdent(const char* const name, const size_t ahead = 0) const {
+        const auto& token = peek(ahead);
+        return token.fType == Tok::Ident && token.fText == name;
+    }
+
+    bool accept(const char* const op) {
+        if(!isOp(op)) return false;
+        next();
+        return true;
+    }
+
+    void expect(const char* const op) {
+        if(!accept(op)) {
+            error("expected '" + std::string(op) + "' before '" +
+                  peek().fText + "'");
+        }
+    }
+
+    std::string expectIdent() {
+        if(peek().fType != Tok::Ident) {
+            error("expected identifier before '" + peek().fText + "'");
+        }
+        return next().fText;
+    }
+
+    bool isType(const size_t ahead = 0) const {
+        const auto& token = peek(ahead);
+        Type type;
+        return token.fType == Tok::Ident && typeFromName(token.fText, type);
+    }
+
+    Type parseType() {
+        const auto token = next();
+        Type type;
+        if(token.fType != Tok::Ident || !typeFromName(token.fText, type)) {
+            error("unsupported type '" + token.fText + "'");
+        }
+        if(isOp("[")) error("arrays are not supported");
+        return type;
+    }
+
+    static bool isPrecision(const std::string& name) {
+        return name == "highp" || name == "mediump" || name == "lowp";
+    }
+
+    // scopes
+
+    void declare(const std::string& name, const Var& var) {
+        auto& scope = mScopes.back();
+        if(scope.find(name) != scope.end()) {
+            error("redefinition of '" + name + "'");
+        }
+        scope[name] = var;
+    }
+
+    const Var* find(const std::string& name) const {
+        for(auto it = mScopes.rbegin(); it != mScopes.rend(); it++) {
+            const auto var = it->find(name);
+            if(var != it->end()) return &var->second;
+        }
+        return nullptr;
+    }
+
+    void declareBuiltins() {
+        const Type vec4{Base::Float, 4};
+        mProgram.fFragCoord = alloc(vec4);
+        declare("gl_FragCoord", {vec4, mProgram.fFragCoord, true});
+        mFragColor = alloc(vec4);
+        declare("gl_FragColor", {vec4, mFragColor, false});
+    }
+
+    // declarations
+
+    void topLevel() {
+        if(accept(";")) return;
+        if(isIdent("precision")) {
+            while(!accept(";")) {
+                if(peek().fType == Tok::End) error("unexpected end");
+                next();
+            }
+            return;
+        }
+        bool isConst = false;
+        bool isUniform = false;
+        bool isIn = false;
+        bool isOut = false;
+        while(true) {
+            if(isIdent("layout")) {
+                next();
+                expect("(");
+                while(!accept(")")) {
+                    const auto token = next();
+                    if(token.fType == Tok::End) error("unexpected end");
+                    if(token.fText == "pixel_center_integer") {
+                        mProgram.fPixelCenterInteger = true;
+                    }
+                }
+            } else if(isIdent("const")) {
+                next();
+                isConst = true;
+            } else if(isIdent("uniform")) {
+                next();
+                isUniform = true;
+            } else if(isIdent("in") || isIdent("varying")) {
+                next();
+                isIn = true;
+            } else if(isIdent("out")) {
+                next();
+                isOut = true;
+            } else if(isIdent("flat") || isIdent("smooth") ||
+                      isIdent("noperspective") || isIdent("invariant") ||
+                      isPrecision(peek().fText)) {
+                next();
+            } else break;
+        }
+        if(isIdent("struct")) error("structs are not supported");
+        const Type type = parseType();
+        const std::string name = expectIdent();
+        if(isOp("(")) {
+            if(isConst || isUniform || isIn || isOut) {
+                error("unexpected qualifier for '" + name + "'");
+            }
+            return function(type, name);
+        }
+        std::string varName = name;
+        while(true) {
+            if(isOp("[")) error("arrays are not supported");
+            if(isUniform) {
+                uniform(type, varName);
+            } else if(isIn) {
+                input(type, varName);
+            } else if(isOut) {
+                if(type != Type{Base::Float, 4} || mOutput >= 0) {
+                    error("only a single vec4 output is supported");
+                }
+                mOutput = alloc(type);
+                declare(varName, {type, mOutput, false});
+            } else {
+                if(type.fBase == Base::Void || type.fBase == Base::Sampler) {
+                    error("invalid type for '" + varName + "'");
+                }
+                const int offset = alloc(type);
+                if(accept("=")) {
+                    auto value = convertTo(parseAssignment(), type);
+                    auto var = std::make_unique<VarExpr>(type, offset, false);
+                    mProgram.fGlobals.fStmts.push_back(
+                                std::make_unique<ExprStmt>(
+                                    std::make_unique<AssignExpr>(
+                                        alloc(type), Op::Eq,
+                                        std::move(var), std::move(value))));
+                } else if(isConst) {
+                    error("const '" + varName + "' needs an initializer");
+                }
+                declare(varName, {type, offset, isConst});
+            }
+            if(!accept(",")) break;
+            varName = expectIdent();
+        }
+        expect(";");
+    }
+
+    void uniform(const Type& type, const std::string& name) {
+        if(type.fBase == Base::Void) error("invalid uniform '" + name + "'");
+        if(type.fBase == Base::Sampler) {
+            declare(name, {type, -1, true});
+            return;
+        }
+        const int offset = alloc(type);
+        mProgram.fUniforms.push_back({name, offset, type.fSize});
+        declare(name, {type, offset, true});
+    }
+
+    void input(const Type& type, const std::string& name) {
+        if(name == "gl_FragCoord") return;
+        // the textured vertex shader only passes the texture coordinate
+        if(type != Type{Base::Float, 2}) {
+            error("unsupported input '" + name + "'");
+        }
+        if(mProgram.fTexCoord < 0) mProgram.fTexCoord = alloc(type);
+        declare(name, {type, mProgram.fTexCoord, true});
+    }
+
+    static bool sameParams(const Function& function,
+                           const std::vector<Param>& params) {
+        if(function.fParams.size() != params.size()) return false;
+        for(size_t i = 0; i < params.size(); i++) {
+            if(function.fParams[i].fType != params[i].fType) return false;
+        }
+        return true;
+    }
+
+    void function(const Type& type, const std::string& name) {
+        expect("(");
+        std::vector<Param> params;
+        std::vector<std::string> names;
+        if(isIdent("void") && isOp(")", 1)) next();
+        if(!isOp(")")) {
+            do {
+                Qualifier qualifier = Qualifier::In;
+                while(true) {
+                    if(isIdent("in")) qualifier = Qualifier::In;
+                    else if(isIdent("out")) qualifier = Qualifier::Out;
+                    else if(isIdent("inout")) qualifier = Qualifier::InOut;
+                    else if(!isIdent("const") && !isPrecision(peek().fText)) break;
+                    next();
+                }
+                const Type paramType = parseType();
+                if(paramType.fBase == Base::Void ||
+                   paramType.fBase == Base::Sampler) {
+                    error("unsupported parameter type in '" + name + "'");
+                }
+                names.push_back(peek().fType == Tok::Ident ? next().fText : "");
+                if(isOp("[")) error("arrays are not supported");
+                params.push_back({paramType, qualifier, -1});
+            } while(accept(","));
+        }
+        expect(")");
+
+        Function* function = nullptr;
+        for(const auto overload : mFunctions[name]) {
+            if(sameParams(*overload, params)) function = overload;
+        }
+        if(!function) {
+            auto created = std::make_unique<Function>();
+            function = created.get();
+            function->fName = name;
+            function->fReturn = type;
+            function->fParams = params;
+            for(auto& param : function->fParams) param.fOffset = alloc(param.fType);
+            if(type.fBase != Base::Void) function->fReturnOffset = alloc(type);
+            mProgram.fFunctions.push_back(std::move(created));
+            mFunctions[name].push_back(function);
+        } else if(function->fReturn != type) {
+            error("conflicting return type for '" + name + "'");
+        }
+        if(name == "main") {
+            if(type.fBase != Base::Void || !params.empty()) {
+                error("invalid main()");
+            }
+            mProgram.fMain = function;
+        }
+        if(accept(";")) return;
+        if(function->fBody) error("redefinition of '" + name + "'");
+
+        mScopes.emplace_back();
+        for(size_t i = 0; i < names.size(); i++) {
+            if(names[i].empty()) continue;
+            const auto& param = function->fParams[i];
+            declare(names[i], {param.fType, param.fOffset, false});
+        }
+        mFunction = function;
+        // the body is assigned last, calls to the function being defined
+        // are caught by the recursion check
+        auto body = block();
+        mFunction = nullptr;
+        mScopes.pop_back();
+        function->fBody = std::move(body);
+    }
+
+    void checkRecursion(Function* const function,
+                        std::set<Function*>& visiting) {
+        if(!function->fBody) {
+            error("'" + function->fName + "' is called but not defined");
+        }
+        if(!visiting.insert(function).second) {
+            error("recursion is not supported ('" + function->fName + "')");
+        }
+        for(const auto call : function->fCalls) checkRecursion(call, visiting);
+        visiting.erase(function);
+    }
+
+    // statements
+
+    StmtPtr block() {
+        expect("{");
+        mScopes.emplace_back();
+        auto result = std::make_unique<BlockStmt>();
+        while(!accept("}")) {
+            if(peek().fType == Tok::End) error("unexpected end");
+            auto stmt = statement();
+            if(stmt) result->fStmts.push_back(std::move(stmt));
+        }
+        mScopes.pop_back();
+        return result;
+    }
+
+    bool isDeclaration() const {
+        size_t i = 0;
+        while(isIdent("const", i) || isPrecision(peek(i).fText)) i++;
+        return isType(i) && peek(i + 1).fType == Tok::Ident;
+    }
+
+    StmtPtr declaration() {
+        bool isConst = false;
+        while(isIdent("const") || isPrecision(peek().fText)) {
+            if(next().fText == "const") isConst = true;
+        }
+        const Type type = parseType();
+        if(type.fBase == Base::Void || type.fBase == Base::Sampler) {
+            error("invalid local variable type");
+        }
+        auto result = std::make_unique<BlockStmt>();
+        do {
+            const std::string name = expectIdent();
+            if(isOp("[")) error("arrays are not supported");
+            const int offset = alloc(type);
+            if(accept("=")) {
+                auto value = convertTo(parseAssignment(), type);
+                auto var = std::make_unique<VarExpr>(type, offset, false);
+                result->fStmts.push_back(std::make_unique<ExprStmt>(
+                        std::make_unique<AssignExpr>(
+                            alloc(type), Op::Eq,
+                            std::move(var), std::move(value))));
+            } else if(isConst) {
+                error("const '" + name + "' needs an initializer");
+            }
+            // declared after the initializer, it may refer to an outer name
+            declare(name, {type, offset, isConst});
+        } while(accept(","));
+        expect(";");
+        return result;
+    }
+
+    ExprPtr condition() {
+        auto cond = parseExpression();
+        if(cond->fType != Type{Base::Bool, 1}) {
+            error("condition has to be a bool");
+        }
+        return cond;
+    }
+
+    StmtPtr statement() {
+        if(isOp("{")) return block();
+        if(accept(";")) return nullptr;
+        if(isIdent("if")) {
+            next();
+            expect("(");
+            auto cond = condition();
+            expect(")");
+            auto then = scopedStatement();
+            StmtPtr otherwise;
+            if(isIdent("else")) {
+                next();
+                otherwise = scopedStatement();
+            }
+            return std::make_unique<IfStmt>(std::move(cond), std::move(then),
+                                             std::move(otherwise));
+        }
+        if(isIdent("for")) {
+            next();
+            expect("(");
+            mScopes.emplace_back();
+            StmtPtr init;
+            if(isDeclaration()) init = declaration();
+            else if(!accept(";")) {
+                init = std::make_unique<ExprStmt>(parseExpression());
+                expect(";");
+            }
+            ExprPtr cond;
+            if(!isOp(";")) cond = condition();
+            expect(";");
+            ExprPtr step;
+            if(!isOp(")")) step = parseExpression();
+            expect(")");
+            mLoops++;
+            auto body = scopedStatement();
+            mLoops--;
+            mScopes.pop_back();
+            return std::make_unique<LoopStmt>(std::move(init), std::move(cond),
+                                              std::move(step), std::move(body),
+                                              true);
+        }
+        if(isIdent("while")) {
+            next();
+            expect("(");
+            auto cond = condition();
+            expect(")");
+            mLoops++;
+            auto body = scopedStatement();
+            mLoops--;
+            return std::make_unique<LoopStmt>(nullptr, std::move(cond),
+                                              nullptr, std::move(body), true);
+        }
+        if(isIdent("do")) {
+            next();
+            mLoops++;
+            auto body = scopedStatement();
+            mLoops--;
+            if(!isIdent("while")) error("expected 'while'");
+            next();
+            expect("(");
+            auto cond = condition();
+            expect(")");
+            expect(";");
+            return std::make_unique<LoopStmt>(nullptr, std::move(cond),
+                                              nullptr, std::move(body), false);
+        }
+        if(isIdent("break") || isIdent("continue")) {
+            const bool isBreak = next().fText == "break";
+            if(!mLoops) error("jump outside of a loop");
+            expect(";");
+            return std::make_unique<JumpStmt>(isBreak ? Jump::Break :
+                                                        Jump::Continue);
+        }
+        if(isIdent("discard")) {
+            next();
+            expect(";");
+            return std::make_unique<JumpStmt>(Jump::Discard);
+        }
+        if(isIdent("return")) {
+            next();
+            const Type type = mFunction->fReturn;
+            if(accept(";")) {
+                if(type.fBase != Base::Void) error("missing return value");
+                return std::make_unique<JumpStmt>(Jump::Return);
+            }
+            auto value = convertTo(parseExpression(), type);
+            expect(";");
+            return std::make_unique<JumpStmt>(Jump::Return, std::move(value),
+                                              mFunction->fReturnOffset);
+        }
+        if(isIdent("switch")) error("switch is not supported");
+        if(isDeclaration()) return declaration();
+        auto expr = parseExpression();
+        expect(";");
+        return std::make_unique<ExprStmt>(std::move(expr));
+    }
+
+    StmtPtr scopedStatement() {
+        mScopes.emplace_back();
+        auto stmt = statement();
+        mScopes.pop_back();
+        return stmt;
+    }
+
+    // expressions
+
+    ExprPtr constant(const Type& type, const float* const values) {
+        const int out = alloc(type);
+        for(int c = 0; c < type.fSize; c++) {
+            mConstants.push_back({out + c*LANES, values[c]});
+        }
+        return std::make_unique<ConstExpr>(type, out, values);
+    }
+
+    ExprPtr convertTo(ExprPtr&& expr, const Type& type) {
+        if(expr->fType == type) return std::move(expr);
+        if(type.fBase == Base::Float && expr->fType.fBase == Base::Int &&
+           type.fSize == expr->fType.fSize) {
+            return std::make_unique<RetypeExpr>(type, std::move(expr));
+        }
+        error("cannot convert to the expected type");
+    }
+
+    ExprPtr parseExpression() {
+        auto expr = parseAssignment();
+        while(accept(",")) {
+            auto second = parseAssignment();
+            expr = std::make_unique<SequenceExpr>(std::move(expr),
+                                                  std::move(second));
+        }
+        return expr;
+    }
+
+    ExprPtr parseAssignment() {
+        auto lhs = parseTernary();
+        static const std::map<std::string, Op> sOps = {
+            {"=", Op::Eq}, {"+=", Op::Add}, {"-=", Op::Sub},
+            {"*=", Op::Mul}, {"/=", Op::Div}, {"%=", Op::Mod}
+        };
+        const auto& token = peek();
+        if(token.fType != Tok::Op) return lhs;
+        const auto it = sOps.find(token.fText);
+        if(it == sOps.end()) return lhs;
+        next();
+        if(!lhs->assignable()) error("assignment to a read-only value");
+        auto rhs = parseAssignment();
+        const Type& dst = lhs->fType;
+        const Type& src = rhs->fType;
+        const bool baseOk = src.fBase == dst.fBase ||
+                (dst.fBase == Base::Float && src.fBase == Base::Int);
+        const bool sizeOk = src.fSize == dst.fSize ||
+                (it->second != Op::Eq && src.scalar());
+        const bool typeOk = it->second == Op::Eq ?
+                    dst.numeric() || dst.fBase == Base::Bool : dst.numeric();
+        if(!baseOk || !sizeOk || !typeOk) {
+            error("invalid assignment");
+        }
+        return std::make_unique<AssignExpr>(alloc(dst), it->second,
+                                            std::move(lhs), std::move(rhs));
+    }
+
+    ExprPtr parseTernary() {
+        auto cond = parseBinary(0);
+        if(!accept("?")) return cond;
+        if(cond->fType != Type{Base::Bool, 1}) error("condition has to be a bool");
+        auto a = parseAssignment();
+        expect(":");
+        auto b = parseAssignment();
+        promote(a, b);
+        if(a->fType != b->fType) error("mismatched types in ?:");
+        const Type type = a->fType;
+        return std::make_unique<TernaryExpr>(type, alloc(type), std::move(cond),
+                                             std::move(a), std::move(b));
+    }
+
+    // int operands next to floats are converted
+    void promote(ExprPtr& a, ExprPtr& b) {
+        if(a->fType.fBase == Base::Int && b->fType.fBase == Base::Float) {
+            a = convertTo(std::move(a), {Base::Float, a->fType.fSize});
+        } else if(a->fType.fBase == Base::Float && b->fType.fBase == Base::Int) {
+            b = convertTo(std::move(b), {Base::Float, b->fType.fSize});
+        }
+    }
+
+    ExprPtr parseBinary(const int minPrecedence) {
+        static const std::map<std::string, std::pair<int, Op>> sOps = {
+            {"||", {1, Op::Or}}, {"^^", {2, Op::Xor}}, {"&&", {3, Op::And}},
+            {"==", {4, Op::Eq}}, {"!=", {4, Op::Ne}},
+            {"<", {5, Op::Lt}}, {">", {5, Op::Gt}},
+            {"<=", {5, Op::Le}}, {">=", {5, Op::Ge}},
+            {"+", {6, Op::Add}}, {"-", {6, Op::Sub}},
+            {"*", {7, Op::Mul}}, {"/", {7, Op::Div}}, {"%", {7, Op::Mod}}
+        };
+        auto lhs = parseUnary();
+        while(true) {
+            const auto& token = peek();
+            if(token.fType != Tok::Op) break;
+            const auto it = sOps.find(token.fText);
+            if(it == sOps.end() || it->second.first < minPrecedence) break;
+            next();
+            const Op op = it->second.second;
+            auto rhs = parseBinary(it->second.first + 1);
+            lhs = binary(op, std::move(lhs), std::move(rhs));
+        }
+        return lhs;
+    }
+
+    ExprPtr binary(const Op op, ExprPtr&& a, ExprPtr&& b) {
+        if(op == Op::And || op == Op::Or || op == Op::Xor) {
+            const Type boolType{Base::Bool, 1};
+            if(a->fType != boolType || b->fType != boolType) {
+                error("logical operators need bool operands");
+            }
+            return std::make_unique<LogicExpr>(alloc(boolType), op,
+                                               std::move(a), std::move(b));
+        }
+        if(op == Op::Eq || op == Op::Ne) {
+            promote(a, b);
+            if(a->fType != b->fType) error("mismatched types in comparison");
+            return std::make_unique<CompareExpr>(alloc({Base::Bool, 1}), op,
+                                                 std::move(a), std::move(b));
+        }
+        if(!a->fType.numeric() || !b->fType.numeric()) {
+            error("arithmetic needs numeric operands");
+        }
+        promote(a, b);
+        if(op == Op::Lt || op == Op::Gt || op == Op::Le || op == Op::Ge) {
+            if(!a->fType.scalar() || !b->fType.scalar()) {
+                error("relational operators need scalar operands");
+            }
+            return std::make_unique<CompareExpr>(alloc({Base::Bool, 1}), op,
+                                                 std::move(a), std::move(b));
+        }
+        const Type& at = a->fType;
+        const Type& bt = b->fType;
+        if(at.fSize != bt.fSize && !at.scalar() && !bt.scalar()) {
+            error("mismatched vector sizes");
+        }
+        const Type type{at.fBase, qMax(at.fSize, bt.fSize)};
+        return std::make_unique<ArithmeticExpr>(type, alloc(type), op,
+                                                std::move(a), std::move(b));
+    }
+
+    ExprPtr parseUnary() {
+        if(accept("+")) return parseUnary();
+        if(accept("-")) {
+            auto sub = parseUnary();
+            if(!sub->fType.numeric()) error("invalid operand for '-'");
+            const Type type = sub->fType;
+            return std::make_unique<UnaryExpr>(type, alloc(type), Op::Neg,
+                                               std::move(sub));
+        }
+        if(accept("!")) {
+            auto sub = parseUnary();
+            if(sub->fType != Type{Base::Bool, 1}) error("invalid operand for '!'");
+            const Type type = sub->fType;
+            return std::make_unique<UnaryExpr>(type, alloc(type), Op::Not,
+                                               std::move(sub));
+        }
+        if(isOp("++") || isOp("--")) {
+            const float delta = next().fText == "++" ? 1.f : -1.f;
+            return incDec(parseUnary(), delta, false);
+        }
+        if(isOp("~")) error("bitwise operators are not supported");
+        return parsePostfix();
+    }
+
+    ExprPtr incDec(ExprPtr&& sub, const float delta, const bool post) {
+        if(!sub->assignable() || !sub->fType.numeric()) {
+            error("invalid operand for increment");
+        }
+        const Type type = sub->fType;
+        const int out = alloc(type);
+        const int tmp = alloc(type);
+        return std::make_unique<IncDecExpr>(out, tmp, std::move(sub),
+                                            delta, post);
+    }
+
+    ExprPtr parsePostfix() {
+        auto expr = parsePrimary();
+        while(true) {
+            if(accept(".")) {
+                expr = swizzle(std::move(expr), expectIdent());
+            } else if(accept("[")) {
+                auto index = parseExpression();
+                expect("]");
+                expr = indexed(std::move(expr), std::move(index));
+            } else if(isOp("++") || isOp("--")) {
+                const float delta = next().fText == "++" ? 1.f : -1.f;
+                expr = incDec(std::move(expr), delta, true);
+            } else break;
+        }
+        return expr;
+    }
+
+    ExprPtr swizzle(ExprPtr&& sub, const std::string& fields) {
+        static const char* const sSets[] = {"xyzw", "rgba", "stpq"};
+        const Type& subType = sub->fType;
+        if(fields.size() > 4 || subType.fBase == Base::Sampler ||
+           subType.fBase == Base::Void) {
+            error("invalid swizzle '" + fields + "'");
+        }
+        int comps[4];
+        bool found = false;
+        for(const auto set : sSets) {
+            found = true;
+            for(size_t i = 0; i < fields.size(); i++) {
+                const auto pos = strchr(set, fields[i]);
+                if(!pos || pos - set >= subType.fSize) {
+                    found = false;
+                    break;
+                }
+                comps[i] = static_cast<int>(pos - set);
+            }
+            if(found) break;
+        }
+        if(!found) error("invalid swizzle '" + fields + "'");
+        const Type type{subType.fBase, static_cast<int>(fields.size())};
+        return std::make_unique<SwizzleExpr>(type, alloc(type),
+                                             std::move(sub), comps);
+    }
+
+    ExprPtr indexed(ExprPtr&& sub, ExprPtr&& index) {
+        if(sub->fType.scalar() || sub->fType.fBase == Base::Sampler) {
+            error("invalid index");
+        }
+        if(index->fType != Type{Base::Int, 1}) error("index has to be an int");
+        const Type type{sub->fType.fBase, 1};
+        if(const auto value = dynamic_cast<ConstExpr*>(index.get())) {
+            const int comp = static_cast<int>(value->fValues[0]);
+            if(comp < 0 || comp >= sub->fType.fSize) error("index out of range");
+            return std::make_unique<SwizzleExpr>(type, alloc(type),
+                                                 std::move(sub), &comp);
+        }
+        return std::make_unique<IndexExpr>(type, alloc(type),
+                                           std::move(sub), std::move(index));
+    }
+
+    std::vector<ExprPtr> arguments() {
+        std::vector<ExprPtr> args;
+        expect("(");
+        if(isIdent("void") && isOp(")", 1)) next();
+        if(!accept(")")) {
+            do {
+                args.push_back(parseAssignment());
+            } while(accept(","));
+            expect(")");
+        }
+        return args;
+    }
+
+    ExprPtr parsePrimary() {
+        const Token token = next();
+        if(token.fType == Tok::Int || token.fType == Tok::Float) {
+            const float value = static_cast<float>(token.fValue);
+            return constant({token.fType == Tok::Int ? Base::Int : Base::Float, 1},
+                            &value);
+        }
+        if(token.fType == Tok::Op && token.fText == "(") {
+            auto expr = parseExpression();
+            expect(")");
+            return expr;
+        }
+        if(token.fType != Tok::Ident) error("unexpected '" + token.fText + "'");
+        if(token.fText == "true" || token.fText == "false") {
+            const float value = token.fText == "true" ? 1.f : 0.f;
+            return constant({Base::Bool, 1}, &value);
+        }
+        Type type;
+        if(typeFromName(token.fText, type)) {
+            if(type.fBase == Base::Void || type.fBase == Base::Sampler) {
+                error("invalid constructor '" + token.fText + "'");
+            }
+            return construct(type, arguments());
+        }
+        if(isOp("(")) return call(token.fText, arguments());
+        const auto var = find(token.fText);
+        if(!var) error("undeclared identifier '" + token.fText + "'");
+        return std::make_unique<VarExpr>(var->fType, var->fOffset,
+                                         var->fReadOnly);
+    }
+
+    ExprPtr construct(const Type& type, std::vector<ExprPtr>&& args) {
+        if(args.empty()) error("constructor without arguments");
+        int comps = 0;
+        for(const auto& arg : args) {
+            const auto base = arg->fType.fBase;
+            if(base == Base::Void || base == Base::Sampler) {
+                error("invalid constructor argument");
+            }
+            comps += arg->fType.fSize;
+        }
+        if(!(args.size() == 1 && args.front()->fType.scalar()) &&
+           comps < type.fSize) {
+            error("not enough data for the constructor");
+        }
+        return std::make_unique<ConstructExpr>(type, alloc(type),
+                                               std::move(args));
+    }
+
+    ExprPtr call(const std::string& name, std::vector<ExprPtr>&& args) {
+        const auto it = mFunctions.find(name);
+        if(it != mFunctions.end()) return userCall(it->second, std::move(args));
+        return builtin(name, std::move(args));
+    }
+
+    ExprPtr userCall(const std::vector<Function*>& overloads,
+                     std::vector<ExprPtr>&& args) {
+        Function* match = nullptr;
+        bool exact = false;
+        for(const auto function : overloads) {
+            if(function->fParams.size() != args.size()) continue;
+            bool same = true;
+            bool convertible = true;
+            for(size_t i = 0; i < args.size(); i++) {
+                const Type& param = function->fParams[i].fType;
+                const Type& arg = args[i]->fType;
+                if(param == arg) continue;
+                same = false;
+                if(param.fBase != Base::Float || arg.fBase != Base::Int ||
+                   param.fSize != arg.fSize ||
+                   function->fParams[i].fQualifier != Qualifier::In) {
+                    convertible = false;
+                }
+            }
+            if(same) {
+                match = function;
+                exact = true;
+                break;
+            }
+            if(convertible && !exact) match = function;
+        }
+        if(!match) error("no matching function '" + overloads.front()->fName + "'");
+        for(size_t i = 0; i < args.size(); i++) {
+            const auto& param = match->fParams[i];
+            if(param.fQualifier != Qualifier::In && !args[i]->assignable()) {
+                error("out argument has to be assignable");
+            }
+        }
+        if(mFunction) mFunction->fCalls.insert(match);
+        else mGlobalCalls.insert(match);
+        const int out = match->fReturn.fBase == Base::Void ? -1 :
+                                                             alloc(match->fReturn);
+        return std::make_unique<CallExpr>(out, match, std::move(args));
+    }
+
+    ExprPtr builtin(const std::string& name, std::vector<ExprPtr>&& args) {
+        static const std::map<std::string, std::pair<Fn, int>> sFns = {
+            {"radians", {Fn::Radians, 1}}, {"degrees", {Fn::Degrees, 1}},
+            {"sin", {Fn::Sin, 1}}, {"cos", {Fn::Cos, 1}}, {"tan", {Fn::Tan, 1}},
+            {"asin", {Fn::Asin, 1}}, {"acos", {Fn::Acos, 1}},
+            {"atan", {Fn::Atan, 1}}, {"exp", {Fn::Exp, 1}},
+            {"log", {Fn::Log, 1}}, {"exp2", {Fn::Exp2, 1}},
+            {"log2", {Fn::Log2, 1}}, {"sqrt", {Fn::Sqrt, 1}},
+            {"inversesqrt", {Fn::InverseSqrt, 1}}, {"abs", {Fn::Abs, 1}},
+            {"sign", {Fn::Sign, 1}}, {"floor", {Fn::Floor, 1}},
+            {"ceil", {Fn::Ceil, 1}}, {"fract", {Fn::Fract, 1}},
+            {"trunc", {Fn::Trunc, 1}}, {"round", {Fn::Round, 1}},
+            {"roundEven", {Fn::Round, 1}},
+            {"pow", {Fn::Pow, 2}}, {"mod", {Fn::Mod, 2}},
+            {"min", {Fn::Min, 2}}, {"max", {Fn::Max, 2}},
+            {"step", {Fn::Step, 2}},
+            {"clamp", {Fn::Clamp, 3}}, {"mix", {Fn::Mix, 3}},
+            {"smoothstep", {Fn::Smoothstep, 3}},
+            {"length", {Fn::Length, 1}}, {"distance", {Fn::Distance, 2}},
+            {"dot", {Fn::Dot, 2}}, {"cross", {Fn::Cross, 2}},
+            {"normalize", {Fn::Normalize, 1}},
+            {"texture", {Fn::Texture, 2}}, {"texture2D", {Fn::Texture, 2}},
+            {"texelFetch", {Fn::TexelFetch, 3}},
+            {"textureSize", {Fn::TextureSize, 2}}
+        };
+        const auto it = sFns.find(name);
+        if(it == sFns.end()) error("unsupported function '" + name + "'");
+        Fn fn = it->second.first;
+        int arity = it->second.second;
+        if(fn == Fn::Atan && args.size() == 2) {
+            fn = Fn::Atan2;
+            arity = 2;
+        }
+        // the optional bias of texture() is ignored
+        if(fn == Fn::Texture && args.size() == 3) args.pop_back();
+        if(static_cast<int>(args.size()) != arity) {
+            error("wrong number of arguments for '" + name + "'");
+        }
+
+        const Type vec2{Base::Float, 2};
+        const Type ivec2{Base::Int, 2};
+        const Type vec4{Base::Float, 4};
+        const Type intType{Base::Int, 1};
+        if(fn == Fn::Texture || fn == Fn::TexelFetch || fn == Fn::TextureSize) {
+            if(args[0]->fType.fBase != Base::Sampler) {
+                error("'" + name + "' needs a sampler");
+            }
+            Type result = vec4;
+            if(fn == Fn::Texture) {
+                if(args[1]->fType != vec2) error("'" + name + "' needs a vec2");
+            } else if(fn == Fn::TexelFetch) {
+                if(args[1]->fType != ivec2 || args[2]->fType != intType) {
+                    error("'" + name + "' needs an ivec2 and an int");
+                }
+            } else {
+                if(args[1]->fType != intType) error("'" + name + "' needs an int");
+                result = ivec2;
+            }
+            return std::make_unique<BuiltinExpr>(result, alloc(result), fn,
+                                                 std::move(args));
+        }
+
+        bool anyFloat = false;
+        int size = 1;
+        for(const auto& arg : args) {
+            if(!arg->fType.numeric()) {
+                error("'" + name + "' needs numeric arguments");
+            }
+            if(arg->fType.fBase == Base::Float) anyFloat = true;
+            size = qMax(size, arg->fType.fSize);
+        }
+        for(const auto& arg : args) {
+            if(arg->fType.fSize != size && !arg->fType.scalar()) {
+                error("mismatched sizes for '" + name + "'");
+            }
+        }
+        const bool keepsInt = fn == Fn::Abs || fn == Fn::Sign ||
+                fn == Fn::Min || fn == Fn::Max || fn == Fn::Clamp;
+        const bool isInt = keepsInt && !anyFloat;
+        for(auto& arg : args) {
+            if(!isInt && arg->fType.fBase == Base::Int) {
+                arg = convertTo(std::move(arg), {Base::Float, arg->fType.fSize});
+            }
+        }
+        Type result{isInt ? Base::Int : Base::Float, size};
+        if(fn == Fn::Length || fn == Fn::Distance || fn == Fn::Dot) {
+            if(fn != Fn::Length && args[0]->fType != args[1]->fType) {
+                error("mismatched sizes for '" + name + "'");
+            }
+            result = {Base::Float, 1};
+        } else if(fn == Fn::Cross) {
+            const Type vec3{Base::Float, 3};
+            if(args[0]->fType != vec3 || args[1]->fType != vec3) {
+                error("'cross' needs vec3 arguments");
+            }
+        } else if(fn == Fn::Mod || fn == Fn::Min || fn == Fn::Max ||
+                  fn == Fn::Clamp) {
+            // only the trailing arguments may be scalars
+            if(args[0]->fType.fSize != size) {
+                error("mismatched sizes for '" + name + "'");
+            }
+        }
+        return std::make_unique<BuiltinExpr>(result, alloc(result), fn,
+                                             std::move(args));
+    }
+
+    const std::string mSource;
+    CpuShaderProgram& mProgram;
+
+    std::vector<Token> mTokens;
+    size_t mPos = 0;
+    int mLine = 0;
+
+    int mMemory = 0;
+    std::vector<std::pair<int, float>> mConstants;
+    std::vector<std::map<std::string, Var>> mScopes;
+    std::map<std::string, std::vector<Function*>> mFunctions;
+    Function* mFunction = nullptr;
+    std::set<Function*> mGlobalCalls;
+    int mLoops = 0;
+    int mFragColor = -1;
+    int mOutput = -1;
+};
+
+}
+
+CpuShader::CpuShader(const QString& source) :
+    mProgram(std::make_unique<CpuShaderProgram>()) {
+    Compiler compiler(source.toStdString(), *mProgram);
+    compiler.compile();
+}
+
+CpuShader::~CpuShader() {}
+
+int CpuShader::uniformLocation(const QString& name) const {
+    const auto stdName = name.toStdString();
+    const auto& uniforms = mProgram->fUniforms;
+    for(size_t i = 0; i < uniforms.size(); i++) {
+        if(uniforms[i].fName == stdName) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void CpuShader::sSetUniform(CpuUniforms& uniforms, const int loc,
+                            const float v0, const float v1,
+                            const float v2, const float v3) {
+    if(loc < 0) return;
+    const size_t first = 4*static_cast<size_t>(loc);
+    if(uniforms.size() < first + 4) uniforms.resize(first + 4, 0.f);
+    uniforms[first] = v0;
+    uniforms[first + 1] = v1;
+    uniforms[first + 2] = v2;
+    uniforms[first + 3] = v3;
+}
+
+void CpuShader::process(const CpuUniforms& uniforms,
+                        const SkBitmap& src, SkBitmap& dst,
+                        const SkIRect& tile) const {
+    const auto& program = *mProgram;
+    Context ctx;
+    ctx.fMem = program.fMemory;
+    ctx.fSrc = static_cast<const uchar*>(src.getPixels());
+    ctx.fSrcRowBytes = src.rowBytes();
+    ctx.fSrcWidth = src.width();
+    ctx.fSrcHeight = src.height();
+
+    for(size_t i = 0; i < program.fUniforms.size(); i++) {
+        const auto& uniform = program.fUniforms[i];
+        for(int c = 0; c < uniform.fSize; c++) {
+            const size_t id = 4*i + static_cast<size_t>(c);
+            const float value = id < uniforms.size() ? uniforms[id] : 0.f;
+            float* const dstU = ctx.at(uniform.fOffset + c*LANES);
+            std::fill(dstU, dstU + LANES, value);
+        }
+    }
+
+    const float center = program.fPixelCenterInteger ? 0.f : 0.5f;
+    float* const fragCoord = ctx.at(program.fFragCoord);
+    std::fill(fragCoord + 2*LANES, fragCoord + 3*LANES, 0.5f);
+    std::fill(fragCoord + 3*LANES, fragCoord + 4*LANES, 1.f);
+    float* const texCoord = program.fTexCoord < 0 ? nullptr :
+                                                    ctx.at(program.fTexCoord);
+    const float* const output = ctx.at(program.fOutput);
+    float* const outputW = ctx.at(program.fOutput);
+    const float invWidth = 1.f/ctx.fSrcWidth;
+    const float invHeight = 1.f/ctx.fSrcHeight;
+
+    for(int y = tile.top(); y < tile.bottom(); y++) {
+        auto row = static_cast<uchar*>(dst.getAddr(0, y - tile.top()));
+        for(int x0 = tile.left(); x0 < tile.right(); x0 += LANES) {
+            const int count = qMin(LANES, tile.right() - x0);
+            for(int i = 0; i < LANES; i++) {
+                fragCoord[i] = x0 + i + center;
+                fragCoord[LANES + i] = y + center;
+            }
+            if(texCoord) {
+                for(int i = 0; i < LANES; i++) {
+                    texCoord[i] = (x0 + i + 0.5f)*invWidth;
+                    texCoord[LANES + i] = (y + 0.5f)*invHeight;
+                }
+            }
+            std::fill(outputW, outputW + 4*LANES, 0.f);
+            ctx.fMask = count == LANES ? ~Mask(0) : (Mask(1) << count) - 1;
+            ctx.fBreak = 0;
+            ctx.fContinue = 0;
+            ctx.fReturned = 0;
+            ctx.fDiscarded = 0;
+            program.fGlobals.exec(ctx);
+            program.fMain->fBody->exec(ctx);
+
+            for(int i = 0; i < count; i++) {
+                uchar* const px = row + 4*i;
+                if(lane(ctx.fDiscarded, i)) {
+                    memset(px, 0, 4);
+                    continue;
+                }
+                for(int c = 0; c < 4; c++) {
+                    const float v = output[c*LANES + i];
+                    const float clamped = v > 0.f ? (v < 1.f ? v : 1.f) : 0.f;
+                    px[c] = static_cast<uchar>(clamped*255.f + 0.5f);
+                }
+            }
+            row += 4*LANES;
+        }
+    }
+}
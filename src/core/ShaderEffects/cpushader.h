@@ -0,0 +1,64 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef CPUSHADER_H
+#define CPUSHADER_H
+
+#include "core_global.h"
+#include "skia/skiaincludes.h"
+
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+struct CpuShaderProgram;
+
+//! @brief Uniform values, four floats per uniform location
+typedef std::vector<float> CpuUniforms;
+
+// Runs a ShaderEffect fragment shader on the cpu, used when no GPU is
+// available. Only a subset of GLSL is understood (scalars and vectors,
+// user functions, flow control, the common builtins and sampling of the
+// source texture), the constructor throws for anything else.
+class CORE_EXPORT CpuShader {
+public:
+    CpuShader(const QString& source);
+    ~CpuShader();
+
+    //! @brief Returns -1 if the shader does not declare the uniform
+    int uniformLocation(const QString& name) const;
+
+    //! @brief Renders the tile, src is the whole source texture
+    void process(const CpuUniforms& uniforms,
+                 const SkBitmap& src, SkBitmap& dst,
+                 const SkIRect& tile) const;
+
+    static void sSetUniform(CpuUniforms& uniforms, const int loc,
+                            const float v0, const float v1 = 0.f,
+                            const float v2 = 0.f, const float v3 = 0.f);
+private:
+    std::unique_ptr<CpuShaderProgram> mProgram;
+};
+
+#endif // CPUSHADER_H
@@ -31,7 +31,9 @@ ShaderEffect::ShaderEffect(const QString& name,
                            const ShaderEffectCreator * const creator,
                            const ShaderEffectProgram * const program,
                            const QList<stdsptr<ShaderPropertyCreator>> &props) :
-    RasterEffect(name, HardwareSupport::gpuOnly, false,
+    RasterEffect(name, program->fCpuShader ? HardwareSupport::gpuPreffered :
+                                             HardwareSupport::gpuOnly,
+                 program->fCpuShader != nullptr,
                  RasterEffectType::CUSTOM_SHADER),
     mProgram(program), mCreator(creator) {
     for(const auto& propC : props)
@@ -56,7 +58,8 @@ stdsptr<RasterEffectCaller> ShaderEffect::getEffectCaller(const qreal relFrame,
     Q_UNUSED(data)
     std::unique_ptr<ShaderEffectJS> engineUPtr;
     takeJSEngine(engineUPtr);
-    const auto effect = enve::make_shared<ShaderEffectCaller>(std::move(engineUPtr),
+    const auto effect = enve::make_shared<ShaderEffectCaller>(instanceHwSupport(),
+                                                              std::move(engineUPtr),
                                                               *mProgram,
                                                               this,
                                                               relFrame,
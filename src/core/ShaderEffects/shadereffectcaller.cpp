@@ -26,18 +26,28 @@
 #include "shadereffectcaller.h"
 #include "shadereffectprogram.h"
 
-ShaderEffectCaller::ShaderEffectCaller(std::unique_ptr<ShaderEffectJS>&& engine,
+HardwareSupport programHwSupport(const HardwareSupport hwSupport,
+                                 const ShaderEffectProgram &program)
+{
+    if (!program.fCpuShader) { return HardwareSupport::gpuOnly; }
+    if (program.fId == 0) { return HardwareSupport::cpuOnly; }
+    return hwSupport;
+}
+
+ShaderEffectCaller::ShaderEffectCaller(const HardwareSupport hwSupport,
+                                       std::unique_ptr<ShaderEffectJS>&& engine,
                                        const ShaderEffectProgram &program,
                                        const ShaderEffect *parentEffect,
                                        const qreal &relFrame,
                                        const qreal &resolution,
                                        const qreal &influence)
-    : RasterEffectCaller(HardwareSupport::gpuOnly,
+    : RasterEffectCaller(programHwSupport(hwSupport, program),
                          false,
                          QMargins())
     , mEngine(std::move(engine))
     , mProgramId(program.fId)
     , mProgram(program)
+    , mCpuShader(program.fCpuShader)
 {
     Q_ASSERT(mEngine.get());
     calc(parentEffect,
@@ -70,6 +80,19 @@ void ShaderEffectCaller::processGpu(QGL33 * const gl,
     renderTools.swapTextures();
 }
 
+void ShaderEffectCaller::processCpu(CpuRenderTools &renderTools,
+                                    const CpuRenderData &data)
+{
+    // tiles are processed in parallel, the uniforms are resolved once
+    std::call_once(mCpuUniformsSet, [this]() {
+        for (const auto& uni : mCpuUniformSpecifiers) { uni(mCpuUniforms); }
+    });
+    mCpuShader->process(mCpuUniforms,
+                        renderTools.fSrcBtmp,
+                        renderTools.fDstBtmp,
+                        data.fTexTile);
+}
+
 void ShaderEffectCaller::calc(const ShaderEffect *pEff,
                               const qreal relFrame,
                               const qreal resolution,
@@ -78,9 +101,12 @@ void ShaderEffectCaller::calc(const ShaderEffect *pEff,
     if (!pEff) { return; }
     mEngine->clearSetters();
     UniformSpecifiers& uniSpecs = mUniformSpecifiers;
+    CpuUniformSpecifiers& cpuUniSpecs = mCpuUniformSpecifiers;
+    const bool cpu = mCpuShader.get();
     const int argsCount = mProgram.fPropUniLocs.count();
     for (int i = 0; i < argsCount; i++) {
         const GLint loc = mProgram.fPropUniLocs.at(i);
+        const int cpuLoc = cpu ? mProgram.fCpuPropUniLocs.at(i) : -1;
         const auto prop = pEff->ca_getChildAt(i);
         const auto& uniformC = mProgram.fPropUniCreators.at(i);
         uniformC->create(getJSEngine(),
@@ -89,14 +115,19 @@ void ShaderEffectCaller::calc(const ShaderEffect *pEff,
                          relFrame,
                          resolution,
                          influence,
-                         uniSpecs);
+                         uniSpecs,
+                         cpuLoc,
+                         cpuUniSpecs);
     }
     mEngine->updateValues();
     const int valsCount = mProgram.fValueHandlers.count();
     for (int i = 0; i < valsCount; i++) {
         const GLint loc = mProgram.fValueLocs.at(i);
         const auto& value = mProgram.fValueHandlers.at(i);
-        uniSpecs << value->create(loc, getJSEngine(), i);
+        if (loc >= 0) { uniSpecs << value->create(loc, getJSEngine(), i); }
+        if (!cpu) { continue; }
+        const int cpuLoc = mProgram.fCpuValueLocs.at(i);
+        cpuUniSpecs << value->createCpu(cpuLoc, getJSEngine(), i);
     }
 }
 
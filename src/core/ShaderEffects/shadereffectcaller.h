@@ -31,10 +31,13 @@
 #include "../gpurendertools.h"
 #include "shadereffectjs.h"
 
+#include <mutex>
+
 class CORE_EXPORT ShaderEffectCaller : public RasterEffectCaller {
     e_OBJECT
 public:
-    ShaderEffectCaller(std::unique_ptr<ShaderEffectJS>&& engine,
+    ShaderEffectCaller(const HardwareSupport hwSupport,
+                       std::unique_ptr<ShaderEffectJS>&& engine,
                        const ShaderEffectProgram& program,
                        const ShaderEffect* parentEffect,
                        const qreal& relFrame,
@@ -44,6 +47,8 @@ public:
 
     void processGpu(QGL33 * const gl,
                     GpuRenderTools& renderTools);
+    void processCpu(CpuRenderTools& renderTools,
+                    const CpuRenderData& data);
 
     void calc(const ShaderEffect * pEff,
               const qreal relFrame,
@@ -54,6 +59,7 @@ public:
     { return *mEngine; }
 
     UniformSpecifiers mUniformSpecifiers;
+    CpuUniformSpecifiers mCpuUniformSpecifiers;
 protected:
     QMargins getMargin(const SkIRect &srcRect);
 private:
@@ -62,6 +68,9 @@ private:
     std::unique_ptr<ShaderEffectJS> mEngine;
     const GLuint mProgramId;
     const ShaderEffectProgram &mProgram;
+    const std::shared_ptr<const CpuShader> mCpuShader;
+    std::once_flag mCpuUniformsSet;
+    CpuUniforms mCpuUniforms;
 };
 
 
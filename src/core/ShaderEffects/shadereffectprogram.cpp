@@ -31,10 +31,51 @@ ShaderEffectProgram::ShaderEffectProgram(
 
 void ShaderEffectProgram::reloadFragmentShader(
         QGL33 * const gl, const QString &fragPath) {
-    GLuint newProgram;
-    if(!QFile(fragPath).exists())
+    QFile fragFile(fragPath);
+    if(!fragFile.exists())
         RuntimeThrow("Failed to open '" + fragPath + "'");
 
+    std::shared_ptr<const CpuShader> cpuShader;
+    QList<int> cpuPropUniLocs;
+    QList<int> cpuValueLocs;
+    try {
+        if(!fragFile.open(QIODevice::ReadOnly | QIODevice::Text))
+            RuntimeThrow("Failed to open '" + fragPath + "'");
+        const auto shader = std::make_shared<CpuShader>(
+                    QString::fromUtf8(fragFile.readAll()));
+        fragFile.close();
+        for(const auto& propC : fProperties) {
+            if(propC->fGLValue) {
+                const int loc = shader->uniformLocation(propC->fName);
+                if(loc < 0) RuntimeThrow("No uniform for '" + propC->fName + "'");
+                cpuPropUniLocs.append(loc);
+            } else cpuPropUniLocs.append(-1);
+        }
+        for(const auto& value : fValueHandlers) {
+            const int loc = shader->uniformLocation(value->fName);
+            if(loc < 0) RuntimeThrow("No uniform for '" + value->fName + "'");
+            cpuValueLocs.append(loc);
+        }
+        cpuShader = shader;
+    } catch(const std::exception& e) {
+        // not an error, the effect just will not render without a GPU
+        qDebug() << "No CPU fallback for" << fragPath
+                 << gAllTextFromException(e);
+        if(!gl) RuntimeThrow("Could not load '" + fragPath + "' without a GPU");
+    }
+
+    if(!gl) {
+        fCpuShader = cpuShader;
+        fCpuPropUniLocs = cpuPropUniLocs;
+        fCpuValueLocs = cpuValueLocs;
+        fPropUniLocs.clear();
+        for(int i = 0; i < cpuPropUniLocs.count(); i++) fPropUniLocs.append(-1);
+        fValueLocs.clear();
+        for(int i = 0; i < cpuValueLocs.count(); i++) fValueLocs.append(-1);
+        return;
+    }
+
+    GLuint newProgram;
     try {
         gIniProgram(gl, newProgram, GL_TEXTURED_VERT, fragPath);
     } catch(...) {
@@ -77,6 +118,9 @@ void ShaderEffectProgram::reloadFragmentShader(
     fPropUniLocs = propUniLocs;
     fValueLocs = valueLocs;
     fTexLocation = texLocation;
+    fCpuShader = cpuShader;
+    fCpuPropUniLocs = cpuPropUniLocs;
+    fCpuValueLocs = cpuValueLocs;
 }
 
 std::unique_ptr<ShaderEffectProgram>
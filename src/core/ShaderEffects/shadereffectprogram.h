@@ -42,10 +42,15 @@ struct CORE_EXPORT ShaderEffectProgram {
     UniformSpecifierCreators fPropUniCreators;
     QList<stdsptr<ShaderValueHandler>> fValueHandlers;
     QList<GLint> fValueLocs;
+    //! @brief Null if the shader can only run on the GPU
+    std::shared_ptr<const CpuShader> fCpuShader;
+    QList<int> fCpuPropUniLocs;
+    QList<int> fCpuValueLocs;
     std::shared_ptr<ShaderEffectJS::Blueprint> fJSBlueprint;
     mutable std::vector<std::unique_ptr<ShaderEffectJS>> fEngines;
     const QList<stdsptr<ShaderPropertyCreator>> fProperties;
 
+    //! @brief Without gl only the cpu shader is loaded
     void reloadFragmentShader(QGL33 * const gl, const QString &fragPath);
 
     static std::unique_ptr<ShaderEffectProgram> sCreateProgram(
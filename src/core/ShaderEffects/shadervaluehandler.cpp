@@ -97,3 +97,64 @@ UniformSpecifier ShaderValueHandler::create(const GLint loc,
     default: RuntimeThrow("Unsupported type for " + fName);
     }
 }
+
+CpuUniformSpecifier ShaderValueHandler::createCpu(const int loc,
+                                                  ShaderEffectJS &engine,
+                                                  int index) const
+{
+    Q_ASSERT(loc >= 0);
+    switch(mType) {
+    case GLValueType::Float:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble(index);
+            CpuShader::sSetUniform(unis, loc, static_cast<float>(val));
+        };
+    case GLValueType::Vec2:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble2(index);
+            CpuShader::sSetUniform(unis, loc,
+                                   static_cast<float>(val.v0),
+                                   static_cast<float>(val.v1));
+        };
+    case GLValueType::Vec3:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble3(index);
+            CpuShader::sSetUniform(unis, loc,
+                                   static_cast<float>(val.v0),
+                                   static_cast<float>(val.v1),
+                                   static_cast<float>(val.v2));
+        };
+    case GLValueType::Vec4:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble4(index);
+            CpuShader::sSetUniform(unis, loc,
+                                   static_cast<float>(val.v0),
+                                   static_cast<float>(val.v1),
+                                   static_cast<float>(val.v2),
+                                   static_cast<float>(val.v3));
+        };
+    case GLValueType::Int:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble(index);
+            CpuShader::sSetUniform(unis, loc, qRound(val));
+        };
+    case GLValueType::iVec2:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble2(index);
+            CpuShader::sSetUniform(unis, loc, qRound(val.v0), qRound(val.v1));
+        };
+    case GLValueType::iVec3:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble3(index);
+            CpuShader::sSetUniform(unis, loc, qRound(val.v0), qRound(val.v1),
+                                   qRound(val.v2));
+        };
+    case GLValueType::iVec4:
+        return [loc, &engine, index](CpuUniforms& unis) {
+            const auto val = engine.getGlValueDouble4(index);
+            CpuShader::sSetUniform(unis, loc, qRound(val.v0), qRound(val.v1),
+                                   qRound(val.v2), qRound(val.v3));
+        };
+    default: RuntimeThrow("Unsupported type for " + fName);
+    }
+}
@@ -29,9 +29,11 @@
 
 #include "ShaderEffects/shadereffectjs.h"
 #include "glhelpers.h"
+#include "cpushader.h"
 #include "smartPointers/ememory.h"
 
 typedef std::function<void(QGL33 * const)> UniformSpecifier;
+typedef std::function<void(CpuUniforms&)> CpuUniformSpecifier;
 
 enum class GLValueType {
     Float, Vec2, Vec3, Vec4,
@@ -48,6 +50,9 @@ public:
     UniformSpecifier create(const GLint loc,
                             ShaderEffectJS &engine,
                             int index) const;
+    CpuUniformSpecifier createCpu(const int loc,
+                                  ShaderEffectJS &engine,
+                                  int index) const;
 
     const QString fName;
     const QString fScript;
@@ -34,7 +34,9 @@ void qrealAnimatorCreate(ShaderEffectJS &engine,
                          const qreal relFrame,
                          const qreal resolution,
                          const qreal influence,
-                         UniformSpecifiers& uniSpec)
+                         UniformSpecifiers& uniSpec,
+                         const int cpuLoc,
+                         CpuUniformSpecifiers& cpuUniSpec)
 {
     const auto anim = static_cast<QrealAnimator*>(property);
     const qreal val = anim->getEffectiveValue(relFrame)*resolution*influence;
@@ -43,10 +45,13 @@ void qrealAnimatorCreate(ShaderEffectJS &engine,
     engine.addSetter(val);
 
     if (!glValue) { return; }
-    Q_ASSERT(loc >= 0);
+    Q_ASSERT(loc >= 0 || cpuLoc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform1f(loc, static_cast<GLfloat>(val));
     };
+    cpuUniSpec << [cpuLoc, val](CpuUniforms& unis) {
+        CpuShader::sSetUniform(unis, cpuLoc, static_cast<float>(val));
+    };
 }
 
 void intAnimatorCreate(ShaderEffectJS &engine,
@@ -56,7 +61,9 @@ void intAnimatorCreate(ShaderEffectJS &engine,
                        const qreal relFrame,
                        const qreal resolution,
                        const qreal influence,
-                       UniformSpecifiers& uniSpec)
+                       UniformSpecifiers& uniSpec,
+                       const int cpuLoc,
+                       CpuUniformSpecifiers& cpuUniSpec)
 {
     const auto anim = static_cast<IntAnimator*>(property);
     const int val = qRound(anim->getEffectiveIntValue(relFrame)*resolution*influence);
@@ -64,10 +71,13 @@ void intAnimatorCreate(ShaderEffectJS &engine,
     engine.addSetter(val);
 
     if (!glValue) { return; }
-    Q_ASSERT(loc >= 0);
+    Q_ASSERT(loc >= 0 || cpuLoc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform1i(loc, val);
     };
+    cpuUniSpec << [cpuLoc, val](CpuUniforms& unis) {
+        CpuShader::sSetUniform(unis, cpuLoc, val);
+    };
 }
 
 QString vec2ValScript(const QString& name,
@@ -84,7 +94,9 @@ void qPointFAnimatorCreate(ShaderEffectJS &engine,
                            const qreal relFrame,
                            const qreal resolution,
                            const qreal influence,
-                           UniformSpecifiers& uniSpec)
+                           UniformSpecifiers& uniSpec,
+                           const int cpuLoc,
+                           CpuUniformSpecifiers& cpuUniSpec)
 {
     const auto anim = static_cast<QPointFAnimator*>(property);
     const QPointF val = anim->getEffectiveValue(relFrame)*resolution*influence;
@@ -92,10 +104,13 @@ void qPointFAnimatorCreate(ShaderEffectJS &engine,
     engine.addSetter(val);
 
     if (!glValue) { return; }
-    Q_ASSERT(loc >= 0);
+    Q_ASSERT(loc >= 0 || cpuLoc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform2f(loc, val.x(), val.y());
     };
+    cpuUniSpec << [cpuLoc, val](CpuUniforms& unis) {
+        CpuShader::sSetUniform(unis, cpuLoc, val.x(), val.y());
+    };
 }
 
 QString colorValScript(const QString& name,
@@ -112,7 +127,9 @@ void colorAnimatorCreate(ShaderEffectJS &engine,
                          const GLint loc,
                          Property * const property,
                          const qreal relFrame,
-                         UniformSpecifiers& uniSpec)
+                         UniformSpecifiers& uniSpec,
+                         const int cpuLoc,
+                         CpuUniformSpecifiers& cpuUniSpec)
 {
     const auto anim = static_cast<ColorAnimator*>(property);
     const QColor val = anim->getColor(relFrame);
@@ -120,11 +137,15 @@ void colorAnimatorCreate(ShaderEffectJS &engine,
     engine.addSetter(val);
 
     if (!glValue) { return; }
-    Q_ASSERT(loc >= 0);
+    Q_ASSERT(loc >= 0 || cpuLoc >= 0);
     uniSpec << [loc, val, valScript](QGL33 * const gl) {
         gl->glUniform4f(loc, val.redF(), val.greenF(), val.blueF(),
                         val.alphaF());
     };
+    cpuUniSpec << [cpuLoc, val](CpuUniforms& unis) {
+        CpuShader::sSetUniform(unis, cpuLoc, val.redF(), val.greenF(),
+                               val.blueF(), val.alphaF());
+    };
 }
 
 void UniformSpecifierCreator::create(ShaderEffectJS &engine,
@@ -133,7 +154,9 @@ void UniformSpecifierCreator::create(ShaderEffectJS &engine,
                                      const qreal relFrame,
                                      const qreal resolution,
                                      const qreal influence,
-                                     UniformSpecifiers& uniSpec) const
+                                     UniformSpecifiers& uniSpec,
+                                     const int cpuLoc,
+                                     CpuUniformSpecifiers& cpuUniSpec) const
 {
     switch(mType) {
     case ShaderPropertyType::floatProperty:
@@ -144,7 +167,9 @@ void UniformSpecifierCreator::create(ShaderEffectJS &engine,
                                    relFrame,
                                    mResolutionScaled ? resolution : 1,
                                    mInfluenceScaled ? influence : 1,
-                                   uniSpec);
+                                   uniSpec,
+                                   cpuLoc,
+                                   cpuUniSpec);
     case ShaderPropertyType::intProperty:
         return intAnimatorCreate(engine,
                                  fGLValue,
@@ -153,7 +178,9 @@ void UniformSpecifierCreator::create(ShaderEffectJS &engine,
                                  relFrame,
                                  mResolutionScaled ? resolution : 1,
                                  mInfluenceScaled ? influence : 1,
-                                 uniSpec);
+                                 uniSpec,
+                                 cpuLoc,
+                                 cpuUniSpec);
     case ShaderPropertyType::vec2Property:
         return qPointFAnimatorCreate(engine,
                                      fGLValue,
@@ -162,14 +189,18 @@ void UniformSpecifierCreator::create(ShaderEffectJS &engine,
                                      relFrame,
                                      mResolutionScaled ? resolution : 1,
                                      mInfluenceScaled ? influence : 1,
-                                     uniSpec);
+                                     uniSpec,
+                                     cpuLoc,
+                                     cpuUniSpec);
     case ShaderPropertyType::colorProperty:
         return colorAnimatorCreate(engine,
                                    fGLValue,
                                    loc,
                                    property,
                                    relFrame,
-                                   uniSpec);
+                                   uniSpec,
+                                   cpuLoc,
+                                   cpuUniSpec);
     default: RuntimeThrow("Unsupported type");
     }
 }
@@ -33,6 +33,7 @@
 #include "PropertyCreators/qpointfanimatorcreator.h"
 #include "PropertyCreators/coloranimatorcreator.h"
 #include "glhelpers.h"
+#include "cpushader.h"
 
 class ShaderEffectJS;
 
@@ -46,6 +47,8 @@ enum class ShaderPropertyType {
 
 typedef std::function<void(QGL33 * const)> UniformSpecifier;
 typedef QList<UniformSpecifier> UniformSpecifiers;
+typedef std::function<void(CpuUniforms&)> CpuUniformSpecifier;
+typedef QList<CpuUniformSpecifier> CpuUniformSpecifiers;
 struct CORE_EXPORT UniformSpecifierCreator : public StdSelfRef
 {
     UniformSpecifierCreator(const ShaderPropertyType type,
@@ -62,7 +65,9 @@ struct CORE_EXPORT UniformSpecifierCreator : public StdSelfRef
                 const qreal relFrame,
                 const qreal resolution,
                 const qreal influence,
-                UniformSpecifiers& uniSpec) const;
+                UniformSpecifiers& uniSpec,
+                const int cpuLoc,
+                CpuUniformSpecifiers& cpuUniSpec) const;
 
     const ShaderPropertyType mType;
     const bool fGLValue;
@@ -124,22 +124,26 @@ void AudioHandler::initializeAudio(const QString &deviceName,
 void AudioHandler::startAudio() {
     //if (!QAudioDeviceInfo::availableDevices(QAudio::AudioOutput)
         //.contains(mAudioDevice)) { initializeAudio(); }
+    if (!mAudioOutput) { return; }
     mAudioIOOutput = mAudioOutput->start();
 }
 
 void AudioHandler::pauseAudio()
 {
+    if (!mAudioOutput) { return; }
     mAudioOutput->suspend();
 }
 
 void AudioHandler::resumeAudio()
 {
+    if (!mAudioOutput) { return; }
     mAudioOutput->resume();
 }
 
 void AudioHandler::stopAudio()
 {
     mAudioIOOutput = nullptr;
+    if (!mAudioOutput) { return; }
     mAudioOutput->stop();
     mAudioOutput->reset();
 }
@@ -0,0 +1,233 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "mixingbus.h"
+#include "exceptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define MIXINGBUS_SSE
+#include <xmmintrin.h>
+#endif
+
+// sample frames mixed at a time, keeps the envelope and the converted
+// source block in the L1 cache
+#define BLOCK_SAMPLES 1024
+
+namespace {
+    // dst += src*gain
+    void mulAdd(const float* src, const float* gain,
+                float* dst, const int count) {
+        int i = 0;
+#ifdef MIXINGBUS_SSE
+        for(; i + 4 <= count; i += 4) {
+            const __m128 s = _mm_loadu_ps(src + i);
+            const __m128 g = _mm_loadu_ps(gain + i);
+            const __m128 d = _mm_loadu_ps(dst + i);
+            _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+        }
+#endif
+        for(; i < count; i++) dst[i] += src[i]*gain[i];
+    }
+
+    void mulAdd(const float* src, const float gain,
+                float* dst, const int count) {
+        int i = 0;
+#ifdef MIXINGBUS_SSE
+        const __m128 g = _mm_set1_ps(gain);
+        for(; i + 4 <= count; i += 4) {
+            const __m128 s = _mm_loadu_ps(src + i);
+            const __m128 d = _mm_loadu_ps(dst + i);
+            _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+        }
+#endif
+        for(; i < count; i++) dst[i] += src[i]*gain;
+    }
+
+    // dst += src*gain for interleaved stereo, a gain per frame
+    void mulAddStereo(const float* src, const float* gain,
+                      float* dst, const int nFrames) {
+        int i = 0;
+#ifdef MIXINGBUS_SSE
+        for(; i + 4 <= nFrames; i += 4) {
+            const __m128 g = _mm_loadu_ps(gain + i);
+            const __m128 g01 = _mm_unpacklo_ps(g, g);
+            const __m128 g23 = _mm_unpackhi_ps(g, g);
+            const __m128 s01 = _mm_loadu_ps(src + 2*i);
+            const __m128 s23 = _mm_loadu_ps(src + 2*i + 4);
+            const __m128 d01 = _mm_loadu_ps(dst + 2*i);
+            const __m128 d23 = _mm_loadu_ps(dst + 2*i + 4);
+            _mm_storeu_ps(dst + 2*i, _mm_add_ps(d01, _mm_mul_ps(s01, g01)));
+            _mm_storeu_ps(dst + 2*i + 4, _mm_add_ps(d23, _mm_mul_ps(s23, g23)));
+        }
+#endif
+        for(; i < nFrames; i++) {
+            dst[2*i] += src[2*i]*gain[i];
+            dst[2*i + 1] += src[2*i + 1]*gain[i];
+        }
+    }
+
+    // unsigned formats are centered around max/2
+    template <typename T>
+    void convertToFloat(const T* src, float* dst,
+                        const int count, const float shift) {
+        for(int i = 0; i < count; i++) {
+            dst[i] = static_cast<float>(src[i]) - shift;
+        }
+    }
+
+    template <typename T>
+    void convertFromFloat(const float* src, T* dst,
+                          const int count, const qreal shift) {
+        const qreal min = qreal(std::numeric_limits<T>::min());
+        const qreal max = qreal(std::numeric_limits<T>::max());
+        for(int i = 0; i < count; i++) {
+            dst[i] = T(qBound(min, std::round(src[i] + shift), max));
+        }
+    }
+
+    const qreal sU8Shift = std::numeric_limits<quint8>::max()/2.;
+}
+
+MixingBus::MixingBus(const int nSamples, const int nChannels,
+                     const AVSampleFormat format) :
+    mNSamples(nSamples), mFormat(format),
+    mPlanar(av_sample_fmt_is_planar(format)),
+    mPlaneStride(mPlanar ? 1 : nChannels) {
+    switch(av_get_packed_sample_fmt(format)) {
+    case AV_SAMPLE_FMT_U8:
+    case AV_SAMPLE_FMT_S16:
+    case AV_SAMPLE_FMT_S32:
+    case AV_SAMPLE_FMT_S64:
+    case AV_SAMPLE_FMT_FLT:
+    case AV_SAMPLE_FMT_DBL:
+        break;
+    default:
+        RuntimeThrow("Unsupported format " + av_get_sample_fmt_name(format));
+    }
+    const int nPlanes = mPlanar ? nChannels : 1;
+    const auto planeSize = static_cast<size_t>(nSamples*mPlaneStride);
+    mPlanes.resize(static_cast<size_t>(nPlanes),
+                   std::vector<float>(planeSize, 0.f));
+    mVolume.resize(BLOCK_SAMPLES);
+    if(mPlaneStride > 2) mGain.resize(BLOCK_SAMPLES*mPlaneStride);
+    if(av_get_packed_sample_fmt(format) != AV_SAMPLE_FMT_FLT) {
+        mSrc.resize(BLOCK_SAMPLES*mPlaneStride);
+    }
+}
+
+const float* MixingBus::toFloat(const uchar * const src, const int first,
+                                const int count) {
+    const auto dst = mSrc.data();
+    switch(av_get_packed_sample_fmt(mFormat)) {
+    case AV_SAMPLE_FMT_FLT:
+        return reinterpret_cast<const float*>(src) + first;
+    case AV_SAMPLE_FMT_DBL:
+        convertToFloat(reinterpret_cast<const qreal*>(src) + first, dst, count, 0.f);
+        break;
+    case AV_SAMPLE_FMT_U8:
+        convertToFloat(reinterpret_cast<const quint8*>(src) + first,
+                       dst, count, static_cast<float>(sU8Shift));
+        break;
+    case AV_SAMPLE_FMT_S16:
+        convertToFloat(reinterpret_cast<const qint16*>(src) + first, dst, count, 0.f);
+        break;
+    case AV_SAMPLE_FMT_S32:
+        convertToFloat(reinterpret_cast<const qint32*>(src) + first, dst, count, 0.f);
+        break;
+    default:
+        convertToFloat(reinterpret_cast<const qint64*>(src) + first, dst, count, 0.f);
+        break;
+    }
+    return dst;
+}
+
+void MixingBus::add(uchar const * const * const src, const int srcFirst,
+                    const int dstFirst, int nSamples,
+                    QrealSnapshot::Iterator volIt) {
+    nSamples = qMin(nSamples, mNSamples - dstFirst);
+    const bool staticVol = volIt.staticValue();
+    const float vol = staticVol ?
+                static_cast<float>(volIt.getValueAndProgress(1)) : 0.f;
+    const int nPlanes = static_cast<int>(mPlanes.size());
+    for(int block = 0; block < nSamples; block += BLOCK_SAMPLES) {
+        const int blockSamples = qMin(BLOCK_SAMPLES, nSamples - block);
+        const int count = blockSamples*mPlaneStride;
+        const float* gain = mVolume.data();
+        if(!staticVol) {
+            volIt.getValuesAndProgress(mVolume.data(), blockSamples);
+            if(mPlaneStride > 2) {
+                // repeat for every channel of interleaved frames
+                float* gainDst = mGain.data();
+                for(int i = 0; i < blockSamples; i++) {
+                    for(int j = 0; j < mPlaneStride; j++) {
+                        *gainDst++ = mVolume[i];
+                    }
+                }
+                gain = mGain.data();
+            }
+        }
+        const int srcId = (srcFirst + block)*mPlaneStride;
+        const int dstId = (dstFirst + block)*mPlaneStride;
+        for(int i = 0; i < nPlanes; i++) {
+            const auto srcData = toFloat(src[i], srcId, count);
+            const auto dstData = mPlanes[i].data() + dstId;
+            if(staticVol) mulAdd(srcData, vol, dstData, count);
+            else if(mPlaneStride == 2) {
+                mulAddStereo(srcData, gain, dstData, blockSamples);
+            } else mulAdd(srcData, gain, dstData, count);
+        }
+    }
+}
+
+void MixingBus::write(uchar ** const dst) const {
+    const int count = mNSamples*mPlaneStride;
+    const int nPlanes = static_cast<int>(mPlanes.size());
+    for(int i = 0; i < nPlanes; i++) {
+        const auto src = mPlanes[i].data();
+        switch(av_get_packed_sample_fmt(mFormat)) {
+        case AV_SAMPLE_FMT_FLT:
+            memcpy(dst[i], src, static_cast<size_t>(count)*sizeof(float));
+            break;
+        case AV_SAMPLE_FMT_DBL:
+            std::copy(src, src + count, reinterpret_cast<qreal*>(dst[i]));
+            break;
+        case AV_SAMPLE_FMT_U8:
+            convertFromFloat(src, reinterpret_cast<quint8*>(dst[i]), count, sU8Shift);
+            break;
+        case AV_SAMPLE_FMT_S16:
+            convertFromFloat(src, reinterpret_cast<qint16*>(dst[i]), count, 0);
+            break;
+        case AV_SAMPLE_FMT_S32:
+            convertFromFloat(src, reinterpret_cast<qint32*>(dst[i]), count, 0);
+            break;
+        default:
+            convertFromFloat(src, reinterpret_cast<qint64*>(dst[i]), count, 0);
+            break;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef MIXINGBUS_H
+#define MIXINGBUS_H
+
+#include "Animators/qrealsnapshot.h"
+
+#include <vector>
+
+extern "C" {
+    #include <libavutil/samplefmt.h>
+}
+
+// Float accumulator SoundMerger mixes the sounds of a second into.
+// Sources are converted to float once, scaled by their volume envelope
+// and summed, the result is converted and saturated to the output
+// sample format in write(). Planar formats keep a plane per channel.
+class CORE_EXPORT MixingBus {
+public:
+    MixingBus(const int nSamples, const int nChannels,
+              const AVSampleFormat format);
+
+    //! @brief Adds nSamples of src, starting at srcFirst, at dstFirst
+    void add(uchar const * const * const src, const int srcFirst,
+             const int dstFirst, int nSamples,
+             QrealSnapshot::Iterator volIt);
+
+    //! @brief dst has to hold nSamples in the bus format
+    void write(uchar ** const dst) const;
+private:
+    const float* toFloat(const uchar * const src, const int first,
+                         const int count);
+
+    const int mNSamples;
+    const AVSampleFormat mFormat;
+    const bool mPlanar;
+    const int mPlaneStride;
+
+    std::vector<std::vector<float>> mPlanes;
+    std::vector<float> mVolume;
+    std::vector<float> mGain;
+    std::vector<float> mSrc;
+};
+
+#endif // MIXINGBUS_H
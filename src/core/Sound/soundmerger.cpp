@@ -24,303 +24,7 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "soundmerger.h"
-
-template <typename T>
-void mergePlanarDataUnsigned(T const * const * const src,
-                             const SampleRange& srcRange,
-                             T ** const dst,
-                             const SampleRange& dstRange,
-                             const int nSamples,
-                             QrealSnapshot::Iterator volIt,
-                             const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    const qreal min = std::numeric_limits<T>::min();
-    const qreal max = std::numeric_limits<T>::max();
-    const qreal shift = max/2;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[j][dstId];
-                dstP = T(qBound(min, round(dstP + (src[j][srcId] - shift)*vol + shift), max));
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[j][dstId];
-                dstP = T(qBound(min, round(dstP + (src[j][srcId] - shift)*vol + shift), max));
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-template <typename T>
-void mergeInterleavedDataUnsigned(const T* const src,
-                                  const SampleRange& srcRange,
-                                  T * const dst,
-                                  const SampleRange& dstRange,
-                                  const int nSamples,
-                                  QrealSnapshot::Iterator volIt,
-                                  const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    const qreal min = std::numeric_limits<T>::min();
-    const qreal max = std::numeric_limits<T>::max();
-    const qreal shift = max/2;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + (src[srcId++] - shift)*vol + shift), max));
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + (src[srcId++] - shift)*vol + shift), max));
-            }
-        }
-    }
-}
-
-template <typename T>
-void mergePlanarDataSigned(T const * const * const src,
-                           const SampleRange& srcRange,
-                           T ** const dst,
-                           const SampleRange& dstRange,
-                           const int nSamples,
-                           QrealSnapshot::Iterator volIt,
-                           const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    const qreal min = (qreal)std::numeric_limits<T>::min();
-    const qreal max = (qreal)std::numeric_limits<T>::max();
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] = T(qBound(min, round(dst[j][dstId] + src[j][srcId]*vol), max));
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] = T(qBound(min, round(dst[j][dstId] + src[j][srcId]*vol), max));
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-template <typename T>
-void mergeInterleavedDataSigned(const T* const src,
-                                const SampleRange& srcRange,
-                                T * const dst,
-                                const SampleRange& dstRange,
-                                const int nSamples,
-                                QrealSnapshot::Iterator volIt,
-                                const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    const qreal min = (qreal)std::numeric_limits<T>::min();
-    const qreal max = (qreal)std::numeric_limits<T>::max();
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + src[srcId++]*vol), max));
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + src[srcId++]*vol), max));
-            }
-        }
-    }
-}
-
-void mergePlanarData(float const * const * const src,
-                     const SampleRange& srcRange,
-                     float ** const dst,
-                     const SampleRange& dstRange,
-                     const int nSamples,
-                     QrealSnapshot::Iterator volIt,
-                     const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    if(volIt.staticValue()) {
-        const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-void mergeInterleavedData(const float* const src,
-                          const SampleRange& srcRange,
-                          float * const dst,
-                          const SampleRange& dstRange,
-                          const int nSamples,
-                          QrealSnapshot::Iterator volIt,
-                          const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    if(volIt.staticValue()) {
-        const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    }
-}
-
-
-void mergePlanarData(qreal const * const * const src,
-                     const SampleRange& srcRange,
-                     qreal ** const dst,
-                     const SampleRange& dstRange,
-                     const int nSamples,
-                     QrealSnapshot::Iterator volIt,
-                     const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-void mergeInterleavedData(const qreal* const src,
-                          const SampleRange& srcRange,
-                          qreal * const dst,
-                          const SampleRange& dstRange,
-                          const int nSamples,
-                          QrealSnapshot::Iterator volIt,
-                          const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    }
-}
-
-void mergeData(uchar const * const * const src,
-               const SampleRange& srcRange,
-               uchar ** const dst,
-               const SampleRange& dstRange,
-               int nSamples,
-               QrealSnapshot::Iterator volIt,
-               const AVSampleFormat format,
-               const int nChannels) {
-    nSamples = qMin(qMin(nSamples, dstRange.span()), srcRange.span());
-    if(format == AV_SAMPLE_FMT_FLT) {
-        mergeInterleavedData(reinterpret_cast<const float*>(src[0]), srcRange,
-                             reinterpret_cast<float*>(dst[0]), dstRange,
-                             nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_FLTP) {
-        mergePlanarData(reinterpret_cast<float const * const *>(src), srcRange,
-                        reinterpret_cast<float**>(dst), dstRange,
-                        nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_DBL) {
-        mergeInterleavedData(reinterpret_cast<const qreal*>(src[0]), srcRange,
-                             reinterpret_cast<qreal*>(dst[0]), dstRange,
-                             nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_DBLP) {
-        mergePlanarData(reinterpret_cast<qreal const * const *>(src), srcRange,
-                        reinterpret_cast<qreal**>(dst), dstRange,
-                        nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_U8) {
-        mergeInterleavedDataUnsigned(reinterpret_cast<const quint8*>(src[0]), srcRange,
-                                     reinterpret_cast<quint8*>(dst[0]), dstRange,
-                                     nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_U8P) {
-        mergePlanarDataUnsigned(reinterpret_cast<quint8 const * const *>(src), srcRange,
-                                reinterpret_cast<quint8**>(dst), dstRange,
-                                nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S16) {
-        mergeInterleavedDataSigned(reinterpret_cast<const qint16*>(src[0]), srcRange,
-                                   reinterpret_cast<qint16*>(dst[0]), dstRange,
-                                   nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S16P) {
-        mergePlanarDataSigned(reinterpret_cast<qint16 const * const *>(src), srcRange,
-                              reinterpret_cast<qint16**>(dst), dstRange,
-                              nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S32) {
-        mergeInterleavedDataSigned(reinterpret_cast<const qint32*>(src[0]), srcRange,
-                                   reinterpret_cast<qint32*>(dst[0]), dstRange,
-                                   nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S32P) {
-        mergePlanarDataSigned(reinterpret_cast<qint32 const * const *>(src), srcRange,
-                              reinterpret_cast<qint32**>(dst), dstRange,
-                              nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S64) {
-        mergeInterleavedDataSigned(reinterpret_cast<const qint64*>(src[0]), srcRange,
-                                   reinterpret_cast<qint64*>(dst[0]), dstRange,
-                                   nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S64P) {
-        mergePlanarDataSigned(reinterpret_cast<qint64 const * const *>(src), srcRange,
-                              reinterpret_cast<qint64**>(dst), dstRange,
-                              nSamples, volIt, nChannels);
-    } else RuntimeThrow("Unsupported format " + av_get_sample_fmt_name(format));
-}
+#include "mixingbus.h"
 
 void SoundMerger::process() {
     const int nChannels = mSettings.channelCount();
@@ -328,8 +32,7 @@ void SoundMerger::process() {
                                           mSettings.fSampleRate,
                                           mSettings.fSampleFormat,
                                           mSettings.fChannelLayout);
-    mSamples->zeroAll();
-    const auto dst = mSamples->fData;
+    MixingBus bus(mSampleRange.span(), nChannels, mSettings.fSampleFormat);
     for(const auto& sound : mSounds) {
         const auto srcSamples = sound.fSamples;
         const qreal stretch = sound.fStretch;
@@ -355,8 +58,8 @@ void SoundMerger::process() {
             const int nSamples = qMin(srcNeededRelRange.span(), dstRelRange.span());
 
             const auto src = srcSamples->fData;
-            mergeData(src, srcNeededRelRange, dst, dstRelRange,
-                      nSamples, volIt, mSettings.fSampleFormat, nChannels);
+            bus.add(src, srcNeededRelRange.fMin, dstRelRange.fMin,
+                    nSamples, volIt);
         } else {
             const int srcSampleRate = mSettings.fSampleRate;
             const int dstSampleRate = qRound(mSettings.fSampleRate*stretch);
@@ -388,10 +91,13 @@ void SoundMerger::process() {
                                 srcSampleRate);
             swr_free(&swrContext);
             if(nSamples < 0) RuntimeThrow("Resampling failed");
-            mergeData(buffer, srcNeededRelRange, dst, dstRelRange,
-                      nSamples, volIt, mSettings.fSampleFormat, nChannels);
+            const int nMerged = qMin(qMin(nSamples, dstRelRange.span()),
+                                     srcNeededRelRange.span());
+            bus.add(buffer, srcNeededRelRange.fMin, dstRelRange.fMin,
+                    nMerged, volIt);
             if(buffer) av_freep(&buffer[0]);
             av_freep(&buffer);
         }
     }
+    bus.write(mSamples->fData);
 }
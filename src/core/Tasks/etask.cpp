@@ -25,6 +25,8 @@
 
 #include "etask.h"
 
+#include "Private/Tasks/taskque.h"
+
 bool eTask::queTask() {
     mState = eTaskState::qued;
     afterQued();
@@ -36,3 +38,7 @@ void eTask::aboutToProcess(const Hardware hw) {
     mState = eTaskState::processing;
     beforeProcessing(hw);
 }
+
+void eTask::becameReady() {
+    if(mWaitingQue) mWaitingQue->taskReady(this);
+}
@@ -31,9 +31,12 @@
 #include "../switchablecontext.h"
 #include "etaskbase.h"
 
+class TaskQue;
+
 class CORE_EXPORT eTask : public StdSelfRef, public eTaskBase {
     friend class TaskScheduler;
     friend class Que;
+    friend class TaskQue;
     friend class eTaskBase;
     template <typename T> friend class TaskCollection;
 protected:
@@ -42,6 +45,8 @@ protected:
     virtual void queTaskNow() = 0;
     virtual void afterQued() {}
     virtual void beforeProcessing(const Hardware) {}
+
+    void becameReady() override;
 public:
     virtual HardwareSupport hardwareSupport() const = 0;
     virtual void processGpu(QGL33 * const gl,
@@ -53,6 +58,8 @@ public:
     bool queTask();
 
     void aboutToProcess(const Hardware hw);
+private:
+    TaskQue* mWaitingQue = nullptr;
 };
 
 Q_DECLARE_METATYPE(stdsptr<eTask>);
@@ -45,6 +45,7 @@ public:
 protected:
     virtual void afterProcessing() {}
     virtual void afterCanceled() {}
+    virtual void becameReady() {}
     virtual bool handleException() { return false; }
 public:
     struct Dependent {
@@ -74,12 +75,16 @@ public:
 
     bool waitingToCancel() const { return mCancel; }
     void cancel();
+
+    //! @brief Time spent in process()/processGpu(), in microseconds
+    qint64 processingUs() const { return mProcessingUs; }
+    void addProcessingUs(const qint64 us) { mProcessingUs += us; }
 protected:
     eTaskState mState = eTaskState::created;
 
     void moveDependent(eTaskBase* const to);
 private:
-    void decDependencies() { mNDependancies--; }
+    void decDependencies() { if(--mNDependancies == 0) becameReady(); }
     void incDependencies() { mNDependancies++; }
 
     void tellDependentThatFinished();
@@ -87,6 +92,7 @@ private:
 
     bool mCancel = false;
     int mNDependancies = 0;
+    qint64 mProcessingUs = 0;
     QList<Dependent> mDependentF;
     QList<stdptr<eTask>> mDependent;
     std::exception_ptr mUpdateException;
@@ -475,6 +475,7 @@ int AppSupport::getFrameFromTimeCode(const QString &timecode,
 HardwareSupport AppSupport::getRasterEffectHardwareSupport(const QString &effect,
                                                            HardwareSupport fallback)
 {
+    if (!HardwareInfo::sGpuAvailable()) { return HardwareSupport::cpuOnly; }
     if (effect.isEmpty()) { return fallback; }
     const QVariant variant = getSettings("RasterEffects",
                                          QString("%1HardwareSupport").arg(effect));
@@ -993,7 +994,11 @@ void AppSupport::checkFFmpeg(const bool &isRenderer)
 
 void AppSupport::initEnv(const bool &isRenderer)
 {
-    Q_UNUSED(isRenderer)
+    // the renderer never opens a window
+    if (isRenderer) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+        return;
+    }
 #if defined(Q_OS_WIN)
     // windows theme integration
 #if QT_VERSION < QT_VERSION_CHECK(6, 5, 0)
@@ -1039,7 +1044,27 @@ void AppSupport::printVersion()
 
 void AppSupport::printHelp(const bool &isRenderer)
 {
-    Q_UNUSED(isRenderer)
+    if (!isRenderer) {
+        std::cout << QString("Usage: %1 [project.friction]").arg(getAppName()).toStdString() << std::endl
+                  << QString("       %1 --renderer [options] project.friction").arg(getAppName()).toStdString() << std::endl;
+        return;
+    }
+    std::cout << QString("Usage: %1 --renderer [options] project.friction").arg(getAppName()).toStdString() << std::endl
+              << std::endl
+              << "Render a project to video without a user interface (CPU only)." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --scene <name|index>   Scene to render (default: first in render queue or project)" << std::endl
+              << "  --start <frame>        First frame (default: scene or render queue range)" << std::endl
+              << "  --end <frame>          Last frame (default: scene or render queue range)" << std::endl
+              << "  --width <pixels>       Output width, keeps aspect ratio unless --height is set" << std::endl
+              << "  --height <pixels>      Output height, keeps aspect ratio unless --width is set" << std::endl
+              << "  --resolution <percent> Output resolution relative to the scene size" << std::endl
+              << "  --profile <name|file>  Output profile name or .conf file" << std::endl
+              << "  --output <file>        Output file (default: render queue destination)" << std::endl
+              << "  --help                 Show this help" << std::endl
+              << std::endl
+              << "Exit status is 0 on success and non-zero on failure." << std::endl;
 }
 
 const AppSupport::ExpressionPreset AppSupport::readEasingPreset(const QString &filename)
@@ -48,6 +48,7 @@
 #include "Boxes/nullobject.h"
 #include "simpletask.h"
 #include "themesupport.h"
+#include "Private/Tasks/taskscheduler.h"
 
 Canvas::Canvas(Document &document,
                const int canvasWidth,
@@ -668,6 +669,16 @@ void Canvas::renderDataFinished(BoxRenderData *renderData) {
                 currentState ? &mSceneFramesHandler : nullptr);
     if(currentState) mSceneFramesHandler.add(cont);
 
+    // only edits on the same frame reuse the composite
+    const auto composite = static_cast<CanvasRenderData*>(renderData)->fComposite;
+    if(mPreviewing || mRenderingOutput || !composite) {
+        mLastComposite.reset();
+        mLastCompositeFrame.clear();
+    } else {
+        mLastComposite = composite;
+        mLastCompositeFrame = cont.get();
+    }
+
     if(!mPreviewing && !mRenderingOutput){
         bool newerSate = true;
         bool closerFrame = true;
@@ -989,6 +1000,10 @@ void Canvas::anim_setAbsFrame(const int frame)
 {
     if (frame == anim_getCurrentAbsFrame()) { return; }
     ContainerBox::anim_setAbsFrame(frame);
+    if (!isPreviewingOrRendering()) {
+        const auto scheduler = TaskScheduler::instance();
+        if (scheduler) { scheduler->setFocusFrame(frame); }
+    }
     const int newRelFrame = anim_getCurrentRelFrame();
 
     const auto cont = mSceneFramesHandler.atFrame<SceneFrameContainer>(newRelFrame);
@@ -400,6 +400,11 @@ public:
         canvasData->fBgColor = toSkColor(mBackgroundColor->getColor());
         canvasData->fCanvasHeight = mHeight;
         canvasData->fCanvasWidth = mWidth;
+        // the pixels are reused only while the frame cache holds them
+        if(mLastCompositeFrame && mLastCompositeFrame->storesDataInMemory()) {
+            canvasData->fPrevious = mLastComposite;
+            canvasData->fPreviousImage = mLastCompositeFrame->getImage();
+        }
     }
 
     bool clipToCanvas()
@@ -813,6 +818,8 @@ protected:
 
     bool mSceneFrameOutdated = false;
     UseSharedPointer<SceneFrameContainer> mSceneFrame;
+    stdsptr<const CanvasComposite> mLastComposite;
+    stdptr<SceneFrameContainer> mLastCompositeFrame;
     UseSharedPointer<SceneFrameContainer> mLoadingSceneFrame;
 
     bool mClipToCanvasSize = false;
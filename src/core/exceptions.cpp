@@ -50,6 +50,12 @@ bool isExceptionNested(const std::exception& e) {
     return false;
 }
 
+static bool gExceptionDialogs = true;
+
+void gSetExceptionDialogs(const bool enabled) {
+    gExceptionDialogs = enabled;
+}
+
 void _gPrintException(const std::exception& e,
                       QString allText,
                       const uint level,
@@ -58,7 +64,8 @@ void _gPrintException(const std::exception& e,
     qCritical() << std::to_string(level) + ") " << e.what();
     try {
         if(!isExceptionNested(e)) {
-            gPrintException(fatal, allText);
+            // already logged above when running without dialogs
+            if(gExceptionDialogs) gPrintException(fatal, allText);
             if(!fatal) return;
         }
         std::rethrow_if_nested(e);
@@ -91,6 +98,10 @@ QString gAllTextFromException(const std::exception &e,
 }
 
 void gPrintException(const bool fatal, const QString &allText) {
+    if(!gExceptionDialogs) {
+        qCritical().noquote() << allText;
+        return;
+    }
     const QString txt = fatal ? "Fatal" : "Critical";
     const auto icon = fatal ? QMessageBox::Critical : QMessageBox::Warning;
     QMessageBox(icon, txt + " Error", allText).exec();
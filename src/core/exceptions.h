@@ -102,5 +102,7 @@ CORE_EXPORT
 extern void gPrintExceptionCritical(const std::exception_ptr& eptr);
 CORE_EXPORT
 extern void gPrintExceptionFatal(const std::exception_ptr& eptr);
+CORE_EXPORT
+extern void gSetExceptionDialogs(const bool enabled);
 
 #endif // EXCEPTIONS_H
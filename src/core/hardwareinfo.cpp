@@ -44,6 +44,7 @@ GpuVendor HardwareInfo::mGpuVendor = GpuVendor::unrecognized;
 QString HardwareInfo::mGpuVendorString = QObject::tr("Unknown");
 QString HardwareInfo::mGpuRendererString = QObject::tr("Unknown");
 QString HardwareInfo::mGpuVersionString = QObject::tr("Unknown");
+bool HardwareInfo::mGpuAvailable = false;
 
 intKB getTotalRamBytes() {
 #if defined(Q_OS_WIN)
@@ -111,12 +112,15 @@ const QPair<GpuVendor, QStringList> gpuVendor()
     return QPair<GpuVendor, QStringList>(gpu, specs);
 }
 
-void HardwareInfo::sUpdateInfo() {
+void HardwareInfo::sUpdateInfo(const bool queryGpu) {
     mCpuThreads = QThread::idealThreadCount();
     mRamKB = getTotalRamBytes();
+    mGpuAvailable = false;
+    if(!queryGpu) return;
     const auto gpu = gpuVendor();
     mGpuVendor = gpu.first;
     mGpuVendorString = gpu.second.at(0);
     mGpuRendererString = gpu.second.at(1);
     mGpuVersionString = gpu.second.at(2);
+    mGpuAvailable = true;
 }
@@ -33,7 +33,7 @@
 class CORE_EXPORT HardwareInfo {
     HardwareInfo() = delete;
 public:
-    static void sUpdateInfo();
+    static void sUpdateInfo(const bool queryGpu = true);
 
     static int sCpuThreads() { return mCpuThreads; }
     static intKB sRamKB() { return mRamKB; }
@@ -41,6 +41,8 @@ public:
     static const QString sGpuVendorString() { return mGpuVendorString; }
     static const QString sGpuRendererString() { return mGpuRendererString; }
     static const QString sGpuVersionString() { return mGpuVersionString; }
+    //! @brief False when running without an OpenGL context (CPU-only)
+    static bool sGpuAvailable() { return mGpuAvailable; }
 
 private:
     static int mCpuThreads;
@@ -49,6 +51,7 @@ private:
     static QString mGpuVendorString;
     static QString mGpuRendererString;
     static QString mGpuVersionString;
+    static bool mGpuAvailable;
 };
 
 #endif // HARDWAREINFO_H
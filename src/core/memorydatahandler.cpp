@@ -26,28 +26,70 @@
 #include "memorydatahandler.h"
 #include "CacheHandlers/cachecontainer.h"
 
+// oldest containers considered for eviction
+#define EVICTION_CANDIDATES 16
+// frames at which a container is worth half as much
+#define HALF_VALUE_DISTANCE 25
+
 MemoryDataHandler *MemoryDataHandler::sInstance = nullptr;
 
+static qreal sEvictionValue(CacheContainer * const cont) {
+    const qreal kB = qMax(1, cont->getByteCount()/1024);
+    const qreal costPerKB = (cont->cost() + 1)/kB;
+    const qreal dist = cont->reuseDistance();
+    return costPerKB*HALF_VALUE_DISTANCE/(HALF_VALUE_DISTANCE + dist);
+}
+
 MemoryDataHandler::MemoryDataHandler() {
     Q_ASSERT(!sInstance);
     sInstance = this;
 }
 
 void MemoryDataHandler::addContainer(CacheContainer * const cont) {
-    mContainers << cont;
+    cont->mEvictionCredit = mInflation;
+    cont->mLruPrev = mLast;
+    cont->mLruNext = nullptr;
+    if(mLast) mLast->mLruNext = cont;
+    else mFirst = cont;
+    mLast = cont;
+    mCount++;
 }
 
 void MemoryDataHandler::removeContainer(CacheContainer * const cont) {
-    mContainers.removeOne(cont);
+    if(cont->mLruPrev) cont->mLruPrev->mLruNext = cont->mLruNext;
+    else mFirst = cont->mLruNext;
+    if(cont->mLruNext) cont->mLruNext->mLruPrev = cont->mLruPrev;
+    else mLast = cont->mLruPrev;
+    cont->mLruPrev = nullptr;
+    cont->mLruNext = nullptr;
+    mCount--;
 }
 
 void MemoryDataHandler::containerUpdated(CacheContainer * const cont) {
+    if(cont == mLast) {
+        cont->mEvictionCredit = mInflation;
+        return;
+    }
     removeContainer(cont);
     addContainer(cont);
 }
 
-CacheContainer *MemoryDataHandler::takeFirst() {
-    const auto cont = mContainers.takeFirst();
+int MemoryDataHandler::freeFirst() {
+    CacheContainer* cont = nullptr;
+    qreal minPriority = 0;
+    auto it = mFirst;
+    for(int i = 0; it && i < EVICTION_CANDIDATES; i++, it = it->mLruNext) {
+        const qreal priority = it->mEvictionCredit + sEvictionValue(it);
+        if(!cont || priority < minPriority) {
+            cont = it;
+            minPriority = priority;
+        }
+    }
+    mInflation = qMax(mInflation, minPriority);
+    removeContainer(cont);
     cont->mHandledByMemoryHandler = false;
-    return cont;
+    const int bytes = cont->free_RAM_k();
+    mStats.fEvictions++;
+    mStats.fBytesFreed += bytes;
+    return bytes;
 }
@@ -25,14 +25,25 @@
 
 #ifndef MEMORYDATAHANDLER_H
 #define MEMORYDATAHANDLER_H
-#include <QList>
+#include <QtGlobal>
 
 #include "core_global.h"
 
 class CacheContainer;
 
+// Containers not in use, least recently used first, linked through
+// CacheContainer::mLruPrev/mLruNext, so that every operation is O(1).
+// Eviction follows GreedyDual-Size over the oldest few containers,
+// weighing recompute cost per byte against the distance from the
+// range in use.
 class CORE_EXPORT MemoryDataHandler {
 public:
+    struct Stats {
+        qint64 fHits = 0; // reused while waiting to be freed
+        qint64 fEvictions = 0;
+        qint64 fBytesFreed = 0;
+    };
+
     MemoryDataHandler();
 
     static MemoryDataHandler *sInstance;
@@ -40,11 +51,20 @@ public:
     void addContainer(CacheContainer * const cont);
     void removeContainer(CacheContainer * const cont);
     void containerUpdated(CacheContainer * const cont);
+    void containerHit() { mStats.fHits++; }
+
+    bool isEmpty() const { return !mFirst; }
+    int count() const { return mCount; }
+    const Stats& stats() const { return mStats; }
 
-    bool isEmpty() const { return mContainers.isEmpty(); }
-    CacheContainer* takeFirst();
+    //! @brief Frees the least recently used container, returns freed bytes
+    int freeFirst();
 private:
-    QList<CacheContainer*> mContainers;
+    CacheContainer* mFirst = nullptr;
+    CacheContainer* mLast = nullptr;
+    int mCount = 0;
+    Stats mStats;
+    qreal mInflation = 0;
 };
 
 #endif // MEMORYDATAHANDLER_H
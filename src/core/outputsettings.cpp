@@ -23,6 +23,7 @@
 #include "outputsettings.h"
 #include "ReadWrite/evformat.h"
 #include "appsupport.h"
+#include <QDir>
 
 using namespace Friction::Core;
 
@@ -346,6 +347,25 @@ OutputSettingsProfile *OutputSettingsProfile::sGetByName(const QString &name)
     return nullptr;
 }
 
+void OutputSettingsProfile::sLoadOutputProfiles()
+{
+    if (sOutputProfilesLoaded) { return; }
+    sOutputProfilesLoaded = true;
+    QDir dirPath(AppSupport::getAppOutputProfilesPath());
+    dirPath.setSorting(QDir::SortFlag::Name);
+    for (const auto &fileInfo : dirPath.entryInfoList()) {
+        if (!fileInfo.isFile()) { continue; }
+        if (!fileInfo.completeSuffix().contains("conf")) { continue; }
+        const auto profile = enve::make_shared<OutputSettingsProfile>();
+        try {
+            profile->load(fileInfo.absoluteFilePath());
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+        }
+        sOutputProfiles << profile;
+    }
+}
+
 FormatOptions OutputSettingsProfile::toFormatOptions(const FormatOptionsList &list)
 {
     FormatOptions options;
@@ -94,6 +94,7 @@ public:
     const QString &path() const { return mPath; }
 
     static OutputSettingsProfile* sGetByName(const QString &name);
+    static void sLoadOutputProfiles();
     static QList<qsptr<OutputSettingsProfile>> sOutputProfiles;
     static bool sOutputProfilesLoaded;
 
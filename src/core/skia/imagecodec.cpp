@@ -0,0 +1,207 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "imagecodec.h"
+#include "skiahelpers.h"
+
+#define OP_INDEX 0x00
+#define OP_DIFF 0x40
+#define OP_LUMA 0x80
+#define OP_RUN 0xc0
+#define OP_RGB 0xfe
+#define OP_RGBA 0xff
+#define MASK_2 0xc0
+#define MAX_RUN 62
+
+namespace {
+    struct Pixel {
+        uchar fC[4]; // alpha is the last channel
+
+        bool operator==(const Pixel& other) const {
+            return memcmp(fC, other.fC, 4) == 0;
+        }
+        bool operator!=(const Pixel& other) const {
+            return !(*this == other);
+        }
+        int hash() const {
+            return (fC[0]*3 + fC[1]*5 + fC[2]*7 + fC[3]*11) % 64;
+        }
+    };
+}
+
+void ImageCodec::encode(const SkPixmap& pix, std::vector<uchar>& dst) {
+    const int width = pix.width();
+    const int height = pix.height();
+    dst.clear();
+    // worst case, every pixel stored with OP_RGBA
+    dst.reserve(static_cast<size_t>(width)*static_cast<size_t>(height)*5);
+
+    Pixel index[64] = {};
+    Pixel prev{{0, 0, 0, 255}};
+    int run = 0;
+    for(int y = 0; y < height; y++) {
+        const auto row = static_cast<const uchar*>(pix.addr(0, y));
+        for(int x = 0; x < width; x++) {
+            Pixel px;
+            memcpy(px.fC, row + 4*x, 4);
+            if(px == prev) {
+                if(++run == MAX_RUN) {
+                    dst.push_back(OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if(run > 0) {
+                dst.push_back(OP_RUN | (run - 1));
+                run = 0;
+            }
+            const int hash = px.hash();
+            if(index[hash] == px) {
+                dst.push_back(OP_INDEX | hash);
+            } else {
+                index[hash] = px;
+                if(px.fC[3] == prev.fC[3]) {
+                    const int d0 = static_cast<int8_t>(px.fC[0] - prev.fC[0]);
+                    const int d1 = static_cast<int8_t>(px.fC[1] - prev.fC[1]);
+                    const int d2 = static_cast<int8_t>(px.fC[2] - prev.fC[2]);
+                    const int d01 = d0 - d1;
+                    const int d21 = d2 - d1;
+                    if(d0 > -3 && d0 < 2 && d1 > -3 && d1 < 2 &&
+                       d2 > -3 && d2 < 2) {
+                        dst.push_back(OP_DIFF | (d0 + 2) << 4 |
+                                      (d1 + 2) << 2 | (d2 + 2));
+                    } else if(d01 > -9 && d01 < 8 && d1 > -33 && d1 < 32 &&
+                              d21 > -9 && d21 < 8) {
+                        dst.push_back(OP_LUMA | (d1 + 32));
+                        dst.push_back(static_cast<uchar>((d01 + 8) << 4 |
+                                                         (d21 + 8)));
+                    } else {
+                        dst.push_back(OP_RGB);
+                        dst.insert(dst.end(), px.fC, px.fC + 3);
+                    }
+                } else {
+                    dst.push_back(OP_RGBA);
+                    dst.insert(dst.end(), px.fC, px.fC + 4);
+                }
+            }
+            prev = px;
+        }
+    }
+    if(run > 0) dst.push_back(OP_RUN | (run - 1));
+}
+
+bool ImageCodec::decode(const uchar* src, const qint64 size,
+                        const SkPixmap& dst) {
+    const int width = dst.width();
+    const int height = dst.height();
+    const uchar* const end = src + size;
+
+    Pixel index[64] = {};
+    Pixel px{{0, 0, 0, 255}};
+    int run = 0;
+    for(int y = 0; y < height; y++) {
+        const auto row = static_cast<uchar*>(dst.writable_addr(0, y));
+        for(int x = 0; x < width; x++) {
+            if(run > 0) {
+                run--;
+            } else {
+                if(src >= end) return false;
+                const uchar op = *src++;
+                if(op == OP_RGB) {
+                    if(end - src < 3) return false;
+                    memcpy(px.fC, src, 3);
+                    src += 3;
+                } else if(op == OP_RGBA) {
+                    if(end - src < 4) return false;
+                    memcpy(px.fC, src, 4);
+                    src += 4;
+                } else if((op & MASK_2) == OP_INDEX) {
+                    px = index[op];
+                } else if((op & MASK_2) == OP_DIFF) {
+                    px.fC[0] += ((op >> 4) & 0x03) - 2;
+                    px.fC[1] += ((op >> 2) & 0x03) - 2;
+                    px.fC[2] += (op & 0x03) - 2;
+                } else if((op & MASK_2) == OP_LUMA) {
+                    if(src >= end) return false;
+                    const uchar b2 = *src++;
+                    const int d1 = (op & 0x3f) - 32;
+                    px.fC[0] += d1 - 8 + ((b2 >> 4) & 0x0f);
+                    px.fC[1] += d1;
+                    px.fC[2] += d1 - 8 + (b2 & 0x0f);
+                } else { // OP_RUN
+                    run = op & 0x3f;
+                }
+                index[px.hash()] = px;
+            }
+            memcpy(row + 4*x, px.fC, 4);
+        }
+    }
+    return true;
+}
+
+void ImageCodec::writeImg(const sk_sp<SkImage> &img, eWriteStream &dst) {
+    SkPixmap pix;
+    sk_sp<SkImage> raster;
+    if(!img->peekPixels(&pix)) {
+        raster = img->makeRasterImage();
+        if(!raster || !raster->peekPixels(&pix)) {
+            RuntimeThrow("Could not peek image pixels");
+        }
+    }
+    std::vector<uchar> data;
+    encode(pix, data);
+    const qint64 size = static_cast<qint64>(data.size());
+    dst << pix.width();
+    dst << pix.height();
+    dst << static_cast<uint64_t>(size);
+    dst.write(data.data(), size);
+}
+
+sk_sp<SkImage> ImageCodec::readImg(eReadStream &src) {
+    int width, height;
+    uint64_t size;
+    src >> width;
+    src >> height;
+    src >> size;
+    if(width <= 0 || height <= 0) {
+        RuntimeThrow("Invalid compressed image size");
+    }
+    // encode never produces more than five bytes per pixel
+    const uint64_t maxSize = static_cast<uint64_t>(width)*
+                             static_cast<uint64_t>(height)*5;
+    if(size > maxSize) RuntimeThrow("Invalid compressed image data size");
+    std::vector<uchar> data(size);
+    const qint64 bytes = static_cast<qint64>(size);
+    if(src.read(data.data(), bytes) != bytes) {
+        RuntimeThrow("Could not read compressed image data");
+    }
+    SkBitmap btmp;
+    const auto info = SkiaHelpers::getPremulRGBAInfo(width, height);
+    if(!btmp.tryAllocPixels(info)) {
+        RuntimeThrow("Could not allocate compressed image pixels");
+    }
+    if(!decode(data.data(), bytes, btmp.pixmap())) {
+        RuntimeThrow("Corrupted compressed image data");
+    }
+    return SkiaHelpers::transferDataToSkImage(btmp);
+}
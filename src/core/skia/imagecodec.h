@@ -0,0 +1,47 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef IMAGECODEC_H
+#define IMAGECODEC_H
+
+#include "ReadWrite/ereadstream.h"
+#include "ReadWrite/ewritestream.h"
+
+#include "skiaincludes.h"
+
+// Fast lossless codec for cached frames, based on QOI
+// (https://qoiformat.org). Repeated pixels are run length encoded,
+// so fully transparent regions cost next to nothing.
+namespace ImageCodec {
+    CORE_EXPORT
+    void writeImg(const sk_sp<SkImage>& img, eWriteStream &dst);
+    CORE_EXPORT
+    sk_sp<SkImage> readImg(eReadStream& src);
+
+    CORE_EXPORT
+    void encode(const SkPixmap& pix, std::vector<uchar>& dst);
+    CORE_EXPORT
+    bool decode(const uchar* src, const qint64 size, const SkPixmap& dst);
+}
+
+#endif // IMAGECODEC_H
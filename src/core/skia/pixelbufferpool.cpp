@@ -0,0 +1,134 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "pixelbufferpool.h"
+#include "skiahelpers.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// smaller buffers are cheap enough for the regular allocator
+#define MIN_POOLED_BYTES (256*1024)
+#define MAX_POOLED_BYTES (qint64(512)*1024*1024)
+
+namespace {
+    struct Pool {
+        std::mutex fMutex;
+        // free buffers by bucket size
+        std::map<size_t, std::vector<void*>> fFree;
+        qint64 fPooledBytes = 0;
+    };
+
+    // never destroyed, images released during exit still return here
+    Pool& pool() {
+        static const auto instance = new Pool;
+        return *instance;
+    }
+
+    // eight buckets per power of two keep the waste under 12.5%
+    size_t bucketSize(const size_t bytes) {
+        int bits = 0;
+        while((bytes >> bits) > 15) bits++;
+        const size_t step = size_t(1) << bits;
+        return (bytes + step - 1) & ~(step - 1);
+    }
+
+    void releasePixels(void* addr, void* context) {
+        const auto size = static_cast<size_t>(reinterpret_cast<uintptr_t>(context));
+        auto& p = pool();
+        {
+            std::lock_guard<std::mutex> lock(p.fMutex);
+            if(p.fPooledBytes + qint64(size) <= MAX_POOLED_BYTES) {
+                p.fFree[size].push_back(addr);
+                p.fPooledBytes += qint64(size);
+                return;
+            }
+        }
+        std::free(addr);
+    }
+
+    void* takeBuffer(const size_t size) {
+        auto& p = pool();
+        {
+            std::lock_guard<std::mutex> lock(p.fMutex);
+            const auto it = p.fFree.find(size);
+            if(it != p.fFree.end() && !it->second.empty()) {
+                void* const addr = it->second.back();
+                it->second.pop_back();
+                p.fPooledBytes -= qint64(size);
+                return addr;
+            }
+        }
+        return std::malloc(size);
+    }
+}
+
+bool PixelBufferPool::allocPixels(SkBitmap& bitmap, const SkImageInfo& info) {
+    const size_t rowBytes = info.minRowBytes();
+    const size_t bytes = info.computeByteSize(rowBytes);
+    if(SkImageInfo::ByteSizeOverflowed(bytes)) return false;
+    if(bytes < MIN_POOLED_BYTES) return bitmap.tryAllocPixels(info);
+    const size_t size = bucketSize(bytes);
+    void* const addr = takeBuffer(size);
+    if(!addr) return false;
+    const auto context = reinterpret_cast<void*>(static_cast<uintptr_t>(size));
+    return bitmap.installPixels(info, addr, rowBytes, releasePixels, context);
+}
+
+sk_sp<SkImage> PixelBufferPool::makeRasterCopy(const sk_sp<SkImage>& img) {
+    if(!img) return nullptr;
+    SkBitmap bitmap;
+    if(!allocPixels(bitmap, img->imageInfo())) return SkiaHelpers::makeCopy(img);
+    if(!img->readPixels(bitmap.pixmap(), 0, 0)) return SkiaHelpers::makeCopy(img);
+    return SkiaHelpers::transferDataToSkImage(bitmap);
+}
+
+qint64 PixelBufferPool::trim(const qint64 bytes) {
+    auto& p = pool();
+    std::vector<void*> toFree;
+    qint64 freed = 0;
+    {
+        std::lock_guard<std::mutex> lock(p.fMutex);
+        // largest buffers first, fewer frees for the same amount
+        for(auto it = p.fFree.rbegin(); it != p.fFree.rend() && freed < bytes; ++it) {
+            auto& buffers = it->second;
+            while(!buffers.empty() && freed < bytes) {
+                toFree.push_back(buffers.back());
+                buffers.pop_back();
+                freed += qint64(it->first);
+            }
+        }
+        p.fPooledBytes -= freed;
+    }
+    for(const auto addr : toFree) std::free(addr);
+    return freed;
+}
+
+qint64 PixelBufferPool::pooledBytes() {
+    auto& p = pool();
+    std::lock_guard<std::mutex> lock(p.fMutex);
+    return p.fPooledBytes;
+}
@@ -0,0 +1,52 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PIXELBUFFERPOOL_H
+#define PIXELBUFFERPOOL_H
+
+#include "core_global.h"
+#include "skiaincludes.h"
+
+// Recycles the raster buffers render tasks allocate every frame. Pixels
+// are handed out with a release proc, so a buffer goes back to its size
+// bucket once the last bitmap or image referencing it is destroyed.
+namespace PixelBufferPool {
+    //! @brief Same as SkBitmap::tryAllocPixels, the pixels are not cleared,
+    //! returns false if the size overflows or the allocation fails
+    CORE_EXPORT
+    bool allocPixels(SkBitmap& bitmap, const SkImageInfo& info);
+
+    //! @brief Raster copy of img in pooled pixels,
+    //! also reads back texture backed images
+    CORE_EXPORT
+    sk_sp<SkImage> makeRasterCopy(const sk_sp<SkImage>& img);
+
+    //! @brief Frees pooled buffers, returns the number of bytes freed
+    CORE_EXPORT
+    qint64 trim(const qint64 bytes);
+
+    CORE_EXPORT
+    qint64 pooledBytes();
+}
+
+#endif // PIXELBUFFERPOOL_H
@@ -0,0 +1,218 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "slicedswscontext.h"
+
+#include "exceptions.h"
+
+extern "C" {
+    #include <libavutil/imgutils.h>
+}
+
+#define MIN_SLICE_HEIGHT 64
+// luma rows converted past each band edge when the chroma planes are
+// resampled vertically, covers the taps of the bicubic chroma filter
+#define SLICE_OVERLAP 16
+
+static bool sSliceable(const AVPixFmtDescriptor * const desc) {
+    if(!desc) return false;
+    const auto unsliceable = AV_PIX_FMT_FLAG_PAL |
+                             AV_PIX_FMT_FLAG_BITSTREAM |
+                             AV_PIX_FMT_FLAG_HWACCEL;
+    return !(desc->flags & unsliceable);
+}
+
+static bool sIsChromaPlane(const int plane) {
+    return plane == 1 || plane == 2;
+}
+
+// row offset of plane 'plane' for a band starting at luma row 'y'
+static int sPlaneRow(const AVPixFmtDescriptor * const desc,
+                     const int plane, const int y) {
+    if(sIsChromaPlane(plane)) return y >> desc->log2_chroma_h;
+    return y;
+}
+
+// rows of plane 'plane' in a band of 'height' luma rows
+static int sPlaneRows(const AVPixFmtDescriptor * const desc,
+                      const int plane, const int height) {
+    if(sIsChromaPlane(plane)) return AV_CEIL_RSHIFT(height, desc->log2_chroma_h);
+    return height;
+}
+
+SlicedSwsContext::~SlicedSwsContext() {
+    clear();
+}
+
+void SlicedSwsContext::initialize(const int width, const int height,
+                                  const AVPixelFormat srcFormat,
+                                  const AVPixelFormat dstFormat,
+                                  const int flags, const int maxSlices) {
+    clear();
+    mDstFormat = dstFormat;
+    mWidth = width;
+    mSrcDesc = av_pix_fmt_desc_get(srcFormat);
+    mDstDesc = av_pix_fmt_desc_get(dstFormat);
+
+    int nSlices = 1;
+    int align = 1;
+    int overlap = 0;
+    if(sSliceable(mSrcDesc) && sSliceable(mDstDesc)) {
+        // bands have to start on a chroma row in both formats
+        align = 1 << qMax(mSrcDesc->log2_chroma_h, mDstDesc->log2_chroma_h);
+        nSlices = qBound(1, height/MIN_SLICE_HEIGHT, qMax(1, maxSlices));
+        // the luma rows map one to one, chroma is filtered across
+        // rows when the vertical subsampling differs
+        if(mSrcDesc->log2_chroma_h != mDstDesc->log2_chroma_h) {
+            overlap = (SLICE_OVERLAP + align - 1)/align*align;
+        }
+    }
+    const int sliceHeight = (height/nSlices + align - 1)/align*align;
+
+    int y = 0;
+    while(y < height) {
+        Slice slice{nullptr, y, qMin(sliceHeight, height - y), 0, 0,
+                    {nullptr, nullptr, nullptr, nullptr}, {0, 0, 0, 0}};
+        slice.fSrcY = qMax(0, y - overlap);
+        slice.fSrcHeight = qMin(height, y + slice.fHeight + overlap) -
+                           slice.fSrcY;
+        slice.fContext = sws_getContext(width, slice.fSrcHeight, srcFormat,
+                                        width, slice.fSrcHeight, dstFormat,
+                                        flags, nullptr, nullptr, nullptr);
+        if(!slice.fContext) {
+            clear();
+            RuntimeThrow("Cannot initialize the conversion context");
+        }
+        if(slice.fSrcHeight != slice.fHeight) {
+            const int ret = av_image_alloc(slice.fData, slice.fLinesize,
+                                           width, slice.fSrcHeight,
+                                           dstFormat, 32);
+            if(ret < 0) {
+                sws_freeContext(slice.fContext);
+                clear();
+                RuntimeThrow("Cannot allocate the conversion band");
+            }
+        }
+        mSlices.push_back(slice);
+        y += slice.fHeight;
+    }
+
+    mQuit = false;
+    mPending = 0;
+    mFrameId = 0;
+    for(uint i = 1; i < mSlices.size(); i++) {
+        mWorkers.emplace_back(&SlicedSwsContext::workerLoop, this, int(i));
+    }
+}
+
+void SlicedSwsContext::clear() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mFrameReady.notify_all();
+    for(auto& worker : mWorkers) worker.join();
+    mWorkers.clear();
+
+    for(auto& slice : mSlices) {
+        sws_freeContext(slice.fContext);
+        av_freep(&slice.fData[0]);
+    }
+    mSlices.clear();
+}
+
+void SlicedSwsContext::scale(const uint8_t * const src[], const int srcStride[],
+                             uint8_t * const dst[], const int dstStride[]) {
+    if(mSlices.empty()) return;
+    const Frame frame{src, srcStride, dst, dstStride};
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFrame = frame;
+        mPending = int(mSlices.size()) - 1;
+        mFrameId++;
+    }
+    mFrameReady.notify_all();
+    scaleSlice(mSlices.front(), frame);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSlicesDone.wait(lock, [this]() { return mPending == 0; });
+}
+
+void SlicedSwsContext::workerLoop(const int sliceId) {
+    const Slice& slice = mSlices[uint(sliceId)];
+    int frameId = 0;
+    while(true) {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mFrameReady.wait(lock, [this, frameId]() {
+                return mQuit || mFrameId != frameId;
+            });
+            if(mQuit) return;
+            frameId = mFrameId;
+            frame = mFrame;
+        }
+        scaleSlice(slice, frame);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPending--;
+        }
+        mSlicesDone.notify_one();
+    }
+}
+
+void SlicedSwsContext::scaleSlice(const Slice& slice,
+                                  const Frame& frame) const {
+    const bool direct = slice.fSrcHeight == slice.fHeight;
+    const uint8_t* srcSlice[4] = {nullptr, nullptr, nullptr, nullptr};
+    uint8_t* dstSlice[4] = {nullptr, nullptr, nullptr, nullptr};
+    for(int i = 0; i < 4; i++) {
+        if(frame.fSrc[i]) {
+            const int row = sPlaneRow(mSrcDesc, i, slice.fSrcY);
+            srcSlice[i] = frame.fSrc[i] + row*frame.fSrcStride[i];
+        }
+        if(direct && frame.fDst[i]) {
+            const int row = sPlaneRow(mDstDesc, i, slice.fY);
+            dstSlice[i] = frame.fDst[i] + row*frame.fDstStride[i];
+        }
+    }
+    if(direct) {
+        sws_scale(slice.fContext, srcSlice, frame.fSrcStride,
+                  0, slice.fHeight, dstSlice, frame.fDstStride);
+        return;
+    }
+    sws_scale(slice.fContext, srcSlice, frame.fSrcStride,
+              0, slice.fSrcHeight, slice.fData, slice.fLinesize);
+    // keep the band rows only, the overlap belongs to the neighbours
+    for(int i = 0; i < 4; i++) {
+        if(!slice.fData[i] || !frame.fDst[i]) continue;
+        const int bytes = av_image_get_linesize(mDstFormat, mWidth, i);
+        if(bytes <= 0) continue;
+        const int skip = sPlaneRow(mDstDesc, i, slice.fY - slice.fSrcY);
+        const int row = sPlaneRow(mDstDesc, i, slice.fY);
+        av_image_copy_plane(frame.fDst[i] + row*frame.fDstStride[i],
+                            frame.fDstStride[i],
+                            slice.fData[i] + skip*slice.fLinesize[i],
+                            slice.fLinesize[i], bytes,
+                            sPlaneRows(mDstDesc, i, slice.fHeight));
+    }
+}
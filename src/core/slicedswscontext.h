@@ -0,0 +1,104 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef SLICEDSWSCONTEXT_H
+#define SLICEDSWSCONTEXT_H
+
+#include "core_global.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+extern "C" {
+    #include <libswscale/swscale.h>
+    #include <libavutil/pixdesc.h>
+}
+
+// Pixel format conversion split into horizontal bands,
+// each band converted by its own SwsContext on its own thread.
+// Source and destination share the same dimensions.
+// The threads are created by initialize and stay alive until clear.
+class CORE_EXPORT SlicedSwsContext {
+public:
+    SlicedSwsContext() {}
+    ~SlicedSwsContext();
+
+    SlicedSwsContext(const SlicedSwsContext&) = delete;
+    SlicedSwsContext& operator=(const SlicedSwsContext&) = delete;
+
+    void initialize(const int width, const int height,
+                    const AVPixelFormat srcFormat,
+                    const AVPixelFormat dstFormat,
+                    const int flags, const int maxSlices);
+    void clear();
+
+    bool isInitialized() const { return !mSlices.empty(); }
+    int sliceCount() const { return static_cast<int>(mSlices.size()); }
+
+    // src and dst hold four planes each, as in AVFrame::data
+    void scale(const uint8_t * const src[], const int srcStride[],
+               uint8_t * const dst[], const int dstStride[]);
+private:
+    struct Slice {
+        SwsContext* fContext;
+        // rows written to the destination
+        int fY;
+        int fHeight;
+        // rows converted, extended past fY and fHeight when the
+        // conversion filters vertically, so band edges do not show
+        int fSrcY;
+        int fSrcHeight;
+        // band sized destination when fSrcHeight != fHeight
+        uint8_t* fData[4];
+        int fLinesize[4];
+    };
+
+    struct Frame {
+        const uint8_t * const * fSrc;
+        const int* fSrcStride;
+        uint8_t * const * fDst;
+        const int* fDstStride;
+    };
+
+    void scaleSlice(const Slice& slice, const Frame& frame) const;
+    void workerLoop(const int sliceId);
+
+    AVPixelFormat mDstFormat = AV_PIX_FMT_NONE;
+    int mWidth = 0;
+    const AVPixFmtDescriptor* mSrcDesc = nullptr;
+    const AVPixFmtDescriptor* mDstDesc = nullptr;
+    std::vector<Slice> mSlices;
+
+    std::vector<std::thread> mWorkers;
+    std::mutex mMutex;
+    std::condition_variable mFrameReady;
+    std::condition_variable mSlicesDone;
+    Frame mFrame;
+    int mFrameId = 0;
+    int mPending = 0;
+    bool mQuit = false;
+};
+
+#endif // SLICEDSWSCONTEXT_H
@@ -0,0 +1,303 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "svgdataparser.h"
+
+#include <cstring>
+
+// mantissas with more digits go through QByteArray::toDouble
+#define MAX_FAST_DIGITS 19
+
+namespace {
+    const double sPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    bool isDigit(const char c) {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    bool isSpace(const char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    // eight ascii digits are handled at once in a 64 bit word,
+    // the first digit is in the lowest byte
+    bool eightDigits(const char* const str, quint64& chunk) {
+        memcpy(&chunk, str, sizeof(chunk));
+        return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+                (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+               0x3333333333333333;
+    }
+
+    quint64 eightDigitsValue(quint64 chunk) {
+        const quint64 mask = 0x000000FF000000FF;
+        const quint64 mul1 = 0x000F424000000064; // 100 + (1000000 << 32)
+        const quint64 mul2 = 0x0000271000000001; // 1 + (10000 << 32)
+        chunk -= 0x3030303030303030;
+        chunk = (chunk*10) + (chunk >> 8);
+        chunk = (((chunk & mask)*mul1) + (((chunk >> 16) & mask)*mul2)) >> 32;
+        return chunk & 0xFFFFFFFF;
+    }
+#endif
+
+    const char* parseDigits(const char* str, const char* const end,
+                            quint64& mantissa, int& nDigits) {
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        quint64 chunk;
+        while(end - str >= 8 && eightDigits(str, chunk)) {
+            mantissa = mantissa*100000000 + eightDigitsValue(chunk);
+            nDigits += 8;
+            str += 8;
+        }
+#endif
+        while(str != end && isDigit(*str)) {
+            mantissa = mantissa*10 + static_cast<quint64>(*str - '0');
+            nDigits++;
+            str++;
+        }
+        return str;
+    }
+
+    const char* skipSpaces(const char* str, const char* const end) {
+        while(str != end && isSpace(*str)) str++;
+        return str;
+    }
+
+    // spaces with at most one comma
+    const char* skipSeparator(const char* str, const char* const end) {
+        str = skipSpaces(str, end);
+        if(str != end && *str == ',') str = skipSpaces(str + 1, end);
+        return str;
+    }
+
+    bool readNumber(const char*& str, const char* const end, SkScalar& value) {
+        double val;
+        const char* const next = SvgDataParser::parseNumber(str, end, val);
+        if(next == str) return false;
+        value = static_cast<SkScalar>(val);
+        str = skipSeparator(next, end);
+        return true;
+    }
+
+    bool readNumbers(const char*& str, const char* const end,
+                     SkScalar* const values, const int count) {
+        for(int i = 0; i < count; i++) {
+            if(!readNumber(str, end, values[i])) return false;
+        }
+        return true;
+    }
+
+    // arc flags do not need separators, "a1 1 0 00 1 1" is valid
+    bool readFlag(const char*& str, const char* const end, bool& value) {
+        if(str == end || (*str != '0' && *str != '1')) return false;
+        value = *str == '1';
+        str = skipSeparator(str + 1, end);
+        return true;
+    }
+
+    bool isCommand(const char c) {
+        switch(c) {
+        case 'M': case 'm': case 'Z': case 'z':
+        case 'L': case 'l': case 'H': case 'h': case 'V': case 'v':
+        case 'C': case 'c': case 'S': case 's':
+        case 'Q': case 'q': case 'T': case 't':
+        case 'A': case 'a':
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+const char* SvgDataParser::parseNumber(const char* const str,
+                                       const char* const end,
+                                       double& value) {
+    const char* pos = str;
+    bool neg = false;
+    if(pos != end && (*pos == '-' || *pos == '+')) {
+        neg = *pos == '-';
+        pos++;
+    }
+    quint64 mantissa = 0;
+    int nDigits = 0;
+    pos = parseDigits(pos, end, mantissa, nDigits);
+    int exp10 = 0;
+    if(pos != end && *pos == '.') {
+        const int nIntDigits = nDigits;
+        pos = parseDigits(pos + 1, end, mantissa, nDigits);
+        exp10 = nIntDigits - nDigits;
+    }
+    if(nDigits == 0) return str;
+    if(pos != end && (*pos == 'e' || *pos == 'E')) {
+        const char* expPos = pos + 1;
+        bool expNeg = false;
+        if(expPos != end && (*expPos == '-' || *expPos == '+')) {
+            expNeg = *expPos == '-';
+            expPos++;
+        }
+        if(expPos != end && isDigit(*expPos)) {
+            int exp = 0;
+            while(expPos != end && isDigit(*expPos)) {
+                if(exp < 10000) exp = exp*10 + (*expPos - '0');
+                expPos++;
+            }
+            exp10 += expNeg ? -exp : exp;
+            pos = expPos;
+        }
+    }
+    const bool exact = nDigits <= MAX_FAST_DIGITS &&
+                       mantissa <= (quint64(1) << 53) &&
+                       exp10 >= -22 && exp10 <= 22;
+    if(exact) {
+        const double m = static_cast<double>(mantissa);
+        value = exp10 < 0 ? m/sPow10[-exp10] : m*sPow10[exp10];
+        if(neg) value = -value;
+    } else {
+        const int len = static_cast<int>(pos - str);
+        value = QByteArray::fromRawData(str, len).toDouble();
+    }
+    return pos;
+}
+
+double SvgDataParser::toDouble(const QByteArray& str, bool* ok) {
+    const char* const begin = str.constData();
+    const char* const end = begin + str.size();
+    double value = 0;
+    const char* const pos = parseNumber(begin, end, value);
+    if(ok) *ok = pos != begin && pos == end;
+    return value;
+}
+
+bool SvgDataParser::parsePath(const char* str, const char* const end,
+                              SkPath& path) {
+    SkPoint current{0, 0};
+    SkPoint start{0, 0};
+    SkPoint lastCtrl{0, 0};
+    char cmd = 0;
+    char prevCmd = 0;
+    str = skipSpaces(str, end);
+    while(str != end) {
+        if(isCommand(*str)) {
+            cmd = *str;
+            str = skipSpaces(str + 1, end);
+        } else if(!cmd) return false;
+        const bool rel = cmd >= 'a';
+        const SkPoint offset = rel ? current : SkPoint{0, 0};
+        SkScalar v[7];
+        switch(cmd) {
+        case 'Z': case 'z':
+            path.close();
+            current = start;
+            // numbers are not allowed to follow
+            cmd = 0;
+            break;
+        case 'M': case 'm':
+            if(!readNumbers(str, end, v, 2)) return false;
+            current = {v[0] + offset.fX, v[1] + offset.fY};
+            start = current;
+            path.moveTo(current);
+            // following pairs are implicit line commands
+            cmd = rel ? 'l' : 'L';
+            break;
+        case 'L': case 'l':
+            if(!readNumbers(str, end, v, 2)) return false;
+            current = {v[0] + offset.fX, v[1] + offset.fY};
+            path.lineTo(current);
+            break;
+        case 'H': case 'h':
+            if(!readNumbers(str, end, v, 1)) return false;
+            current.fX = v[0] + offset.fX;
+            path.lineTo(current);
+            break;
+        case 'V': case 'v':
+            if(!readNumbers(str, end, v, 1)) return false;
+            current.fY = v[0] + offset.fY;
+            path.lineTo(current);
+            break;
+        case 'C': case 'c': {
+            if(!readNumbers(str, end, v, 6)) return false;
+            const SkPoint c1{v[0] + offset.fX, v[1] + offset.fY};
+            lastCtrl = {v[2] + offset.fX, v[3] + offset.fY};
+            current = {v[4] + offset.fX, v[5] + offset.fY};
+            path.cubicTo(c1, lastCtrl, current);
+        } break;
+        case 'S': case 's': {
+            if(!readNumbers(str, end, v, 4)) return false;
+            const bool smooth = prevCmd == 'C' || prevCmd == 'S';
+            const SkPoint c1 = smooth ? current + (current - lastCtrl) : current;
+            lastCtrl = {v[0] + offset.fX, v[1] + offset.fY};
+            current = {v[2] + offset.fX, v[3] + offset.fY};
+            path.cubicTo(c1, lastCtrl, current);
+        } break;
+        case 'Q': case 'q':
+            if(!readNumbers(str, end, v, 4)) return false;
+            lastCtrl = {v[0] + offset.fX, v[1] + offset.fY};
+            current = {v[2] + offset.fX, v[3] + offset.fY};
+            path.quadTo(lastCtrl, current);
+            break;
+        case 'T': case 't': {
+            if(!readNumbers(str, end, v, 2)) return false;
+            const bool smooth = prevCmd == 'Q' || prevCmd == 'T';
+            lastCtrl = smooth ? current + (current - lastCtrl) : current;
+            current = {v[0] + offset.fX, v[1] + offset.fY};
+            path.quadTo(lastCtrl, current);
+        } break;
+        case 'A': case 'a': {
+            bool largeArc;
+            bool sweep;
+            if(!readNumbers(str, end, v, 3) ||
+               !readFlag(str, end, largeArc) ||
+               !readFlag(str, end, sweep) ||
+               !readNumbers(str, end, v + 3, 2)) return false;
+            current = {v[3] + offset.fX, v[4] + offset.fY};
+            path.arcTo(v[0], v[1], v[2],
+                       largeArc ? SkPath::kLarge_ArcSize : SkPath::kSmall_ArcSize,
+                       sweep ? SkPathDirection::kCW : SkPathDirection::kCCW,
+                       current.fX, current.fY);
+        } break;
+        default:
+            return false;
+        }
+        if(cmd) prevCmd = cmd >= 'a' ? static_cast<char>(cmd - 'a' + 'A') : cmd;
+        else prevCmd = 'Z';
+    }
+    return true;
+}
+
+bool SvgDataParser::parsePoints(const char* str, const char* const end,
+                                SkPath& path, const bool isPolygon) {
+    str = skipSpaces(str, end);
+    bool first = true;
+    SkScalar v[2];
+    while(str != end) {
+        if(!readNumbers(str, end, v, 2)) break;
+        if(first) path.moveTo(v[0], v[1]);
+        else path.lineTo(v[0], v[1]);
+        first = false;
+    }
+    if(isPolygon && !first) path.close();
+    return str == end;
+}
@@ -0,0 +1,55 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef SVGDATAPARSER_H
+#define SVGDATAPARSER_H
+
+#include "core_global.h"
+#include "skia/skiaincludes.h"
+
+#include <QByteArray>
+
+// Parsers for the numeric attribute data of svg elements, they work on
+// latin1 text and are safe to use from any thread.
+namespace SvgDataParser {
+    //! @brief Returns the position after the number, or str if there
+    //! is no number at str
+    CORE_EXPORT
+    const char* parseNumber(const char* str, const char* end, double& value);
+
+    //! @brief Same as parseNumber, ok is false unless the whole str is a number
+    CORE_EXPORT
+    double toDouble(const QByteArray& str, bool* ok = nullptr);
+
+    //! @brief Path data of the 'd' attribute, returns false on error,
+    //! the path then holds the data up to the error
+    CORE_EXPORT
+    bool parsePath(const char* str, const char* end, SkPath& path);
+
+    //! @brief Point list of the 'points' attribute
+    CORE_EXPORT
+    bool parsePoints(const char* str, const char* end,
+                     SkPath& path, const bool isPolygon);
+}
+
+#endif // SVGDATAPARSER_H
@@ -24,6 +24,10 @@
 
 #include "appsupport.h"
 
+// input bytes base64 encoded at a time, a multiple of 3 so that
+// only the last chunk is padded
+#define BASE64_CHUNK (3*16384)
+
 SvgExporter::SvgExporter(const QString& path,
                          Canvas* const scene,
                          const FrameRange& frameRange,
@@ -45,6 +49,8 @@ SvgExporter::SvgExporter(const QString& path,
     , fImageQuality(imageQuality)
     , mHtml(html)
     , mOpen(false)
+    , mSvgOpen(false)
+    , mDefsOpen(false)
     , mFile(path)
     , mSvg(createElement("svg"))
     , mDefs(createElement("defs"))
@@ -72,6 +78,7 @@ void SvgExporter::nextStep()
             mStream << QString::fromUtf8("<!-- Created with %1 - %2 -->").arg(AppSupport::getAppDisplayName(),
                                                                               AppSupport::getAppUrl()) << Qt::endl << Qt::endl;
             fScene->saveSceneSVG(*this);
+            openSvg();
         } else {
             RuntimeThrow("Could not open:\n\"" + mFile.fileName() + "\"");
         }
@@ -87,12 +94,99 @@ void SvgExporter::addNextTask(const stdsptr<eTask>& task)
     mWaitingTasks << task;
 }
 
+void SvgExporter::addToDefs(const QDomElement& def)
+{
+    if (!mSvgOpen) {
+        mDefs.appendChild(def);
+        return;
+    }
+    openDefs();
+    def.save(mStream, 1);
+}
+
+void SvgExporter::addToDefs(QDomElement& def,
+                            const QString& attribute,
+                            const QByteArray& dataPrefix,
+                            const sk_sp<SkData>& data)
+{
+    const auto bytes = static_cast<const char*>(data->data());
+    const int size = static_cast<int>(data->size());
+    if (!mSvgOpen) {
+        const auto base64 = QByteArray::fromRawData(bytes, size).toBase64();
+        def.setAttribute(attribute, QString::fromLatin1(dataPrefix + base64));
+        return addToDefs(def);
+    }
+    openDefs();
+    mStream << '<' << def.tagName();
+    writeAttributes(def);
+    mStream << ' ' << attribute << "=\"" << dataPrefix;
+    for (int i = 0; i < size; i += BASE64_CHUNK) {
+        const int chunk = qMin(BASE64_CHUNK, size - i);
+        mStream << QByteArray::fromRawData(bytes + i, chunk).toBase64();
+    }
+    mStream << "\"/>" << Qt::endl;
+}
+
+void SvgExporter::flush()
+{
+    if (!mSvgOpen) { return; }
+    auto child = mSvg.firstChild();
+    if (child.isNull()) { return; }
+    closeDefs();
+    while (!child.isNull()) {
+        child.save(mStream, 1);
+        mSvg.removeChild(child);
+        child = mSvg.firstChild();
+    }
+}
+
+void SvgExporter::openSvg()
+{
+    mStream << "<svg";
+    writeAttributes(mSvg);
+    mStream << '>' << Qt::endl;
+    mSvgOpen = true;
+
+    // written before the elements, they were added by the scene
+    auto def = mDefs.firstChild();
+    while (!def.isNull()) {
+        mDefs.removeChild(def);
+        addToDefs(def.toElement());
+        def = mDefs.firstChild();
+    }
+    flush();
+}
+
+void SvgExporter::openDefs()
+{
+    if (mDefsOpen) { return; }
+    mStream << "<defs>" << Qt::endl;
+    mDefsOpen = true;
+}
+
+void SvgExporter::closeDefs()
+{
+    if (!mDefsOpen) { return; }
+    mStream << "</defs>" << Qt::endl;
+    mDefsOpen = false;
+}
+
+void SvgExporter::writeAttributes(const QDomElement& ele)
+{
+    const auto attributes = ele.attributes();
+    for (int i = 0; i < attributes.count(); i++) {
+        const auto attr = attributes.item(i).toAttr();
+        mStream << ' ' << attr.name() << "=\""
+                << attr.value().toHtmlEscaped() << '"';
+    }
+}
+
 void SvgExporter::finish()
 {
     if (mOpen) {
-        mSvg.appendChild(mDefs);
-        mDoc.appendChild(mSvg);
-        mStream << mDoc.toString();
+        flush();
+        closeDefs();
+        mStream << "</svg>" << Qt::endl;
         if (mHtml) {
             mStream << QString::fromUtf8("</body>") << Qt::endl;
             mStream << QString::fromUtf8("</html>") << Qt::endl;
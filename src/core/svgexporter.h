@@ -66,20 +66,32 @@ public:
         return mDoc.createTextNode(text);
     }
 
-    void addToDefs(const QDomElement& def)
-    {
-        mDefs.appendChild(def);
-    }
+    void addToDefs(const QDomElement& def);
+    //! @brief Same as addToDefs, data is written base64 encoded as the value
+    //! of attribute, without being copied into the document
+    void addToDefs(QDomElement& def,
+                   const QString& attribute,
+                   const QByteArray& dataPrefix,
+                   const sk_sp<SkData>& data);
 
     QDomElement& svg()
     {
         return mSvg;
     }
 
+    //! @brief Writes the elements appended to svg() and removes them
+    void flush();
+
 private:
     void finish();
+    void openSvg();
+    void openDefs();
+    void closeDefs();
+    void writeAttributes(const QDomElement& ele);
     bool mHtml;
     bool mOpen;
+    bool mSvgOpen;
+    bool mDefsOpen;
     QFile mFile;
     QTextStream mStream;
     QDomDocument mDoc;
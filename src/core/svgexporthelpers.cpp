@@ -37,9 +37,10 @@ void SvgExportHelpers::assignLoop(QDomElement& ele, const bool loop) {
     else ele.setAttribute("fill", "freeze");
 }
 
-sk_sp<SkData> asDataUri(SkImage* image,
-                        SkEncodedImageFormat format = SkEncodedImageFormat::kPNG,
-                        int quality = 100)
+sk_sp<SkData> encodeImage(SkImage* image,
+                          QByteArray& dataPrefix,
+                          SkEncodedImageFormat format = SkEncodedImageFormat::kPNG,
+                          int quality = 100)
 {
     switch (format) {
     case SkEncodedImageFormat::kBMP:
@@ -56,39 +57,18 @@ sk_sp<SkData> asDataUri(SkImage* image,
     default:;
     }
 
-    sk_sp<SkData> imageData = image->encodeToData(format, quality);
-    if (!imageData) {
-        return nullptr;
-    }
-
-    const char* selectedPrefix = nullptr;
-    size_t selectedPrefixLength = 0;
-
-    const static char pngDataPrefix[] = "data:image/png;base64,";
-    const static char jpgDataPrefix[] = "data:image/jpeg;base64,";
-    const static char webpDataPrefix[] = "data:image/webp;base64,";
-
     switch (format) {
     case SkEncodedImageFormat::kJPEG:
-        selectedPrefix = jpgDataPrefix;
-        selectedPrefixLength = sizeof(jpgDataPrefix);
+        dataPrefix = "data:image/jpeg;base64,";
         break;
     case SkEncodedImageFormat::kWEBP:
-        selectedPrefix = webpDataPrefix;
-        selectedPrefixLength = sizeof(webpDataPrefix);
+        dataPrefix = "data:image/webp;base64,";
         break;
     default:
-        selectedPrefix = pngDataPrefix;
-        selectedPrefixLength = sizeof(pngDataPrefix);
+        dataPrefix = "data:image/png;base64,";
     }
 
-    size_t b64Size = SkBase64::Encode(imageData->data(), imageData->size(), nullptr);
-    sk_sp<SkData> dataUri = SkData::MakeUninitialized(selectedPrefixLength + b64Size);
-    char* dest = (char*)dataUri->writable_data();
-    memcpy(dest, selectedPrefix, selectedPrefixLength);
-    SkBase64::Encode(imageData->data(), imageData->size(), dest + selectedPrefixLength - 1);
-    dest[dataUri->size() - 1] = 0;
-    return dataUri;
+    return image->encodeToData(format, quality);
 }
 
 void SvgExportHelpers::defImage(SvgExporter& exp,
@@ -96,17 +76,18 @@ void SvgExportHelpers::defImage(SvgExporter& exp,
                                 const QString id)
 {
     if (!image) { return; }
+    QByteArray dataPrefix;
+    const auto imageData = encodeImage(image.get(), dataPrefix,
+                                       exp.fImageFormat,
+                                       exp.fImageQuality);
+    if (!imageData) { return; }
     auto def = exp.createElement("image");
     def.setAttribute("id", id);
     def.setAttribute("x", 0);
     def.setAttribute("y", 0);
     def.setAttribute("width", image->width());
     def.setAttribute("height", image->height());
-    const auto dataUri = asDataUri(image.get(),
-                                   exp.fImageFormat,
-                                   exp.fImageQuality);
-    def.setAttribute("xlink:href", static_cast<const char*>(dataUri->data()));
-    exp.addToDefs(def);
+    exp.addToDefs(def, "xlink:href", dataPrefix, imageData);
 }
 
 void SvgExportHelpers::assignVisibility(SvgExporter& exp,
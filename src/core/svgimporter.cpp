@@ -26,8 +26,14 @@
 #include "svgimporter.h"
 
 #include <QtXml/QDomDocument>
+#include <QXmlStreamReader>
 #include <QRegularExpression>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include "Boxes/containerbox.h"
 #include "colorhelpers.h"
 #include "pointhelpers.h"
@@ -44,9 +50,30 @@
 #include "matrixdecomposition.h"
 #include "transformvalues.h"
 #include "regexhelpers.h"
+#include "svgdataparser.h"
+#include "Private/esettings.h"
 
 #define RGXS REGEX_SPACES
 
+// tag name and attributes of the current start element of the stream
+class SvgElement {
+public:
+    SvgElement(const QXmlStreamReader& reader) :
+        mTagName(reader.qualifiedName().toString()),
+        mAttributes(reader.attributes()) {}
+
+    const QString& tagName() const { return mTagName; }
+
+    QString attribute(const QString& name,
+                      const QString& defValue = QString()) const {
+        if(!mAttributes.hasAttribute(name)) return defValue;
+        return mAttributes.value(name).toString();
+    }
+private:
+    const QString mTagName;
+    const QXmlStreamAttributes mAttributes;
+};
+
 class TextSvgAttributes {
 public:
     TextSvgAttributes() {}
@@ -155,7 +182,7 @@ public:
     const StrokeSvgAttributes &getStrokeAttributes() const;
     const TextSvgAttributes &getTextAttributes() const;
 
-    void loadBoundingBoxAttributes(const QDomElement &element);
+    void loadBoundingBoxAttributes(const SvgElement &element);
 
     bool hasTransform() const;
 
@@ -269,221 +296,186 @@ bool toColor(const QString &colorStr, QColor &color)
     return true;
 }
 
-// '0' is 0x30 and '9' is 0x39
-static bool isDigit(ushort ch) {
-    static quint16 magic = 0x3ff;
-    return ((ch >> 4) == 3) && (magic >> (ch & 15));
+static qreal toDouble(const QString &str, bool *ok = nullptr) {
+    return SvgDataParser::toDouble(str.toLatin1(), ok);
 }
 
-static qreal toDouble(const QChar *&str) {
-    const int maxLen = 255;//technically doubles can go til 308+ but whatever
-    char temp[maxLen+1];
-    int pos = 0;
+// Parses the path data on worker threads while the stream is read,
+// finish() then loads the parsed paths on the calling thread
+class SvgPathParser {
+public:
+    enum class DataType { path, polyline, polygon };
 
-    if(*str == QLatin1Char('-')) {
-        temp[pos++] = '-';
-        ++str;
-    } else if(*str == QLatin1Char('+')) {
-        ++str;
-    }
-    while(isDigit(str->unicode()) && pos < maxLen) {
-        temp[pos++] = str->toLatin1();
-        ++str;
-    }
-    if(*str == QLatin1Char('.') && pos < maxLen) {
-        temp[pos++] = '.';
-        ++str;
-    }
-    while(isDigit(str->unicode()) && pos < maxLen) {
-        temp[pos++] = str->toLatin1();
-        ++str;
-    }
-    bool exponent = false;
-    if((*str == QLatin1Char('e') || *str == QLatin1Char('E')) && pos < maxLen) {
-        exponent = true;
-        temp[pos++] = 'e';
-        ++str;
-        if((*str == QLatin1Char('-') || *str == QLatin1Char('+')) && pos < maxLen) {
-            temp[pos++] = str->toLatin1();
-            ++str;
-        }
-        while(isDigit(str->unicode()) && pos < maxLen) {
-            temp[pos++] = str->toLatin1();
-            ++str;
-        }
-    }
+    ~SvgPathParser() { stop(true); }
 
-    temp[pos] = '\0';
+    void add(const qsptr<SmartVectorPath>& box, const QString& data,
+             const DataType type, const SkPathFillType fillRule);
 
-    qreal val;
-    if(!exponent && pos < 10) {
-        int ival = 0;
-        const char *t = temp;
-        bool neg = false;
-        if(*t == '-') {
-            neg = true;
-            ++t;
-        }
-        while(*t && *t != '.') {
-            ival *= 10;
-            ival += (*t) - '0';
-            ++t;
-        }
-        if(*t == '.') {
-            ++t;
-            int div = 1;
-            while(*t) {
-                ival *= 10;
-                ival += (*t) - '0';
-                div *= 10;
-                ++t;
-            }
-            val = static_cast<qreal>(ival)/div;
-        } else {
-            val = ival;
+    //! @brief Paths that turned out empty are removed with their
+    //! groups left empty
+    void finish();
+private:
+    struct Job {
+        qsptr<SmartVectorPath> fBox;
+        QString fData;
+        DataType fType;
+        SkPathFillType fFillRule;
+        SkPath fPath;
+    };
+
+    void run();
+    void stop(const bool discard);
+    static void parse(Job& job);
+    static void removeEmpty(BoundingBox* const box);
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    // references stay valid when jobs are added
+    std::deque<Job> mJobs;
+    size_t mNext = 0;
+    bool mStop = false;
+    std::vector<std::thread> mThreads;
+};
+
+void SvgPathParser::add(const qsptr<SmartVectorPath>& box,
+                        const QString& data, const DataType type,
+                        const SkPathFillType fillRule) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back({box, data, type, fillRule, SkPath()});
+    }
+    if(mThreads.empty()) {
+        const int count = qMax(1, eSettings::sCpuThreadsCapped());
+        for(int i = 0; i < count; i++) {
+            mThreads.emplace_back(&SvgPathParser::run, this);
         }
-        if(neg) val = -val;
-    } else {
-        val = QByteArray::fromRawData(temp, pos).toDouble();
+    } else mCond.notify_one();
+}
+
+void SvgPathParser::run() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while(true) {
+        mCond.wait(lock, [this]() {
+            return mStop || mNext < mJobs.size();
+        });
+        if(mNext >= mJobs.size()) return;
+        Job& job = mJobs[mNext++];
+        lock.unlock();
+        parse(job);
+        lock.lock();
     }
-    return val;
 }
 
-static qreal toDouble(const QString &str, bool *ok = nullptr) {
-    const QChar *c = str.constData();
-    const qreal res = toDouble(c);
-    if(ok) *ok = (*c == QLatin1Char('\0'));
-    return res;
-}
-
-//static qreal toDouble(const QStringRef &str, bool *ok = nullptr) {
-//    const QChar *c = str.constData();
-//    qreal res = toDouble(c);
-//    if(ok) {
-//        *ok = (c == (str.constData() + str.length()));
-//    }
-//    return res;
-//}
-
-static void parseNumbersArray(const QChar *&str,
-                              QVarLengthArray<float, 8> &points) {
-    while(str->isSpace()) str++;
-    while(isDigit(str->unicode()) ||
-          *str == QLatin1Char('-') || *str == QLatin1Char('+') ||
-          *str == QLatin1Char('.')) {
-
-        points.append(toSkScalar(toDouble(str)));
-
-        while(str->isSpace()) str++;
-        if(*str == QLatin1Char(',')) str++;
-
-        //eat the rest of space
-        while(str->isSpace()) str++;
+void SvgPathParser::stop(const bool discard) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(discard) mNext = mJobs.size();
+        mStop = true;
     }
+    mCond.notify_all();
+    for(auto& thread : mThreads) thread.join();
+    mThreads.clear();
 }
 
-bool parsePolylineData(const QString &dataStr,
-                       VectorPathSvgAttributes &attributes,
-                       const bool isPolygon) {
-    float x0 = 0, y0 = 0;              // starting point
-    float x = 0, y = 0;                // current point
-    const QChar *str = dataStr.constData();
-    const QChar *end = str + dataStr.size();
+void SvgPathParser::parse(Job& job) {
+    const QByteArray data = job.fData.toLatin1();
+    job.fData.clear();
+    const char* const begin = data.constData();
+    const char* const end = begin + data.size();
+    switch(job.fType) {
+    case DataType::path:
+        SvgDataParser::parsePath(begin, end, job.fPath);
+        break;
+    case DataType::polyline:
+        SvgDataParser::parsePoints(begin, end, job.fPath, false);
+        break;
+    case DataType::polygon:
+        SvgDataParser::parsePoints(begin, end, job.fPath, true);
+        break;
+    }
+}
 
-    SkPath& path = attributes.path();
-    while (str != end) {
-        while(str->isSpace()) ++str;
-        QChar endc = *end;
-        *const_cast<QChar *>(end) = 0; // parseNumbersArray requires 0-termination that QStringRef cannot guarantee
-        QVarLengthArray<float, 8> arg;
-        parseNumbersArray(str, arg);
-        *const_cast<QChar *>(end) = endc;
-        const float *num = arg.constData();
-        int count = arg.count();
-        bool first = true;
-        while(count > 0) {
-            x = num[0];
-            y = num[1];
-            num++;
-            num++;
-            count -= 2;
-            if(count < 0) {
-                if(qAbs(x - x0) < 0.001f &&
-                   qAbs(y - y0) < 0.001f) {
-                    path.close();
-                    return true;
-                }
-            }
-            if(first) {
-                x0 = x;
-                y0 = y;
-                path.moveTo({x0, y0});
-                first = false;
-            } else {
-                path.lineTo({x, y});
-            }
+void SvgPathParser::finish() {
+    stop(false);
+    for(auto& job : mJobs) {
+        if(job.fPath.isEmpty()) {
+            removeEmpty(job.fBox.get());
+            continue;
         }
-        if(isPolygon) path.close();
+        const auto pathAnimator = job.fBox->getPathAnimator();
+        pathAnimator->loadSkPath(job.fPath);
+        pathAnimator->setFillType(job.fFillRule);
     }
-    return true;
+    mJobs.clear();
 }
 
-void loadElement(const QDomElement &element, ContainerBox *parentGroup,
+void SvgPathParser::removeEmpty(BoundingBox* const box) {
+    auto parent = box->getParentGroup();
+    box->removeFromParent_k();
+    while(parent && parent->getContainedBoxesCount() == 0) {
+        const auto grandParent = parent->getParentGroup();
+        if(!grandParent) break;
+        parent->removeFromParent_k();
+        parent = grandParent;
+    }
+}
+
+void loadElement(QXmlStreamReader &reader, ContainerBox *parentGroup,
                  const BoxSvgAttributes &parentGroupAttributes,
-                 const GradientCreator& gradientCreator);
+                 const GradientCreator& gradientCreator,
+                 SvgPathParser& pathParser);
 
-qsptr<ContainerBox> loadBoxesGroup(const QDomElement &groupElement,
+//! @brief Returns nullptr if the contained boxes were moved to parentGroup
+qsptr<ContainerBox> loadBoxesGroup(QXmlStreamReader &reader,
                                    ContainerBox *parentGroup,
                                    const BoxSvgAttributes &attributes,
-                                   const GradientCreator& gradientCreator) {
-    const QDomNodeList allRootChildNodes = groupElement.childNodes();
-    qsptr<ContainerBox> boxesGroup;
-    const bool hasTransform = attributes.hasTransform();
-    if(allRootChildNodes.count() > 1 || hasTransform || !parentGroup) {
-        boxesGroup = enve::make_shared<ContainerBox>(eBoxType::group);
-        boxesGroup->planCenterPivotPosition();
-        attributes.apply(boxesGroup.get());
-        if(parentGroup) parentGroup->addContained(boxesGroup);
-    } else {
-        boxesGroup = parentGroup->ref<ContainerBox>();
+                                   const GradientCreator& gradientCreator,
+                                   SvgPathParser& pathParser) {
+    const auto boxesGroup = enve::make_shared<ContainerBox>(eBoxType::group);
+    boxesGroup->planCenterPivotPosition();
+    attributes.apply(boxesGroup.get());
+    if(parentGroup) parentGroup->addContained(boxesGroup);
+
+    // counted the way QDomNode::childNodes() would count them
+    int nChildNodes = 0;
+    while(reader.readNext() != QXmlStreamReader::EndElement && !reader.atEnd()) {
+        if(reader.isStartElement()) {
+            nChildNodes++;
+            loadElement(reader, boxesGroup.get(), attributes,
+                        gradientCreator, pathParser);
+        } else if(reader.isComment() ||
+                  (reader.isCharacters() && !reader.isWhitespace())) {
+            nChildNodes++;
+        }
     }
 
-    for(int i = 0; i < allRootChildNodes.count(); i++) {
-        const QDomNode iNode = allRootChildNodes.at(i);
-        if(iNode.isElement()) {
-            loadElement(iNode.toElement(), boxesGroup.get(),
-                        attributes, gradientCreator);
-        }
+    if(nChildNodes > 1 || attributes.hasTransform() || !parentGroup) {
+        return boxesGroup;
     }
-    return boxesGroup;
+    const int id = parentGroup->getContainedIndex(boxesGroup.get());
+    boxesGroup->removeFromParent_k();
+    if(boxesGroup->getContainedBoxesCount() == 1) {
+        parentGroup->insertContained(id, boxesGroup->takeContained_k(0));
+    }
+    return nullptr;
 }
 
-void loadVectorPath(const QDomElement &pathElement,
+void loadVectorPath(const SvgElement &pathElement,
                     ContainerBox *parentGroup,
-                    VectorPathSvgAttributes& attributes) {
-    const QString pathStr = pathElement.attribute("d");
-    SkParsePath::FromSVGString(pathStr.toStdString().data(), &attributes.path());
-    if(attributes.isEmpty()) return;
+                    const VectorPathSvgAttributes& attributes,
+                    SvgPathParser& pathParser,
+                    const SvgPathParser::DataType type) {
+    const QString pathStr = pathElement.attribute(
+                type == SvgPathParser::DataType::path ? "d" : "points");
+    if(pathStr.isEmpty()) return;
     const auto vectorPath = enve::make_shared<SmartVectorPath>();
     vectorPath->planCenterPivotPosition();
-    attributes.apply(vectorPath.get());
+    attributes.BoxSvgAttributes::apply(vectorPath.get());
     parentGroup->addContained(vectorPath);
+    pathParser.add(vectorPath, pathStr, type, attributes.getFillRule());
 }
 
-void loadPolyline(const QDomElement &pathElement,
-                  ContainerBox *parentGroup,
-                  VectorPathSvgAttributes &attributes,
-                  const bool isPolygon) {
-    const QString pathStr = pathElement.attribute("points");
-    parsePolylineData(pathStr, attributes, isPolygon);
-    if(attributes.isEmpty()) return;
-    const auto vectorPath = enve::make_shared<SmartVectorPath>();
-    vectorPath->planCenterPivotPosition();
-    attributes.apply(vectorPath.get());
-    parentGroup->addContained(vectorPath);
-}
-
-void loadCircle(const QDomElement &pathElement,
+void loadCircle(const SvgElement &pathElement,
                 ContainerBox *parentGroup,
                 const BoxSvgAttributes &attributes) {
 
@@ -517,7 +509,7 @@ void loadCircle(const QDomElement &pathElement,
     parentGroup->addContained(circle);
 }
 
-void loadRect(const QDomElement &pathElement,
+void loadRect(const SvgElement &pathElement,
               ContainerBox *parentGroup,
               const BoxSvgAttributes &attributes) {
 
@@ -549,7 +541,7 @@ void loadRect(const QDomElement &pathElement,
     parentGroup->addContained(rect);
 }
 
-void loadLine(const QDomElement &pathElement,
+void loadLine(const SvgElement &pathElement,
                   ContainerBox *parentGroup,
                   VectorPathSvgAttributes &attributes) {
 
@@ -568,7 +560,7 @@ void loadLine(const QDomElement &pathElement,
     parentGroup->addContained(vectorPath);
 }
 
-void loadText(const QDomElement &pathElement,
+void loadText(const SvgElement &pathElement, const QString &text,
               ContainerBox *parentGroup,
               const BoxSvgAttributes &attributes) {
 
@@ -579,7 +571,7 @@ void loadText(const QDomElement &pathElement,
     textBox->planCenterPivotPosition();
 
     textBox->moveByRel(QPointF(xStr.toDouble(), yStr.toDouble()));
-    textBox->setCurrentValue(pathElement.text());
+    textBox->setCurrentValue(text);
 
     attributes.apply(textBox.data());
     parentGroup->addContained(textBox);
@@ -684,18 +676,16 @@ QMatrix getMatrixFromString(const QString &str) {
 static QMap<QString, SvgGradient> gGradients;
 //            to       from
 static QMap<QString, QStringList> gUnresolvedGradientLinks;
-void loadElement(const QDomElement &element, ContainerBox *parentGroup,
+void loadElement(QXmlStreamReader &reader, ContainerBox *parentGroup,
                  const BoxSvgAttributes &parentGroupAttributes,
-                 const GradientCreator& gradientCreator) {
-    const QString tagName = element.tagName();
+                 const GradientCreator& gradientCreator,
+                 SvgPathParser& pathParser) {
+    const SvgElement element(reader);
+    const QString& tagName = element.tagName();
     if(tagName == "defs") {
-        const QDomNodeList allRootChildNodes = element.childNodes();
-        for(int i = 0; i < allRootChildNodes.count(); i++) {
-            const QDomNode iNode = allRootChildNodes.at(i);
-            if(iNode.isElement()) {
-                loadElement(iNode.toElement(), parentGroup,
-                            parentGroupAttributes, gradientCreator);
-            }
+        while(reader.readNextStartElement()) {
+            loadElement(reader, parentGroup, parentGroupAttributes,
+                        gradientCreator, pathParser);
         }
         return;
     } else if(tagName == "linearGradient" || tagName == "radialGradient") {
@@ -710,11 +700,9 @@ void loadElement(const QDomElement &element, ContainerBox *parentGroup,
         Gradient* gradient = nullptr;
         if(linkId.isEmpty()) {
             gradient = gradientCreator();
-            const QDomNodeList allRootChildNodes = element.childNodes();
-            for(int i = 0; i < allRootChildNodes.count(); i++) {
-                const QDomNode iNode = allRootChildNodes.at(i);
-                if(!iNode.isElement()) continue;
-                const QDomElement elem = iNode.toElement();
+            while(reader.readNextStartElement()) {
+                const SvgElement elem(reader);
+                reader.skipCurrentElement();
                 if(elem.tagName() != "stop") continue;
                 QString stopColorS;
                 QString stopOpacityS;
@@ -745,6 +733,7 @@ void loadElement(const QDomElement &element, ContainerBox *parentGroup,
                 gradient->addColor(stopColor);
             }
         } else {
+            reader.skipCurrentElement();
             if(linkId.at(0) == "#") linkId.remove(0, 1);
             const auto it = gGradients.find(linkId);
             if(it == gGradients.end()) {
@@ -813,12 +802,16 @@ void loadElement(const QDomElement &element, ContainerBox *parentGroup,
         VectorPathSvgAttributes attributes;
         attributes.setParent(parentGroupAttributes);
         attributes.loadBoundingBoxAttributes(element);
+        reader.skipCurrentElement();
         if(tagName == "path") {
-            loadVectorPath(element, parentGroup, attributes);
+            loadVectorPath(element, parentGroup, attributes, pathParser,
+                           SvgPathParser::DataType::path);
         } else if(tagName == "polyline") {
-            loadPolyline(element, parentGroup, attributes, false);
+            loadVectorPath(element, parentGroup, attributes, pathParser,
+                           SvgPathParser::DataType::polyline);
         } else if(tagName == "polygon") {
-            loadPolyline(element, parentGroup, attributes, true);
+            loadVectorPath(element, parentGroup, attributes, pathParser,
+                           SvgPathParser::DataType::polygon);
         } else if(tagName == "line") {
             loadLine(element, parentGroup, attributes);
         }
@@ -829,18 +822,25 @@ void loadElement(const QDomElement &element, ContainerBox *parentGroup,
         attributes.setParent(parentGroupAttributes);
         attributes.loadBoundingBoxAttributes(element);
         if(tagName == "g" || tagName == "text") {
-            const auto group = loadBoxesGroup(element, parentGroup,
-                                              attributes, gradientCreator);
-            if(group->getContainedBoxesCount() == 0)
+            const auto group = loadBoxesGroup(reader, parentGroup, attributes,
+                                              gradientCreator, pathParser);
+            if(group && group->getContainedBoxesCount() == 0)
                 group->removeFromParent_k();
         } else if(tagName == "circle" || tagName == "ellipse") {
+            reader.skipCurrentElement();
             loadCircle(element, parentGroup, attributes);
         } else if(tagName == "rect") {
+            reader.skipCurrentElement();
             loadRect(element, parentGroup, attributes);
         } else if(tagName == "tspan") {
-            loadText(element, parentGroup, attributes);
+            const QString text = reader.readElementText(
+                        QXmlStreamReader::IncludeChildElements);
+            loadText(element, text, parentGroup, attributes);
         }
-    } else qDebug() << "Unrecognized tagName \"" + tagName + "\"";
+    } else {
+        qDebug() << "Unrecognized tagName \"" + tagName + "\"";
+        reader.skipCurrentElement();
+    }
 }
 
 bool getUrlId(const QString &urlStr, QString *id) {
@@ -881,14 +881,26 @@ bool getFlatColorFromString(const QString &colorStr, FillSvgAttributes *target)
     return true;
 }
 
-qsptr<BoundingBox> ImportSVG::loadSVGFile(
-        const QDomDocument& src,
-        const GradientCreator& gradientCreator) {
-    const QDomElement rootElement = src.firstChildElement("svg");
-    if(rootElement.isNull()) RuntimeThrow("File does not have svg root element");
+qsptr<BoundingBox> loadSVGStream(QXmlStreamReader& reader,
+                                 const GradientCreator& gradientCreator) {
+    reader.setNamespaceProcessing(false);
+    if(!reader.readNextStartElement() || reader.qualifiedName() != "svg") {
+        if(reader.hasError())
+            RuntimeThrow("Cannot parse file: " + reader.errorString());
+        RuntimeThrow("File does not have svg root element");
+    }
+    gGradients.clear();
+    gUnresolvedGradientLinks.clear();
+    SvgPathParser pathParser;
     BoxSvgAttributes attributes;
-    const auto result = loadBoxesGroup(rootElement, nullptr,
-                                       attributes, gradientCreator);
+    const auto result = loadBoxesGroup(reader, nullptr, attributes,
+                                       gradientCreator, pathParser);
+    if(reader.hasError()) {
+        RuntimeThrow("Cannot parse file (line " +
+                     QString::number(reader.lineNumber()) + "): " +
+                     reader.errorString());
+    }
+    pathParser.finish();
     gGradients.clear();
     auto it = gUnresolvedGradientLinks.begin();
     while(it != gUnresolvedGradientLinks.end()) {
@@ -906,22 +918,24 @@ qsptr<BoundingBox> ImportSVG::loadSVGFile(
     return result;
 }
 
+qsptr<BoundingBox> ImportSVG::loadSVGFile(
+        const QDomDocument& src,
+        const GradientCreator& gradientCreator) {
+    return loadSVGFile(src.toByteArray(), gradientCreator);
+}
+
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
         const QByteArray& src,
         const GradientCreator& gradientCreator) {
-    QDomDocument document;
-    if(!document.setContent(src))
-        RuntimeThrow("Cannot set file as QDomDocument content");
-    return loadSVGFile(document, gradientCreator);
+    QXmlStreamReader reader(src);
+    return loadSVGStream(reader, gradientCreator);
 }
 
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
         QIODevice* const src,
         const GradientCreator& gradientCreator) {
-    QDomDocument document;
-    if(!document.setContent(src))
-        RuntimeThrow("Cannot set file as QDomDocument content");
-    return loadSVGFile(document, gradientCreator);
+    QXmlStreamReader reader(src);
+    return loadSVGStream(reader, gradientCreator);
 }
 
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
@@ -986,7 +1000,7 @@ QString stripPx(const QString& val) {
     return result;
 }
 
-void BoxSvgAttributes::loadBoundingBoxAttributes(const QDomElement &element) {
+void BoxSvgAttributes::loadBoundingBoxAttributes(const SvgElement &element) {
     QList<SvgAttribute> styleAttributes;
     const QString styleAttributesStr = element.attribute("style");
     extractSvgAttributes(styleAttributesStr, &styleAttributes);
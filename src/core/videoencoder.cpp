@@ -28,6 +28,9 @@
 #include "Boxes/boxrendercontainer.h"
 #include "CacheHandlers/sceneframecontainer.h"
 #include "canvas.h"
+#include "hardwareinfo.h"
+
+#include <chrono>
 
 #define AV_RuntimeThrow(errId, message) \
 { \
@@ -45,26 +48,54 @@ using namespace Friction::Core;
 
 VideoEncoder *VideoEncoder::sInstance = nullptr;
 
+// scene frames handed to the encoder thread at once,
+// the remaining ones wait in mNextContainers
+#define MAX_QUED_CONTAINERS 8
+
+using Clock = std::chrono::steady_clock;
+
+static qint64 elapsedUs(const Clock::time_point& since) {
+    const auto elapsed = Clock::now() - since;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
 VideoEncoder::VideoEncoder() {
     Q_ASSERT(!sInstance);
     sInstance = this;
 }
 
+VideoEncoder::~VideoEncoder() {
+    stopEncoderThread();
+}
+
 void VideoEncoder::addContainer(const stdsptr<SceneFrameContainer>& cont) {
-    if(!cont) return;
+    if(!cont || !mCurrentlyEncoding) return;
     mNextContainers.append(cont);
-    if(getState() < eTaskState::qued || getState() > eTaskState::processing) queTask();
+    queContainers();
 }
 
 void VideoEncoder::addContainer(const stdsptr<Samples>& cont) {
-    if(!cont) return;
-    mNextSoundConts.append(cont);
-    if(getState() < eTaskState::qued || getState() > eTaskState::processing) queTask();
+    if(!cont || !mCurrentlyEncoding) return;
+    std::lock_guard<std::mutex> lock(mMutex);
+    _mSoundConts.append(cont);
+    mCondition.notify_one();
 }
 
 void VideoEncoder::allAudioProvided() {
-    mAllAudioProvided = true;
-    if(getState() < eTaskState::qued || getState() > eTaskState::processing) queTask();
+    if(!mCurrentlyEncoding) return;
+    std::lock_guard<std::mutex> lock(mMutex);
+    _mAllAudioProvided = true;
+    mCondition.notify_one();
+}
+
+void VideoEncoder::queContainers() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    while(!mNextContainers.isEmpty() &&
+          _mContainers.count() < MAX_QUED_CONTAINERS) {
+        _mContainers.append(mNextContainers.takeFirst());
+    }
+    _mAllContainersProvided = mEncodingFinished && mNextContainers.isEmpty();
+    mCondition.notify_one();
 }
 
 bool VideoEncoder::isValidProfile(const AVCodec *codec,
@@ -229,6 +260,8 @@ static void addVideoStream(OutputStream * const ost,
         }
     }
 
+    // let the codec spread the work over its own threads
+    c->thread_count  = 0;
     c->gop_size      = 12; /* emit one intra frame every twelve frames at most */
     c->pix_fmt       = outSettings.fVideoPixelFormat;//RGBA;
     if(c->codec_id == AV_CODEC_ID_MPEG2VIDEO) {
@@ -246,85 +279,6 @@ static void addVideoStream(OutputStream * const ost,
     }
 }
 
-static AVFrame *getVideoFrame(OutputStream * const ost,
-                              const sk_sp<SkImage> &image) {
-    AVCodecContext *c = ost->fCodec;
-
-    /* check if we want to generate more frames */
-//    if(av_compare_ts(ost->next_pts, c->time_base,
-//                      STREAM_DURATION, (AVRational) { 1, 1 }) >= 0)
-//        return nullptr;
-
-    /* as we only generate a rgba picture, we must convert it
-     * to the codec pixel format if needed */
-    if(!ost->fSwsCtx) {
-        ost->fSwsCtx = sws_getContext(c->width, c->height,
-                                      AV_PIX_FMT_RGBA,
-                                      c->width, c->height,
-                                      c->pix_fmt, SWS_BICUBIC,
-                                      nullptr, nullptr, nullptr);
-        if(!ost->fSwsCtx)
-            RuntimeThrow("Cannot initialize the conversion context");
-    }
-    SkPixmap pixmap;
-    image->peekPixels(&pixmap);
-    const uint8_t * const dstSk[] = {static_cast<uint8_t*>(pixmap.writable_addr())};
-    int linesizesSk[4];
-
-    av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA, image->width());
-    const int ret = av_frame_make_writable(ost->fDstFrame) ;
-    if(ret < 0) AV_RuntimeThrow(ret, "Could not make AVFrame writable")
-
-    sws_scale(ost->fSwsCtx, dstSk,
-              linesizesSk, 0, c->height, ost->fDstFrame->data,
-              ost->fDstFrame->linesize);
-
-    ost->fDstFrame->pts = ost->fNextPts++;
-
-    return ost->fDstFrame;
-}
-
-static void writeVideoFrame(AVFormatContext * const oc,
-                            OutputStream * const ost,
-                            const sk_sp<SkImage> &image,
-                            bool * const encodeVideo) {
-    AVCodecContext * const c = ost->fCodec;
-
-    AVFrame * frame;
-    try {
-        frame = getVideoFrame(ost, image);
-    } catch(...) {
-        RuntimeThrow("Failed to retrieve video frame");
-    }
-
-
-    // encode the image
-    const int ret = avcodec_send_frame(c, frame);
-    if(ret < 0) AV_RuntimeThrow(ret, "Error submitting a frame for encoding")
-
-    while(ret >= 0) {
-        AVPacket pkt;
-        av_init_packet(&pkt);
-
-        const int recRet = avcodec_receive_packet(c, &pkt);
-        if(recRet >= 0) {
-            av_packet_rescale_ts(&pkt, c->time_base, ost->fStream->time_base);
-            pkt.stream_index = ost->fStream->index;
-
-            // Write the compressed frame to the media file.
-            const int interRet = av_interleaved_write_frame(oc, &pkt);
-            if(interRet < 0) AV_RuntimeThrow(interRet, "Error while writing video frame")
-        } else if(recRet == AVERROR(EAGAIN) || recRet == AVERROR_EOF) {
-            *encodeVideo = ret != AVERROR_EOF;
-            break;
-        } else {
-            AV_RuntimeThrow(recRet, "Error encoding a video frame")
-        }
-
-        av_packet_unref(&pkt);
-    }
-}
-
 static void addAudioStream(OutputStream * const ost,
                            AVFormatContext * const oc,
                            const OutputSettings &settings,
@@ -481,6 +435,9 @@ static void processAudioStream(AVFormatContext * const oc,
                                OutputStream * const ost,
                                SoundIterator &iterator,
                                bool * const audioEnabled) {
+    // the codec might still reference the previous samples
+    const int ret = av_frame_make_writable(ost->fSrcFrame);
+    if(ret < 0) AV_RuntimeThrow(ret, "Could not make AVFrame writable")
     iterator.fillFrame(ost->fSrcFrame);
     bool gotOutput = ost->fSrcFrame;
 
@@ -523,9 +480,7 @@ void VideoEncoder::startEncodingNow() {
     mFormatContext->oformat = const_cast<AVOutputFormat*>(mOutputFormat);
     mFormatContext->url = av_strdup(mPathByteArray.constData());
 
-    _mCurrentContainerFrame = 0;
     // add streams
-    mAllAudioProvided = false;
     mEncodeVideo = false;
     mEncodeAudio = false;
     if(mOutputSettings.fVideoCodec && mOutputSettings.fVideoEnabled) {
@@ -599,6 +554,13 @@ bool VideoEncoder::startEncoding(RenderInstanceSettings * const settings) {
         startEncodingNow();
         mCurrentlyEncoding = true;
         mEncodingFinished = false;
+        _mRenderRange = {mRenderSettings.fMinFrame, mRenderSettings.fMaxFrame};
+        _mAllAudioProvided = false;
+        _mAllContainersProvided = false;
+        _mInterruptEncoding = false;
+        mStats = Stats();
+        mEncoderThread = std::thread(&VideoEncoder::encoderThread,
+                                     this, ++mEncodingId);
         mRenderInstanceSettings->setCurrentState(RenderState::rendering);
         mEmitter.encodingStarted();
         return true;
@@ -624,6 +586,30 @@ void VideoEncoder::finishEncodingSuccess() {
     mEmitter.encodingFinished();
 }
 
+void VideoEncoder::encodingError(const std::exception_ptr& exception) {
+    gPrintExceptionCritical(exception);
+    mRenderInstanceSettings->setCurrentState(RenderState::error, "Error");
+    finishEncodingNow();
+    mEmitter.encodingFailed();
+}
+
+void VideoEncoder::containerEncoded(const stdsptr<SceneFrameContainer>& cont) {
+    const auto currCanvas = mRenderInstanceSettings->getTargetCanvas();
+    currCanvas->setSceneFrame(cont);
+    currCanvas->setMinFrameUseRange(cont->getRange().fMax + 1);
+    queContainers();
+}
+
+void VideoEncoder::stopEncoderThread() {
+    if(!mEncoderThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        _mInterruptEncoding = true;
+        mCondition.notify_one();
+    }
+    mEncoderThread.join();
+}
+
 static void flushStream(OutputStream * const ost,
                         AVFormatContext * const formatCtx) {
     if(!ost) return;
@@ -660,18 +646,15 @@ static void closeStream(OutputStream * const ost) {
     }
     if(ost->fDstFrame) av_frame_free(&ost->fDstFrame);
     if(ost->fSrcFrame) av_frame_free(&ost->fSrcFrame);
-    if(ost->fSwsCtx) sws_freeContext(ost->fSwsCtx);
     if(ost->fSwrCtx) swr_free(&ost->fSwrCtx);
     *ost = OutputStream();
 }
 
 void VideoEncoder::finishEncodingNow() {
     if(!mCurrentlyEncoding) return;
-
-    if(mEncodeVideo) flushStream(&mVideoStream, mFormatContext);
-    if(mEncodeAudio) flushStream(&mAudioStream, mFormatContext);
-
-    if(mEncodingSuccesfull) av_write_trailer(mFormatContext);
+    // after a successful encoding the thread has already
+    // flushed the codecs and written the trailer
+    stopEncoderThread();
 
     /* Close each codec. */
     if(mEncodeVideo) closeStream(&mVideoStream);
@@ -694,118 +677,173 @@ void VideoEncoder::finishEncodingNow() {
     mCurrentlyEncoding = false;
     mEncodingSuccesfull = false;
     mNextContainers.clear();
-    mNextSoundConts.clear();
-    clearContainers();
+    _mContainers.clear();
+    _mSoundConts.clear();
+    mSoundIterator.clear();
+    mVideoConverter.clear();
 
     eSoundSettings::sRestore();
 }
 
-void VideoEncoder::clearContainers() {
-    _mContainers.clear();
-    mSoundIterator.clear();
+template <typename F>
+void VideoEncoder::invokeOnGuiThread(const int id, const F& func) {
+    QMetaObject::invokeMethod(&mEmitter, [this, id, func]() {
+        // ignore a stopped or replaced encoding
+        if(id != mEncodingId || !mCurrentlyEncoding) return;
+        func();
+    }, Qt::QueuedConnection);
 }
 
-void VideoEncoder::process() {
-    bool hasVideo = !_mContainers.isEmpty(); // local encode
-    bool hasAudio;
-    if(mEncodeAudio) {
-        if(_mAllAudioProvided) {
-            hasAudio = mSoundIterator.hasValue();
-        } else {
-            hasAudio = mSoundIterator.hasSamples(mAudioStream.fSrcFrame->nb_samples);
-        }
-    } else hasAudio = false;
-    while((mEncodeVideo && hasVideo) || (mEncodeAudio && hasAudio)) {
-        bool videoAligned = true;
-        if(mEncodeVideo && mEncodeAudio) {
-            videoAligned = av_compare_ts(mVideoStream.fNextPts,
-                                         mVideoStream.fCodec->time_base,
-                                         mAudioStream.fNextPts,
-                                         mAudioStream.fCodec->time_base) <= 0;
+void VideoEncoder::encoderThread(const int id) {
+    const auto start = Clock::now();
+    try {
+        const bool finished = encodeStreams(id);
+        mStats.fTotalUs = elapsedUs(start);
+        if(!finished) return;
+        if(mEncodeVideo) flushStream(&mVideoStream, mFormatContext);
+        if(mEncodeAudio) flushStream(&mAudioStream, mFormatContext);
+        const int ret = av_write_trailer(mFormatContext);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not write trailer")
+        invokeOnGuiThread(id, [this]() { finishEncodingSuccess(); });
+    } catch(...) {
+        mStats.fTotalUs = elapsedUs(start);
+        const auto exception = std::current_exception();
+        invokeOnGuiThread(id, [this, exception]() {
+            encodingError(exception);
+        });
+    }
+}
+
+bool VideoEncoder::encodeStreams(const int id) {
+    stdsptr<SceneFrameContainer> cont;
+    int contFrames = 0; // some containers will add multiple frames
+    bool contConverted = false;
+    while(true) {
+        bool encodeVideo = false;
+        bool encodeAudio = false;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while(true) {
+                if(_mInterruptEncoding) return false;
+                for(const auto& sound : _mSoundConts)
+                    mSoundIterator.add(sound);
+                _mSoundConts.clear();
+                if(!cont && !_mContainers.isEmpty()) {
+                    cont = _mContainers.takeFirst();
+                    contFrames = (cont->getRange()*_mRenderRange).span();
+                    contConverted = false;
+                }
+                const bool allAudio = _mAllAudioProvided ||
+                                      _mAllContainersProvided;
+                const bool videoDone = !mEncodeVideo ||
+                        (!cont && _mAllContainersProvided);
+                bool audioDone = !mEncodeAudio;
+                bool hasAudio = false;
+                if(mEncodeAudio) {
+                    audioDone = allAudio && !mSoundIterator.hasValue();
+                    hasAudio = allAudio ? mSoundIterator.hasValue() :
+                                          mSoundIterator.hasSamples(mAudioStream.fSrcFrame->nb_samples);
+                }
+                int videoVsAudio = 0;
+                if(mEncodeVideo && mEncodeAudio) {
+                    videoVsAudio = av_compare_ts(mVideoStream.fNextPts,
+                                                 mVideoStream.fCodec->time_base,
+                                                 mAudioStream.fNextPts,
+                                                 mAudioStream.fCodec->time_base);
+                }
+                encodeVideo = mEncodeVideo && cont &&
+                              (audioDone || videoVsAudio <= 0);
+                encodeAudio = hasAudio && (videoDone || videoVsAudio >= 0);
+                if(encodeVideo || encodeAudio) break;
+                if(videoDone && audioDone) return true;
+                mCondition.wait(lock);
+            }
         }
-        const bool encodeVideo = mEncodeVideo && hasVideo && videoAligned;
         if(encodeVideo) {
-            const auto cacheCont = _mContainers.at(_mCurrentContainerId);
-            const auto contRange = cacheCont->getRange()*_mRenderRange;
-            const int nFrames = contRange.span();
             try {
-                writeVideoFrame(mFormatContext, &mVideoStream,
-                                cacheCont->getImage(), &hasVideo);
-                avcodec_flush_buffers(mVideoStream.fCodec);
+                if(contFrames > 0) {
+                    writeVideoFrame(cont, !contConverted);
+                    contConverted = true;
+                }
             } catch(...) {
                 RuntimeThrow("Failed to write video frame");
             }
-            if(++_mCurrentContainerFrame >= nFrames) {
-                _mCurrentContainerId++;
-                _mCurrentContainerFrame = 0;
-                hasVideo = _mCurrentContainerId < _mContainers.count();
+            if(--contFrames <= 0) {
+                invokeOnGuiThread(id, [this, cont]() {
+                    containerEncoded(cont);
+                });
+                cont.reset();
             }
-        }
-        bool audioAligned = true;
-        if(mEncodeVideo && mEncodeAudio) {
-            audioAligned = av_compare_ts(mVideoStream.fNextPts,
-                                         mVideoStream.fCodec->time_base,
-                                         mAudioStream.fNextPts,
-                                         mAudioStream.fCodec->time_base) >= 0;
-        }
-        const bool encodeAudio = mEncodeAudio && hasAudio && audioAligned;
-        if(encodeAudio) {
+        } else if(encodeAudio) {
             try {
+                bool hasAudio;
                 processAudioStream(mFormatContext, &mAudioStream,
                                    mSoundIterator, &hasAudio);
-                avcodec_flush_buffers(mAudioStream.fCodec);
             } catch(...) {
                 RuntimeThrow("Failed to process audio stream");
             }
-            hasAudio = _mAllAudioProvided ? mSoundIterator.hasValue() :
-                                            mSoundIterator.hasSamples(mAudioStream.fSrcFrame->nb_samples);
         }
-        if(!encodeVideo && !encodeAudio) break;
     }
 }
 
-
-void VideoEncoder::beforeProcessing(const Hardware) {
-    _mCurrentContainerId = 0;
-    _mAllAudioProvided = mAllAudioProvided;
-    if(_mContainers.isEmpty()) {
-        _mContainers.swap(mNextContainers);
-    } else {
-        for(const auto& cont : mNextContainers)
-            _mContainers.append(cont);
-        mNextContainers.clear();
+void VideoEncoder::writeVideoFrame(const stdsptr<SceneFrameContainer>& cont,
+                                   const bool convert) {
+    OutputStream * const ost = &mVideoStream;
+    AVCodecContext * const c = ost->fCodec;
+    AVFrame * const frame = ost->fDstFrame;
+
+    if(convert) {
+        const auto start = Clock::now();
+        /* as we only generate a rgba picture, we must convert it
+         * to the codec pixel format if needed */
+        if(!mVideoConverter.isInitialized()) {
+            mVideoConverter.initialize(c->width, c->height,
+                                       AV_PIX_FMT_RGBA, c->pix_fmt,
+                                       SWS_BICUBIC,
+                                       HardwareInfo::sCpuThreads());
+        }
+        SkPixmap pixmap;
+        if(!cont->getImage()->peekPixels(&pixmap))
+            RuntimeThrow("Could not access frame pixels");
+        const uint8_t * const src[4] = {
+            static_cast<const uint8_t*>(pixmap.addr()),
+            nullptr, nullptr, nullptr};
+        const int srcStride[4] = {int(pixmap.rowBytes()), 0, 0, 0};
+        // the codec might still reference the previous picture
+        const int ret = av_frame_make_writable(frame);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not make AVFrame writable")
+        mVideoConverter.scale(src, srcStride, frame->data, frame->linesize);
+        mStats.fConversionUs += elapsedUs(start);
     }
-    for(const auto& sound : mNextSoundConts)
-        mSoundIterator.add(sound);
-    mNextSoundConts.clear();
-    _mRenderRange = {mRenderSettings.fMinFrame, mRenderSettings.fMaxFrame};
-    if(!mCurrentlyEncoding) clearContainers();
-}
 
-void VideoEncoder::afterProcessing() {
-    const auto currCanvas = mRenderInstanceSettings->getTargetCanvas();
-    if(_mCurrentContainerId != 0) {
-        const auto lastEncoded = _mContainers.at(_mCurrentContainerId - 1);
-        currCanvas->setSceneFrame(lastEncoded);
-        currCanvas->setMinFrameUseRange(lastEncoded->getRange().fMax + 1);
-    }
+    const auto start = Clock::now();
+    frame->pts = ost->fNextPts++;
+    // encode the image
+    const int ret = avcodec_send_frame(c, frame);
+    if(ret < 0) AV_RuntimeThrow(ret, "Error submitting a frame for encoding")
 
-    for(int i = _mContainers.count() - 1; i >= _mCurrentContainerId; i--) {
-        const auto &cont = _mContainers.at(i);
-        mNextContainers.prepend(cont);
-    }
-    _mContainers.clear();
+    while(true) {
+        AVPacket pkt;
+        av_init_packet(&pkt);
 
-    if(mInterruptEncoding) {
-        interrupEncoding();
-        mInterruptEncoding = false;
-    } else if(unhandledException()) {
-        gPrintExceptionCritical(takeException());
-        mRenderInstanceSettings->setCurrentState(RenderState::error, "Error");
-        finishEncodingNow();
-        mEmitter.encodingFailed();
-    } else if(mEncodingFinished) finishEncodingSuccess();
-    else if(!mNextContainers.isEmpty()) queTask();
+        const int recRet = avcodec_receive_packet(c, &pkt);
+        if(recRet >= 0) {
+            av_packet_rescale_ts(&pkt, c->time_base, ost->fStream->time_base);
+            pkt.stream_index = ost->fStream->index;
+
+            // Write the compressed frame to the media file.
+            const int interRet = av_interleaved_write_frame(mFormatContext, &pkt);
+            if(interRet < 0) AV_RuntimeThrow(interRet, "Error while writing video frame")
+        } else if(recRet == AVERROR(EAGAIN) || recRet == AVERROR_EOF) {
+            break;
+        } else {
+            AV_RuntimeThrow(recRet, "Error encoding a video frame")
+        }
+
+        av_packet_unref(&pkt);
+    }
+    mStats.fEncodingUs += elapsedUs(start);
+    mStats.fFrames++;
 }
 
 void VideoEncoder::sFinishEncoding() {
@@ -36,6 +36,11 @@
 #include "framerange.h"
 #include "CacheHandlers/samples.h"
 #include "Sound/esoundsettings.h"
+#include "slicedswscontext.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 extern "C" {
     #include <libavcodec/avcodec.h>
@@ -166,7 +171,6 @@ typedef struct CORE_EXPORT OutputStream {
     AVCodecContext *fCodec = nullptr;
     AVFrame *fDstFrame = nullptr;
     AVFrame *fSrcFrame = nullptr;
-    struct SwsContext *fSwsCtx = nullptr;
     struct SwrContext *fSwrCtx = nullptr;
 } OutputStream;
 
@@ -183,28 +187,33 @@ signals:
     void encodingFailed();
 };
 
-class CORE_EXPORT VideoEncoder : public eHddTask {
+class CORE_EXPORT VideoEncoder : public StdSelfRef {
     e_OBJECT
 protected:
     VideoEncoder();
 public:
-    void process();
-    void beforeProcessing(const Hardware);
-    void afterProcessing();
+    ~VideoEncoder();
+
+    // Time spent by the encoder thread on the last encoding
+    struct Stats {
+        int fFrames = 0;
+        qint64 fConversionUs = 0;
+        qint64 fEncodingUs = 0;
+        qint64 fTotalUs = 0;
+    };
 
     bool startNewEncoding(RenderInstanceSettings * const settings) {
         return startEncoding(settings);
     }
 
     void interruptCurrentEncoding() {
-        if(isActive()) mInterruptEncoding = true;
-        else interrupEncoding();
+        interrupEncoding();
     }
 
     void finishCurrentEncoding() {
         if(!mCurrentlyEncoding) return;
-        if(isActive()) mEncodingFinished = true;
-        else finishEncodingSuccess();
+        mEncodingFinished = true;
+        queContainers();
     }
 
     void addContainer(const stdsptr<SceneFrameContainer> &cont);
@@ -231,27 +240,45 @@ public:
     bool getCurrentlyEncoding() const {
         return mCurrentlyEncoding;
     }
+
+    //! @brief Valid once encoding finished, interrupted or failed
+    const Stats& getStats() const {
+        return mStats;
+    }
 protected:
-    void clearContainers();
     VideoEncoderEmitter mEmitter;
     void interrupEncoding();
     void finishEncodingSuccess();
     void finishEncodingNow();
     bool startEncoding(RenderInstanceSettings * const settings);
     void startEncodingNow();
+private:
+    // GUI thread
+    void queContainers();
+    void containerEncoded(const stdsptr<SceneFrameContainer> &cont);
+    void encodingError(const std::exception_ptr& exception);
+    void stopEncoderThread();
+
+    // encoder thread
+    void encoderThread(const int id);
+    bool encodeStreams(const int id);
+    void writeVideoFrame(const stdsptr<SceneFrameContainer> &cont,
+                         const bool convert);
+    template <typename F>
+    void invokeOnGuiThread(const int id, const F& func);
 
     bool mEncodingSuccesfull = false;
     bool mEncodingFinished = false;
-    bool mInterruptEncoding = false;
 
     eSoundSettingsData mInSoundSettings;
     OutputStream mVideoStream;
     OutputStream mAudioStream;
+    SlicedSwsContext mVideoConverter;
     AVFormatContext *mFormatContext = nullptr;
     const AVOutputFormat *mOutputFormat = nullptr;
     bool mCurrentlyEncoding = false;
+    int mEncodingId = 0;
     QList<stdsptr<SceneFrameContainer>> mNextContainers;
-    QList<stdsptr<Samples>> mNextSoundConts;
 
     RenderSettings mRenderSettings;
     OutputSettings mOutputSettings;
@@ -259,15 +286,21 @@ protected:
     QByteArray mPathByteArray;
     bool mEncodeVideo = false;
     bool mEncodeAudio = false;
-    bool mAllAudioProvided = false;
 
+    std::thread mEncoderThread;
+    // guards the members shared with the encoder thread
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    // bounded, mNextContainers holds the overflow
+    QList<stdsptr<SceneFrameContainer>> _mContainers;
+    QList<stdsptr<Samples>> _mSoundConts;
     bool _mAllAudioProvided = false;
-    int _mCurrentContainerId = 0;
-    int _mCurrentContainerFrame = 0; // some containers will add multiple frames
-    FrameRange _mRenderRange;
+    bool _mAllContainersProvided = false;
+    bool _mInterruptEncoding = false;
 
-    QList<stdsptr<SceneFrameContainer>> _mContainers;
+    FrameRange _mRenderRange;
     SoundIterator mSoundIterator;
+    Stats mStats;
 };
 
 #endif // VIDEOENCODER_H
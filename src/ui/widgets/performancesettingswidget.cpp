@@ -98,6 +98,11 @@ PerformanceSettingsWidget::PerformanceSettingsWidget(QWidget *parent)
     ramCapSett->addWidget(mRamMBCapSpin);
     capLayout->addLayout(ramCapSett);
 
+    mHddCacheCompressionCheck = new QCheckBox(tr("Compress disk cache"), this);
+    mHddCacheCompressionCheck->setToolTip(tr("Fast lossless compression of "
+                                             "frames moved to the disk cache"));
+    capLayout->addWidget(mHddCacheCompressionCheck);
+
     const auto gpuGroup = new QGroupBox(HardwareInfo::sGpuRendererString(),
                                         this);
     gpuGroup->setObjectName("BlueBox");
@@ -162,6 +167,7 @@ PerformanceSettingsWidget::PerformanceSettingsWidget(QWidget *parent)
     eSizesUI::widget.add(mCpuThreadsCapCheck, [this](const int size) {
         mCpuThreadsCapCheck->setFixedHeight(size);
         mRamMBCapCheck->setFixedHeight(size);
+        mHddCacheCompressionCheck->setFixedHeight(size);
         mPathGpuAccCheck->setFixedHeight(size);
         mAudioDevicesCombo->setFixedHeight(eSizesUI::button);
     });
@@ -178,6 +184,7 @@ void PerformanceSettingsWidget::applySettings()
                 mCpuThreadsCapSlider->value() : 0;
     mSett.fRamMBCap = intMB(mRamMBCapCheck->isChecked() ?
                 mRamMBCapSpin->value() : 0);
+    mSett.fHddCacheCompression = mHddCacheCompressionCheck->isChecked();
     mSett.fAccPreference = static_cast<AccPreference>(
                 mAccPreferenceSlider->value());
     mSett.fPathGpuAcc = mPathGpuAccCheck->isChecked();
@@ -204,6 +211,7 @@ void PerformanceSettingsWidget::updateSettings(bool restore)
     const int nRamMB = capRam ? mSett.fRamMBCap.fValue :
                                 intMB(HardwareInfo::sRamKB()).fValue;
     mRamMBCapSpin->setValue(nRamMB);
+    mHddCacheCompressionCheck->setChecked(mSett.fHddCacheCompression);
 
     mAccPreferenceSlider->setValue(static_cast<int>(mSett.fAccPreference));
     updateAccPreferenceDesc();
@@ -53,6 +53,25 @@ WrapperNode* WrapperNode::sRead(eReadStream &src,
     return wid;
 }
 
+void WrapperNode::sSkip(eReadStream &src,
+                        const std::function<void(eReadStream&)>& skipWidget) {
+    WrapperNodeType type;
+    src.read(&type, sizeof(WrapperNodeType));
+    switch(type) {
+    case WrapperNodeType::widget:
+        skipWidget(src);
+        break;
+    case WrapperNodeType::splitH:
+    case WrapperNodeType::splitV: {
+        // SplitWrapperNode::readData
+        sSkip(src, skipWidget);
+        sSkip(src, skipWidget);
+        qreal child2frac; src >> child2frac;
+    } break;
+    default: RuntimeThrow("Invalid WrapperNodeType, data corrupted");
+    }
+}
+
 WrapperNode* WrapperNode::sReadXEV(XevReadBoxesHandler& boxReadHandler,
                                    const QDomElement& ele,
                                    const WidgetCreator& creator,
@@ -74,6 +74,10 @@ public:
 
     static WrapperNode *sRead(eReadStream& src,
                               const WidgetCreator& creator);
+    //! @brief Reads past the data read by sRead without creating widgets,
+    //! skipWidget has to read past the data of a single widget
+    static void sSkip(eReadStream& src,
+                      const std::function<void(eReadStream&)>& skipWidget);
     static WrapperNode *sReadXEV(XevReadBoxesHandler& boxReadHandler,
                                  const QDomElement& ele,
                                  const WidgetCreator& creator,
@@ -193,6 +197,7 @@ public:
     }
 protected:
     virtual QWidget* takeWidget(QWidget* const wid) = 0;
+    virtual void appendChildren(const qreal child2frac) = 0;
 
     void readData(eReadStream& src) {
         fChild1 = sRead(src, fCreator);
@@ -200,6 +205,9 @@ protected:
 
         fChild1->fParent = this;
         fChild2->fParent = this;
+
+        qreal child2frac; src >> child2frac;
+        appendChildren(child2frac);
     }
 
     void writeData(eWriteStream& dst) {
@@ -247,9 +255,7 @@ protected:
         return VWidgetStack::takeWidget(wid);
     }
 
-    void readData(eReadStream& src) {
-        SplitWrapperNode::readData(src);
-        qreal child2frac; src >> child2frac;
+    void appendChildren(const qreal child2frac) {
         appendWidget(fChild1->widget());
         appendWidget(fChild2->widget(), child2frac);
     }
@@ -271,8 +277,7 @@ protected:
         SplitWrapperNode::readDataXEV(boxReadHandler, ele, objListIdConv);
         const QString child2fracStr = ele.attribute("proportions");
         const qreal child2frac = XmlExportHelpers::stringToDouble(child2fracStr);
-        appendWidget(fChild1->widget());
-        appendWidget(fChild2->widget(), child2frac);
+        appendChildren(child2frac);
     }
 
     QString tagNameXEV() const { return "VSplit"; };
@@ -295,9 +300,7 @@ protected:
         return HWidgetStack::takeWidget(wid);
     }
 
-    void readData(eReadStream& src) {
-        SplitWrapperNode::readData(src);
-        qreal child2frac; src >> child2frac;
+    void appendChildren(const qreal child2frac) {
         appendWidget(fChild1->widget());
         appendWidget(fChild2->widget(), child2frac);
     }
@@ -319,8 +322,7 @@ protected:
         SplitWrapperNode::readDataXEV(boxReadHandler, ele, objListIdConv);
         const QString child2fracStr = ele.attribute("proportions");
         const qreal child2frac = XmlExportHelpers::stringToDouble(child2fracStr);
-        appendWidget(fChild1->widget());
-        appendWidget(fChild2->widget(), child2frac);
+        appendChildren(child2frac);
     }
 
     QString tagNameXEV() const { return "HSplit"; };